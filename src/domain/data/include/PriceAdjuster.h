@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace domain {
+namespace data {
+
+// 复权方式
+enum class AdjustMode {
+    None,      // 不复权
+    Forward,   // 前复权：以最新价格为基准，历史价格向下调整
+    Backward   // 后复权：以上市首日为基准，之后价格向上调整
+};
+
+// 除权除息事件（数值均为"每股"口径）
+struct CorporateAction {
+    std::int32_t exDate = 0;     // 除权除息日 YYYYMMDD
+    double cashDividend = 0.0;   // 每股派息（元）
+    double bonusShares = 0.0;    // 每股送转股数，如 10 送 3 记 0.3
+    double rightsShares = 0.0;   // 每股配股数
+    double rightsPrice = 0.0;    // 配股价
+};
+
+// 单个标的的复权因子表
+// 每个除权日存一个累计因子，新分红到来时只在尾部追加一项，
+// 原始行情数据本身不需要改写
+class AdjustmentFactorTable {
+public:
+    struct Entry {
+        std::int32_t exDate;
+        double cumulative;   // 截至该日（含）所有事件的累计因子，后复权乘数
+    };
+
+    // 追加一个除权事件；prevClose 为除权日前一交易日收盘价
+    // 事件必须按日期严格递增追加，否则抛出 std::invalid_argument；
+    // 同一天的派息、送转、配股要合并成一个 CorporateAction，不能分开登记
+    void addAction(const CorporateAction& action, double prevClose);
+
+    // 直接追加已计算好的单次因子（数据源直接提供因子时使用），日期规则同 addAction
+    void addFactor(std::int32_t exDate, double factor);
+
+    // date 当日生效的后复权累计因子
+    double cumulativeAt(std::int32_t date) const;
+    double latest() const { return entries_.empty() ? 1.0 : entries_.back().cumulative; }
+
+    const std::vector<Entry>& entries() const { return entries_; }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    std::vector<Entry> entries_;
+};
+
+// 复权计算与缓存
+// - 因子表按标的存储，行情数据保持原始价格
+// - 取数时按 (symbol, mode) 惰性计算复权序列并缓存
+// - 缓存按 (dataVersion, 条数, 末日期) 识别同一份输入，不依赖缓冲区地址，
+//   命中时不再遍历整列数据，开销与序列长度无关
+// - 因子表变化（新增分红）后对应缓存自动失效
+// - 缓存按最近使用淘汰，最多保留 capacity 项
+class PriceAdjuster {
+public:
+    // 复权后的价格序列，在缓存中共享
+    using Series = std::shared_ptr<const std::vector<double>>;
+
+    explicit PriceAdjuster(std::size_t cacheCapacity = 1024) : capacity_(cacheCapacity ? cacheCapacity : 1) {}
+
+    void addAction(const std::string& symbol, const CorporateAction& action, double prevClose);
+    void addFactor(const std::string& symbol, std::int32_t exDate, double factor);
+
+    // 对整列价格复权；dates 必须递增，与 prices 一一对应
+    // dataVersion 由调用方维护（与 IndicatorCache::series 相同）：同一标的的行情被修正或重新加载时
+    // 必须换一个从未用过的值；只在尾部追加 bar 时条数与末日期已会变化，可以沿用原值
+    // 返回值可长期持有，缓存淘汰不会影响已返回的序列
+    Series adjusted(const std::string& symbol, AdjustMode mode, std::uint64_t dataVersion,
+                    const std::int32_t* dates, const double* prices, std::size_t n);
+
+    // 不走缓存，直接写入 out（out 可与 prices 相同，实现原地复权）
+    void apply(const std::string& symbol, AdjustMode mode,
+               const std::int32_t* dates, const double* prices, double* out, std::size_t n) const;
+
+    void invalidate(const std::string& symbol);
+    void clearCache();
+
+    std::size_t cacheHits() const { return hits_.load(std::memory_order_relaxed); }
+    std::size_t cacheMisses() const { return misses_.load(std::memory_order_relaxed); }
+    std::size_t cacheSize() const;
+    std::size_t cacheCapacity() const { return capacity_; }
+
+private:
+    struct SymbolState {
+        AdjustmentFactorTable table;
+        std::uint64_t version = 0;
+    };
+
+    struct CacheEntry {
+        std::uint64_t version = 0;       // 因子表版本
+        std::uint64_t dataVersion = 0;
+        std::size_t count = 0;
+        std::int32_t lastDate = 0;
+        Series series;
+        std::list<std::string>::iterator lru;
+    };
+
+    static std::string cacheKey(const std::string& symbol, AdjustMode mode);
+    static void applyTable(const AdjustmentFactorTable& table, AdjustMode mode,
+                           const std::int32_t* dates, const double* prices, double* out, std::size_t n);
+
+    mutable std::shared_mutex mutex_;   // 保护 symbols_
+    std::unordered_map<std::string, SymbolState> symbols_;
+
+    std::size_t capacity_;
+    mutable std::mutex cacheMutex_;     // 保护 cache_ / lru_（命中也要调整 LRU 顺序）
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::list<std::string> lru_;        // 头部最近使用
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+};
+
+} // namespace data
+} // namespace domain
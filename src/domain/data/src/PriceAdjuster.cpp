@@ -0,0 +1,192 @@
+#include "PriceAdjuster.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace domain {
+namespace data {
+
+// ==================== AdjustmentFactorTable ====================
+
+void AdjustmentFactorTable::addAction(const CorporateAction& action, double prevClose)
+{
+    if (prevClose <= 0.0) {
+        throw std::invalid_argument("AdjustmentFactorTable: prevClose must be positive");
+    }
+    // 除权参考价 = (前收盘 - 每股派息 + 配股价 * 每股配股数) / (1 + 每股送转 + 每股配股)
+    const double shares = 1.0 + action.bonusShares + action.rightsShares;
+    const double refPrice =
+        (prevClose - action.cashDividend + action.rightsPrice * action.rightsShares) / shares;
+    if (refPrice <= 0.0) {
+        throw std::invalid_argument("AdjustmentFactorTable: invalid corporate action, reference price <= 0");
+    }
+    addFactor(action.exDate, prevClose / refPrice);
+}
+
+void AdjustmentFactorTable::addFactor(std::int32_t exDate, double factor)
+{
+    if (factor <= 0.0) {
+        throw std::invalid_argument("AdjustmentFactorTable: factor must be positive");
+    }
+    if (!entries_.empty() && exDate <= entries_.back().exDate) {
+        // 同一天的第二次登记多半是重复导入；各自按同一个前收盘算出的因子相乘也不等于合并后的因子
+        if (exDate == entries_.back().exDate) {
+            throw std::invalid_argument("AdjustmentFactorTable: ex-date " + std::to_string(exDate) +
+                                        " already registered; merge same-day actions into one");
+        }
+        throw std::invalid_argument("AdjustmentFactorTable: actions must be added in date order");
+    }
+    entries_.push_back({exDate, latest() * factor});
+}
+
+double AdjustmentFactorTable::cumulativeAt(std::int32_t date) const
+{
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), date,
+                               [](std::int32_t d, const Entry& e) { return d < e.exDate; });
+    if (it == entries_.begin()) return 1.0;
+    return std::prev(it)->cumulative;
+}
+
+// ==================== PriceAdjuster ====================
+
+void PriceAdjuster::addAction(const std::string& symbol, const CorporateAction& action, double prevClose)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& state = symbols_[symbol];
+    state.table.addAction(action, prevClose);
+    ++state.version;
+}
+
+void PriceAdjuster::addFactor(const std::string& symbol, std::int32_t exDate, double factor)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& state = symbols_[symbol];
+    state.table.addFactor(exDate, factor);
+    ++state.version;
+}
+
+std::string PriceAdjuster::cacheKey(const std::string& symbol, AdjustMode mode)
+{
+    std::string key = symbol;
+    key.push_back('#');
+    key.push_back(static_cast<char>('0' + static_cast<int>(mode)));
+    return key;
+}
+
+void PriceAdjuster::applyTable(const AdjustmentFactorTable& table, AdjustMode mode,
+                               const std::int32_t* dates, const double* prices, double* out, std::size_t n)
+{
+    // 因子是分段常数：每两个除权日之间的区间乘同一个数
+    // 先用二分找到区间边界，再对每个区间做一次连续乘法（编译器可自动向量化）
+    const auto& entries = table.entries();
+    const double base = (mode == AdjustMode::Forward) ? table.latest() : 1.0;
+
+    std::size_t begin = 0;
+    double factor = 1.0 / base;
+    for (std::size_t k = 0; k <= entries.size() && begin < n; ++k) {
+        std::size_t end = n;
+        if (k < entries.size()) {
+            end = static_cast<std::size_t>(
+                std::lower_bound(dates + begin, dates + n, entries[k].exDate) - dates);
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            out[i] = prices[i] * factor;
+        }
+        begin = end;
+        if (k < entries.size()) {
+            factor = entries[k].cumulative / base;
+        }
+    }
+}
+
+void PriceAdjuster::apply(const std::string& symbol, AdjustMode mode,
+                          const std::int32_t* dates, const double* prices, double* out, std::size_t n) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = symbols_.find(symbol);
+    if (mode == AdjustMode::None || it == symbols_.end() || it->second.table.empty()) {
+        if (out != prices) std::copy(prices, prices + n, out);
+        return;
+    }
+    applyTable(it->second.table, mode, dates, prices, out, n);
+}
+
+PriceAdjuster::Series PriceAdjuster::adjusted(const std::string& symbol, AdjustMode mode,
+                                              std::uint64_t dataVersion,
+                                              const std::int32_t* dates, const double* prices, std::size_t n)
+{
+    const std::string key = cacheKey(symbol, mode);
+    const std::int32_t lastDate = n ? dates[n - 1] : 0;
+
+    std::uint64_t version = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto sit = symbols_.find(symbol);
+        version = (sit == symbols_.end()) ? 0 : sit->second.version;
+    }
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto cit = cache_.find(key);
+        if (cit != cache_.end() && cit->second.version == version && cit->second.dataVersion == dataVersion &&
+            cit->second.count == n && cit->second.lastDate == lastDate) {
+            lru_.splice(lru_.begin(), lru_, cit->second.lru);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return cit->second.series;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    auto series = std::make_shared<std::vector<double>>(n);
+    apply(symbol, mode, dates, prices, series->data(), n);
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto [it, inserted] = cache_.try_emplace(key);
+    CacheEntry& entry = it->second;
+    if (inserted) {
+        lru_.push_front(key);
+        entry.lru = lru_.begin();
+    } else {
+        lru_.splice(lru_.begin(), lru_, entry.lru);
+    }
+    entry.version = version;
+    entry.dataVersion = dataVersion;
+    entry.count = n;
+    entry.lastDate = lastDate;
+    entry.series = series;
+
+    while (cache_.size() > capacity_) {
+        cache_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    return series;
+}
+
+std::size_t PriceAdjuster::cacheSize() const
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return cache_.size();
+}
+
+void PriceAdjuster::invalidate(const std::string& symbol)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    for (AdjustMode mode : {AdjustMode::None, AdjustMode::Forward, AdjustMode::Backward}) {
+        auto it = cache_.find(cacheKey(symbol, mode));
+        if (it == cache_.end()) continue;
+        lru_.erase(it->second.lru);
+        cache_.erase(it);
+    }
+}
+
+void PriceAdjuster::clearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cache_.clear();
+    lru_.clear();
+}
+
+} // namespace data
+} // namespace domain
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "foundation/log/metrics.hpp"
+
+namespace domain {
+namespace indicators {
+
+enum class IndicatorType : std::uint16_t {
+    Sma = 1,
+    Ema = 2,
+    StdDev = 3,   // 滚动标准差（总体）
+    Rsi = 4       // Wilder RSI
+};
+
+const char* indicatorTypeName(IndicatorType type);
+
+// 缓存键：(标的 id, 指标类型, 参数)
+struct IndicatorKey {
+    std::uint32_t symbolId = 0;
+    IndicatorType type = IndicatorType::Sma;
+    std::uint32_t period = 0;
+    double param = 0.0;   // 预留的第二个参数（如布林带倍数），不用时为 0
+
+    bool operator==(const IndicatorKey& o) const {
+        return symbolId == o.symbolId && type == o.type && period == o.period && param == o.param;
+    }
+};
+
+struct IndicatorKeyHash {
+    std::size_t operator()(const IndicatorKey& k) const {
+        std::uint64_t h = (static_cast<std::uint64_t>(k.symbolId) << 32) ^
+                          (static_cast<std::uint64_t>(k.type) << 24) ^ k.period;
+        h ^= std::hash<double>()(k.param) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        return static_cast<std::size_t>(h);
+    }
+};
+
+// 对整列输入计算指标，预热期输出 NaN；流式与批量两种模式结果一致
+// NaN 输入跳过（不进入窗口），输出保持上一个值，与 StaticPipeline 的 Sma/Ema 相同
+void computeIndicator(IndicatorType type, std::uint32_t period, double param,
+                      const double* input, std::size_t n, double* out);
+
+// 指标共享缓存
+// 多个策略/信号在同一标的上反复计算 SMA(20) 之类的指标，这里统一去重：
+//
+// 流式模式（回测/实时逐 bar）：
+//   acquire(key) 取得句柄，相同 key 共享同一个实例；
+//   引擎每根 bar 对每个标的调用一次 onBar(symbolId, barSeq, price)，
+//   同一个 barSeq 重复调用会被忽略，保证每个指标每根 bar 只更新一次
+//
+// 批量模式（整列计算）：
+//   series(key, input, n, dataVersion) 返回整列结果并缓存，
+//   按字节数上限做 LRU 淘汰；多个线程同时请求同一个 key、同一版本、同样长度只计算一次
+//
+// 线程安全：流式部分按标的分片加锁，批量部分单独一把锁，读句柄的值无锁
+class IndicatorCache {
+public:
+    using Series = std::shared_ptr<const std::vector<double>>;
+
+    struct Options {
+        std::size_t maxSeriesBytes = 256u << 20;   // 批量结果的内存上限
+        std::size_t shards = 16;                   // 流式部分的分片数
+    };
+
+    struct Stats {
+        std::uint64_t streamHits = 0;
+        std::uint64_t streamMisses = 0;
+        std::uint64_t seriesHits = 0;
+        std::uint64_t seriesMisses = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t updates = 0;        // 实际执行的流式更新次数
+        std::uint64_t skippedUpdates = 0; // 同一根 bar 重复 onBar 被忽略的次数
+        std::size_t streamEntries = 0;
+        std::size_t seriesEntries = 0;
+        std::size_t seriesBytes = 0;
+
+        double hitRate() const {
+            const double total = static_cast<double>(streamHits + streamMisses + seriesHits + seriesMisses);
+            return total > 0 ? static_cast<double>(streamHits + seriesHits) / total : 0.0;
+        }
+    };
+
+    struct StreamEntry;
+
+    // 流式指标句柄，持有期间对应实例不会被清理
+    class StreamHandle {
+    public:
+        StreamHandle() = default;
+        bool valid() const { return entry_ != nullptr; }
+        // 最近一次更新后的值，预热期为 NaN
+        double value() const;
+        const IndicatorKey& key() const;
+
+    private:
+        friend class IndicatorCache;
+        explicit StreamHandle(std::shared_ptr<StreamEntry> e) : entry_(std::move(e)) {}
+        std::shared_ptr<StreamEntry> entry_;
+    };
+
+    IndicatorCache();
+    explicit IndicatorCache(const Options& options);
+    ~IndicatorCache();
+
+    IndicatorCache(const IndicatorCache&) = delete;
+    IndicatorCache& operator=(const IndicatorCache&) = delete;
+
+    // ---------- 流式 ----------
+    StreamHandle acquire(const IndicatorKey& key);
+    // barSeq 单调递增（例如全局 bar 序号或时间戳）
+    void onBar(std::uint32_t symbolId, std::uint64_t barSeq, double price);
+    // 清理已经没有句柄引用的流式实例
+    std::size_t purgeUnused();
+
+    // ---------- 批量 ----------
+    // 缓存按 (key, dataVersion, n) 识别同一份输入，不看 input 指针（缓冲区释放后地址可能被复用）。
+    // dataVersion 由调用方维护：同一标的的数据变化（追加/修正/重新加载）时必须换一个从未用过的值，
+    // 例如全局递增计数器，不能随数据对象重建而从 0 重新开始
+    Series series(const IndicatorKey& key, const double* input, std::size_t n, std::uint64_t dataVersion);
+
+    void clear();
+
+    Stats stats() const;
+    // 文本导出（name value 每行一项），供日志/监控采集
+    std::string exportText(const std::string& prefix = "indicator_cache") const;
+    // 挂到全局指标注册表（标签 cache="name"），析构时自动注销
+    void bindMetrics(const std::string& name);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+    std::vector<foundation::metrics::CallbackHandle> metricHandles_;   // 先于 impl_ 析构
+};
+
+} // namespace indicators
+} // namespace domain
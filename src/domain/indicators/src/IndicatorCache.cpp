@@ -0,0 +1,445 @@
+#include "IndicatorCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "foundation/log/instrumentation.hpp"
+
+namespace domain {
+namespace indicators {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// 指标的滚动状态；流式更新和整列计算共用，保证两种模式结果一致
+// NaN 输入（停牌、缺失数据）与 StaticPipeline 的 Sma/Ema 一致：直接跳过，不进入窗口，
+// 返回上一次的结果（预热期为 NaN）
+class RollingKernel {
+public:
+    RollingKernel(IndicatorType type, std::uint32_t period)
+        : type_(type), period_(period ? period : 1) {
+        if (type_ == IndicatorType::Sma || type_ == IndicatorType::StdDev) ring_.assign(period_, 0.0);
+    }
+
+    double step(double x) {
+        if (std::isnan(x)) return last_;
+        last_ = compute(x);
+        return last_;
+    }
+
+private:
+    double compute(double x) {
+        switch (type_) {
+        case IndicatorType::Sma: {
+            sum_ += x - ring_[pos_];
+            ring_[pos_] = x;
+            advance();
+            return count_ >= period_ ? sum_ / period_ : kNaN;
+        }
+        case IndicatorType::StdDev: {
+            // 滑动窗口版 Welford：维护均值与离差平方和，避免 sumSq/n - mean^2 在价格量级上的相消误差
+            if (count_ < period_) {
+                ring_[pos_] = x;
+                advance();
+                const double delta = x - mean_;
+                mean_ += delta / count_;
+                m2_ += delta * (x - mean_);
+            } else {
+                const double old = ring_[pos_];
+                ring_[pos_] = x;
+                advance();
+                const double oldMean = mean_;
+                mean_ += (x - old) / period_;
+                m2_ += (x - old) * (x - mean_ + old - oldMean);
+            }
+            if (count_ < period_) return kNaN;
+            return std::sqrt(std::max(0.0, m2_ / period_));
+        }
+        case IndicatorType::Ema: {
+            const double alpha = 2.0 / (period_ + 1.0);
+            ema_ = count_ == 0 ? x : ema_ + alpha * (x - ema_);
+            if (count_ < period_) ++count_;
+            return count_ >= period_ ? ema_ : kNaN;
+        }
+        case IndicatorType::Rsi: {
+            if (count_ == 0) {
+                prev_ = x;
+                ++count_;
+                return kNaN;
+            }
+            const double change = x - prev_;
+            prev_ = x;
+            const double gain = change > 0 ? change : 0.0;
+            const double loss = change < 0 ? -change : 0.0;
+            if (count_ <= period_) {
+                // 前 period 个变化取简单平均作为初值
+                sum_ += gain;
+                lossSum_ += loss;
+                ++count_;
+                if (count_ <= period_) return kNaN;
+                avgGain_ = sum_ / period_;
+                avgLoss_ = lossSum_ / period_;
+            } else {
+                avgGain_ = (avgGain_ * (period_ - 1) + gain) / period_;
+                avgLoss_ = (avgLoss_ * (period_ - 1) + loss) / period_;
+            }
+            if (avgLoss_ == 0.0) return avgGain_ == 0.0 ? 50.0 : 100.0;
+            return 100.0 - 100.0 / (1.0 + avgGain_ / avgLoss_);
+        }
+        }
+        return kNaN;
+    }
+
+    void advance() {
+        if (++pos_ == period_) pos_ = 0;
+        if (count_ < period_) ++count_;
+    }
+
+    IndicatorType type_;
+    std::uint32_t period_;
+    std::vector<double> ring_;
+    std::uint32_t pos_ = 0;
+    std::uint32_t count_ = 0;
+    double last_ = kNaN;
+    double sum_ = 0.0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double lossSum_ = 0.0;
+    double ema_ = 0.0;
+    double prev_ = 0.0;
+    double avgGain_ = 0.0;
+    double avgLoss_ = 0.0;
+};
+
+} // namespace
+
+const char* indicatorTypeName(IndicatorType type)
+{
+    switch (type) {
+    case IndicatorType::Sma: return "sma";
+    case IndicatorType::Ema: return "ema";
+    case IndicatorType::StdDev: return "stddev";
+    case IndicatorType::Rsi: return "rsi";
+    }
+    return "unknown";
+}
+
+void computeIndicator(IndicatorType type, std::uint32_t period, double,
+                      const double* input, std::size_t n, double* out)
+{
+    RollingKernel kernel(type, period);
+    for (std::size_t i = 0; i < n; ++i) out[i] = kernel.step(input[i]);
+}
+
+// ==================== 流式 ====================
+
+struct IndicatorCache::StreamEntry {
+    IndicatorKey key;
+    RollingKernel kernel;
+    std::atomic<double> value{kNaN};
+
+    explicit StreamEntry(const IndicatorKey& k) : key(k), kernel(k.type, k.period) {}
+};
+
+double IndicatorCache::StreamHandle::value() const
+{
+    return entry_ ? entry_->value.load(std::memory_order_acquire) : kNaN;
+}
+
+const IndicatorKey& IndicatorCache::StreamHandle::key() const
+{
+    static const IndicatorKey kEmpty{};
+    return entry_ ? entry_->key : kEmpty;
+}
+
+struct IndicatorCache::Impl {
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<IndicatorKey, std::shared_ptr<StreamEntry>, IndicatorKeyHash> entries;
+        // 标的 -> 该标的上的所有流式指标，onBar 时顺序更新
+        std::unordered_map<std::uint32_t, std::vector<std::shared_ptr<StreamEntry>>> bySymbol;
+        std::unordered_map<std::uint32_t, std::uint64_t> lastBar;
+    };
+
+    struct SeriesEntry {
+        Series series;
+        std::uint64_t version = 0;
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+        std::list<IndicatorKey>::iterator lru;
+    };
+
+    // 正在计算的批量请求：指标键 + 数据版本 + 长度，三者都相同才共享同一次计算
+    struct SeriesRequest {
+        IndicatorKey key;
+        std::uint64_t version = 0;
+        std::size_t count = 0;
+
+        bool operator==(const SeriesRequest& o) const {
+            return key == o.key && version == o.version && count == o.count;
+        }
+    };
+
+    struct SeriesRequestHash {
+        std::size_t operator()(const SeriesRequest& r) const {
+            std::size_t h = IndicatorKeyHash()(r.key);
+            h ^= std::hash<std::uint64_t>()(r.version) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= std::hash<std::size_t>()(r.count) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    explicit Impl(const Options& o) : options(o), shards(o.shards ? o.shards : 1) {}
+
+    Shard& shardFor(std::uint32_t symbolId) { return shards[symbolId % shards.size()]; }
+
+    Options options;
+    std::vector<Shard> shards;
+
+    std::mutex seriesMutex;
+    std::unordered_map<IndicatorKey, SeriesEntry, IndicatorKeyHash> seriesMap;
+    std::unordered_map<SeriesRequest, std::shared_future<Series>, SeriesRequestHash> inflight;
+    std::list<IndicatorKey> lru;   // 头部为最近使用
+    std::size_t seriesBytes = 0;
+
+    std::atomic<std::uint64_t> streamHits{0};
+    std::atomic<std::uint64_t> streamMisses{0};
+    std::atomic<std::uint64_t> seriesHits{0};
+    std::atomic<std::uint64_t> seriesMisses{0};
+    std::atomic<std::uint64_t> evictions{0};
+    std::atomic<std::uint64_t> updates{0};
+    std::atomic<std::uint64_t> skippedUpdates{0};
+};
+
+IndicatorCache::IndicatorCache() : IndicatorCache(Options{}) {}
+
+IndicatorCache::IndicatorCache(const Options& options) : impl_(std::make_unique<Impl>(options)) {}
+
+IndicatorCache::~IndicatorCache() = default;
+
+IndicatorCache::StreamHandle IndicatorCache::acquire(const IndicatorKey& key)
+{
+    if (key.period == 0) throw std::invalid_argument("IndicatorCache: period must be positive");
+    auto& shard = impl_->shardFor(key.symbolId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+        impl_->streamHits.fetch_add(1, std::memory_order_relaxed);
+        return StreamHandle(it->second);
+    }
+    impl_->streamMisses.fetch_add(1, std::memory_order_relaxed);
+    auto entry = std::make_shared<StreamEntry>(key);
+    shard.entries.emplace(key, entry);
+    shard.bySymbol[key.symbolId].push_back(entry);
+    return StreamHandle(std::move(entry));
+}
+
+void IndicatorCache::onBar(std::uint32_t symbolId, std::uint64_t barSeq, double price)
+{
+    ENGINE_PROBE(foundation::metrics::Stage::IndicatorUpdate);
+    auto& shard = impl_->shardFor(symbolId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto last = shard.lastBar.find(symbolId);
+    if (last != shard.lastBar.end() && barSeq <= last->second) {
+        impl_->skippedUpdates.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    shard.lastBar[symbolId] = barSeq;
+
+    auto it = shard.bySymbol.find(symbolId);
+    if (it == shard.bySymbol.end()) return;
+    for (auto& entry : it->second) {
+        entry->value.store(entry->kernel.step(price), std::memory_order_release);
+    }
+    impl_->updates.fetch_add(it->second.size(), std::memory_order_relaxed);
+}
+
+std::size_t IndicatorCache::purgeUnused()
+{
+    std::size_t removed = 0;
+    for (auto& shard : impl_->shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& [symbol, list] : shard.bySymbol) {
+            // 引用计数为 2 表示只剩 entries 与 bySymbol 两处持有
+            auto end = std::remove_if(list.begin(), list.end(), [&](const std::shared_ptr<StreamEntry>& e) {
+                if (e.use_count() > 2) return false;
+                shard.entries.erase(e->key);
+                ++removed;
+                return true;
+            });
+            list.erase(end, list.end());
+        }
+    }
+    return removed;
+}
+
+// ==================== 批量 ====================
+
+IndicatorCache::Series IndicatorCache::series(const IndicatorKey& key, const double* input, std::size_t n,
+                                              std::uint64_t dataVersion)
+{
+    if (key.period == 0) throw std::invalid_argument("IndicatorCache: period must be positive");
+    Impl& d = *impl_;
+    const Impl::SeriesRequest request{key, dataVersion, n};
+
+    std::promise<Series> promise;
+    {
+        std::unique_lock<std::mutex> lock(d.seriesMutex);
+        auto it = d.seriesMap.find(key);
+        if (it != d.seriesMap.end() && it->second.version == dataVersion && it->second.count == n) {
+            d.lru.splice(d.lru.begin(), d.lru, it->second.lru);
+            d.seriesHits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.series;
+        }
+        auto pending = d.inflight.find(request);
+        if (pending != d.inflight.end()) {
+            // 其它线程正在算同一个 key、同一版本、同样长度的数据，等它的结果
+            auto future = pending->second;
+            lock.unlock();
+            Series shared = future.get();
+            if (shared && shared->size() == n) {
+                d.seriesHits.fetch_add(1, std::memory_order_relaxed);
+                return shared;
+            }
+            // 不应出现；保险起见自己再算一遍，不写回缓存
+            d.seriesMisses.fetch_add(1, std::memory_order_relaxed);
+            auto values = std::make_shared<std::vector<double>>(n);
+            computeIndicator(key.type, key.period, key.param, input, n, values->data());
+            return values;
+        }
+        d.inflight.emplace(request, promise.get_future().share());
+    }
+    d.seriesMisses.fetch_add(1, std::memory_order_relaxed);
+
+    Series result;
+    try {
+        auto values = std::make_shared<std::vector<double>>(n);
+        computeIndicator(key.type, key.period, key.param, input, n, values->data());
+        result = std::move(values);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(d.seriesMutex);
+        d.inflight.erase(request);
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(d.seriesMutex);
+        auto it = d.seriesMap.find(key);
+        if (it != d.seriesMap.end()) {
+            d.seriesBytes -= it->second.bytes;
+            d.lru.erase(it->second.lru);
+            d.seriesMap.erase(it);
+        }
+        Impl::SeriesEntry entry;
+        entry.series = result;
+        entry.version = dataVersion;
+        entry.count = n;
+        entry.bytes = n * sizeof(double) + sizeof(Impl::SeriesEntry);
+        d.lru.push_front(key);
+        entry.lru = d.lru.begin();
+        d.seriesBytes += entry.bytes;
+        d.seriesMap.emplace(key, std::move(entry));
+
+        // 超出上限时从最久未使用的开始淘汰，至少保留刚插入的这一项
+        while (d.seriesBytes > d.options.maxSeriesBytes && d.lru.size() > 1) {
+            const IndicatorKey victim = d.lru.back();
+            auto vit = d.seriesMap.find(victim);
+            d.seriesBytes -= vit->second.bytes;
+            d.seriesMap.erase(vit);
+            d.lru.pop_back();
+            d.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        d.inflight.erase(request);
+    }
+    promise.set_value(result);
+    return result;
+}
+
+void IndicatorCache::clear()
+{
+    for (auto& shard : impl_->shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.bySymbol.clear();
+        shard.lastBar.clear();
+    }
+    std::lock_guard<std::mutex> lock(impl_->seriesMutex);
+    impl_->seriesMap.clear();
+    impl_->lru.clear();
+    impl_->seriesBytes = 0;
+}
+
+IndicatorCache::Stats IndicatorCache::stats() const
+{
+    Impl& d = *impl_;
+    Stats s;
+    s.streamHits = d.streamHits.load(std::memory_order_relaxed);
+    s.streamMisses = d.streamMisses.load(std::memory_order_relaxed);
+    s.seriesHits = d.seriesHits.load(std::memory_order_relaxed);
+    s.seriesMisses = d.seriesMisses.load(std::memory_order_relaxed);
+    s.evictions = d.evictions.load(std::memory_order_relaxed);
+    s.updates = d.updates.load(std::memory_order_relaxed);
+    s.skippedUpdates = d.skippedUpdates.load(std::memory_order_relaxed);
+    for (auto& shard : d.shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        s.streamEntries += shard.entries.size();
+    }
+    std::lock_guard<std::mutex> lock(d.seriesMutex);
+    s.seriesEntries = d.seriesMap.size();
+    s.seriesBytes = d.seriesBytes;
+    return s;
+}
+
+std::string IndicatorCache::exportText(const std::string& prefix) const
+{
+    const Stats s = stats();
+    std::ostringstream os;
+    os << prefix << "_stream_hits " << s.streamHits << '\n'
+       << prefix << "_stream_misses " << s.streamMisses << '\n'
+       << prefix << "_series_hits " << s.seriesHits << '\n'
+       << prefix << "_series_misses " << s.seriesMisses << '\n'
+       << prefix << "_evictions " << s.evictions << '\n'
+       << prefix << "_updates " << s.updates << '\n'
+       << prefix << "_skipped_updates " << s.skippedUpdates << '\n'
+       << prefix << "_stream_entries " << s.streamEntries << '\n'
+       << prefix << "_series_entries " << s.seriesEntries << '\n'
+       << prefix << "_series_bytes " << s.seriesBytes << '\n'
+       << prefix << "_hit_rate " << s.hitRate() << '\n';
+    return os.str();
+}
+
+void IndicatorCache::bindMetrics(const std::string& name)
+{
+    metricHandles_.clear();
+    auto& registry = foundation::metrics::MetricsRegistry::instance();
+    const foundation::metrics::Labels labels{{"cache", name}};
+    std::vector<foundation::metrics::CallbackHandle> handles;
+    auto addCounter = [&](const char* metric, double (*pick)(const Stats&)) {
+        handles.push_back(registry.counterCallback(metric, labels, [this, pick] { return pick(stats()); }));
+    };
+    auto addGauge = [&](const char* metric, double (*pick)(const Stats&)) {
+        handles.push_back(registry.gaugeCallback(metric, labels, [this, pick] { return pick(stats()); }));
+    };
+    addCounter("indicator_cache_stream_hits_total", [](const Stats& s) { return static_cast<double>(s.streamHits); });
+    addCounter("indicator_cache_stream_misses_total",
+               [](const Stats& s) { return static_cast<double>(s.streamMisses); });
+    addCounter("indicator_cache_series_hits_total", [](const Stats& s) { return static_cast<double>(s.seriesHits); });
+    addCounter("indicator_cache_series_misses_total",
+               [](const Stats& s) { return static_cast<double>(s.seriesMisses); });
+    addCounter("indicator_cache_evictions_total", [](const Stats& s) { return static_cast<double>(s.evictions); });
+    addGauge("indicator_cache_series_bytes", [](const Stats& s) { return static_cast<double>(s.seriesBytes); });
+    addGauge("indicator_cache_hit_rate", [](const Stats& s) { return s.hitRate(); });
+    metricHandles_ = std::move(handles);
+}
+
+} // namespace indicators
+} // namespace domain
@@ -0,0 +1,175 @@
+// 全市场冷启动加载：逐个同步读 vs AsyncFileReader（io_uring / 线程池）
+// 每个标的一个列式数据块文件（MarketDataCache 的块格式），读完即解码。
+// 每轮开始前用 posix_fadvise(DONTNEED) 把文件逐出页缓存，模拟冷启动。
+// 用法：BulkLoadBench [symbols] [bars] [queueDepth]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MarketDataCache.h"
+#include "foundation/Fs/AsyncFileReader.h"
+
+using namespace domain::market;
+using foundation::fs::AsyncFileReader;
+using foundation::fs::AsyncReaderBackend;
+using foundation::fs::AsyncReaderOptions;
+using foundation::fs::AsyncReadResult;
+
+namespace {
+
+BarColumns makeBars(std::size_t n, std::uint64_t seed)
+{
+    BarColumns b;
+    b.reserve(n);
+    double price = 5.0 + static_cast<double>(seed % 100);
+    for (std::size_t i = 0; i < n; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const double r = static_cast<double>(seed >> 40) / 16777216.0 - 0.5;
+        price = std::max(1.0, std::round(price * (1.0 + r * 0.04) * 100.0) / 100.0);
+        b.date.push_back(static_cast<std::int32_t>(20000101 + i));
+        b.open.push_back(price);
+        b.high.push_back(price + 0.1);
+        b.low.push_back(price - 0.1);
+        b.close.push_back(price);
+        b.volume.push_back(static_cast<double>(100000 + (seed >> 44)));
+        b.amount.push_back(std::round(price * 100000.0));
+    }
+    return b;
+}
+
+void evict(const std::vector<std::string>& paths)
+{
+#if defined(__linux__)
+    for (const auto& p : paths) {
+        const int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        ::fdatasync(fd);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)paths;
+#endif
+}
+
+struct Outcome {
+    double ms = 0.0;
+    std::size_t rows = 0;
+    std::size_t failures = 0;
+};
+
+Outcome loadSync(const std::vector<std::string>& paths)
+{
+    Outcome o;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (const auto& p : paths) {
+        std::ifstream in(p, std::ios::binary);
+        const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        BarColumns bars;
+        if (!MarketDataCache::decodeBlock(data, bars)) {
+            ++o.failures;
+            continue;
+        }
+        o.rows += bars.size();
+    }
+    o.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return o;
+}
+
+Outcome loadAsync(const std::vector<std::string>& paths, AsyncReaderBackend backend, std::size_t depth)
+{
+    AsyncReaderOptions opts;
+    opts.backend = backend;
+    opts.queueDepth = depth;
+    opts.ioThreads = depth;
+    // 线程池后端的回调在多个读线程上并发执行
+    std::atomic<std::size_t> rows{0};
+    std::atomic<std::size_t> failures{0};
+    const auto t0 = std::chrono::steady_clock::now();
+    AsyncFileReader reader(opts);
+    for (const auto& p : paths) {
+        reader.read(p, [&rows, &failures](AsyncReadResult&& r) {
+            BarColumns bars;
+            if (!r.ok() || !MarketDataCache::decodeBlock(r.data, bars)) {
+                ++failures;
+                return;
+            }
+            rows += bars.size();
+        });
+    }
+    reader.wait();
+    Outcome o;
+    o.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    o.rows = rows.load();
+    o.failures = failures.load();
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 5000;
+    const std::size_t bars = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 2500;
+    const std::size_t depth = argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : 64;
+
+    const auto dir = std::filesystem::temp_directory_path() / "bulk_load_bench";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::vector<std::string> paths;
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < symbols; ++i) {
+        const std::string block = MarketDataCache::encodeBlock(makeBars(bars, i + 1));
+        paths.push_back((dir / (std::to_string(600000 + i) + ".blk")).string());
+        std::ofstream(paths.back(), std::ios::binary).write(block.data(), static_cast<std::streamsize>(block.size()));
+        bytes += block.size();
+    }
+
+    evict(paths);
+    const Outcome sync = loadSync(paths);
+    evict(paths);
+    Outcome uring;
+    bool haveUring = true;
+    try {
+        uring = loadAsync(paths, AsyncReaderBackend::IoUring, depth);
+    } catch (const std::runtime_error&) {
+        haveUring = false;
+    }
+    evict(paths);
+    const Outcome pool = loadAsync(paths, AsyncReaderBackend::ThreadPool, depth);
+
+    std::filesystem::remove_all(dir);
+
+    const std::size_t expected = symbols * bars;
+    if (sync.rows != expected || pool.rows != expected || (haveUring && uring.rows != expected) || sync.failures ||
+        pool.failures || uring.failures) {
+        std::fprintf(stderr, "row mismatch: sync=%zu io_uring=%zu thread_pool=%zu expected=%zu\n", sync.rows,
+                     uring.rows, pool.rows, expected);
+        return 1;
+    }
+
+    char uringMs[32] = "null";
+    char speedup[32] = "null";
+    if (haveUring) {
+        std::snprintf(uringMs, sizeof(uringMs), "%.3f", uring.ms);
+        std::snprintf(speedup, sizeof(speedup), "%.2f", sync.ms / uring.ms);
+    }
+    std::printf("{\"bench\":\"bulk_load\",\"symbols\":%zu,\"bars\":%zu,\"bytes\":%zu,\"queue_depth\":%zu,"
+                "\"sync_ms\":%.3f,\"io_uring_ms\":%s,\"thread_pool_ms\":%.3f,\"io_uring_speedup\":%s}\n",
+                symbols, bars, bytes, depth, sync.ms, uringMs, pool.ms, speedup);
+    return 0;
+}
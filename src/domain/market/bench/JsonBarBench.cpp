@@ -0,0 +1,228 @@
+// 行情 JSON 解析：nlohmann DOM + 取字段 vs BarJsonReader（SAX 流式）
+// 用法：JsonBarBench [rows] [rounds]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "BarJsonReader.h"
+
+using namespace domain::market;
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t& s)
+{
+    std::uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct Row {
+    char date[32];
+    double open, high, low, close, volume, amount;
+};
+
+std::vector<Row> makeRows(std::size_t n)
+{
+    std::vector<Row> rows(n);
+    std::uint64_t seed = 20240102;
+    double price = 10.0;
+    int y = 2000, m = 1, d = 1;
+    for (auto& r : rows) {
+        std::snprintf(r.date, sizeof(r.date), "%04d-%02d-%02d", y, m, d);
+        if (++d > 28) {
+            d = 1;
+            if (++m > 12) {
+                m = 1;
+                ++y;
+            }
+        }
+        const double u = static_cast<double>(splitmix64(seed) >> 11) / 9007199254740992.0;
+        price = std::max(1.0, std::round(price * (1.0 + (u - 0.5) * 0.04) * 100.0) / 100.0);
+        r.open = price;
+        r.close = std::round(price * (1.0 + (u - 0.5) * 0.01) * 100.0) / 100.0;
+        r.high = std::max(r.open, r.close) + 0.05;
+        r.low = std::min(r.open, r.close) - 0.05;
+        r.volume = static_cast<double>(100000 + splitmix64(seed) % 5000000);
+        r.amount = std::round(r.volume * price);
+    }
+    return rows;
+}
+
+// 新浪：顶层数组，数字放在字符串里
+std::string sinaPayload(const std::vector<Row>& rows)
+{
+    std::string s = "[";
+    char buf[256];
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"day\":\"%s\",\"open\":\"%.3f\",\"high\":\"%.3f\",\"low\":\"%.3f\",\"close\":\"%.3f\","
+                      "\"volume\":\"%.0f\",\"ma_price5\":%.3f,\"ma_volume5\":%.0f}",
+                      i ? "," : "", r.date, r.open, r.high, r.low, r.close, r.volume, r.close, r.volume);
+        s += buf;
+    }
+    s += "]";
+    return s;
+}
+
+// 东方财富：{"rc":0,"data":{"code":...,"klines":["日期,开,收,高,低,量,额,振幅,涨跌幅,涨跌额,换手率"]}}
+std::string eastmoneyPayload(const std::vector<Row>& rows)
+{
+    std::string s = R"({"rc":0,"rt":17,"svr":181734976,"lt":1,"full":0,"data":{"code":"600000","market":1,)"
+                    R"("name":"浦发银行","decimal":2,"dktotal":)" +
+                    std::to_string(rows.size()) + R"(,"preKPrice":7.1,"klines":[)";
+    char buf[256];
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        std::snprintf(buf, sizeof(buf), "%s\"%s,%.2f,%.2f,%.2f,%.2f,%.0f,%.1f,1.23,0.45,0.03,0.12\"", i ? "," : "",
+                      r.date, r.open, r.close, r.high, r.low, r.volume, r.amount);
+        s += buf;
+    }
+    s += "]}}";
+    return s;
+}
+
+// ---------- DOM 基线：parse 整棵树，再逐行取字段 ----------
+
+double toNumber(const nlohmann::json& v)
+{
+    return v.is_string() ? std::strtod(v.get_ref<const std::string&>().c_str(), nullptr) : v.get<double>();
+}
+
+std::int32_t toDate(const std::string& s)
+{
+    return std::atoi(s.substr(0, 4).c_str()) * 10000 + std::atoi(s.substr(5, 2).c_str()) * 100 +
+           std::atoi(s.substr(8, 2).c_str());
+}
+
+BarColumns domSina(const std::string& text)
+{
+    const auto doc = nlohmann::json::parse(text);
+    BarColumns out;
+    out.reserve(doc.size());
+    for (const auto& row : doc) {
+        out.date.push_back(toDate(row.at("day").get<std::string>()));
+        out.open.push_back(toNumber(row.at("open")));
+        out.high.push_back(toNumber(row.at("high")));
+        out.low.push_back(toNumber(row.at("low")));
+        out.close.push_back(toNumber(row.at("close")));
+        out.volume.push_back(toNumber(row.at("volume")));
+        out.amount.push_back(std::numeric_limits<double>::quiet_NaN());
+    }
+    return out;
+}
+
+BarColumns domEastmoney(const std::string& text)
+{
+    const auto doc = nlohmann::json::parse(text);
+    const auto& klines = doc.at("data").at("klines");
+    BarColumns out;
+    out.reserve(klines.size());
+    for (const auto& line : klines) {
+        const auto& s = line.get_ref<const std::string&>();
+        double v[6] = {};
+        const char* p = s.c_str() + s.find(',') + 1;
+        for (double& x : v) {
+            char* e = nullptr;
+            x = std::strtod(p, &e);
+            p = e + 1;
+        }
+        out.date.push_back(toDate(s));
+        out.open.push_back(v[0]);
+        out.close.push_back(v[1]);
+        out.high.push_back(v[2]);
+        out.low.push_back(v[3]);
+        out.volume.push_back(v[4]);
+        out.amount.push_back(v[5]);
+    }
+    return out;
+}
+
+bool sameBars(const BarColumns& a, const BarColumns& b)
+{
+    auto eq = [](const std::vector<double>& x, const std::vector<double>& y) {
+        if (x.size() != y.size()) return false;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            if (x[i] != y[i] && !(std::isnan(x[i]) && std::isnan(y[i]))) return false;
+        }
+        return true;
+    };
+    return a.date == b.date && eq(a.open, b.open) && eq(a.high, b.high) && eq(a.low, b.low) &&
+           eq(a.close, b.close) && eq(a.volume, b.volume) && eq(a.amount, b.amount);
+}
+
+template <typename F>
+double bestMillis(int rounds, F&& run)
+{
+    double best = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+struct Result {
+    double domMs = 0.0;
+    double saxMs = 0.0;
+    bool same = false;
+};
+
+template <typename Dom>
+Result compare(const std::string& text, const BarJsonReader& reader, Dom&& dom, int rounds)
+{
+    Result r;
+    const BarColumns expected = dom(text);
+    const BarColumns actual = reader.readAll(text);
+    r.same = sameBars(expected, actual) && !actual.empty();
+
+    std::size_t sink = 0;
+    r.domMs = bestMillis(rounds, [&] { sink += dom(text).size(); });
+    r.saxMs = bestMillis(rounds, [&] {
+        reader.read(text, [&sink](BarColumns& batch) { sink += batch.size(); });
+    });
+    if (sink == 0) r.same = false;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 200000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    const auto rows = makeRows(n);
+
+    const std::string sina = sinaPayload(rows);
+    const std::string east = eastmoneyPayload(rows);
+
+    const Result rs = compare(sina, BarJsonReader(BarJsonLayout::sinaKline()), domSina, rounds);
+    const Result re = compare(east, BarJsonReader(BarJsonLayout::eastmoneyKline()), domEastmoney, rounds);
+
+    if (!rs.same || !re.same) {
+        std::fprintf(stderr, "result mismatch: sina=%d eastmoney=%d\n", rs.same, re.same);
+        return 1;
+    }
+
+    auto mbps = [](std::size_t bytes, double ms) { return static_cast<double>(bytes) / 1048576.0 / (ms / 1000.0); };
+    std::printf("{\"bench\":\"json_bar\",\"rows\":%zu,"
+                "\"sina\":{\"bytes\":%zu,\"dom_ms\":%.3f,\"sax_ms\":%.3f,\"dom_mb_s\":%.1f,\"sax_mb_s\":%.1f,\"speedup\":%.2f},"
+                "\"eastmoney\":{\"bytes\":%zu,\"dom_ms\":%.3f,\"sax_ms\":%.3f,\"dom_mb_s\":%.1f,\"sax_mb_s\":%.1f,"
+                "\"speedup\":%.2f}}\n",
+                n, sina.size(), rs.domMs, rs.saxMs, mbps(sina.size(), rs.domMs), mbps(sina.size(), rs.saxMs),
+                rs.domMs / rs.saxMs, east.size(), re.domMs, re.saxMs, mbps(east.size(), re.domMs),
+                mbps(east.size(), re.saxMs), re.domMs / re.saxMs);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "MarketDataCache.h"
+
+namespace domain {
+namespace market {
+
+// 行情接口 JSON 响应 -> BarColumns 批次
+// 基于 foundation::json 的 SAX 解析，不建 DOM：只跟踪到目标数组的路径，
+// 数组元素边解析边写进列式批次，攒够 batchSize 行交给回调，目标数组结束后立即停止解析。
+// 几十 MB 的响应内存占用只有一个批次。
+//
+// 支持三种行格式：
+//   Object  [{"day":"2024-01-02","open":"7.10",...}, ...]        字段名可配置，数字可以放在字符串里
+//   Array   [["2024-01-02", 7.10, 7.12, ...], ...]                按列下标取值
+//   Csv     ["2024-01-02,7.10,7.12,...", ...]                     逗号分隔的字符串，按列下标取值
+//
+// 日期接受 "YYYY-MM-DD"、"YYYYMMDD"、带时间的 "YYYY-MM-DD HH:MM:SS"（取日期部分）或整数 YYYYMMDD。
+// 缺日期或收盘价的行跳过并计入 skipped。
+struct BarJsonLayout {
+    enum class RowFormat { Object, Array, Csv };
+
+    std::string arrayPath;                // 目标数组的对象键路径，如 "data.klines"；空表示顶层数组
+    RowFormat format = RowFormat::Object;
+
+    // Object 格式的字段名；空表示没有该字段
+    std::string dateField = "date";
+    std::string openField = "open";
+    std::string highField = "high";
+    std::string lowField = "low";
+    std::string closeField = "close";
+    std::string volumeField = "volume";
+    std::string amountField = "amount";
+
+    // Array / Csv 格式的列下标；-1 表示没有该列
+    int dateIndex = 0;
+    int openIndex = 1;
+    int highIndex = 2;
+    int lowIndex = 3;
+    int closeIndex = 4;
+    int volumeIndex = 5;
+    int amountIndex = 6;
+
+    // 新浪日线：顶层数组，[{"day":"2024-01-02","open":"7.100","high":...,"volume":"123456"}]
+    static BarJsonLayout sinaKline();
+    // 东方财富 K 线：{"data":{"klines":["2024-01-02,开,收,高,低,量,额,..."]}}
+    static BarJsonLayout eastmoneyKline();
+};
+
+struct BarJsonStats {
+    std::size_t rows = 0;      // 写入批次的行数
+    std::size_t skipped = 0;   // 缺字段被跳过的行数
+    std::size_t batches = 0;
+    bool found = false;        // 是否遇到了目标数组
+};
+
+class BarJsonReader {
+public:
+    // 回调可以把批次 swap 走；回调返回后批次会被清空复用
+    using BatchSink = std::function<void(BarColumns& batch)>;
+
+    explicit BarJsonReader(BarJsonLayout layout, std::size_t batchSize = 4096);
+
+    // JSON 语法错误抛 std::runtime_error（带字节偏移）
+    BarJsonStats read(std::string_view json, const BatchSink& sink) const;
+    // 全部读进一个 BarColumns
+    BarColumns readAll(std::string_view json, BarJsonStats* stats = nullptr) const;
+
+private:
+    BarJsonLayout layout_;
+    std::size_t batchSize_;
+};
+
+} // namespace market
+} // namespace domain
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "foundation/log/metrics.hpp"
+
+namespace domain {
+namespace market {
+
+// 日线按列存放，日期为 YYYYMMDD，升序
+struct BarColumns {
+    std::vector<std::int32_t> date;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+    std::vector<double> amount;
+
+    std::size_t size() const { return date.size(); }
+    bool empty() const { return date.empty(); }
+    void reserve(std::size_t n);
+    void clear();
+    void appendRow(const BarColumns& src, std::size_t i);
+};
+
+// 闭区间 [from, to]，YYYYMMDD
+struct DateRange {
+    std::int32_t from = 0;
+    std::int32_t to = 0;
+
+    bool empty() const { return from > to; }
+    bool contains(std::int32_t d) const { return d >= from && d <= to; }
+    bool operator==(const DateRange& o) const { return from == o.from && to == o.to; }
+};
+
+// 行情拉取回调的结果；notModified 表示服务端按 ETag 返回 304，沿用本地数据
+struct FetchResult {
+    BarColumns bars;
+    std::string etag;
+    bool notModified = false;
+};
+
+// 拉取 [range] 的行情；etag 为本地紧接 range 之前（或与之重叠）的分段拉取时得到的 ETag，没有则为空。
+// 服务端据此判断该标的数据自那次拉取以来是否有变化，没有变化时返回 notModified
+using RangeFetcher = std::function<FetchResult(const std::string& symbol, const DateRange& range,
+                                               const std::string& etag)>;
+
+// 行情本地磁盘缓存（io.paths.cache 下的 market 目录）
+//
+// 目录结构：
+//   <root>/objects/ab/abcdef0123456789.blk   数据块，文件名为内容哈希（内容寻址，相同内容只存一份）
+//   <root>/index/<symbol>.idx                每个标的一个索引，每行一个分段：
+//                                            coverFrom coverTo rows hash etag
+//   <root>/http/<hash>.body / .meta          原始 HTTP 响应体 + ETag（供 Net_facade 调用方使用）
+//
+// 数据块是列式编码：日期做差分 + zigzag varint；价格/成交量能无损放大成整数时
+// 同样差分 varint，否则原样存 8 字节，日线通常能压到原始大小的一半以下。
+//
+// 分段记录的是"请求覆盖的日期区间"而不是"数据实际出现的日期"：
+// 从请求起点到返回的最后一根 bar 之间，节假日、停牌没有数据也算已覆盖，不会被反复请求；
+// 最后一根 bar 之后的日期不记为已覆盖（可能只是数据源还没更新），返回 0 根 bar 时不记录分段。
+// 新数据只追加新分段和索引行，已有数据块不会被改写（compact 除外）。
+//
+// 读取数据块时校验内容哈希，损坏的分段读取时跳过；verify() 可以找出损坏的分段。
+//
+// 并发：同一进程内由 mutex_ 串行化；多个进程共用一个缓存目录时，读写索引、compact 与 HTTP 响应的读写
+// 另外持有 <root>/lock 上的文件锁（POSIX 为 flock，Windows 为 LockFileEx），文件都经唯一命名的
+// 临时文件 + rename 写入；compact 会删除数据块，所以读数据块时也持有共享锁。
+class MarketDataCache {
+public:
+    struct Segment {
+        DateRange cover;
+        std::size_t rows = 0;
+        std::string hash;
+        std::string etag;
+    };
+
+    struct Stats {
+        std::size_t hits = 0;           // 完全由本地满足的请求
+        std::size_t partialHits = 0;    // 部分本地、部分拉取
+        std::size_t misses = 0;         // 完全需要拉取
+        std::size_t fetchedRanges = 0;  // 实际发出的拉取次数
+        std::size_t notModified = 0;    // 按 ETag 判定未变化的次数
+        std::size_t corruptBlocks = 0;  // 校验失败的数据块
+
+        // 完全命中的比例（部分命中不算）
+        double hitRate() const {
+            const std::size_t total = hits + partialHits + misses;
+            return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // cacheDir 即配置项 io.paths.cache，行情缓存放在其下的 market 子目录
+    explicit MarketDataCache(const std::string& cacheDir);
+
+    const std::string& root() const { return root_; }
+
+    // 某标的已缓存的分段（按写入顺序）
+    std::vector<Segment> segments(const std::string& symbol) const;
+
+    // want 中本地尚未覆盖的日期区间，按日期升序
+    std::vector<DateRange> missingRanges(const std::string& symbol, const DateRange& want) const;
+
+    // 读出 want 范围内的本地数据；重叠分段以后写入的为准
+    BarColumns read(const std::string& symbol, const DateRange& want) const;
+
+    // 写入一个分段（追加数据块与索引行）
+    void store(const std::string& symbol, const DateRange& cover, const BarColumns& bars,
+               const std::string& etag = std::string());
+
+    // 读缓存 + 只拉缺失区间 + 写回，返回 want 范围内的完整数据
+    BarColumns fetchThrough(const std::string& symbol, const DateRange& want, const RangeFetcher& fetcher);
+
+    // 请求 range 时应带的 ETag：紧接 range 之前（或与之重叠）的分段的 ETag，没有则为空
+    std::string etagFor(const std::string& symbol, const DateRange& range) const;
+    // 把一次拉取 range 的结果写回：覆盖区间只记到返回的最后一根 bar，0 根 bar 不写；
+    // notModified 时不写数据，服务端给了新 ETag 则刷新到对应分段上。返回写入的行数
+    std::size_t storeFetched(const std::string& symbol, const DateRange& range, const FetchResult& result);
+    // 本地已存的最后一根 bar 的日期；没有数据返回 0
+    std::int32_t lastBarDate(const std::string& symbol) const;
+
+    // 校验某标的所有数据块，返回损坏个数
+    std::size_t verify(const std::string& symbol) const;
+
+    // 把某标的的所有分段合并成一个（只在维护时调用，会重写索引；期间持锁，与 store 互斥）。
+    // 新索引生效后删除所有索引都不再引用的数据块，包括此前中断的 compact 留下的块和临时文件
+    void compact(const std::string& symbol);
+
+    // ---------- 原始 HTTP 响应 ----------
+    struct CachedResponse {
+        std::string body;
+        std::string etag;
+    };
+    std::optional<CachedResponse> loadResponse(const std::string& url) const;
+    void storeResponse(const std::string& url, const std::string& body, const std::string& etag);
+
+    Stats stats() const;
+    // 统计挂到全局指标注册表（market_cache_*，标签 cache="name"），析构时自动注销
+    void bindMetrics(const std::string& name);
+
+    // ---------- 编码（公开便于测试与其它存储复用） ----------
+    static std::string encodeBlock(const BarColumns& bars);
+    static bool decodeBlock(std::string_view data, BarColumns& out);
+    static std::string contentHash(std::string_view data);
+
+private:
+    std::string indexPath(const std::string& symbol) const;
+    std::string objectPath(const std::string& hash) const;
+    // 以下需持有 mutex_
+    std::vector<Segment> loadIndex(const std::string& symbol) const;
+    bool loadBlock(const std::string& hash, BarColumns& out) const;
+    std::string writeBlock(const BarColumns& bars);
+    void appendIndex(const std::string& symbol, const Segment& segment);
+    BarColumns readSegments(const std::vector<Segment>& segs, const DateRange& want) const;
+    // 另需持有独占的目录锁；返回删除的文件数
+    std::size_t removeUnreferencedBlocks();
+
+    static std::vector<DateRange> coverGaps(const std::vector<Segment>& segs, const DateRange& want);
+    static std::optional<Segment> segmentBefore(const std::vector<Segment>& segs, const DateRange& range);
+
+    std::string root_;
+    mutable std::mutex mutex_;
+    mutable Stats stats_;
+    std::vector<foundation::metrics::CallbackHandle> metricHandles_;   // 最先析构，之后不会再回调
+};
+
+} // namespace market
+} // namespace domain
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MarketDataCache.h"
+#include "foundation/config/ConfigSnapshot.hpp"
+#include "foundation/log/metrics.hpp"
+
+namespace domain {
+namespace market {
+
+// 拉取失败时由 fetcher 抛出；retryable = false 表示重试也没用（如代码不存在、鉴权失败）
+class FetchError : public std::runtime_error {
+public:
+    FetchError(const std::string& what, bool retryable = true)
+        : std::runtime_error(what), retryable_(retryable) {}
+    bool retryable() const { return retryable_; }
+
+private:
+    bool retryable_;
+};
+
+// 限速与重试退避用的时间源；为空时用 steady_clock::now / this_thread::sleep_for，测试时注入假时钟
+struct SyncClock {
+    std::function<std::chrono::steady_clock::time_point()> now;
+    std::function<void(std::chrono::steady_clock::duration)> sleep;
+};
+
+// 令牌桶限速，多线程共享
+class RateLimiter {
+public:
+    // ratePerSecond <= 0 表示不限速
+    explicit RateLimiter(double ratePerSecond, double burst = 1.0, SyncClock clock = SyncClock());
+
+    // 阻塞直到拿到一个令牌
+    void acquire();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double rate_;
+    double burst_;
+    double tokens_;
+    SyncClock clock_;
+    Clock::time_point last_;
+    std::mutex mutex_;
+};
+
+struct SyncOptions {
+    std::size_t workers = 8;
+    double requestsPerSecond = 20.0;              // 数据源的限速
+    double burst = 5.0;
+    int maxRetries = 3;                           // 对应配置 network.max_retries
+    std::chrono::milliseconds retryBaseDelay{200};
+    std::chrono::milliseconds retryMaxDelay{5000};
+    SyncClock clock;
+};
+
+// 从配置读取 network.max_retries，其余字段沿用 defaults
+SyncOptions syncOptionsFromConfig(const foundation::config::ConfigSnapshot& config,
+                                  SyncOptions defaults = SyncOptions());
+
+struct SymbolSyncResult {
+    std::string symbol;
+    std::int32_t previousHighWater = 0;   // 同步前本地最后一根 bar 的日期，0 表示本地没有
+    std::int32_t highWater = 0;           // 同步后
+    std::size_t newBars = 0;
+    int attempts = 0;
+    bool ok = false;
+    bool skipped = false;                 // 本地已是最新，没有发请求
+    std::string error;
+};
+
+struct SyncReport {
+    std::vector<SymbolSyncResult> results;   // 与输入标的顺序一致
+    std::size_t succeeded = 0;
+    std::size_t skipped = 0;
+    std::size_t failed = 0;
+    std::size_t newBars = 0;
+    std::size_t requests = 0;
+    double seconds = 0.0;
+};
+
+// 行情增量同步
+// 每个标的的高水位 = 本地存储里最后一根 bar 的日期（直接从 MarketDataCache 推出，
+// 不单独保存状态，避免两份记录不一致）。同步时只请求 (高水位, upTo] 这一段并带上本地分段的 ETag，
+// 结果按 MarketDataCache::storeFetched 的规则追加进本地列式存储，已有文件不改写；
+// 304 或空结果不推进高水位，数据源晚到的 bar 下次同步还能补上。
+//
+// 多个标的并行拉取，共享一个令牌桶限速；单个标的失败按指数退避重试，
+// 重试用尽或遇到不可重试错误时记入报告，不影响其它标的。读写本地存储失败（高水位、ETag、
+// 写入）不重试，错误以 "cannot read local store" / "cannot store fetched bars" 开头记入报告。
+//
+// 每次请求的耗时与结果记入全局指标注册表：market_sync_request_latency_ns、
+// market_sync_requests_total{result="ok|retryable_error|fatal_error"}。
+//
+// fetcher 与 MarketDataCache::fetchThrough 使用同一个签名，
+// 测试时可以换成本地 mock 服务或内存数据源。
+class MarketDataSync {
+public:
+    MarketDataSync(MarketDataCache& store, RangeFetcher fetcher, SyncOptions options = SyncOptions());
+
+    // 本地最后一根 bar 的日期；本地没有数据返回 0
+    std::int32_t highWaterMark(const std::string& symbol) const;
+
+    // 把 symbols 同步到 upTo（含）；本地没有数据的标的从 defaultStart 开始拉全量
+    SyncReport sync(const std::vector<std::string>& symbols, std::int32_t upTo, std::int32_t defaultStart);
+
+private:
+    SymbolSyncResult syncOne(const std::string& symbol, std::int32_t upTo, std::int32_t defaultStart,
+                             std::size_t& requests);
+    std::chrono::milliseconds backoff(int attempt) const;
+
+    MarketDataCache& store_;
+    RangeFetcher fetcher_;
+    SyncOptions options_;
+    RateLimiter limiter_;
+    foundation::metrics::Histogram& requestLatency_;
+    foundation::metrics::Counter& requestsOk_;
+    foundation::metrics::Counter& requestsRetryable_;
+    foundation::metrics::Counter& requestsFatal_;
+};
+
+} // namespace market
+} // namespace domain
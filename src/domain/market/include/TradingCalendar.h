@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace domain {
+namespace market {
+
+// A 股交易日历
+// 启动时把 [firstYear, lastYear] 内的所有自然日预计算成两张紧凑数组：
+//   自然日序号 -> 交易日序号、交易日序号 -> 日期
+// 之后日期 <-> 交易日序号、前后交易日、分钟序号的换算都是 O(1) 查表，
+// 数据存储可以直接按 "交易日序号 * 每日分钟数 + 分钟序号" 定位 bar，而不用搜索时间戳
+//
+// 日期统一使用 YYYYMMDD 整数，时间使用 HHMM 整数
+class TradingCalendar {
+public:
+    // 连续竞价时段：09:30-11:30, 13:00-15:00，共 240 分钟
+    static constexpr int kMorningOpen = 930;
+    static constexpr int kMorningClose = 1130;
+    static constexpr int kAfternoonOpen = 1300;
+    static constexpr int kAfternoonClose = 1500;
+    static constexpr int kMinutesPerSession = 240;
+    static constexpr int kMinutesPerHalfDay = 120;
+
+    // holidays: 非周末的休市日；halfDays: 只交易上午的日子
+    // 其中出现不合法的日期（如 20230230）抛 std::invalid_argument
+    TradingCalendar(int firstYear, int lastYear,
+                    const std::vector<std::int32_t>& holidays,
+                    const std::vector<std::int32_t>& halfDays = {});
+
+    // 从文本文件加载：每行一个 YYYYMMDD，后缀 " half" 表示半日市，'#' 开头为注释
+    static TradingCalendar loadFromFile(const std::string& path, int firstYear, int lastYear);
+
+    // ---------- 日期 ----------
+    bool isTradingDay(std::int32_t date) const;
+    bool isHalfDay(std::int32_t date) const;
+
+    // 以下接口对不合法的日期：indexOf/isTradingDay/isHalfDay 视为非交易日，
+    // 其余抛 std::invalid_argument
+    // 交易日序号（从 0 开始）；非交易日返回 -1
+    int indexOf(std::int32_t date) const;
+    // 序号对应的日期；越界抛 std::out_of_range
+    std::int32_t dateAt(int index) const;
+
+    // 严格晚于/早于 date 的交易日；date 可以在日历范围之外，所求交易日不在日历内时返回 0
+    std::int32_t nextTradingDay(std::int32_t date) const;
+    std::int32_t prevTradingDay(std::int32_t date) const;
+    // date 当天是交易日则返回自身，否则返回之后第一个交易日；同样超出范围返回 0
+    std::int32_t onOrAfter(std::int32_t date) const;
+    // 从 date 起偏移 n 个交易日（n 可为负）；date 必须是交易日，结果超出日历范围抛 std::out_of_range
+    std::int32_t addTradingDays(std::int32_t date, int n) const;
+    // [from, to] 之间的交易日数量；日历范围之外的部分不计
+    int tradingDaysBetween(std::int32_t from, std::int32_t to) const;
+
+    std::size_t tradingDayCount() const { return tradingDays_.size(); }
+    const std::vector<std::int32_t>& tradingDays() const { return tradingDays_; }
+    std::int32_t firstDate() const { return civilFromDays(firstDay_); }
+    std::int32_t lastDate() const { return civilFromDays(firstDay_ + static_cast<int>(dayToIndex_.size()) - 1); }
+
+    // ---------- 分钟 ----------
+    // HHMM 对应的会话分钟序号 [0, 240)；非交易时段返回 -1
+    // 分钟 bar 以结束时间标记：09:31 -> 0, 11:30 -> 119, 13:01 -> 120, 15:00 -> 239
+    static int minuteOfSession(int hhmm);
+    // 会话分钟序号 -> HHMM
+    static int timeOfMinute(int minuteIndex);
+
+    // 全局分钟偏移 = 交易日序号 * 240 + 会话分钟序号；无效返回 -1
+    std::int64_t sessionOffset(std::int32_t date, int hhmm) const;
+    // 当日实际可交易分钟数（半日市为 120，非交易日为 0）
+    int minutesInDay(std::int32_t date) const;
+
+    // ---------- 工具 ----------
+    // YYYYMMDD 是否为合法的公历日期（月 1-12，日不超过当月天数，闰年按公历规则）
+    static bool isValidDate(std::int32_t yyyymmdd);
+    // 公历日期 <-> 1970-01-01 起的天数，YYYYMMDD 形式的 timefmt::daysFromCivil/civilFromDays；
+    // daysFromCivil 要求 isValidDate
+    static int daysFromCivil(std::int32_t yyyymmdd);
+    static std::int32_t civilFromDays(int days);
+
+private:
+    // 相对日历首日的天数，可能落在日历范围之外；不合法的日期抛 std::invalid_argument
+    int dayOffset(std::int32_t date) const;
+    // 第一个不早于 off 的交易日序号；off 超出日历末尾时为 tradingDayCount()
+    int indexAtOrAfter(int off) const;
+
+    int firstDay_ = 0;                          // 日历首日（自 1970-01-01 起的天数）
+    std::vector<std::int32_t> dayToIndex_;      // 自然日 -> 交易日序号；非交易日编码为 -(下一交易日序号) - 1
+    std::vector<std::int32_t> tradingDays_;     // 交易日序号 -> YYYYMMDD
+    std::vector<std::uint8_t> halfDay_;         // 交易日序号 -> 是否半日市
+};
+
+} // namespace market
+} // namespace domain
@@ -0,0 +1,324 @@
+#include "BarJsonReader.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "foundation/Utils/time_format.hpp"
+#include "foundation/json/json_sax.h"
+#include "foundation/log/instrumentation.hpp"
+
+namespace domain {
+namespace market {
+
+BarJsonLayout BarJsonLayout::sinaKline()
+{
+    BarJsonLayout l;
+    l.format = RowFormat::Object;
+    l.dateField = "day";
+    l.amountField.clear();
+    return l;
+}
+
+BarJsonLayout BarJsonLayout::eastmoneyKline()
+{
+    BarJsonLayout l;
+    l.arrayPath = "data.klines";
+    l.format = RowFormat::Csv;
+    l.dateIndex = 0;
+    l.openIndex = 1;
+    l.closeIndex = 2;
+    l.highIndex = 3;
+    l.lowIndex = 4;
+    l.volumeIndex = 5;
+    l.amountIndex = 6;
+    return l;
+}
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+enum Field : int { kDate, kOpen, kHigh, kLow, kClose, kVolume, kAmount, kFieldCount, kNone = -1 };
+
+bool parseBarDate(std::string_view s, std::int32_t& out)
+{
+    // 带时间的只取日期部分
+    const std::size_t cut = s.find_first_of(" T");
+    if (cut != std::string_view::npos) s = s.substr(0, cut);
+    return foundation::utils::timefmt::parseDate(s, out);
+}
+
+class BarSaxHandler : public foundation::json::JsonSaxHandler {
+public:
+    BarSaxHandler(const BarJsonLayout& layout, std::size_t batchSize, const BarJsonReader::BatchSink& sink)
+        : layout_(layout), batchSize_(batchSize), sink_(sink) {
+        std::string_view path = layout.arrayPath;
+        while (!path.empty()) {
+            const std::size_t dot = path.find('.');
+            target_.emplace_back(path.substr(0, dot));
+            path = dot == std::string_view::npos ? std::string_view() : path.substr(dot + 1);
+        }
+        const std::string* names[kFieldCount] = {&layout.dateField,  &layout.openField,   &layout.highField,
+                                                 &layout.lowField,   &layout.closeField,  &layout.volumeField,
+                                                 &layout.amountField};
+        const int indexes[kFieldCount] = {layout.dateIndex,  layout.openIndex,   layout.highIndex, layout.lowIndex,
+                                          layout.closeIndex, layout.volumeIndex, layout.amountIndex};
+        for (int f = 0; f < kFieldCount; ++f) {
+            fieldNames_[f] = *names[f];
+            if (indexes[f] >= 0) {
+                if (static_cast<std::size_t>(indexes[f]) >= columnField_.size()) columnField_.resize(indexes[f] + 1, kNone);
+                columnField_[indexes[f]] = static_cast<Field>(f);
+            }
+        }
+        batch_.reserve(batchSize_);
+    }
+
+    void finish() {
+        if (!batch_.empty()) flush();
+    }
+
+    BarJsonStats stats;
+
+    // ---------- 目标数组之外：只跟踪对象键路径 ----------
+
+    bool onStartObject() override {
+        if (inTarget_) return rowStart(true);
+        frames_.push_back({true, std::string()});
+        return true;
+    }
+
+    bool onEndObject() override {
+        if (inTarget_) return rowEnd();
+        frames_.pop_back();
+        return true;
+    }
+
+    bool onStartArray() override {
+        if (inTarget_) return rowStart(false);
+        if (pathMatches()) {
+            inTarget_ = true;
+            stats.found = true;
+            depth_ = 0;
+            return true;
+        }
+        frames_.push_back({false, std::string()});
+        return true;
+    }
+
+    bool onEndArray() override {
+        if (inTarget_) {
+            if (depth_ == 0) return false;   // 目标数组结束，后面的内容不再需要
+            return rowEnd();
+        }
+        frames_.pop_back();
+        return true;
+    }
+
+    bool onKey(std::string_view key) override {
+        if (!inTarget_) {
+            frames_.back().key.assign(key.data(), key.size());
+            return true;
+        }
+        if (depth_ == 1 && rowIsObject_) currentField_ = fieldOfKey(key);
+        return true;
+    }
+
+    bool onString(std::string_view s) override {
+        if (!inTarget_) return true;
+        if (depth_ == 0 && layout_.format == BarJsonLayout::RowFormat::Csv) {
+            parseCsvRow(s);
+            return true;
+        }
+        if (depth_ == 1) setField(targetField(), s);
+        return true;
+    }
+
+    bool onInt(std::int64_t v) override {
+        if (inTarget_ && depth_ == 1) setNumber(targetField(), static_cast<double>(v), v);
+        return true;
+    }
+
+    bool onDouble(double v) override {
+        if (inTarget_ && depth_ == 1) setNumber(targetField(), v, -1);
+        return true;
+    }
+
+    bool onNull() override {
+        if (inTarget_ && depth_ == 1) advanceColumn();
+        return true;
+    }
+
+    bool onBool(bool) override {
+        if (inTarget_ && depth_ == 1) advanceColumn();
+        return true;
+    }
+
+private:
+    struct Frame {
+        bool object;
+        std::string key;
+    };
+
+    bool pathMatches() const {
+        std::size_t k = 0;
+        for (const auto& f : frames_) {
+            if (!f.object) continue;
+            if (k >= target_.size() || f.key != target_[k]) return false;
+            ++k;
+        }
+        return k == target_.size();
+    }
+
+    Field fieldOfKey(std::string_view key) const {
+        for (int f = 0; f < kFieldCount; ++f) {
+            if (!fieldNames_[f].empty() && key == fieldNames_[f]) return static_cast<Field>(f);
+        }
+        return kNone;
+    }
+
+    // 当前标量对应的字段；数组行按列序号，每个标量推进一列
+    Field targetField() {
+        if (rowIsObject_) return currentField_;
+        const std::size_t col = column_++;
+        return col < columnField_.size() ? columnField_[col] : kNone;
+    }
+
+    void advanceColumn() {
+        if (!rowIsObject_) ++column_;
+    }
+
+    bool rowStart(bool object) {
+        if (depth_ == 1) advanceColumn();   // 行内嵌套的值也占一列
+        if (++depth_ == 1) {
+            rowIsObject_ = object;
+            column_ = 0;
+            currentField_ = kNone;
+            resetRow();
+        }
+        return true;
+    }
+
+    bool rowEnd() {
+        if (depth_-- == 1) commitRow();
+        return true;
+    }
+
+    void resetRow() {
+        date_ = 0;
+        for (double& v : values_) v = kNaN;
+    }
+
+    void setNumber(Field f, double v, std::int64_t asInt) {
+        if (f == kNone) return;
+        if (f == kDate) {
+            if (asInt >= 19000101 && asInt <= 29991231) date_ = static_cast<std::int32_t>(asInt);
+            return;
+        }
+        values_[f] = v;
+    }
+
+    void setField(Field f, std::string_view s) {
+        if (f == kNone) return;
+        if (f == kDate) {
+            std::int32_t d = 0;
+            if (parseBarDate(s, d)) date_ = d;
+            return;
+        }
+        double v = 0.0;
+        if (foundation::json::parseJsonNumber(s, v)) values_[f] = v;
+    }
+
+    void parseCsvRow(std::string_view s) {
+        resetRow();
+        std::size_t col = 0;
+        while (true) {
+            const std::size_t comma = s.find(',');
+            const std::string_view cell = s.substr(0, comma);
+            if (col < columnField_.size()) setField(columnField_[col], cell);
+            if (comma == std::string_view::npos) break;
+            s.remove_prefix(comma + 1);
+            ++col;
+        }
+        commitRow();
+    }
+
+    void commitRow() {
+        if (date_ == 0 || std::isnan(values_[kClose])) {
+            ++stats.skipped;
+            return;
+        }
+        batch_.date.push_back(date_);
+        batch_.open.push_back(values_[kOpen]);
+        batch_.high.push_back(values_[kHigh]);
+        batch_.low.push_back(values_[kLow]);
+        batch_.close.push_back(values_[kClose]);
+        batch_.volume.push_back(values_[kVolume]);
+        batch_.amount.push_back(values_[kAmount]);
+        ++stats.rows;
+        if (batch_.size() >= batchSize_) flush();
+    }
+
+    void flush() {
+        ++stats.batches;
+        sink_(batch_);
+        batch_.clear();
+    }
+
+    const BarJsonLayout& layout_;
+    const std::size_t batchSize_;
+    const BarJsonReader::BatchSink& sink_;
+
+    std::vector<std::string> target_;
+    std::string fieldNames_[kFieldCount];
+    std::vector<Field> columnField_;
+
+    std::vector<Frame> frames_;
+    bool inTarget_ = false;
+    int depth_ = 0;   // 目标数组内的嵌套深度：1 为行本身
+
+    bool rowIsObject_ = false;
+    Field currentField_ = kNone;
+    std::size_t column_ = 0;
+    std::int32_t date_ = 0;
+    double values_[kFieldCount] = {};
+
+    BarColumns batch_;
+};
+
+} // namespace
+
+BarJsonReader::BarJsonReader(BarJsonLayout layout, std::size_t batchSize)
+    : layout_(std::move(layout)), batchSize_(batchSize == 0 ? 1 : batchSize)
+{
+}
+
+BarJsonStats BarJsonReader::read(std::string_view json, const BatchSink& sink) const
+{
+    ENGINE_PROBE(foundation::metrics::Stage::DataDecode);   // 含 sink 回调的耗时
+    BarSaxHandler handler(layout_, batchSize_, sink);
+    const auto result = foundation::json::parseJsonSax(json, handler);
+    if (!result.ok) {
+        throw std::runtime_error("BarJsonReader: " + result.error + " at offset " + std::to_string(result.offset));
+    }
+    handler.finish();
+    return handler.stats;
+}
+
+BarColumns BarJsonReader::readAll(std::string_view json, BarJsonStats* stats) const
+{
+    BarColumns all;
+    const auto s = read(json, [&all](BarColumns& batch) {
+        if (all.empty()) {
+            std::swap(all, batch);
+            return;
+        }
+        for (std::size_t i = 0; i < batch.size(); ++i) all.appendRow(batch, i);
+    });
+    if (stats) *stats = s;
+    return all;
+}
+
+} // namespace market
+} // namespace domain
@@ -0,0 +1,750 @@
+#include "MarketDataCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include "TradingCalendar.h"
+#include "foundation/Fs/MappedFile.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <process.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace domain {
+namespace market {
+
+// ==================== BarColumns ====================
+
+void BarColumns::reserve(std::size_t n)
+{
+    date.reserve(n);
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+    amount.reserve(n);
+}
+
+void BarColumns::clear()
+{
+    date.clear();
+    open.clear();
+    high.clear();
+    low.clear();
+    close.clear();
+    volume.clear();
+    amount.clear();
+}
+
+void BarColumns::appendRow(const BarColumns& src, std::size_t i)
+{
+    date.push_back(src.date[i]);
+    open.push_back(src.open[i]);
+    high.push_back(src.high[i]);
+    low.push_back(src.low[i]);
+    close.push_back(src.close[i]);
+    volume.push_back(src.volume[i]);
+    amount.push_back(src.amount[i]);
+}
+
+namespace {
+
+// ---------------- 列编码 ----------------
+
+constexpr char kBlockMagic[4] = {'A', 'Q', 'B', '1'};
+
+enum ColumnMode : std::uint8_t {
+    kRaw = 0,        // 原样 8 字节
+    kScaled = 1      // 乘以 10^scale 后差分 + zigzag varint
+};
+
+void putVarint(std::string& out, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+bool getVarint(std::string_view in, std::size_t& pos, std::uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) return false;
+        const auto b = static_cast<std::uint8_t>(in[pos++]);
+        v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+std::uint64_t zigzag(std::int64_t v) { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+std::int64_t unzigzag(std::uint64_t v) { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+
+const double kPow10[] = {1.0, 10.0, 100.0, 1000.0, 10000.0};
+
+// 找一个能无损还原的放大倍数；找不到返回 -1
+int chooseScale(const std::vector<double>& col)
+{
+    for (int scale = 0; scale <= 4; ++scale) {
+        const double f = kPow10[scale];
+        bool ok = true;
+        for (double v : col) {
+            if (!std::isfinite(v) || std::fabs(v * f) > 9.0e15) {
+                ok = false;
+                break;
+            }
+            const double r = static_cast<double>(std::llround(v * f)) / f;
+            if (r != v) {
+                ok = false;
+                break;
+            }
+        }
+        if (ok) return scale;
+    }
+    return -1;
+}
+
+void encodeColumn(std::string& out, const std::vector<double>& col)
+{
+    const int scale = chooseScale(col);
+    if (scale < 0) {
+        out.push_back(static_cast<char>(kRaw));
+        const std::size_t off = out.size();
+        out.resize(off + col.size() * sizeof(double));
+        std::memcpy(&out[off], col.data(), col.size() * sizeof(double));
+        return;
+    }
+    out.push_back(static_cast<char>(kScaled));
+    out.push_back(static_cast<char>(scale));
+    std::int64_t prev = 0;
+    for (double v : col) {
+        const std::int64_t x = std::llround(v * kPow10[scale]);
+        putVarint(out, zigzag(x - prev));
+        prev = x;
+    }
+}
+
+bool decodeColumn(std::string_view in, std::size_t& pos, std::size_t rows, std::vector<double>& col)
+{
+    if (pos >= in.size()) return false;
+    const auto mode = static_cast<std::uint8_t>(in[pos++]);
+    col.resize(rows);
+    if (mode == kRaw) {
+        if (pos + rows * sizeof(double) > in.size()) return false;
+        std::memcpy(col.data(), &in[pos], rows * sizeof(double));
+        pos += rows * sizeof(double);
+        return true;
+    }
+    if (mode != kScaled || pos >= in.size()) return false;
+    const int scale = in[pos++];
+    if (scale < 0 || scale > 4) return false;
+    std::int64_t prev = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        std::uint64_t z;
+        if (!getVarint(in, pos, z)) return false;
+        prev += unzigzag(z);
+        col[i] = static_cast<double>(prev) / kPow10[scale];
+    }
+    return true;
+}
+
+// FNV-1a 64
+std::uint64_t fnv1a(std::string_view data)
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+std::string toHex(std::uint64_t v)
+{
+    static const char* digits = "0123456789abcdef";
+    std::string s(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        s[i] = digits[v & 0xF];
+        v >>= 4;
+    }
+    return s;
+}
+
+bool readFile(const std::string& path, std::string& out)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int processId()
+{
+#if defined(_WIN32)
+    return ::_getpid();
+#else
+    return static_cast<int>(::getpid());
+#endif
+}
+
+// 先写临时文件再 rename，避免进程中断留下半个文件。
+// 临时文件名带进程号和序号：多个线程/进程同时写同一个目标（例如同一内容的数据块）时各写各的，
+// 不会互相截断对方写了一半的临时文件
+void writeFileAtomic(const std::string& path, const std::string& data)
+{
+    static std::atomic<std::uint64_t> counter{0};
+    const std::string tmp = path + ".tmp." + std::to_string(processId()) + "." + std::to_string(++counter);
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("MarketDataCache: cannot write " + tmp);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        out.close();
+        if (!out) {
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            throw std::runtime_error("MarketDataCache: write failed " + tmp);
+        }
+    }
+    fs::rename(tmp, path);
+}
+
+// 缓存目录的进程间锁（<root>/lock 上的 flock，Windows 上是 LockFileEx）。mutex_ 只管本进程内的线程，
+// 多个进程共用一个 io.paths.cache 时，追加索引行与重写索引、成对写 HTTP body/meta
+// 都要再拿这把锁，否则 compact 的 rename 会吞掉另一个进程刚追加到旧文件上的行。
+// 总是在持有 mutex_ 之后获取
+class DirLock {
+public:
+    DirLock(const std::string& root, bool exclusive)
+    {
+#if !defined(_WIN32)
+        const std::string path = (fs::path(root) / "lock").string();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) throw std::runtime_error("MarketDataCache: cannot open " + path);
+        int rc;
+        do {
+            rc = ::flock(fd_, exclusive ? LOCK_EX : LOCK_SH);
+        } while (rc != 0 && errno == EINTR);
+        if (rc != 0) {
+            ::close(fd_);
+            throw std::runtime_error("MarketDataCache: cannot lock " + path);
+        }
+#else
+        const fs::path path = fs::path(root) / "lock";
+        handle_ = ::CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle_ == INVALID_HANDLE_VALUE) throw std::runtime_error("MarketDataCache: cannot open " + path.string());
+        OVERLAPPED overlapped{};
+        if (!::LockFileEx(handle_, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+            ::CloseHandle(handle_);
+            throw std::runtime_error("MarketDataCache: cannot lock " + path.string());
+        }
+#endif
+    }
+    ~DirLock()
+    {
+#if !defined(_WIN32)
+        ::close(fd_);   // 关闭即释放 flock
+#else
+        OVERLAPPED overlapped{};
+        ::UnlockFileEx(handle_, 0, MAXDWORD, MAXDWORD, &overlapped);
+        ::CloseHandle(handle_);
+#endif
+    }
+    DirLock(const DirLock&) = delete;
+    DirLock& operator=(const DirLock&) = delete;
+
+private:
+#if !defined(_WIN32)
+    int fd_ = -1;
+#else
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#endif
+};
+
+// 标的代码可能含有 '.'（600000.SH），其它非字母数字替换掉，保证是合法文件名
+std::string safeName(const std::string& symbol)
+{
+    std::string s = symbol;
+    for (auto& c : s) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') c = '_';
+    }
+    return s;
+}
+
+// YYYYMMDD 前后一天
+std::int32_t shiftDate(std::int32_t yyyymmdd, int delta)
+{
+    return TradingCalendar::civilFromDays(TradingCalendar::daysFromCivil(yyyymmdd) + delta);
+}
+
+std::string formatSegment(const MarketDataCache::Segment& s)
+{
+    std::ostringstream os;
+    os << s.cover.from << ' ' << s.cover.to << ' ' << s.rows << ' ' << s.hash << ' '
+       << (s.etag.empty() ? "-" : s.etag) << '\n';
+    return os.str();
+}
+
+} // namespace
+
+// ==================== 编码 ====================
+
+std::string MarketDataCache::encodeBlock(const BarColumns& bars)
+{
+    for (const auto* col : {&bars.open, &bars.high, &bars.low, &bars.close, &bars.volume, &bars.amount}) {
+        if (col->size() != bars.size()) throw std::invalid_argument("MarketDataCache: column size mismatch");
+    }
+    std::string out(kBlockMagic, sizeof(kBlockMagic));
+    putVarint(out, bars.size());
+    std::int32_t prev = 0;
+    for (auto d : bars.date) {
+        putVarint(out, zigzag(static_cast<std::int64_t>(d) - prev));
+        prev = d;
+    }
+    for (const auto* col : {&bars.open, &bars.high, &bars.low, &bars.close, &bars.volume, &bars.amount}) {
+        encodeColumn(out, *col);
+    }
+    return out;
+}
+
+bool MarketDataCache::decodeBlock(std::string_view data, BarColumns& out)
+{
+    if (data.size() < sizeof(kBlockMagic) || std::memcmp(data.data(), kBlockMagic, sizeof(kBlockMagic)) != 0) {
+        return false;
+    }
+    std::size_t pos = sizeof(kBlockMagic);
+    std::uint64_t rows;
+    if (!getVarint(data, pos, rows) || rows > data.size()) return false;
+    out.date.resize(rows);
+    std::int64_t prev = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        std::uint64_t z;
+        if (!getVarint(data, pos, z)) return false;
+        prev += unzigzag(z);
+        out.date[i] = static_cast<std::int32_t>(prev);
+    }
+    for (auto* col : {&out.open, &out.high, &out.low, &out.close, &out.volume, &out.amount}) {
+        if (!decodeColumn(data, pos, rows, *col)) return false;
+    }
+    return pos == data.size();
+}
+
+std::string MarketDataCache::contentHash(std::string_view data)
+{
+    return toHex(fnv1a(data));
+}
+
+// ==================== MarketDataCache ====================
+
+MarketDataCache::MarketDataCache(const std::string& cacheDir)
+    : root_((fs::path(cacheDir) / "market").string())
+{
+    fs::create_directories(fs::path(root_) / "objects");
+    fs::create_directories(fs::path(root_) / "index");
+    fs::create_directories(fs::path(root_) / "http");
+}
+
+std::string MarketDataCache::indexPath(const std::string& symbol) const
+{
+    return (fs::path(root_) / "index" / (safeName(symbol) + ".idx")).string();
+}
+
+std::string MarketDataCache::objectPath(const std::string& hash) const
+{
+    return (fs::path(root_) / "objects" / hash.substr(0, 2) / (hash + ".blk")).string();
+}
+
+std::vector<MarketDataCache::Segment> MarketDataCache::loadIndex(const std::string& symbol) const
+{
+    std::vector<Segment> result;
+    std::ifstream in(indexPath(symbol));
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream is(line);
+        Segment s;
+        // 最后一行可能因中断而不完整，解析失败的行直接忽略
+        if (!(is >> s.cover.from >> s.cover.to >> s.rows >> s.hash >> s.etag)) continue;
+        if (s.etag == "-") s.etag.clear();
+        result.push_back(std::move(s));
+    }
+    return result;
+}
+
+bool MarketDataCache::loadBlock(const std::string& hash, BarColumns& out) const
+{
+    // 数据块直接在映射上校验和解码，不再先读进 string
+    foundation::fs::MappedFile file;
+    try {
+        file = foundation::fs::MappedFile::open(objectPath(hash));
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    const std::string_view data = file.view();
+    if (contentHash(data) != hash || !decodeBlock(data, out)) {
+        ++stats_.corruptBlocks;
+        return false;
+    }
+    return true;
+}
+
+std::string MarketDataCache::writeBlock(const BarColumns& bars)
+{
+    const std::string data = encodeBlock(bars);
+    const std::string hash = contentHash(data);
+    const std::string path = objectPath(hash);
+    if (!fs::exists(path)) {
+        fs::create_directories(fs::path(path).parent_path());
+        writeFileAtomic(path, data);
+    }
+    return hash;
+}
+
+std::vector<MarketDataCache::Segment> MarketDataCache::segments(const std::string& symbol) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loadIndex(symbol);
+}
+
+std::vector<DateRange> MarketDataCache::missingRanges(const std::string& symbol, const DateRange& want) const
+{
+    std::vector<Segment> segs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segs = loadIndex(symbol);
+    }
+    return coverGaps(segs, want);
+}
+
+std::vector<DateRange> MarketDataCache::coverGaps(const std::vector<Segment>& segs, const DateRange& want)
+{
+    std::vector<DateRange> covered;
+    for (const auto& s : segs) {
+        if (s.cover.to >= want.from && s.cover.from <= want.to) covered.push_back(s.cover);
+    }
+    std::sort(covered.begin(), covered.end(), [](const DateRange& a, const DateRange& b) { return a.from < b.from; });
+
+    std::vector<DateRange> missing;
+    std::int32_t cursor = want.from;
+    for (const auto& c : covered) {
+        if (cursor > want.to) break;
+        if (c.from > cursor) missing.push_back({cursor, std::min(shiftDate(c.from, -1), want.to)});
+        if (c.to >= cursor) cursor = shiftDate(c.to, 1);
+    }
+    if (cursor <= want.to) missing.push_back({cursor, want.to});
+    return missing;
+}
+
+BarColumns MarketDataCache::read(const std::string& symbol, const DateRange& want) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, false);
+    return readSegments(loadIndex(symbol), want);
+}
+
+BarColumns MarketDataCache::readSegments(const std::vector<Segment>& segs, const DateRange& want) const
+{
+    // 日期 -> (分段序号, 行号)，后写入的分段覆盖先写入的
+    std::map<std::int32_t, std::pair<std::size_t, std::size_t>> rows;
+    std::vector<BarColumns> blocks;
+    for (const auto& s : segs) {
+        if (s.cover.to < want.from || s.cover.from > want.to || s.rows == 0) continue;
+        BarColumns block;
+        if (!loadBlock(s.hash, block)) continue;
+        blocks.push_back(std::move(block));
+        const auto& b = blocks.back();
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            if (want.contains(b.date[i])) rows[b.date[i]] = {blocks.size() - 1, i};
+        }
+    }
+    BarColumns out;
+    out.reserve(rows.size());
+    for (const auto& [date, ref] : rows) out.appendRow(blocks[ref.first], ref.second);
+    return out;
+}
+
+void MarketDataCache::store(const std::string& symbol, const DateRange& cover, const BarColumns& bars,
+                            const std::string& etag)
+{
+    if (cover.empty()) throw std::invalid_argument("MarketDataCache: empty cover range");
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, true);
+    Segment s;
+    s.cover = cover;
+    s.rows = bars.size();
+    s.hash = writeBlock(bars);
+    s.etag = etag;
+    appendIndex(symbol, s);
+}
+
+void MarketDataCache::appendIndex(const std::string& symbol, const Segment& s)
+{
+    // 索引只追加一行，不改写已有内容
+    std::ofstream out(indexPath(symbol), std::ios::app);
+    if (!out) throw std::runtime_error("MarketDataCache: cannot append index for " + symbol);
+    out << formatSegment(s);
+}
+
+std::optional<MarketDataCache::Segment> MarketDataCache::segmentBefore(const std::vector<Segment>& segs,
+                                                                       const DateRange& range)
+{
+    // range 紧接着的那个分段（与 range 重叠或首尾相接），同等条件下以后写入的为准
+    const std::int32_t dayBefore = shiftDate(range.from, -1);
+    const Segment* best = nullptr;
+    for (const auto& s : segs) {
+        if (s.cover.to < dayBefore || s.cover.from > range.to) continue;
+        if (!best || s.cover.to >= best->cover.to) best = &s;
+    }
+    if (!best) return std::nullopt;
+    return *best;
+}
+
+std::string MarketDataCache::etagFor(const std::string& symbol, const DateRange& range) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, false);
+    const auto seg = segmentBefore(loadIndex(symbol), range);
+    return seg ? seg->etag : std::string();
+}
+
+std::int32_t MarketDataCache::lastBarDate(const std::string& symbol) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, false);
+    std::vector<Segment> segs = loadIndex(symbol);
+    // 按覆盖区间末尾从晚到早找，一旦已找到的日期不早于剩余分段的末尾就可以停
+    std::stable_sort(segs.begin(), segs.end(),
+                     [](const Segment& a, const Segment& b) { return a.cover.to > b.cover.to; });
+    std::int32_t last = 0;
+    for (const auto& s : segs) {
+        if (last >= s.cover.to) break;
+        if (s.rows == 0) continue;
+        BarColumns block;
+        if (!loadBlock(s.hash, block)) continue;
+        for (auto d : block.date) {
+            if (d <= s.cover.to) last = std::max(last, d);
+        }
+    }
+    return last;
+}
+
+std::size_t MarketDataCache::storeFetched(const std::string& symbol, const DateRange& range, const FetchResult& r)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, true);
+    ++stats_.fetchedRanges;
+    if (r.notModified) {
+        ++stats_.notModified;
+        // 304：本地分段仍然有效，沿用它的数据，不追加索引行。
+        // 服务端换了 ETag 时原地改掉那个分段的 ETag（整体原子重写索引），下次带新 ETag 请求
+        std::vector<Segment> segs = loadIndex(symbol);
+        const auto seg = segmentBefore(segs, range);
+        if (seg && !r.etag.empty() && r.etag != seg->etag) {
+            // segmentBefore 同等条件下取后写入的，这里从后往前改第一个相同的分段
+            for (auto it = segs.rbegin(); it != segs.rend(); ++it) {
+                if (it->cover.from == seg->cover.from && it->cover.to == seg->cover.to && it->hash == seg->hash &&
+                    it->etag == seg->etag) {
+                    it->etag = r.etag;
+                    break;
+                }
+            }
+            std::string text;
+            for (const auto& s : segs) text += formatSegment(s);
+            writeFileAtomic(indexPath(symbol), text);
+        }
+        return 0;
+    }
+
+    // 只把覆盖区间记到实际返回的最后一根 bar；之后的日期可能只是数据源还没更新，不能当成已覆盖
+    std::int32_t last = 0;
+    for (auto d : r.bars.date) {
+        if (range.contains(d)) last = std::max(last, d);
+    }
+    if (last == 0) return 0;
+
+    BarColumns bars;
+    bars.reserve(r.bars.size());
+    for (std::size_t i = 0; i < r.bars.size(); ++i) {
+        if (range.contains(r.bars.date[i])) bars.appendRow(r.bars, i);
+    }
+    Segment s;
+    s.cover = {range.from, last};
+    s.rows = bars.size();
+    s.hash = writeBlock(bars);
+    s.etag = r.etag;
+    appendIndex(symbol, s);
+    return s.rows;
+}
+
+BarColumns MarketDataCache::fetchThrough(const std::string& symbol, const DateRange& want,
+                                         const RangeFetcher& fetcher)
+{
+    const auto missing = missingRanges(symbol, want);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (missing.empty()) ++stats_.hits;
+        else if (missing.size() == 1 && missing.front() == want) ++stats_.misses;
+        else ++stats_.partialHits;
+    }
+    for (const auto& range : missing) {
+        storeFetched(symbol, range, fetcher(symbol, range, etagFor(symbol, range)));
+    }
+    return read(symbol, want);
+}
+
+std::size_t MarketDataCache::verify(const std::string& symbol) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, false);
+    std::size_t bad = 0;
+    for (const auto& s : loadIndex(symbol)) {
+        BarColumns block;
+        if (!loadBlock(s.hash, block) || block.size() != s.rows) ++bad;
+    }
+    return bad;
+}
+
+void MarketDataCache::compact(const std::string& symbol)
+{
+    // 整个过程持锁（含进程间锁）：读索引到重写索引之间不能插入 store()，否则新追加的分段会被覆盖掉
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, true);
+    const std::vector<Segment> segs = loadIndex(symbol);
+    if (segs.size() <= 1) return;
+    // 只有各分段连成一片（整体跨度内没有空洞）时才合并，否则会把空洞误记为已覆盖
+    DateRange span{segs.front().cover.from, segs.front().cover.to};
+    for (const auto& s : segs) {
+        span.from = std::min(span.from, s.cover.from);
+        span.to = std::max(span.to, s.cover.to);
+    }
+    if (!coverGaps(segs, span).empty()) return;
+
+    const BarColumns all = readSegments(segs, span);
+    Segment merged;
+    merged.cover = span;
+    merged.rows = all.size();
+    merged.hash = writeBlock(all);
+    // 合并后的分段沿用最后面那个分段的 ETag，增量请求仍能带上它
+    for (const auto& s : segs) {
+        if (s.cover.to == span.to) merged.etag = s.etag;
+    }
+    writeFileAtomic(indexPath(symbol), formatSegment(merged));
+    // 被合并掉的分段的块现在可能没人引用了；中断的 compact 写出的块内容确定，重做时会直接复用
+    removeUnreferencedBlocks();
+}
+
+std::size_t MarketDataCache::removeUnreferencedBlocks()
+{
+    // 数据块按内容寻址，可能被多个标的共用：只删所有索引都不引用的块。
+    // 写块的路径（store/storeFetched/compact）都持有独占目录锁，此刻留下的临时文件必然是中断写入的残留
+    std::unordered_set<std::string> referenced;
+    for (const auto& e : fs::directory_iterator(fs::path(root_) / "index")) {
+        if (e.path().extension() != ".idx") continue;
+        for (const auto& s : loadIndex(e.path().stem().string())) referenced.insert(s.hash);
+    }
+    std::vector<fs::path> garbage;
+    for (const auto& e : fs::recursive_directory_iterator(fs::path(root_) / "objects")) {
+        if (!e.is_regular_file()) continue;
+        const fs::path& p = e.path();
+        const bool tmp = p.filename().string().find(".tmp.") != std::string::npos;
+        if (tmp || (p.extension() == ".blk" && !referenced.count(p.stem().string()))) garbage.push_back(p);
+    }
+    std::size_t removed = 0;
+    for (const auto& p : garbage) {
+        std::error_code ec;
+        if (fs::remove(p, ec)) ++removed;
+    }
+    return removed;
+}
+
+std::optional<MarketDataCache::CachedResponse> MarketDataCache::loadResponse(const std::string& url) const
+{
+    const std::string key = contentHash(url);
+    const fs::path base = fs::path(root_) / "http" / key;
+    CachedResponse r;
+    std::string meta;
+    // body 与 meta 是两个文件，要和 storeResponse 互斥读，否则可能读到新 body + 旧 meta 而误判为损坏
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, false);
+    if (!readFile(base.string() + ".body", r.body) || !readFile(base.string() + ".meta", meta)) return std::nullopt;
+    // meta 第一行是 URL（防哈希碰撞），第二行是 body 哈希，第三行是 ETag
+    std::istringstream is(meta);
+    std::string storedUrl, bodyHash;
+    std::getline(is, storedUrl);
+    std::getline(is, bodyHash);
+    std::getline(is, r.etag);
+    if (storedUrl != url || bodyHash != contentHash(r.body)) {
+        ++stats_.corruptBlocks;
+        return std::nullopt;
+    }
+    return r;
+}
+
+void MarketDataCache::storeResponse(const std::string& url, const std::string& body, const std::string& etag)
+{
+    const std::string key = contentHash(url);
+    const fs::path base = fs::path(root_) / "http" / key;
+    std::lock_guard<std::mutex> lock(mutex_);
+    DirLock dirLock(root_, true);
+    writeFileAtomic(base.string() + ".body", body);
+    writeFileAtomic(base.string() + ".meta", url + "\n" + contentHash(body) + "\n" + etag + "\n");
+}
+
+MarketDataCache::Stats MarketDataCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MarketDataCache::bindMetrics(const std::string& name)
+{
+    metricHandles_.clear();   // 重复绑定时旧句柄先注销，同名同标签不能重复注册
+    auto& registry = foundation::metrics::MetricsRegistry::instance();
+    const foundation::metrics::Labels labels{{"cache", name}};
+    std::vector<foundation::metrics::CallbackHandle> handles;
+    auto addCounter = [&](const char* metric, const foundation::metrics::Labels& l, std::size_t Stats::*field) {
+        handles.push_back(registry.counterCallback(metric, l, [this, field] {
+            return static_cast<double>(stats().*field);
+        }));
+    };
+    const std::pair<const char*, std::size_t Stats::*> results[] = {
+        {"hit", &Stats::hits}, {"partial", &Stats::partialHits}, {"miss", &Stats::misses}};
+    for (const auto& [result, field] : results) {
+        auto l = labels;
+        l["result"] = result;
+        addCounter("market_cache_requests_total", l, field);
+    }
+    addCounter("market_cache_fetched_ranges_total", labels, &Stats::fetchedRanges);
+    addCounter("market_cache_not_modified_total", labels, &Stats::notModified);
+    addCounter("market_cache_corrupt_blocks_total", labels, &Stats::corruptBlocks);
+    handles.push_back(registry.gaugeCallback("market_cache_hit_rate", labels, [this] { return stats().hitRate(); }));
+    metricHandles_ = std::move(handles);
+}
+
+} // namespace market
+} // namespace domain
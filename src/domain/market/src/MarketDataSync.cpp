@@ -0,0 +1,200 @@
+#include "MarketDataSync.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "TradingCalendar.h"
+
+namespace domain {
+namespace market {
+
+// ==================== RateLimiter ====================
+
+RateLimiter::RateLimiter(double ratePerSecond, double burst, SyncClock clock)
+    : rate_(ratePerSecond), burst_(std::max(1.0, burst)), tokens_(std::max(1.0, burst)), clock_(std::move(clock))
+{
+    if (!clock_.now) clock_.now = [] { return Clock::now(); };
+    if (!clock_.sleep) clock_.sleep = [](Clock::duration d) { std::this_thread::sleep_for(d); };
+    last_ = clock_.now();
+}
+
+void RateLimiter::acquire()
+{
+    if (rate_ <= 0.0) return;
+    std::chrono::duration<double> wait{0.0};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = clock_.now();
+        tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_).count() * rate_);
+        last_ = now;
+        // 先扣令牌再睡，令牌可以为负，后来的线程排在后面
+        tokens_ -= 1.0;
+        if (tokens_ < 0.0) wait = std::chrono::duration<double>(-tokens_ / rate_);
+    }
+    if (wait.count() > 0.0) clock_.sleep(std::chrono::duration_cast<Clock::duration>(wait));
+}
+
+// ==================== MarketDataSync ====================
+
+MarketDataSync::MarketDataSync(MarketDataCache& store, RangeFetcher fetcher, SyncOptions options)
+    : store_(store), fetcher_(std::move(fetcher)), options_(options),
+      limiter_(options.requestsPerSecond, options.burst, options.clock),
+      requestLatency_(foundation::metrics::MetricsRegistry::instance().histogram("market_sync_request_latency_ns")),
+      requestsOk_(foundation::metrics::MetricsRegistry::instance().counter("market_sync_requests_total",
+                                                                           {{"result", "ok"}})),
+      requestsRetryable_(foundation::metrics::MetricsRegistry::instance().counter("market_sync_requests_total",
+                                                                                  {{"result", "retryable_error"}})),
+      requestsFatal_(foundation::metrics::MetricsRegistry::instance().counter("market_sync_requests_total",
+                                                                              {{"result", "fatal_error"}}))
+{
+    if (!fetcher_) throw std::invalid_argument("MarketDataSync: fetcher is required");
+}
+
+SyncOptions syncOptionsFromConfig(const foundation::config::ConfigSnapshot& config, SyncOptions defaults)
+{
+    defaults.maxRetries = std::max(0, config.get<int>("network.max_retries", defaults.maxRetries));
+    return defaults;
+}
+
+std::int32_t MarketDataSync::highWaterMark(const std::string& symbol) const
+{
+    return store_.lastBarDate(symbol);
+}
+
+std::chrono::milliseconds MarketDataSync::backoff(int attempt) const
+{
+    // 指数退避 + 随机抖动，避免一批失败的标的同时重试
+    thread_local std::mt19937 rng(std::random_device{}());
+    const auto base = options_.retryBaseDelay.count() << std::min(attempt, 16);
+    const auto capped = std::min<long long>(base, options_.retryMaxDelay.count());
+    std::uniform_int_distribution<long long> jitter(capped / 2, std::max<long long>(capped, 1));
+    return std::chrono::milliseconds(jitter(rng));
+}
+
+SymbolSyncResult MarketDataSync::syncOne(const std::string& symbol, std::int32_t upTo, std::int32_t defaultStart,
+                                         std::size_t& requests)
+{
+    SymbolSyncResult r;
+    r.symbol = symbol;
+    // 读本地存储失败（锁文件打不开、索引损坏）不是网络问题，不发请求也不重试
+    try {
+        r.previousHighWater = highWaterMark(symbol);
+    } catch (const std::exception& e) {
+        r.error = std::string("cannot read local store: ") + e.what();
+        return r;
+    }
+    r.highWater = r.previousHighWater;
+
+    DateRange range;
+    range.from = r.previousHighWater > 0
+                     ? TradingCalendar::civilFromDays(TradingCalendar::daysFromCivil(r.previousHighWater) + 1)
+                     : defaultStart;
+    range.to = upTo;
+    if (range.empty()) {
+        r.ok = true;
+        r.skipped = true;
+        return r;
+    }
+
+    std::string etag;
+    try {
+        etag = store_.etagFor(symbol, range);
+    } catch (const std::exception& e) {
+        r.error = std::string("cannot read local store: ") + e.what();
+        return r;
+    }
+
+    for (int attempt = 0; attempt <= options_.maxRetries; ++attempt) {
+        if (attempt > 0) {
+            const auto delay = backoff(attempt - 1);
+            if (options_.clock.sleep) options_.clock.sleep(delay);
+            else std::this_thread::sleep_for(delay);
+        }
+        limiter_.acquire();
+        ++requests;
+        ++r.attempts;
+        const std::uint64_t t0 = foundation::utils::steadyNanos();
+        FetchResult fetched;
+        try {
+            fetched = fetcher_(symbol, range, etag);
+        } catch (const FetchError& e) {
+            requestLatency_.record(foundation::utils::steadyNanos() - t0);
+            (e.retryable() ? requestsRetryable_ : requestsFatal_).inc();
+            r.error = e.what();
+            if (!e.retryable()) break;
+            continue;
+        } catch (const std::exception& e) {
+            requestLatency_.record(foundation::utils::steadyNanos() - t0);
+            requestsRetryable_.inc();
+            r.error = e.what();
+            continue;
+        }
+        requestLatency_.record(foundation::utils::steadyNanos() - t0);
+        requestsOk_.inc();
+
+        // 下载已经成功，写本地存储失败（磁盘满、权限、索引损坏）重新下载也无济于事：记入报告，不再重试
+        try {
+            // 304 或空结果：本地已是数据源的最新状态，高水位不动，下次仍从同一天开始请求
+            r.newBars = store_.storeFetched(symbol, range, fetched);
+            if (r.newBars > 0) r.highWater = store_.lastBarDate(symbol);
+        } catch (const std::exception& e) {
+            r.error = std::string("cannot store fetched bars: ") + e.what();
+            return r;
+        }
+        r.ok = true;
+        r.error.clear();
+        return r;
+    }
+    return r;
+}
+
+SyncReport MarketDataSync::sync(const std::vector<std::string>& symbols, std::int32_t upTo,
+                                std::int32_t defaultStart)
+{
+    const auto start = std::chrono::steady_clock::now();
+    SyncReport report;
+    report.results.resize(symbols.size());
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> requests{0};
+    auto worker = [&] {
+        std::size_t local = 0;
+        for (std::size_t i = next.fetch_add(1); i < symbols.size(); i = next.fetch_add(1)) {
+            // 工作线程里漏出的异常会让整个进程 terminate：兜底记到该标的上，其余标的照常同步
+            try {
+                report.results[i] = syncOne(symbols[i], upTo, defaultStart, local);
+            } catch (const std::exception& e) {
+                report.results[i] = SymbolSyncResult();
+                report.results[i].symbol = symbols[i];
+                report.results[i].error = e.what();
+            } catch (...) {
+                report.results[i] = SymbolSyncResult();
+                report.results[i].symbol = symbols[i];
+                report.results[i].error = "unknown error";
+            }
+        }
+        requests.fetch_add(local);
+    };
+
+    const std::size_t n = std::max<std::size_t>(1, std::min(options_.workers, symbols.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    for (std::size_t t = 1; t < n; ++t) threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads) th.join();
+
+    for (const auto& r : report.results) {
+        if (!r.ok) ++report.failed;
+        else if (r.skipped) ++report.skipped;
+        else ++report.succeeded;
+        report.newBars += r.newBars;
+    }
+    report.requests = requests.load();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace market
+} // namespace domain
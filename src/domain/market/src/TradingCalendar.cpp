@@ -0,0 +1,245 @@
+#include "TradingCalendar.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "foundation/Utils/time_format.hpp"
+
+namespace domain {
+namespace market {
+
+namespace timefmt = foundation::utils::timefmt;
+
+namespace {
+
+// 分钟 -> 会话分钟序号 的查找表，按一天 1440 分钟展开
+const std::array<std::int16_t, 24 * 60>& minuteTable()
+{
+    static const std::array<std::int16_t, 24 * 60> table = [] {
+        std::array<std::int16_t, 24 * 60> t{};
+        t.fill(-1);
+        std::int16_t idx = 0;
+        // 以 bar 结束时间标记：(open, close]
+        for (int m = 9 * 60 + 31; m <= 11 * 60 + 30; ++m) t[m] = idx++;
+        for (int m = 13 * 60 + 1; m <= 15 * 60; ++m) t[m] = idx++;
+        return t;
+    }();
+    return table;
+}
+
+bool isWeekend(int days)
+{
+    // 1970-01-01 是星期四；weekday: 0 = 周日
+    const int weekday = ((days % 7) + 11) % 7;
+    return weekday == 0 || weekday == 6;
+}
+
+} // namespace
+
+bool TradingCalendar::isValidDate(std::int32_t yyyymmdd)
+{
+    if (yyyymmdd <= 0) return false;
+    const int y = yyyymmdd / 10000;
+    const int m = yyyymmdd / 100 % 100;
+    const int d = yyyymmdd % 100;
+    if (m < 1 || m > 12 || d < 1) return false;
+    static constexpr int kDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return d <= kDays[m - 1] + (m == 2 && leap ? 1 : 0);
+}
+
+int TradingCalendar::daysFromCivil(std::int32_t yyyymmdd)
+{
+    return timefmt::daysFromCivil(yyyymmdd / 10000, yyyymmdd / 100 % 100, yyyymmdd % 100);
+}
+
+std::int32_t TradingCalendar::civilFromDays(int days)
+{
+    int y = 0, m = 0, d = 0;
+    timefmt::civilFromDays(days, y, m, d);
+    return y * 10000 + m * 100 + d;
+}
+
+TradingCalendar::TradingCalendar(int firstYear, int lastYear,
+                                 const std::vector<std::int32_t>& holidays,
+                                 const std::vector<std::int32_t>& halfDays)
+{
+    if (lastYear < firstYear) {
+        throw std::invalid_argument("TradingCalendar: lastYear < firstYear");
+    }
+    firstDay_ = daysFromCivil(firstYear * 10000 + 101);
+    const int endDay = daysFromCivil((lastYear + 1) * 10000 + 101);
+    const int span = endDay - firstDay_;
+
+    for (const auto* list : {&holidays, &halfDays}) {
+        for (std::int32_t date : *list) {
+            if (!isValidDate(date)) {
+                throw std::invalid_argument("TradingCalendar: invalid date " + std::to_string(date));
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> closed(static_cast<std::size_t>(span), 0);
+    for (std::int32_t h : holidays) {
+        const int off = daysFromCivil(h) - firstDay_;
+        if (off >= 0 && off < span) closed[off] = 1;
+    }
+
+    std::vector<std::int32_t> sortedHalf(halfDays);
+    std::sort(sortedHalf.begin(), sortedHalf.end());
+
+    dayToIndex_.resize(static_cast<std::size_t>(span));
+    tradingDays_.reserve(static_cast<std::size_t>(span) * 5 / 7);
+    halfDay_.reserve(tradingDays_.capacity());
+
+    for (int off = 0; off < span; ++off) {
+        const int day = firstDay_ + off;
+        if (closed[off] || isWeekend(day)) {
+            // 非交易日：记录下一个交易日的序号，编码为负数
+            dayToIndex_[off] = -static_cast<std::int32_t>(tradingDays_.size()) - 1;
+            continue;
+        }
+        const std::int32_t date = civilFromDays(day);
+        dayToIndex_[off] = static_cast<std::int32_t>(tradingDays_.size());
+        tradingDays_.push_back(date);
+        halfDay_.push_back(std::binary_search(sortedHalf.begin(), sortedHalf.end(), date) ? 1 : 0);
+    }
+}
+
+TradingCalendar TradingCalendar::loadFromFile(const std::string& path, int firstYear, int lastYear)
+{
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("TradingCalendar: cannot open " + path);
+    }
+    std::vector<std::int32_t> holidays;
+    std::vector<std::int32_t> halfDays;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ss(line);
+        std::int32_t date = 0;
+        std::string tag;
+        if (!(ss >> date)) continue;
+        ss >> tag;
+        (tag == "half" ? halfDays : holidays).push_back(date);
+    }
+    return TradingCalendar(firstYear, lastYear, holidays, halfDays);
+}
+
+int TradingCalendar::dayOffset(std::int32_t date) const
+{
+    if (!isValidDate(date)) {
+        throw std::invalid_argument("TradingCalendar: invalid date " + std::to_string(date));
+    }
+    return daysFromCivil(date) - firstDay_;
+}
+
+int TradingCalendar::indexAtOrAfter(int off) const
+{
+    if (off < 0) return 0;
+    if (off >= static_cast<int>(dayToIndex_.size())) return static_cast<int>(tradingDays_.size());
+    const std::int32_t v = dayToIndex_[off];
+    return v >= 0 ? v : -v - 1;
+}
+
+bool TradingCalendar::isTradingDay(std::int32_t date) const
+{
+    return indexOf(date) >= 0;
+}
+
+bool TradingCalendar::isHalfDay(std::int32_t date) const
+{
+    const int idx = indexOf(date);
+    return idx >= 0 && halfDay_[idx] != 0;
+}
+
+int TradingCalendar::indexOf(std::int32_t date) const
+{
+    if (!isValidDate(date)) return -1;
+    const int off = daysFromCivil(date) - firstDay_;
+    if (off < 0 || off >= static_cast<int>(dayToIndex_.size())) return -1;
+    const std::int32_t v = dayToIndex_[off];
+    return v >= 0 ? v : -1;
+}
+
+std::int32_t TradingCalendar::dateAt(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(tradingDays_.size())) {
+        throw std::out_of_range("TradingCalendar: trading day index out of range");
+    }
+    return tradingDays_[index];
+}
+
+std::int32_t TradingCalendar::nextTradingDay(std::int32_t date) const
+{
+    const int next = indexAtOrAfter(dayOffset(date) + 1);
+    return next < static_cast<int>(tradingDays_.size()) ? tradingDays_[next] : 0;
+}
+
+std::int32_t TradingCalendar::prevTradingDay(std::int32_t date) const
+{
+    const int prev = indexAtOrAfter(dayOffset(date)) - 1;
+    return prev >= 0 ? tradingDays_[prev] : 0;
+}
+
+std::int32_t TradingCalendar::onOrAfter(std::int32_t date) const
+{
+    const int next = indexAtOrAfter(dayOffset(date));
+    return next < static_cast<int>(tradingDays_.size()) ? tradingDays_[next] : 0;
+}
+
+std::int32_t TradingCalendar::addTradingDays(std::int32_t date, int n) const
+{
+    const int idx = indexOf(date);
+    if (idx < 0) {
+        throw std::invalid_argument("TradingCalendar::addTradingDays: " + std::to_string(date) + " is not a trading day");
+    }
+    return dateAt(idx + n);
+}
+
+int TradingCalendar::tradingDaysBetween(std::int32_t from, std::int32_t to) const
+{
+    if (to < from) return 0;
+    const int lower = indexAtOrAfter(dayOffset(from));
+    const int upper = indexAtOrAfter(dayOffset(to) + 1);
+    return std::max(0, upper - lower);
+}
+
+int TradingCalendar::minuteOfSession(int hhmm)
+{
+    const int h = hhmm / 100;
+    const int m = hhmm % 100;
+    if (h < 0 || h >= 24 || m < 0 || m >= 60) return -1;
+    return minuteTable()[h * 60 + m];
+}
+
+int TradingCalendar::timeOfMinute(int minuteIndex)
+{
+    if (minuteIndex < 0 || minuteIndex >= kMinutesPerSession) return -1;
+    const int base = minuteIndex < kMinutesPerHalfDay ? 9 * 60 + 31 : 13 * 60 + 1 - kMinutesPerHalfDay;
+    const int m = base + minuteIndex;
+    return (m / 60) * 100 + m % 60;
+}
+
+std::int64_t TradingCalendar::sessionOffset(std::int32_t date, int hhmm) const
+{
+    const int idx = indexOf(date);
+    const int minute = minuteOfSession(hhmm);
+    if (idx < 0 || minute < 0) return -1;
+    if (halfDay_[idx] && minute >= kMinutesPerHalfDay) return -1;
+    return static_cast<std::int64_t>(idx) * kMinutesPerSession + minute;
+}
+
+int TradingCalendar::minutesInDay(std::int32_t date) const
+{
+    const int idx = indexOf(date);
+    if (idx < 0) return 0;
+    return halfDay_[idx] ? kMinutesPerHalfDay : kMinutesPerSession;
+}
+
+} // namespace market
+} // namespace domain
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace domain {
+namespace model {
+
+// 历史窗口：指向 BarHistory 底层存储的只读视图（零拷贝）
+// - 按时间顺序排列，[0] 为最早的一根，back() 为当前 bar
+// - ago(k) 按"k 根之前"访问，ago(0) == back()
+// - 只在下一次 advance() 之前有效；Debug 下访问过期窗口会触发断言
+// - epoch 放在与 BarHistory 共享的堆单元里：BarHistory 被移动后窗口仍然跟随新的所有者，
+//   被销毁时 epoch 前进，窗口变为无效而不是悬空
+template <typename T>
+class HistoryWindow {
+public:
+    using value_type = T;
+    using const_iterator = const T*;
+
+    HistoryWindow() = default;
+
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const_iterator begin() const { checkValid(); return data_; }
+    const_iterator end() const { checkValid(); return data_ + size_; }
+
+    const T& operator[](std::size_t i) const {
+        checkValid();
+        assert(i < size_);
+        return data_[i];
+    }
+
+    const T& at(std::size_t i) const {
+        checkValid();
+        if (i >= size_) {
+            throw std::out_of_range("HistoryWindow::at index " + std::to_string(i) +
+                                    " out of range " + std::to_string(size_));
+        }
+        return data_[i];
+    }
+
+    const T& ago(std::size_t k) const { return at(size_ - 1 - k); }
+    const T& front() const { return at(0); }
+    const T& back() const { return at(size_ - 1); }
+
+    // 取更短的尾部子窗口，例如 window(60).last(20)
+    HistoryWindow last(std::size_t n) const {
+        checkValid();
+        if (n > size_) n = size_;
+        return HistoryWindow(data_ + (size_ - n), n, epoch_, epochRef_);
+    }
+
+    // 是否仍然有效（底层游标未前进、BarHistory 未销毁）
+    bool valid() const { return epochRef_ == nullptr || *epochRef_ == epoch_; }
+
+private:
+    template <typename> friend class BarHistory;
+
+    HistoryWindow(const T* data, std::size_t size, std::uint64_t epoch,
+                  std::shared_ptr<const std::uint64_t> epochRef)
+        : data_(data), size_(size), epoch_(epoch), epochRef_(std::move(epochRef)) {}
+
+    void checkValid() const {
+        assert(valid() && "HistoryWindow used after BarHistory advanced");
+    }
+
+    const T* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::uint64_t epoch_ = 0;
+    std::shared_ptr<const std::uint64_t> epochRef_;
+};
+
+// 单个标的的 bar 历史存储 + 仿真游标
+// 数据可以整体预加载（回测）或逐根追加（实时），但策略/指标能看到的范围
+// 永远是 [0, cursor]，从结构上杜绝未来函数（lookahead bias）
+template <typename T>
+class BarHistory {
+public:
+    BarHistory() = default;
+    explicit BarHistory(std::vector<T> bars) : bars_(std::move(bars)) {}
+
+    BarHistory(const BarHistory&) = delete;
+    BarHistory& operator=(const BarHistory&) = delete;
+    // 移动时 epoch 单元随数据一起转移，已发出的窗口继续有效；源对象换一个新单元
+    BarHistory(BarHistory&& other)
+        : bars_(std::move(other.bars_)), visible_(other.visible_), epoch_(std::move(other.epoch_)) {
+        other.bars_.clear();
+        other.visible_ = 0;
+        other.epoch_ = std::make_shared<std::uint64_t>(0);
+    }
+    BarHistory& operator=(BarHistory&& other) {
+        if (this != &other) {
+            ++*epoch_;   // 本对象原先发出的窗口失效
+            bars_ = std::move(other.bars_);
+            visible_ = other.visible_;
+            epoch_ = std::move(other.epoch_);
+            other.bars_.clear();
+            other.visible_ = 0;
+            other.epoch_ = std::make_shared<std::uint64_t>(0);
+        }
+        return *this;
+    }
+    ~BarHistory() {
+        if (epoch_) ++*epoch_;
+    }
+
+    void reserve(std::size_t n) { bars_.reserve(n); }
+
+    // 实时模式逐根追加；vector 扩容会使已发出的窗口失效，因此推进 epoch
+    void append(const T& bar) {
+        if (bars_.size() == bars_.capacity()) ++*epoch_;
+        bars_.push_back(bar);
+    }
+
+    // 推进一根 bar；没有更多数据时返回 false
+    bool advance() {
+        if (visible_ >= bars_.size()) return false;
+        ++visible_;
+        ++*epoch_;
+        return true;
+    }
+
+    // 回到起点（重新回测时使用）
+    void rewind() {
+        visible_ = 0;
+        ++*epoch_;
+    }
+
+    // 当前可见的 bar 数量（游标位置 + 1）
+    std::size_t visibleCount() const { return visible_; }
+    std::size_t totalCount() const { return bars_.size(); }
+    bool hasCurrent() const { return visible_ > 0; }
+
+    const T& current() const {
+        if (visible_ == 0) throw std::out_of_range("BarHistory::current before first advance");
+        return bars_[visible_ - 1];
+    }
+
+    // 最近 n 根（包含当前 bar），n 超过可见数量时抛出异常
+    HistoryWindow<T> window(std::size_t n) const {
+        if (n > visible_) {
+            throw std::out_of_range("BarHistory::window requested " + std::to_string(n) +
+                                    " bars, only " + std::to_string(visible_) + " visible");
+        }
+        return HistoryWindow<T>(bars_.data() + (visible_ - n), n, *epoch_, epoch_);
+    }
+
+    // 最近至多 n 根，数据不足时返回较短窗口（预热期使用）
+    HistoryWindow<T> windowUpTo(std::size_t n) const {
+        return window(n < visible_ ? n : visible_);
+    }
+
+    // 全部可见历史
+    HistoryWindow<T> all() const { return window(visible_); }
+
+private:
+    std::vector<T> bars_;
+    std::size_t visible_ = 0;
+    std::shared_ptr<std::uint64_t> epoch_ = std::make_shared<std::uint64_t>(0);
+};
+
+} // namespace model
+} // namespace domain
@@ -0,0 +1,132 @@
+// 全市场交叉信号：逐标的逐 bar 标量循环 vs batchCross 位图批量计算
+// 用法：BatchSignalsBench [symbols] [bars]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "BatchSignals.h"
+
+using namespace domain::signals;
+
+namespace {
+
+// 价格矩阵与其 5/20 日均线，前 19 列均线为 NaN（预热期），固定种子保证可复现
+struct Universe {
+    std::size_t rows;
+    std::size_t cols;
+    std::vector<double> fast;
+    std::vector<double> slow;
+};
+
+Universe makeUniverse(std::size_t rows, std::size_t cols)
+{
+    Universe u{rows, cols, std::vector<double>(rows * cols), std::vector<double>(rows * cols)};
+    std::mt19937_64 rng(20240101);
+    std::normal_distribution<double> z(0.0, 0.02);
+    std::vector<double> close(cols);
+    for (std::size_t r = 0; r < rows; ++r) {
+        double p = 10.0;
+        for (auto& c : close) {
+            p *= std::exp(z(rng));
+            c = p;
+        }
+        double s5 = 0.0;
+        double s20 = 0.0;
+        for (std::size_t t = 0; t < cols; ++t) {
+            s5 += close[t] - (t >= 5 ? close[t - 5] : 0.0);
+            s20 += close[t] - (t >= 20 ? close[t - 20] : 0.0);
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            u.fast[r * cols + t] = t >= 4 ? s5 / 5.0 : nan;
+            u.slow[r * cols + t] = t >= 19 ? s20 / 20.0 : nan;
+        }
+    }
+    return u;
+}
+
+// 与 CrossSignal 逐 bar 更新同构的标量版本：每个标的一个状态机，产生事件列表
+std::vector<SignalEvent> scalarCross(const Universe& u)
+{
+    std::vector<SignalEvent> events;
+    for (std::size_t r = 0; r < u.rows; ++r) {
+        const double* f = u.fast.data() + r * u.cols;
+        const double* s = u.slow.data() + r * u.cols;
+        bool hasPrev = false;
+        bool prevAbove = false;
+        for (std::size_t t = 0; t < u.cols; ++t) {
+            if (std::isnan(f[t]) || std::isnan(s[t])) {
+                hasPrev = false;
+                continue;
+            }
+            const bool above = f[t] > s[t];
+            if (hasPrev && above != prevAbove) {
+                events.push_back({static_cast<std::uint32_t>(r), static_cast<std::uint32_t>(t),
+                                  static_cast<std::int8_t>(above ? 1 : -1)});
+            }
+            prevAbove = above;
+            hasPrev = true;
+        }
+    }
+    return events;
+}
+
+template <typename F>
+double bestMs(int rounds, F&& run)
+{
+    double best = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 5000;
+    const std::size_t bars = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 2500;
+    const Universe u = makeUniverse(symbols, bars);
+    constexpr int kRounds = 5;
+
+    std::vector<SignalEvent> scalarEvents;
+    std::vector<SignalEvent> batchEvents;
+    std::size_t bitmapCount = 0;
+
+    const double scalar = bestMs(kRounds, [&] { scalarEvents = scalarCross(u); });
+    const double bitmap = bestMs(kRounds, [&] {
+        const CrossResult r = batchCross(SeriesMatrix(u.fast.data(), u.rows, u.cols),
+                                         SeriesMatrix(u.slow.data(), u.rows, u.cols));
+        bitmapCount = r.up.count() + r.down.count();
+    });
+    const double withEvents = bestMs(kRounds, [&] {
+        batchEvents = batchCross(SeriesMatrix(u.fast.data(), u.rows, u.cols),
+                                 SeriesMatrix(u.slow.data(), u.rows, u.cols)).events();
+    });
+
+    bool same = scalarEvents.size() == batchEvents.size() && bitmapCount == batchEvents.size();
+    for (std::size_t i = 0; same && i < scalarEvents.size(); ++i) {
+        same = scalarEvents[i].symbol == batchEvents[i].symbol && scalarEvents[i].time == batchEvents[i].time &&
+               scalarEvents[i].direction == batchEvents[i].direction;
+    }
+    if (!same) {
+        std::fprintf(stderr, "result mismatch: scalar %zu events, batch %zu events\n", scalarEvents.size(),
+                     batchEvents.size());
+        return 1;
+    }
+
+    std::printf("{\"bench\":\"batch_cross\",\"symbols\":%zu,\"bars\":%zu,\"events\":%zu,"
+                "\"scalar_ms\":%.3f,\"bitmap_ms\":%.3f,\"bitmap_events_ms\":%.3f,"
+                "\"speedup\":%.2f,\"speedup_with_events\":%.2f}\n",
+                symbols, bars, scalarEvents.size(), scalar, bitmap, withEvents, scalar / bitmap,
+                scalar / withEvents);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace domain {
+namespace signals {
+
+// 全市场批量信号计算
+// CrossSignal / ThresholdSignal 按单条序列逐 bar 计算，适合回测；
+// 选股/筛选场景需要对 "标的 × 时间" 整个矩阵一次算完，这里提供批量版本：
+//   - 输入为按标的连续存放的矩阵（row = 标的，col = 时间），NaN 表示无数据/预热期
+//   - 比较用 SIMD 一次处理多列，结果直接压成位图（每个 bar 1 bit）
+//   - 需要事件列表时再从位图稀疏展开
+
+// 只读矩阵视图，rowStride 为相邻两行首元素之间的元素个数（默认等于 cols）
+struct SeriesMatrix {
+    const double* data = nullptr;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t rowStride = 0;
+
+    SeriesMatrix() = default;
+    SeriesMatrix(const double* d, std::size_t r, std::size_t c, std::size_t stride = 0)
+        : data(d), rows(r), cols(c), rowStride(stride ? stride : c) {}
+
+    const double* row(std::size_t r) const { return data + r * rowStride; }
+};
+
+// 信号事件（稀疏形式）
+struct SignalEvent {
+    std::uint32_t symbol;   // 行号
+    std::uint32_t time;     // 列号
+    std::int8_t direction;  // +1 上穿 / -1 下穿
+};
+
+// 标的 × 时间 位图，每行按 64 位对齐
+class SignalBitset {
+public:
+    SignalBitset() = default;
+    SignalBitset(std::size_t rows, std::size_t cols);
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t wordsPerRow() const { return wordsPerRow_; }
+
+    bool test(std::size_t row, std::size_t col) const {
+        return (rowWords(row)[col >> 6] >> (col & 63)) & 1u;
+    }
+    void set(std::size_t row, std::size_t col) {
+        rowWords(row)[col >> 6] |= std::uint64_t(1) << (col & 63);
+    }
+
+    std::uint64_t* rowWords(std::size_t row) { return words_.data() + row * wordsPerRow_; }
+    const std::uint64_t* rowWords(std::size_t row) const { return words_.data() + row * wordsPerRow_; }
+
+    // 置位总数 / 某一行置位数
+    std::size_t count() const;
+    std::size_t countRow(std::size_t row) const;
+    // 某一行最后一个置位列，没有返回 -1（"最近一次金叉在哪天"）
+    long long lastSetInRow(std::size_t row) const;
+
+    // 展开成事件列表，direction 由调用方指定
+    void appendEvents(std::vector<SignalEvent>& out, std::int8_t direction) const;
+
+private:
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t wordsPerRow_ = 0;
+    std::vector<std::uint64_t> words_;
+};
+
+// 交叉结果：上穿 / 下穿 各一张位图
+struct CrossResult {
+    SignalBitset up;
+    SignalBitset down;
+
+    // 合并成按 (symbol, time) 排序的事件列表
+    std::vector<SignalEvent> events() const;
+};
+
+// fast 上穿/下穿 slow：
+//   上穿 t：fast[t] > slow[t] 且 fast[t-1] <= slow[t-1]
+//   下穿 t：fast[t] <= slow[t] 且 fast[t-1] > slow[t-1]
+// 任一端为 NaN 的 bar 不产生信号；两个矩阵形状必须一致
+CrossResult batchCross(const SeriesMatrix& fast, const SeriesMatrix& slow);
+
+// 与固定阈值比较（例如 RSI 与 70）：上穿/下穿 threshold
+CrossResult batchThresholdCross(const SeriesMatrix& values, double threshold);
+// 每个标的一个阈值，thresholds 长度等于行数
+CrossResult batchThresholdCross(const SeriesMatrix& values, const double* thresholds);
+
+// 电平位图：values > threshold 的所有 bar
+SignalBitset batchAbove(const SeriesMatrix& values, double threshold);
+// 电平位图：values < threshold 的所有 bar
+SignalBitset batchBelow(const SeriesMatrix& values, double threshold);
+
+} // namespace signals
+} // namespace domain
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BatchSignals.h"
+
+namespace domain {
+namespace signals {
+
+// 信号表达式
+// 用一行表达式组合信号，不再需要为每种组合写 C++：
+//
+//   cross(sma(close, 5), sma(close, 20)) & close > threshold
+//   count(close > ref(close, 1), 5) >= 3          // 5 根里至少 3 根上涨（N-of-M）
+//   ref(cross(ema(close, 12), ema(close, 26)), 2) & volume > sma(volume, 20)   // 滞后确认
+//
+// 编译后是一张扁平的指令表（拓扑序），所有名字在编译期解析成下标，
+// 相同子表达式只计算一次（例如上面的 sma(volume, 20) 与其它地方共用）。
+// 同一张表既可以逐 bar 流式计算（SignalStream），也可以对整列/全市场批量计算。
+//
+// 语法：
+//   运算符（优先级从低到高）：|  &  比较(> >= < <= == !=)  + -  * /  一元(! -)
+//   函数：sma(x,n) ema(x,n) ref(x,n) cross(a,b) crossunder(a,b) count(cond,n)
+//         abs(x) min(a,b) max(a,b)
+//   标识符：编译时给定的行情字段，或参数表中的常量
+//
+// 取值约定：布尔结果为 0/1；算术遇到 NaN 传播 NaN；比较/逻辑遇到 NaN 结果为 0
+// 窗口函数 sma/ema/count 与 IndicatorCache、StaticPipeline 一致：凑满 n 个有效输入之前为 NaN，
+// NaN 输入跳过（不进入窗口），输出保持上一个值；ref 按 bar 滞后，不跳过 NaN
+class SignalExpression {
+public:
+    enum class Op : std::uint8_t {
+        Input, Const,
+        Add, Sub, Mul, Div, Neg,
+        Gt, Ge, Lt, Le, Eq, Ne,
+        And, Or, Not,
+        Abs, Min, Max,
+        Sma, Ema, Ref, Cross, CrossUnder, Count
+    };
+
+    struct Instr {
+        Op op;
+        std::int32_t a = -1;      // 第一个操作数的指令号
+        std::int32_t b = -1;      // 第二个操作数的指令号
+        std::int32_t period = 0;  // 窗口参数；Input 时为字段下标
+        double value = 0.0;       // Const 的值
+    };
+
+    // 括号/函数调用/一元运算的最大嵌套层数
+    static constexpr std::size_t kMaxDepth = 256;
+
+    // fields: 行情字段名，顺序即批量/流式计算时输入列的顺序
+    // params: 表达式中可引用的常量参数
+    // 语法错误、未知名字或嵌套超过 kMaxDepth 抛 std::invalid_argument，消息带出错位置（" at <偏移>"）
+    static SignalExpression compile(const std::string& text,
+                                    const std::vector<std::string>& fields,
+                                    const std::unordered_map<std::string, double>& params = {});
+
+    const std::string& text() const { return text_; }
+    const std::vector<std::string>& fields() const { return fields_; }
+    const std::vector<Instr>& plan() const { return plan_; }
+    std::size_t instructionCount() const { return plan_.size(); }
+    // 计算结果需要的最少历史 bar 数（预热期）
+    std::size_t warmup() const { return warmup_; }
+
+    // 单条序列批量计算：columns[i] 指向第 i 个字段的 n 个值，结果写入 out
+    void evaluate(const double* const* columns, std::size_t n, double* out) const;
+
+    // 全市场批量计算：每个字段一个矩阵（形状一致），返回结果为真的位图
+    SignalBitset evaluateUniverse(const std::vector<SeriesMatrix>& fields) const;
+
+    // 打印指令表，调试用
+    std::string describe() const;
+
+private:
+    std::string text_;
+    std::vector<std::string> fields_;
+    std::vector<Instr> plan_;
+    std::size_t warmup_ = 0;
+};
+
+// 流式计算器：每来一根 bar 调用一次 update，内部维护各个窗口函数的滚动状态
+// 与 SignalExpression::evaluate 的逐点结果完全一致
+class SignalStream {
+public:
+    explicit SignalStream(const SignalExpression& expr);
+    ~SignalStream();
+
+    SignalStream(SignalStream&&) noexcept;
+    SignalStream& operator=(SignalStream&&) noexcept;
+
+    // barFields[i] 为第 i 个字段在当前 bar 的值；返回表达式结果
+    double update(const double* barFields);
+    // 最近一次 update 的结果是否为真
+    bool signal() const;
+    void reset();
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+} // namespace signals
+} // namespace domain
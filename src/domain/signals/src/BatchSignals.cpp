@@ -0,0 +1,265 @@
+#include "BatchSignals.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "foundation/log/instrumentation.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ASTOCK_BATCH_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define ASTOCK_BATCH_SSE2 1
+#endif
+
+namespace domain {
+namespace signals {
+
+namespace {
+
+enum class CmpOp { Greater, Less };
+
+inline int popcount64(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline int highestBit(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int n = 0;
+    while (x >>= 1) ++n;
+    return n;
+#endif
+}
+
+inline int lowestBit(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while ((x & 1u) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// 把一行比较结果压成位图：
+//   cmpBits   : a[i] op b[i]（NaN 为 false）
+//   validBits : a[i]、b[i] 都不是 NaN
+// b 为空时与标量 scalar 比较
+template <CmpOp Op>
+void compareRow(const double* a, const double* b, double scalar, std::size_t n,
+                std::uint64_t* cmpBits, std::uint64_t* validBits)
+{
+    std::size_t i = 0;
+
+#if defined(ASTOCK_BATCH_AVX)
+    const __m256d vs = _mm256_set1_pd(scalar);
+    for (; i + 4 <= n; i += 4) {
+        const __m256d va = _mm256_loadu_pd(a + i);
+        const __m256d vb = b ? _mm256_loadu_pd(b + i) : vs;
+        const __m256d c = (Op == CmpOp::Greater) ? _mm256_cmp_pd(va, vb, _CMP_GT_OQ)
+                                                 : _mm256_cmp_pd(va, vb, _CMP_LT_OQ);
+        const __m256d o = _mm256_cmp_pd(va, vb, _CMP_ORD_Q);
+        const std::size_t word = i >> 6;
+        const unsigned shift = static_cast<unsigned>(i & 63);
+        cmpBits[word] |= static_cast<std::uint64_t>(_mm256_movemask_pd(c)) << shift;
+        validBits[word] |= static_cast<std::uint64_t>(_mm256_movemask_pd(o)) << shift;
+    }
+#elif defined(ASTOCK_BATCH_SSE2)
+    const __m128d vs = _mm_set1_pd(scalar);
+    for (; i + 2 <= n; i += 2) {
+        const __m128d va = _mm_loadu_pd(a + i);
+        const __m128d vb = b ? _mm_loadu_pd(b + i) : vs;
+        const __m128d c = (Op == CmpOp::Greater) ? _mm_cmpgt_pd(va, vb) : _mm_cmplt_pd(va, vb);
+        const __m128d o = _mm_cmpord_pd(va, vb);
+        const std::size_t word = i >> 6;
+        const unsigned shift = static_cast<unsigned>(i & 63);
+        cmpBits[word] |= static_cast<std::uint64_t>(_mm_movemask_pd(c)) << shift;
+        validBits[word] |= static_cast<std::uint64_t>(_mm_movemask_pd(o)) << shift;
+    }
+#endif
+
+    for (; i < n; ++i) {
+        const double x = a[i];
+        const double y = b ? b[i] : scalar;
+        const bool c = (Op == CmpOp::Greater) ? (x > y) : (x < y);
+        const bool o = (x == x) && (y == y);
+        cmpBits[i >> 6] |= static_cast<std::uint64_t>(c) << (i & 63);
+        validBits[i >> 6] |= static_cast<std::uint64_t>(o) << (i & 63);
+    }
+}
+
+// 由 "在上方" 位图推导上穿/下穿：整字移位即可得到前一个 bar 的状态
+void crossFromBits(const std::uint64_t* above, const std::uint64_t* valid, std::size_t words,
+                   std::uint64_t* up, std::uint64_t* down)
+{
+    std::uint64_t carryAbove = 0;
+    std::uint64_t carryValid = 0;
+    for (std::size_t w = 0; w < words; ++w) {
+        const std::uint64_t prevAbove = (above[w] << 1) | carryAbove;
+        const std::uint64_t prevValid = (valid[w] << 1) | carryValid;
+        const std::uint64_t both = valid[w] & prevValid;
+        up[w] = above[w] & ~prevAbove & both;
+        down[w] = ~above[w] & prevAbove & both;
+        carryAbove = above[w] >> 63;
+        carryValid = valid[w] >> 63;
+    }
+}
+
+void checkSameShape(const SeriesMatrix& a, const SeriesMatrix& b)
+{
+    if (a.rows != b.rows || a.cols != b.cols) {
+        throw std::invalid_argument("batchCross: matrix shapes differ");
+    }
+}
+
+// rowThreshold(r) 返回第 r 行的阈值；rowOther 为空表示和阈值比较
+template <typename ThresholdFn>
+CrossResult crossImpl(const SeriesMatrix& values, const SeriesMatrix* other, ThresholdFn rowThreshold)
+{
+    ENGINE_PROBE(foundation::metrics::Stage::SignalEval);
+    CrossResult result{SignalBitset(values.rows, values.cols), SignalBitset(values.rows, values.cols)};
+    const std::size_t words = result.up.wordsPerRow();
+    std::vector<std::uint64_t> above(words);
+    std::vector<std::uint64_t> valid(words);
+
+    for (std::size_t r = 0; r < values.rows; ++r) {
+        std::fill(above.begin(), above.end(), 0);
+        std::fill(valid.begin(), valid.end(), 0);
+        compareRow<CmpOp::Greater>(values.row(r), other ? other->row(r) : nullptr, rowThreshold(r),
+                                   values.cols, above.data(), valid.data());
+        crossFromBits(above.data(), valid.data(), words, result.up.rowWords(r), result.down.rowWords(r));
+    }
+    return result;
+}
+
+template <CmpOp Op>
+SignalBitset levelImpl(const SeriesMatrix& values, double threshold)
+{
+    ENGINE_PROBE(foundation::metrics::Stage::SignalEval);
+    SignalBitset bits(values.rows, values.cols);
+    std::vector<std::uint64_t> valid(bits.wordsPerRow());
+    for (std::size_t r = 0; r < values.rows; ++r) {
+        std::fill(valid.begin(), valid.end(), 0);
+        compareRow<Op>(values.row(r), nullptr, threshold, values.cols, bits.rowWords(r), valid.data());
+    }
+    return bits;
+}
+
+} // namespace
+
+// ==================== SignalBitset ====================
+
+SignalBitset::SignalBitset(std::size_t rows, std::size_t cols)
+    : rows_(rows), cols_(cols), wordsPerRow_((cols + 63) / 64), words_(rows * ((cols + 63) / 64), 0)
+{
+}
+
+std::size_t SignalBitset::count() const
+{
+    std::size_t n = 0;
+    for (std::uint64_t w : words_) n += static_cast<std::size_t>(popcount64(w));
+    return n;
+}
+
+std::size_t SignalBitset::countRow(std::size_t row) const
+{
+    std::size_t n = 0;
+    const std::uint64_t* words = rowWords(row);
+    for (std::size_t w = 0; w < wordsPerRow_; ++w) n += static_cast<std::size_t>(popcount64(words[w]));
+    return n;
+}
+
+long long SignalBitset::lastSetInRow(std::size_t row) const
+{
+    const std::uint64_t* words = rowWords(row);
+    for (std::size_t w = wordsPerRow_; w-- > 0;) {
+        if (words[w]) return static_cast<long long>(w * 64 + static_cast<std::size_t>(highestBit(words[w])));
+    }
+    return -1;
+}
+
+void SignalBitset::appendEvents(std::vector<SignalEvent>& out, std::int8_t direction) const
+{
+    for (std::size_t r = 0; r < rows_; ++r) {
+        const std::uint64_t* words = rowWords(r);
+        for (std::size_t w = 0; w < wordsPerRow_; ++w) {
+            std::uint64_t bits = words[w];
+            while (bits) {
+                const int b = lowestBit(bits);
+                out.push_back({static_cast<std::uint32_t>(r), static_cast<std::uint32_t>(w * 64 + b), direction});
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+// ==================== CrossResult ====================
+
+std::vector<SignalEvent> CrossResult::events() const
+{
+    // 同一 bar 不可能既上穿又下穿：逐字合并两张位图即按 (symbol, time) 有序，无需排序
+    std::vector<SignalEvent> out;
+    out.reserve(up.count() + down.count());
+    const std::size_t words = up.wordsPerRow();
+    for (std::size_t r = 0; r < up.rows(); ++r) {
+        const std::uint64_t* u = up.rowWords(r);
+        const std::uint64_t* d = down.rowWords(r);
+        for (std::size_t w = 0; w < words; ++w) {
+            std::uint64_t bits = u[w] | d[w];
+            while (bits) {
+                const int b = lowestBit(bits);
+                const std::int8_t dir = ((u[w] >> b) & 1u) ? std::int8_t(1) : std::int8_t(-1);
+                out.push_back({static_cast<std::uint32_t>(r), static_cast<std::uint32_t>(w * 64 + b), dir});
+                bits &= bits - 1;
+            }
+        }
+    }
+    return out;
+}
+
+// ==================== 批量计算 ====================
+
+CrossResult batchCross(const SeriesMatrix& fast, const SeriesMatrix& slow)
+{
+    checkSameShape(fast, slow);
+    return crossImpl(fast, &slow, [](std::size_t) { return 0.0; });
+}
+
+CrossResult batchThresholdCross(const SeriesMatrix& values, double threshold)
+{
+    return crossImpl(values, nullptr, [threshold](std::size_t) { return threshold; });
+}
+
+CrossResult batchThresholdCross(const SeriesMatrix& values, const double* thresholds)
+{
+    return crossImpl(values, nullptr, [thresholds](std::size_t r) { return thresholds[r]; });
+}
+
+SignalBitset batchAbove(const SeriesMatrix& values, double threshold)
+{
+    return levelImpl<CmpOp::Greater>(values, threshold);
+}
+
+SignalBitset batchBelow(const SeriesMatrix& values, double threshold)
+{
+    return levelImpl<CmpOp::Less>(values, threshold);
+}
+
+} // namespace signals
+} // namespace domain
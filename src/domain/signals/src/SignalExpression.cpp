@@ -0,0 +1,688 @@
+#include "SignalExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "foundation/log/instrumentation.hpp"
+
+namespace domain {
+namespace signals {
+
+namespace {
+
+using Op = SignalExpression::Op;
+using Instr = SignalExpression::Instr;
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+inline bool truthy(double x) { return x != 0.0 && !std::isnan(x); }
+inline double boolValue(bool b) { return b ? 1.0 : 0.0; }
+
+const char* opName(Op op)
+{
+    switch (op) {
+    case Op::Input: return "input";
+    case Op::Const: return "const";
+    case Op::Add: return "add";
+    case Op::Sub: return "sub";
+    case Op::Mul: return "mul";
+    case Op::Div: return "div";
+    case Op::Neg: return "neg";
+    case Op::Gt: return "gt";
+    case Op::Ge: return "ge";
+    case Op::Lt: return "lt";
+    case Op::Le: return "le";
+    case Op::Eq: return "eq";
+    case Op::Ne: return "ne";
+    case Op::And: return "and";
+    case Op::Or: return "or";
+    case Op::Not: return "not";
+    case Op::Abs: return "abs";
+    case Op::Min: return "min";
+    case Op::Max: return "max";
+    case Op::Sma: return "sma";
+    case Op::Ema: return "ema";
+    case Op::Ref: return "ref";
+    case Op::Cross: return "cross";
+    case Op::CrossUnder: return "crossunder";
+    case Op::Count: return "count";
+    }
+    return "?";
+}
+
+bool isStateful(Op op)
+{
+    return op == Op::Sma || op == Op::Ema || op == Op::Ref || op == Op::Cross ||
+           op == Op::CrossUnder || op == Op::Count;
+}
+
+// 无状态运算的逐点定义，批量与流式共用
+inline double applyScalar(Op op, double x, double y)
+{
+    switch (op) {
+    case Op::Add: return x + y;
+    case Op::Sub: return x - y;
+    case Op::Mul: return x * y;
+    case Op::Div: return x / y;
+    case Op::Neg: return -x;
+    case Op::Gt: return boolValue(x > y);
+    case Op::Ge: return boolValue(x >= y);
+    case Op::Lt: return boolValue(x < y);
+    case Op::Le: return boolValue(x <= y);
+    case Op::Eq: return boolValue(x == y);
+    case Op::Ne: return boolValue(x != y && !std::isnan(x) && !std::isnan(y));
+    case Op::And: return boolValue(truthy(x) && truthy(y));
+    case Op::Or: return boolValue(truthy(x) || truthy(y));
+    case Op::Not: return boolValue(!truthy(x));
+    case Op::Abs: return std::fabs(x);
+    case Op::Min: return (std::isnan(x) || std::isnan(y)) ? kNaN : std::min(x, y);
+    case Op::Max: return (std::isnan(x) || std::isnan(y)) ? kNaN : std::max(x, y);
+    default: return kNaN;
+    }
+}
+
+// 窗口函数的滚动状态
+// sma/ema/count 与 IndicatorCache、StaticPipeline 的规则相同：NaN 输入跳过（不进入窗口、不计数），
+// 输出保持上一个值；凑满 period 个有效输入之前输出 NaN
+struct Rolling {
+    std::vector<double> ring;
+    double sum = 0.0;
+    double ema = 0.0;
+    double prevA = kNaN;
+    double prevB = kNaN;
+    double last = kNaN;
+    std::int64_t count = 0;
+    std::size_t pos = 0;
+
+    void init(const Instr& in) {
+        ring.assign((in.op == Op::Sma || in.op == Op::Ref || in.op == Op::Count) ? static_cast<std::size_t>(in.period) : 0, 0.0);
+        sum = 0.0;
+        ema = 0.0;
+        prevA = prevB = kNaN;
+        last = kNaN;
+        count = 0;
+        pos = 0;
+    }
+
+    double step(const Instr& in, double x, double y) {
+        switch (in.op) {
+        case Op::Sma: {
+            if (std::isnan(x)) return last;
+            sum += x - ring[pos];
+            ring[pos] = x;
+            pos = (pos + 1) % ring.size();
+            ++count;
+            last = count >= in.period ? sum / in.period : kNaN;
+            return last;
+        }
+        case Op::Ema: {
+            if (std::isnan(x)) return last;
+            const double alpha = 2.0 / (in.period + 1.0);
+            ema = (count == 0) ? x : ema + alpha * (x - ema);
+            ++count;
+            last = count >= in.period ? ema : kNaN;
+            return last;
+        }
+        case Op::Ref: {
+            const double out = count >= in.period ? ring[pos] : kNaN;
+            ring[pos] = x;
+            pos = (pos + 1) % ring.size();
+            ++count;
+            return out;
+        }
+        case Op::Cross:
+        case Op::CrossUnder: {
+            const bool valid = !std::isnan(x) && !std::isnan(y) && !std::isnan(prevA) && !std::isnan(prevB);
+            const bool above = x > y;
+            const bool prevAbove = prevA > prevB;
+            prevA = x;
+            prevB = y;
+            if (!valid) return 0.0;
+            return boolValue(in.op == Op::Cross ? (above && !prevAbove) : (!above && prevAbove));
+        }
+        case Op::Count: {
+            if (std::isnan(x)) return last;
+            const double v = boolValue(truthy(x));
+            sum += v - ring[pos];
+            ring[pos] = v;
+            pos = (pos + 1) % ring.size();
+            ++count;
+            last = count >= in.period ? sum : kNaN;
+            return last;
+        }
+        default:
+            return kNaN;
+        }
+    }
+};
+
+// ==================== 词法 ====================
+
+enum class Tok { End, Number, Ident, LParen, RParen, Comma, Operator };
+
+struct Token {
+    Tok kind = Tok::End;
+    std::string text;
+    double number = 0.0;
+    std::size_t pos = 0;
+};
+
+class Lexer {
+public:
+    explicit Lexer(const std::string& s) : s_(s) {}
+
+    Token next() {
+        while (i_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[i_]))) ++i_;
+        Token t;
+        t.pos = i_;
+        if (i_ >= s_.size()) return t;
+
+        const char c = s_[i_];
+        if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && i_ + 1 < s_.size() && std::isdigit(static_cast<unsigned char>(s_[i_ + 1])))) {
+            char* end = nullptr;
+            t.number = std::strtod(s_.c_str() + i_, &end);
+            t.kind = Tok::Number;
+            t.text = s_.substr(i_, static_cast<std::size_t>(end - (s_.c_str() + i_)));
+            i_ = static_cast<std::size_t>(end - s_.c_str());
+            return t;
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            const std::size_t start = i_;
+            while (i_ < s_.size() && (std::isalnum(static_cast<unsigned char>(s_[i_])) || s_[i_] == '_' || s_[i_] == '.')) ++i_;
+            t.kind = Tok::Ident;
+            t.text = s_.substr(start, i_ - start);
+            return t;
+        }
+        if (c == '(') { ++i_; t.kind = Tok::LParen; t.text = "("; return t; }
+        if (c == ')') { ++i_; t.kind = Tok::RParen; t.text = ")"; return t; }
+        if (c == ',') { ++i_; t.kind = Tok::Comma; t.text = ","; return t; }
+
+        static const char* const kTwoChar[] = {">=", "<=", "==", "!=", "&&", "||"};
+        for (const char* op : kTwoChar) {
+            if (s_.compare(i_, 2, op) == 0) {
+                i_ += 2;
+                t.kind = Tok::Operator;
+                t.text = op[0] == '&' ? "&" : (op[0] == '|' ? "|" : op);
+                return t;
+            }
+        }
+        if (std::string("+-*/<>&|!").find(c) != std::string::npos) {
+            ++i_;
+            t.kind = Tok::Operator;
+            t.text = std::string(1, c);
+            return t;
+        }
+        throw std::invalid_argument("SignalExpression: unexpected character '" + std::string(1, c) +
+                                    "' at " + std::to_string(i_));
+    }
+
+private:
+    const std::string& s_;
+    std::size_t i_ = 0;
+};
+
+// ==================== 语法分析 + 代码生成 ====================
+// 递归下降，边解析边生成指令；按 (op, 操作数, 参数) 去重实现公共子表达式消除
+// 括号、函数参数与一元运算每嵌套一层递归一次，超过 kMaxDepth 报语法错误，避免恶意输入打爆栈
+class Compiler {
+public:
+    Compiler(const std::string& text, const std::vector<std::string>& fields,
+             const std::unordered_map<std::string, double>& params)
+        : lexer_(text), fields_(fields), params_(params) {
+        advance();
+    }
+
+    std::int32_t compile() {
+        const std::int32_t root = parseOr();
+        if (cur_.kind != Tok::End) fail("unexpected '" + cur_.text + "'");
+        return root;
+    }
+
+    std::vector<Instr>& plan() { return plan_; }
+
+private:
+    // 进入一层嵌套；作用域结束时退出
+    class DepthGuard {
+    public:
+        explicit DepthGuard(Compiler& c) : c_(c) {
+            if (++c_.depth_ > SignalExpression::kMaxDepth) c_.fail("expression nested too deeply");
+        }
+        ~DepthGuard() { --c_.depth_; }
+        DepthGuard(const DepthGuard&) = delete;
+        DepthGuard& operator=(const DepthGuard&) = delete;
+
+    private:
+        Compiler& c_;
+    };
+
+    void advance() { cur_ = lexer_.next(); }
+
+    [[noreturn]] void fail(const std::string& msg) const {
+        throw std::invalid_argument("SignalExpression: " + msg + " at " + std::to_string(cur_.pos));
+    }
+
+    bool acceptOp(const char* op) {
+        if (cur_.kind == Tok::Operator && cur_.text == op) {
+            advance();
+            return true;
+        }
+        return false;
+    }
+
+    void expect(Tok kind, const char* what) {
+        if (cur_.kind != kind) fail(std::string("expected ") + what);
+        advance();
+    }
+
+    std::int32_t emit(const Instr& in) {
+        std::ostringstream key;
+        key << static_cast<int>(in.op) << ':' << in.a << ':' << in.b << ':' << in.period;
+        if (in.op == Op::Const) {
+            key.precision(17);
+            key << ':' << in.value;
+        }
+        auto it = cse_.find(key.str());
+        if (it != cse_.end()) return it->second;
+        plan_.push_back(in);
+        const auto idx = static_cast<std::int32_t>(plan_.size() - 1);
+        cse_.emplace(key.str(), idx);
+        return idx;
+    }
+
+    std::int32_t emitConst(double v) {
+        Instr in{Op::Const};
+        in.value = v;
+        return emit(in);
+    }
+
+    std::int32_t emitBinary(Op op, std::int32_t a, std::int32_t b) {
+        // 两边都是常量时直接折叠
+        if (plan_[a].op == Op::Const && (b < 0 || plan_[b].op == Op::Const)) {
+            return emitConst(applyScalar(op, plan_[a].value, b < 0 ? 0.0 : plan_[b].value));
+        }
+        Instr in{op};
+        in.a = a;
+        in.b = b;
+        return emit(in);
+    }
+
+    std::int32_t parseOr() {
+        std::int32_t lhs = parseAnd();
+        while (acceptOp("|")) lhs = emitBinary(Op::Or, lhs, parseAnd());
+        return lhs;
+    }
+
+    std::int32_t parseAnd() {
+        std::int32_t lhs = parseCompare();
+        while (acceptOp("&")) lhs = emitBinary(Op::And, lhs, parseCompare());
+        return lhs;
+    }
+
+    std::int32_t parseCompare() {
+        std::int32_t lhs = parseAdditive();
+        static const std::pair<const char*, Op> kOps[] = {
+            {">=", Op::Ge}, {"<=", Op::Le}, {"==", Op::Eq}, {"!=", Op::Ne}, {">", Op::Gt}, {"<", Op::Lt}};
+        for (;;) {
+            bool matched = false;
+            for (const auto& op : kOps) {
+                if (acceptOp(op.first)) {
+                    lhs = emitBinary(op.second, lhs, parseAdditive());
+                    matched = true;
+                    break;
+                }
+            }
+            if (!matched) return lhs;
+        }
+    }
+
+    std::int32_t parseAdditive() {
+        std::int32_t lhs = parseMultiplicative();
+        for (;;) {
+            if (acceptOp("+")) lhs = emitBinary(Op::Add, lhs, parseMultiplicative());
+            else if (acceptOp("-")) lhs = emitBinary(Op::Sub, lhs, parseMultiplicative());
+            else return lhs;
+        }
+    }
+
+    std::int32_t parseMultiplicative() {
+        std::int32_t lhs = parseUnary();
+        for (;;) {
+            if (acceptOp("*")) lhs = emitBinary(Op::Mul, lhs, parseUnary());
+            else if (acceptOp("/")) lhs = emitBinary(Op::Div, lhs, parseUnary());
+            else return lhs;
+        }
+    }
+
+    // 每个操作数都经过这里：括号、函数参数、一元运算每深一层计一次
+    std::int32_t parseUnary() {
+        DepthGuard guard(*this);
+        if (acceptOp("!")) return emitBinary(Op::Not, parseUnary(), -1);
+        if (acceptOp("-")) return emitBinary(Op::Neg, parseUnary(), -1);
+        return parsePrimary();
+    }
+
+    std::int32_t parsePrimary() {
+        if (cur_.kind == Tok::Number) {
+            const double v = cur_.number;
+            advance();
+            return emitConst(v);
+        }
+        if (cur_.kind == Tok::LParen) {
+            advance();
+            const std::int32_t inner = parseOr();
+            expect(Tok::RParen, "')'");
+            return inner;
+        }
+        if (cur_.kind != Tok::Ident) fail("expected expression");
+
+        const std::string name = cur_.text;
+        advance();
+        if (cur_.kind == Tok::LParen) return parseCall(name);
+
+        auto field = std::find(fields_.begin(), fields_.end(), name);
+        if (field != fields_.end()) {
+            Instr in{Op::Input};
+            in.period = static_cast<std::int32_t>(field - fields_.begin());
+            return emit(in);
+        }
+        auto param = params_.find(name);
+        if (param != params_.end()) return emitConst(param->second);
+        fail("unknown identifier '" + name + "'");
+    }
+
+    std::int32_t parsePeriod(const std::string& fn) {
+        const std::int32_t idx = parseOr();
+        if (plan_[idx].op != Op::Const) fail(fn + ": window length must be a constant");
+        const double v = plan_[idx].value;
+        if (v < 1 || v != std::floor(v) || v > 1e7) fail(fn + ": window length must be a positive integer");
+        return static_cast<std::int32_t>(v);
+    }
+
+    std::int32_t parseCall(const std::string& fn) {
+        advance(); // '('
+        static const std::unordered_map<std::string, Op> kWindowed = {
+            {"sma", Op::Sma}, {"ma", Op::Sma}, {"ema", Op::Ema}, {"ref", Op::Ref}, {"count", Op::Count}};
+        static const std::unordered_map<std::string, Op> kBinary = {
+            {"cross", Op::Cross}, {"crossunder", Op::CrossUnder}, {"min", Op::Min}, {"max", Op::Max}};
+
+        std::int32_t result = -1;
+        if (auto w = kWindowed.find(fn); w != kWindowed.end()) {
+            Instr in{w->second};
+            in.a = parseOr();
+            expect(Tok::Comma, "','");
+            in.period = parsePeriod(fn);
+            result = emit(in);
+        } else if (auto b = kBinary.find(fn); b != kBinary.end()) {
+            const std::int32_t x = parseOr();
+            expect(Tok::Comma, "','");
+            const std::int32_t y = parseOr();
+            result = isStateful(b->second) ? emit(Instr{b->second, x, y}) : emitBinary(b->second, x, y);
+        } else if (fn == "abs") {
+            result = emitBinary(Op::Abs, parseOr(), -1);
+        } else {
+            fail("unknown function '" + fn + "'");
+        }
+        expect(Tok::RParen, "')'");
+        return result;
+    }
+
+    Lexer lexer_;
+    Token cur_;
+    const std::vector<std::string>& fields_;
+    const std::unordered_map<std::string, double>& params_;
+    std::vector<Instr> plan_;
+    std::unordered_map<std::string, std::int32_t> cse_;
+    std::size_t depth_ = 0;
+};
+
+// 只保留根节点可达的指令并重新编号（常量折叠后可能留下无用指令）
+std::vector<Instr> prune(const std::vector<Instr>& plan, std::int32_t root)
+{
+    std::vector<char> live(plan.size(), 0);
+    live[root] = 1;
+    for (std::int32_t i = root; i >= 0; --i) {
+        if (!live[i]) continue;
+        if (plan[i].a >= 0) live[plan[i].a] = 1;
+        if (plan[i].b >= 0) live[plan[i].b] = 1;
+    }
+    std::vector<std::int32_t> remap(plan.size(), -1);
+    std::vector<Instr> out;
+    for (std::size_t i = 0; i <= static_cast<std::size_t>(root); ++i) {
+        if (!live[i]) continue;
+        Instr in = plan[i];
+        if (in.a >= 0) in.a = remap[in.a];
+        if (in.b >= 0) in.b = remap[in.b];
+        remap[i] = static_cast<std::int32_t>(out.size());
+        out.push_back(in);
+    }
+    return out;
+}
+
+std::size_t computeWarmup(const std::vector<Instr>& plan)
+{
+    std::vector<std::size_t> w(plan.size(), 0);
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        const Instr& in = plan[i];
+        std::size_t base = 0;
+        if (in.a >= 0) base = std::max(base, w[in.a]);
+        if (in.b >= 0) base = std::max(base, w[in.b]);
+        switch (in.op) {
+        case Op::Sma:
+        case Op::Ema:
+        case Op::Count: base += static_cast<std::size_t>(in.period) - 1; break;
+        case Op::Ref: base += static_cast<std::size_t>(in.period); break;
+        case Op::Cross:
+        case Op::CrossUnder: base += 1; break;
+        default: break;
+        }
+        w[i] = base;
+    }
+    return plan.empty() ? 0 : w.back();
+}
+
+// 批量执行的中间缓冲，全市场计算时按行复用
+struct Scratch {
+    std::vector<std::vector<double>> buffers;
+    std::vector<const double*> slots;
+    std::vector<Rolling> rolling;
+};
+
+template <typename F>
+inline void mapUnary(const double* a, double* out, std::size_t n, F f)
+{
+    for (std::size_t i = 0; i < n; ++i) out[i] = f(a[i]);
+}
+
+template <typename F>
+inline void mapBinary(const double* a, const double* b, double* out, std::size_t n, F f)
+{
+    for (std::size_t i = 0; i < n; ++i) out[i] = f(a[i], b[i]);
+}
+
+// 按列执行整张指令表；返回根节点结果的指针（可能直接指向输入列）
+const double* runPlan(const std::vector<Instr>& plan, const double* const* columns, std::size_t n, Scratch& s)
+{
+    s.buffers.resize(plan.size());
+    s.slots.assign(plan.size(), nullptr);
+    s.rolling.resize(plan.size());
+
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        const Instr& in = plan[i];
+        if (in.op == Op::Input) {
+            s.slots[i] = columns[in.period];
+            continue;
+        }
+        auto& buf = s.buffers[i];
+        buf.resize(n);
+        double* out = buf.data();
+        const double* a = in.a >= 0 ? s.slots[in.a] : nullptr;
+        const double* b = in.b >= 0 ? s.slots[in.b] : nullptr;
+
+        switch (in.op) {
+        case Op::Const: std::fill(out, out + n, in.value); break;
+        case Op::Add: mapBinary(a, b, out, n, [](double x, double y) { return x + y; }); break;
+        case Op::Sub: mapBinary(a, b, out, n, [](double x, double y) { return x - y; }); break;
+        case Op::Mul: mapBinary(a, b, out, n, [](double x, double y) { return x * y; }); break;
+        case Op::Div: mapBinary(a, b, out, n, [](double x, double y) { return x / y; }); break;
+        case Op::Gt: mapBinary(a, b, out, n, [](double x, double y) { return boolValue(x > y); }); break;
+        case Op::Ge: mapBinary(a, b, out, n, [](double x, double y) { return boolValue(x >= y); }); break;
+        case Op::Lt: mapBinary(a, b, out, n, [](double x, double y) { return boolValue(x < y); }); break;
+        case Op::Le: mapBinary(a, b, out, n, [](double x, double y) { return boolValue(x <= y); }); break;
+        case Op::Neg: mapUnary(a, out, n, [](double x) { return -x; }); break;
+        case Op::Abs: mapUnary(a, out, n, [](double x) { return std::fabs(x); }); break;
+        case Op::Not: mapUnary(a, out, n, [](double x) { return boolValue(!truthy(x)); }); break;
+        case Op::Eq:
+        case Op::Ne:
+        case Op::And:
+        case Op::Or:
+        case Op::Min:
+        case Op::Max: {
+            const Op op = in.op;
+            mapBinary(a, b, out, n, [op](double x, double y) { return applyScalar(op, x, y); });
+            break;
+        }
+        default: {
+            // 窗口函数：同一个滚动状态沿时间走一遍
+            Rolling& r = s.rolling[i];
+            r.init(in);
+            for (std::size_t t = 0; t < n; ++t) out[t] = r.step(in, a[t], b ? b[t] : 0.0);
+            break;
+        }
+        }
+        s.slots[i] = out;
+    }
+    return plan.empty() ? nullptr : s.slots.back();
+}
+
+} // namespace
+
+// ==================== SignalExpression ====================
+
+SignalExpression SignalExpression::compile(const std::string& text,
+                                           const std::vector<std::string>& fields,
+                                           const std::unordered_map<std::string, double>& params)
+{
+    Compiler compiler(text, fields, params);
+    const std::int32_t root = compiler.compile();
+
+    SignalExpression expr;
+    expr.text_ = text;
+    expr.fields_ = fields;
+    expr.plan_ = prune(compiler.plan(), root);
+    expr.warmup_ = computeWarmup(expr.plan_);
+    return expr;
+}
+
+void SignalExpression::evaluate(const double* const* columns, std::size_t n, double* out) const
+{
+    ENGINE_PROBE(foundation::metrics::Stage::SignalEval);
+    Scratch scratch;
+    const double* result = runPlan(plan_, columns, n, scratch);
+    std::copy(result, result + n, out);
+}
+
+SignalBitset SignalExpression::evaluateUniverse(const std::vector<SeriesMatrix>& fields) const
+{
+    ENGINE_PROBE(foundation::metrics::Stage::SignalEval);
+    if (fields.size() != fields_.size()) {
+        throw std::invalid_argument("SignalExpression::evaluateUniverse: expected " +
+                                    std::to_string(fields_.size()) + " field matrices");
+    }
+    const std::size_t rows = fields.empty() ? 0 : fields[0].rows;
+    const std::size_t cols = fields.empty() ? 0 : fields[0].cols;
+    for (const auto& m : fields) {
+        if (m.rows != rows || m.cols != cols) {
+            throw std::invalid_argument("SignalExpression::evaluateUniverse: field matrix shapes differ");
+        }
+    }
+
+    SignalBitset bits(rows, cols);
+    Scratch scratch;
+    std::vector<const double*> columns(fields.size());
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t f = 0; f < fields.size(); ++f) columns[f] = fields[f].row(r);
+        const double* result = runPlan(plan_, columns.data(), cols, scratch);
+        std::uint64_t* words = bits.rowWords(r);
+        for (std::size_t t = 0; t < cols; ++t) {
+            words[t >> 6] |= static_cast<std::uint64_t>(truthy(result[t])) << (t & 63);
+        }
+    }
+    return bits;
+}
+
+std::string SignalExpression::describe() const
+{
+    std::ostringstream os;
+    for (std::size_t i = 0; i < plan_.size(); ++i) {
+        const Instr& in = plan_[i];
+        os << '%' << i << " = " << opName(in.op);
+        if (in.op == Op::Input) os << ' ' << fields_[in.period];
+        if (in.op == Op::Const) os << ' ' << in.value;
+        if (in.a >= 0) os << " %" << in.a;
+        if (in.b >= 0) os << " %" << in.b;
+        if (isStateful(in.op) && in.period > 0) os << " n=" << in.period;
+        os << '\n';
+    }
+    return os.str();
+}
+
+// ==================== SignalStream ====================
+
+struct SignalStream::State {
+    std::vector<Instr> plan;
+    std::vector<double> values;
+    std::vector<Rolling> rolling;
+    double last = kNaN;
+};
+
+SignalStream::SignalStream(const SignalExpression& expr) : state_(std::make_unique<State>())
+{
+    state_->plan = expr.plan();
+    state_->values.assign(state_->plan.size(), kNaN);
+    state_->rolling.resize(state_->plan.size());
+    reset();
+}
+
+SignalStream::~SignalStream() = default;
+SignalStream::SignalStream(SignalStream&&) noexcept = default;
+SignalStream& SignalStream::operator=(SignalStream&&) noexcept = default;
+
+double SignalStream::update(const double* barFields)
+{
+    ENGINE_PROBE(foundation::metrics::Stage::SignalEval);
+    State& s = *state_;
+    for (std::size_t i = 0; i < s.plan.size(); ++i) {
+        const Instr& in = s.plan[i];
+        const double x = in.a >= 0 ? s.values[in.a] : 0.0;
+        const double y = in.b >= 0 ? s.values[in.b] : 0.0;
+        double v;
+        if (in.op == Op::Input) v = barFields[in.period];
+        else if (in.op == Op::Const) v = in.value;
+        else if (isStateful(in.op)) v = s.rolling[i].step(in, x, y);
+        else v = applyScalar(in.op, x, y);
+        s.values[i] = v;
+    }
+    s.last = s.values.empty() ? kNaN : s.values.back();
+    return s.last;
+}
+
+bool SignalStream::signal() const
+{
+    return truthy(state_->last);
+}
+
+void SignalStream::reset()
+{
+    State& s = *state_;
+    for (std::size_t i = 0; i < s.plan.size(); ++i) s.rolling[i].init(s.plan[i]);
+    std::fill(s.values.begin(), s.values.end(), kNaN);
+    s.last = kNaN;
+}
+
+} // namespace signals
+} // namespace domain
@@ -0,0 +1,165 @@
+// 每根 bar 的临时内存：std::vector（全局堆）vs StrategyContext::scratch()（bar 级 arena）
+// 横截面动量策略每根 bar 给全部标的打分、排序、取前 K 名调仓，临时数组的分配是典型的热点。
+// 全局 operator new 被替换为计数版本，直接数出每根 bar 的堆分配次数。
+// 用法：ArenaBench [symbols] [bars] [strategies]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PortfolioRunner.h"
+
+using namespace domain::strategies;
+
+namespace {
+std::atomic<std::uint64_t> g_heapAllocations{0};
+} // namespace
+
+void* operator new(std::size_t n)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+MarketFrame makeFrame(std::size_t symbols, std::size_t bars)
+{
+    MarketFrame f;
+    for (std::size_t s = 0; s < symbols; ++s) f.symbols.push_back(std::to_string(600000 + s) + ".SH");
+    for (std::size_t t = 0; t < bars; ++t) f.dates.push_back(static_cast<std::int32_t>(20100101 + t));
+    f.close.resize(symbols * bars);
+    std::uint64_t seed = 42;
+    std::vector<double> price(symbols, 10.0);
+    for (std::size_t t = 0; t < bars; ++t) {
+        for (std::size_t s = 0; s < symbols; ++s) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const double r = static_cast<double>(seed >> 40) / 16777216.0 - 0.5;
+            price[s] = std::max(1.0, price[s] * (1.0 + r * 0.05));
+            f.close[t * symbols + s] = std::round(price[s] * 100.0) / 100.0;
+        }
+    }
+    return f;
+}
+
+// UseScratch 为 false 时临时数组走全局堆
+template <bool UseScratch>
+class MomentumStrategy : public IPortfolioStrategy {
+public:
+    explicit MomentumStrategy(std::size_t topK) : topK_(topK) {}
+
+    std::string name() const override { return UseScratch ? "momentum_scratch" : "momentum_heap"; }
+
+    void onStart(StrategySetup& setup) override {
+        handles_.clear();
+        for (std::size_t s = 0; s < setup.symbolCount(); ++s) {
+            handles_.push_back(setup.indicator(s, SharedIndicatorKind::Sma, 20));
+        }
+    }
+
+    void onBar(StrategyContext& ctx) override {
+        if (UseScratch) {
+            std::pmr::vector<std::pair<double, std::size_t>> scores(ctx.scratch());
+            std::pmr::vector<std::size_t> picks(ctx.scratch());
+            rebalance(ctx, scores, picks);
+        } else {
+            std::vector<std::pair<double, std::size_t>> scores;
+            std::vector<std::size_t> picks;
+            rebalance(ctx, scores, picks);
+        }
+    }
+
+private:
+    template <typename Scores, typename Picks>
+    void rebalance(StrategyContext& ctx, Scores& scores, Picks& picks) {
+        // 不预留容量，保持与常见写法一致（push_back 逐步增长）
+        for (std::size_t s = 0; s < handles_.size(); ++s) {
+            const double p = ctx.price(s);
+            const double ma = ctx.value(handles_[s]);
+            if (std::isnan(p) || std::isnan(ma) || ma <= 0.0) continue;
+            scores.emplace_back(p / ma - 1.0, s);
+        }
+        if (scores.size() < topK_) return;
+        std::partial_sort(scores.begin(), scores.begin() + static_cast<std::ptrdiff_t>(topK_), scores.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (std::size_t i = 0; i < topK_; ++i) picks.push_back(scores[i].second);
+        std::sort(picks.begin(), picks.end());
+
+        const double budget = ctx.equity() / static_cast<double>(topK_);
+        for (std::size_t s = 0; s < handles_.size(); ++s) {
+            const bool picked = std::binary_search(picks.begin(), picks.end(), s);
+            const double p = ctx.price(s);
+            if (std::isnan(p)) continue;
+            ctx.orderTarget(s, picked ? std::floor(budget / p / 100.0) * 100.0 : 0.0);
+        }
+    }
+
+    std::size_t topK_;
+    std::vector<IndicatorHandle> handles_;
+};
+
+struct Outcome {
+    double ms = 0.0;
+    double allocsPerBar = 0.0;
+    double finalEquity = 0.0;
+    std::size_t scratchPeak = 0;
+};
+
+template <bool UseScratch>
+Outcome runOnce(const MarketFrame& frame, std::size_t strategies)
+{
+    PortfolioRunner runner(1e8);
+    for (std::size_t i = 0; i < strategies; ++i) {
+        runner.addStrategy(std::make_shared<MomentumStrategy<UseScratch>>(5 + i));
+    }
+    runner.run(frame);   // 预热：arena 的块在第一次 run 中长到稳定大小
+
+    const auto allocs0 = g_heapAllocations.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto report = runner.run(frame);
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto allocs1 = g_heapAllocations.load();
+
+    Outcome o;
+    o.ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    o.allocsPerBar = static_cast<double>(allocs1 - allocs0) / static_cast<double>(frame.barCount());
+    o.finalEquity = report.equityCurve.back();
+    o.scratchPeak = report.scratchPeakBytes;
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 500;
+    const std::size_t bars = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 2000;
+    const std::size_t strategies = argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : 10;
+
+    const MarketFrame frame = makeFrame(symbols, bars);
+    const Outcome heap = runOnce<false>(frame, strategies);
+    const Outcome arena = runOnce<true>(frame, strategies);
+
+    if (heap.finalEquity != arena.finalEquity) {
+        std::fprintf(stderr, "result mismatch: %f %f\n", heap.finalEquity, arena.finalEquity);
+        return 1;
+    }
+
+    std::printf("{\"bench\":\"arena\",\"symbols\":%zu,\"bars\":%zu,\"strategies\":%zu,"
+                "\"heap_ms\":%.3f,\"arena_ms\":%.3f,\"heap_allocs_per_bar\":%.2f,\"arena_allocs_per_bar\":%.2f,"
+                "\"scratch_peak_bytes\":%zu}\n",
+                symbols, bars, strategies, heap.ms, arena.ms, heap.allocsPerBar, arena.allocsPerBar,
+                arena.scratchPeak);
+    return 0;
+}
@@ -0,0 +1,187 @@
+// 静态流水线 vs 虚函数链路 的单 bar 开销对比
+// 用法：StaticPipelineBench [bars]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "StaticPipeline.h"
+
+using namespace domain::strategies;
+
+namespace {
+
+struct BenchBar {
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+
+// ---------- 与现有动态链路同构的虚函数版本：指标 -> 信号 -> 策略 ----------
+
+class IIndicatorV {
+public:
+    virtual ~IIndicatorV() = default;
+    virtual double update(double x) = 0;
+    virtual bool ready() const = 0;
+};
+
+class SmaV : public IIndicatorV {
+public:
+    explicit SmaV(std::size_t n) : impl_(n) {}
+    double update(double x) override { return impl_.update(x); }
+    bool ready() const override { return impl_.ready(); }
+
+private:
+    Sma impl_;
+};
+
+class ISignalV {
+public:
+    virtual ~ISignalV() = default;
+    virtual int update(double price) = 0;
+};
+
+class CrossV : public ISignalV {
+public:
+    CrossV(std::unique_ptr<IIndicatorV> f, std::unique_ptr<IIndicatorV> s)
+        : fast_(std::move(f)), slow_(std::move(s)) {}
+
+    int update(double price) override {
+        const double f = fast_->update(price);
+        const double s = slow_->update(price);
+        if (!fast_->ready() || !slow_->ready()) return 0;
+        const bool above = f > s;
+        const int signal = (hasPrev_ && above != prevAbove_) ? (above ? 1 : -1) : 0;
+        prevAbove_ = above;
+        hasPrev_ = true;
+        return signal;
+    }
+
+private:
+    std::unique_ptr<IIndicatorV> fast_;
+    std::unique_ptr<IIndicatorV> slow_;
+    bool prevAbove_ = false;
+    bool hasPrev_ = false;
+};
+
+class ISizingV {
+public:
+    virtual ~ISizingV() = default;
+    virtual double size(int direction, double price) const = 0;
+};
+
+class FixedSizeV : public ISizingV {
+public:
+    explicit FixedSizeV(double q) : q_(q) {}
+    double size(int direction, double) const override { return direction * q_; }
+
+private:
+    double q_;
+};
+
+class IStrategyV {
+public:
+    virtual ~IStrategyV() = default;
+    virtual PipelineDecision onBar(const BenchBar& bar) = 0;
+};
+
+class MaStrategyV : public IStrategyV {
+public:
+    MaStrategyV(std::unique_ptr<ISignalV> sig, std::unique_ptr<ISizingV> sizing)
+        : signal_(std::move(sig)), sizing_(std::move(sizing)) {}
+
+    PipelineDecision onBar(const BenchBar& bar) override {
+        const int d = signal_->update(bar.close);
+        if (d == 0) return {};
+        return {d, sizing_->size(d, bar.close)};
+    }
+
+private:
+    std::unique_ptr<ISignalV> signal_;
+    std::unique_ptr<ISizingV> sizing_;
+};
+
+// 几何布朗运动生成价格，固定种子保证可复现
+std::vector<BenchBar> makeBars(std::size_t n)
+{
+    std::mt19937_64 rng(20240101);
+    std::normal_distribution<double> z(0.0, 1.0);
+    std::vector<BenchBar> bars(n);
+    double p = 10.0;
+    const double mu = 0.0002;
+    const double sigma = 0.02;
+    for (auto& b : bars) {
+        p *= std::exp(mu - 0.5 * sigma * sigma + sigma * z(rng));
+        b = {p, p * 1.01, p * 0.99, p, 1e6};
+    }
+    return bars;
+}
+
+// 通过 volatile 函数指针构造，模拟策略由插件/工厂在运行时创建，避免编译器去虚化
+std::unique_ptr<IStrategyV> makeVirtualStrategy()
+{
+    return std::make_unique<MaStrategyV>(
+        std::make_unique<CrossV>(std::make_unique<SmaV>(5), std::make_unique<SmaV>(20)),
+        std::make_unique<FixedSizeV>(100));
+}
+
+std::unique_ptr<IStrategyV> (*volatile g_strategyFactory)() = &makeVirtualStrategy;
+
+template <typename F>
+double nsPerBar(const std::vector<BenchBar>& bars, int rounds, F&& run)
+{
+    double best = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(bars.size()));
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 5000000;
+    const auto bars = makeBars(n);
+    constexpr int kRounds = 5;
+
+    double sinkStatic = 0.0;
+    double sinkVirtual = 0.0;
+    double sinkAdapter = 0.0;
+
+    const double fused = nsPerBar(bars, kRounds, [&] {
+        auto p = makePipeline(ClosePrice{}, CrossOver<Sma, Sma>(Sma(5), Sma(20)), FixedSize(100));
+        for (const auto& b : bars) sinkStatic += p.onBar(b).quantity;
+    });
+
+    const double virt = nsPerBar(bars, kRounds, [&] {
+        auto strategy = g_strategyFactory();
+        for (const auto& b : bars) sinkVirtual += strategy->onBar(b).quantity;
+    });
+
+    const double adapted = nsPerBar(bars, kRounds, [&] {
+        auto p = makeDynamic<BenchBar>(makePipeline(ClosePrice{}, CrossOver<Sma, Sma>(Sma(5), Sma(20)), FixedSize(100)));
+        for (const auto& b : bars) sinkAdapter += p->onBar(b).quantity;
+    });
+
+    if (sinkStatic != sinkVirtual || sinkStatic != sinkAdapter) {
+        std::fprintf(stderr, "result mismatch: %f %f %f\n", sinkStatic, sinkVirtual, sinkAdapter);
+        return 1;
+    }
+
+    std::printf("{\"bench\":\"static_pipeline\",\"bars\":%zu,"
+                "\"fused_ns_per_bar\":%.3f,\"virtual_ns_per_bar\":%.3f,\"adapter_ns_per_bar\":%.3f,"
+                "\"speedup\":%.2f}\n",
+                n, fused, virt, adapted, virt / fused);
+    return 0;
+}
@@ -0,0 +1,146 @@
+// 成交记录交给界面：逐行复制（每行一个对象 + 若干字符串，对应 addTrade 循环）vs 共享列式 TradeLog
+// 高换手策略跑出百万级成交后，比较把结果交给列表模型的耗时、额外内存，以及模拟滚动时按需取行的开销。
+// 两种方式取到的可见行必须一致。
+// 用法：TradeLogBench [symbols] [bars] [visibleRows]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PortfolioRunner.h"
+#include "TradeLog.h"
+
+using namespace domain::strategies;
+
+namespace {
+
+MarketFrame makeFrame(std::size_t symbols, std::size_t bars)
+{
+    MarketFrame f;
+    for (std::size_t s = 0; s < symbols; ++s) f.symbols.push_back(std::to_string(600000 + s) + ".SH");
+    for (std::size_t t = 0; t < bars; ++t) f.dates.push_back(static_cast<std::int32_t>(20100101 + t));
+    f.close.resize(symbols * bars);
+    std::uint64_t seed = 11;
+    std::vector<double> price(symbols, 10.0);
+    for (std::size_t t = 0; t < bars; ++t) {
+        for (std::size_t s = 0; s < symbols; ++s) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const double r = static_cast<double>(seed >> 40) / 16777216.0 - 0.5;
+            price[s] = std::max(1.0, price[s] * (1.0 + r * 0.05));
+            f.close[t * symbols + s] = std::round(price[s] * 100.0) / 100.0;
+        }
+    }
+    return f;
+}
+
+// 每根 bar 在持仓/空仓之间来回切换，成交笔数约为 标的数 × bar 数
+class FlipStrategy : public IPortfolioStrategy {
+public:
+    std::string name() const override { return "flip"; }
+    void onBar(StrategyContext& ctx) override {
+        for (std::size_t s = 0; s < ctx.symbolCount(); ++s) {
+            ctx.orderTarget(s, ctx.position(s) > 0.0 ? 0.0 : 100.0);
+        }
+    }
+};
+
+// 逐行模型里的一行：与旧的 addTrade(symbol, price, volume, side) 一样每行各带字符串
+struct RowRecord {
+    std::string time;
+    std::string symbol;
+    double price;
+    double volume;
+    std::string side;
+};
+
+std::size_t rowRecordBytes(const std::vector<RowRecord>& rows)
+{
+    std::size_t bytes = rows.capacity() * sizeof(RowRecord);
+    for (const auto& r : rows) {
+        // 超出短字符串缓冲的部分另占堆内存
+        for (const std::string* s : {&r.time, &r.symbol, &r.side}) {
+            if (s->capacity() > 15) bytes += s->capacity() + 1;
+        }
+    }
+    return bytes;
+}
+
+double msSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 500;
+    const std::size_t bars = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 2000;
+    const std::size_t visible = argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : 50;
+
+    const MarketFrame frame = makeFrame(symbols, bars);
+    PortfolioRunner runner(1e9);
+    runner.addStrategy(std::make_shared<FlipStrategy>());
+    const PortfolioReport report = runner.run(frame);
+    const TradeLog& log = *report.trades;
+    const std::size_t trades = log.size();
+    if (trades < visible) {
+        std::fprintf(stderr, "too few trades: %zu\n", trades);
+        return 1;
+    }
+
+    // 交给模型：逐行复制
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<RowRecord> rows;
+    for (std::size_t i = 0; i < trades; ++i) {
+        const auto r = log.row(i);
+        rows.push_back({std::to_string(r.date), std::string(r.symbol), r.price, std::fabs(r.quantity),
+                        r.buy() ? "买入" : "卖出"});
+    }
+    const double copyMs = msSince(t0);
+
+    // 交给模型：共享同一份列式数据
+    t0 = std::chrono::steady_clock::now();
+    TradeLogView view;
+    const auto range = view.append(report.trades);
+    const double shareMs = msSince(t0);
+    if (range.count != trades || view.size() != trades) {
+        std::fprintf(stderr, "view size mismatch: %zu %zu\n", view.size(), trades);
+        return 1;
+    }
+
+    // 模拟滚动：在 1000 个位置各取一屏可见行
+    const std::size_t positions = 1000;
+    double copySum = 0.0;
+    double viewSum = 0.0;
+    t0 = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < positions; ++p) {
+        const std::size_t first = (trades - visible) * p / (positions - 1);
+        for (std::size_t i = first; i < first + visible; ++i) copySum += rows[i].price * rows[i].volume;
+    }
+    const double copyScrollMs = msSince(t0);
+    t0 = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < positions; ++p) {
+        const std::size_t first = (trades - visible) * p / (positions - 1);
+        for (std::size_t i = first; i < first + visible; ++i) viewSum += view.row(i).amount();
+    }
+    const double viewScrollMs = msSince(t0);
+
+    if (copySum != viewSum) {
+        std::fprintf(stderr, "result mismatch: %f %f\n", copySum, viewSum);
+        return 1;
+    }
+
+    std::printf("{\"bench\":\"trade_log\",\"symbols\":%zu,\"bars\":%zu,\"trades\":%zu,"
+                "\"copy_ms\":%.3f,\"share_ms\":%.3f,\"copy_extra_bytes\":%zu,\"view_segments\":%zu,"
+                "\"log_bytes\":%zu,\"copy_scroll_us_per_screen\":%.3f,\"view_scroll_us_per_screen\":%.3f}\n",
+                symbols, bars, trades, copyMs, shareMs, rowRecordBytes(rows),
+                view.segmentCount(), log.memoryBytes(),
+                copyScrollMs * 1000.0 / static_cast<double>(positions),
+                viewScrollMs * 1000.0 / static_cast<double>(positions));
+    return 0;
+}
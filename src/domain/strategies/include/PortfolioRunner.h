@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "TradeLog.h"
+
+namespace domain {
+namespace strategies {
+
+// 组合级多策略运行器
+// 同一份行情上同时跑 N 个策略：
+//   - 行情只遍历一次，所有策略共享同一个时间步
+//   - 指标经 IndicatorCache 按 (标的, 类型, 周期) 去重，每根 bar 只更新一次，多个策略读同一个值
+//   - 各策略的下单先在组合内部按标的轧差，只有净额送进撮合模拟，
+//     手续费也只对净额收取，再按成交量比例分摊回各策略
+//   - 每个策略有独立的资金账户、持仓和净值曲线
+// 50 个策略的成本接近 "一次行情遍历 + 50 次 onBar"，而不是 50 次完整回测
+//
+// 内存：每次 run 有一个回测级 arena（run 开始时重置），每根 bar 有一个临时 arena（bar 结束时重置），
+// 稳定运行后两者都不再向系统申请内存。策略可以用 std::pmr 容器从中分配，见 runArena() / scratch()。
+
+// 行情帧：按时间优先存放（close[t * symbolCount + s]），NaN 表示停牌/无数据
+struct MarketFrame {
+    std::vector<std::string> symbols;
+    std::vector<std::int32_t> dates;
+    std::vector<double> close;
+
+    std::size_t symbolCount() const { return symbols.size(); }
+    std::size_t barCount() const { return dates.size(); }
+    double at(std::size_t t, std::size_t s) const { return close[t * symbols.size() + s]; }
+};
+
+enum class SharedIndicatorKind : std::uint8_t { Sma, Ema, StdDev, Rsi };
+
+// 共享指标句柄：在 onStart 中申请，在 onBar 中按句柄 O(1) 取值
+struct IndicatorHandle {
+    std::int32_t index = -1;
+    bool valid() const { return index >= 0; }
+};
+
+class PortfolioRunner;
+
+// 策略启动时可见的接口：申请指标
+class StrategySetup {
+public:
+    IndicatorHandle indicator(std::size_t symbol, SharedIndicatorKind kind, std::size_t period);
+    std::size_t symbolIndex(const std::string& symbol) const;
+    std::size_t symbolCount() const;
+    // 本次回测期间有效的内存（run 结束前不会释放），用于策略的回测级状态。
+    // 与运行器内部的缓冲区分开；每次 run 返回一个新的资源，下一次 run 开始时底层内存整块复用。
+    // 用它分配的成员容器必须在每次 onStart 里重建：
+    //   scores_ = std::pmr::vector<double>(setup.runArena());
+    // 上一次 run 的容器再申请内存会抛 std::logic_error；容量之内的写入检测不到，会覆盖本次 run 策略的数据。
+    // 这些容器不能比 PortfolioRunner 活得更久（策略对象被外部持有时，要在运行器析构前销毁这些容器）
+    std::pmr::memory_resource* runArena() const;
+
+private:
+    friend class PortfolioRunner;
+    explicit StrategySetup(PortfolioRunner& runner) : runner_(runner) {}
+    PortfolioRunner& runner_;
+};
+
+// 每根 bar 传给策略的上下文：读行情/指标/自身账户，提交订单
+// 带 symbol 参数的接口在下标越界时都抛 std::out_of_range
+class StrategyContext {
+public:
+    std::int32_t date() const;
+    std::size_t barIndex() const;
+    std::size_t symbolCount() const;
+
+    // 当前 bar 收盘价，停牌为 NaN
+    double price(std::size_t symbol) const;
+    // 共享指标当前值，预热期或句柄无效时为 NaN；不是本运行器发出的句柄抛 std::out_of_range
+    double value(IndicatorHandle h) const;
+
+    // 本策略账户
+    double cash() const;
+    double position(std::size_t symbol) const;
+    double equity() const;
+
+    // 下单（带符号数量，正买负卖）；当根 bar 收盘价撮合。
+    // 卖单最多卖到已成交持仓为止，同 bar 未成交的买单不能用来卖
+    void order(std::size_t symbol, double quantity);
+    // 调整到目标持仓
+    void orderTarget(std::size_t symbol, double targetQuantity);
+
+    // 当根 bar 的临时内存，onBar 返回后即失效；用它分配的容器不能留到下一根 bar
+    //   std::pmr::vector<double> scores(ctx.scratch());
+    std::pmr::memory_resource* scratch() const;
+
+private:
+    friend class PortfolioRunner;
+    StrategyContext(PortfolioRunner& runner, std::size_t slot) : runner_(runner), slot_(slot) {}
+    PortfolioRunner& runner_;
+    std::size_t slot_;
+};
+
+// 组合中的策略接口
+class IPortfolioStrategy {
+public:
+    virtual ~IPortfolioStrategy() = default;
+    virtual std::string name() const = 0;
+    // 每次 run 开始时调用；用 runArena() 分配的容器在这里重建
+    virtual void onStart(StrategySetup&) {}
+    virtual void onBar(StrategyContext& ctx) = 0;
+};
+
+// 撮合模拟：收到某标的的净额订单，返回成交价（滑点在这里体现）
+// 下买单预留资金时用该标的当根 bar 已下买单总量调用 fillPrice / commission 估算成交额；
+// 轧差后实际成本仍超出预留的买单在结算时缩量，任何撮合模型下现金都不会为负
+class IBrokerSimulator {
+public:
+    virtual ~IBrokerSimulator() = default;
+    virtual double fillPrice(std::size_t symbol, double netQuantity, double refPrice) = 0;
+    virtual double commission(double notional) const = 0;
+};
+
+// 默认撮合：固定滑点（基点）+ 按成交额比例收佣，最低 5 元
+class SimpleBrokerSimulator : public IBrokerSimulator {
+public:
+    SimpleBrokerSimulator(double slippageBps = 0.0, double commissionRate = 0.0003, double minCommission = 5.0)
+        : slippageBps_(slippageBps), commissionRate_(commissionRate), minCommission_(minCommission) {}
+
+    double fillPrice(std::size_t symbol, double netQuantity, double refPrice) override;
+    double commission(double notional) const override;
+
+private:
+    double slippageBps_;
+    double commissionRate_;
+    double minCommission_;
+};
+
+struct StrategyReport {
+    std::string name;
+    double initialCapital = 0.0;
+    double finalEquity = 0.0;
+    std::size_t orders = 0;
+    double commission = 0.0;
+    std::vector<double> equityCurve;
+};
+
+struct PortfolioReport {
+    std::vector<StrategyReport> strategies;
+    std::vector<double> equityCurve;     // 组合总净值
+    double grossTraded = 0.0;            // 各策略下单数量绝对值之和
+    double netTraded = 0.0;              // 轧差后实际送撮合的数量绝对值之和
+    std::size_t sharedIndicators = 0;    // 去重后实际维护的指标个数
+    std::size_t indicatorRequests = 0;   // 各策略申请指标的总次数
+    std::size_t scratchPeakBytes = 0;    // 单根 bar 临时内存的峰值
+    // 各策略的逐笔成交（按 bar、下单顺序），与界面模型共享同一份，不复制
+    std::shared_ptr<const TradeLog> trades;
+};
+
+class PortfolioRunner {
+public:
+    // totalCapital 按 addStrategy 时给定的权重分配
+    explicit PortfolioRunner(double totalCapital,
+                             std::unique_ptr<IBrokerSimulator> broker = std::make_unique<SimpleBrokerSimulator>());
+    ~PortfolioRunner();
+
+    PortfolioRunner(const PortfolioRunner&) = delete;
+    PortfolioRunner& operator=(const PortfolioRunner&) = delete;
+
+    void addStrategy(std::shared_ptr<IPortfolioStrategy> strategy, double capitalWeight = 1.0);
+    std::size_t strategyCount() const;
+
+    PortfolioReport run(const MarketFrame& frame);
+
+private:
+    friend class StrategySetup;
+    friend class StrategyContext;
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace strategies
+} // namespace domain
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace domain {
+namespace strategies {
+
+// 编译期策略组合
+// IStrategy 这条动态链路上，每根 bar 要经过 指标 -> 信号 -> 策略 多层虚函数调用。
+// 这里提供一套纯模板的组件：指标、信号、仓位规则都是具体类型，
+// 通过 Pipeline<...> 拼在一起后，整个 per-bar 流程在编译期确定，可以被完全内联。
+//
+//   auto p = makePipeline(ClosePrice{},
+//                         CrossOver<Sma, Sma>(Sma(5), Sma(20)),
+//                         FixedSize(100));
+//   for (const Bar& bar : bars) { auto d = p.onBar(bar); ... }
+//
+// 需要插件化/运行时配置的场景仍然走 IStrategy；PipelineAdapter 可以把一个
+// 静态流水线包装成虚接口，两种方式可以混用。
+//
+// 约定（鸭子类型，不需要继承）：
+//   指标：double update(double x); bool ready() const; void reset();
+//   信号：int update(double price);  返回 +1 买入 / -1 卖出 / 0 无操作
+//   仓位：double size(int direction, double price) const;
+//   取价：double operator()(const BarT&) const;
+
+constexpr double kPipelineNaN = std::numeric_limits<double>::quiet_NaN();
+
+// ---------------- 指标 ----------------
+
+// 简单移动平均，环形缓冲 + 滚动求和
+// NaN 输入（停牌、缺失数据）直接跳过，不进入窗口，否则滚动和会被永久污染
+class Sma {
+public:
+    explicit Sma(std::size_t period) : period_(checkedPeriod(period)), ring_(period, 0.0) {}
+
+    double update(double x) {
+        if (std::isnan(x)) return current();
+        sum_ += x - ring_[pos_];
+        ring_[pos_] = x;
+        if (++pos_ == period_) pos_ = 0;
+        if (count_ < period_) ++count_;
+        return current();
+    }
+    bool ready() const { return count_ >= period_; }
+    void reset() {
+        std::fill(ring_.begin(), ring_.end(), 0.0);
+        sum_ = 0.0;
+        pos_ = count_ = 0;
+    }
+
+private:
+    static std::size_t checkedPeriod(std::size_t period) {
+        if (period == 0) throw std::invalid_argument("Sma: period must be positive");
+        return period;
+    }
+    double current() const { return ready() ? sum_ / static_cast<double>(period_) : kPipelineNaN; }
+
+    std::size_t period_;
+    std::vector<double> ring_;
+    double sum_ = 0.0;
+    std::size_t pos_ = 0;
+    std::size_t count_ = 0;
+};
+
+// 指数移动平均，前 period 根视为预热；NaN 输入跳过
+class Ema {
+public:
+    explicit Ema(std::size_t period)
+        : period_(period), alpha_(2.0 / (static_cast<double>(period) + 1.0)) {
+        if (period == 0) throw std::invalid_argument("Ema: period must be positive");
+    }
+
+    double update(double x) {
+        if (std::isnan(x)) return ready() ? value_ : kPipelineNaN;
+        value_ = count_ == 0 ? x : value_ + alpha_ * (x - value_);
+        if (count_ < period_) ++count_;
+        return ready() ? value_ : kPipelineNaN;
+    }
+    bool ready() const { return count_ >= period_; }
+    void reset() {
+        value_ = 0.0;
+        count_ = 0;
+    }
+
+private:
+    std::size_t period_;
+    double alpha_;
+    double value_ = 0.0;
+    std::size_t count_ = 0;
+};
+
+// 原始价格（把价格本身当作"指标"，用于 价格 x 均线 的交叉）
+struct Identity {
+    double update(double x) { return x; }
+    bool ready() const { return true; }
+    void reset() {}
+};
+
+// ---------------- 信号 ----------------
+
+// Fast 上穿 Slow 买入、下穿卖出
+// 价格或指标值为 NaN 的 bar 不出信号，也不改变上一次的相对位置（Identity 会把 NaN 原样传出来）
+template <typename Fast, typename Slow>
+class CrossOver {
+public:
+    CrossOver(Fast fast, Slow slow) : fast_(std::move(fast)), slow_(std::move(slow)) {}
+
+    int update(double price) {
+        const double f = fast_.update(price);
+        const double s = slow_.update(price);
+        if (!fast_.ready() || !slow_.ready()) return 0;
+        if (std::isnan(price) || std::isnan(f) || std::isnan(s)) return 0;
+        const bool above = f > s;
+        const int signal = (hasPrev_ && above != prevAbove_) ? (above ? 1 : -1) : 0;
+        prevAbove_ = above;
+        hasPrev_ = true;
+        return signal;
+    }
+    void reset() {
+        fast_.reset();
+        slow_.reset();
+        hasPrev_ = false;
+    }
+
+private:
+    Fast fast_;
+    Slow slow_;
+    bool prevAbove_ = false;
+    bool hasPrev_ = false;
+};
+
+// 指标值上穿 upper 卖出、下穿 lower 买入（如 RSI 超买超卖）；NaN 的 bar 跳过，同 CrossOver
+template <typename Ind>
+class Band {
+public:
+    Band(Ind ind, double lower, double upper) : ind_(std::move(ind)), lower_(lower), upper_(upper) {}
+
+    int update(double price) {
+        const double v = ind_.update(price);
+        if (!ind_.ready()) return 0;
+        if (std::isnan(price) || std::isnan(v)) return 0;
+        int signal = 0;
+        if (hasPrev_) {
+            if (prev_ >= lower_ && v < lower_) signal = 1;
+            else if (prev_ <= upper_ && v > upper_) signal = -1;
+        }
+        prev_ = v;
+        hasPrev_ = true;
+        return signal;
+    }
+    void reset() {
+        ind_.reset();
+        hasPrev_ = false;
+    }
+
+private:
+    Ind ind_;
+    double lower_;
+    double upper_;
+    double prev_ = 0.0;
+    bool hasPrev_ = false;
+};
+
+// 多个信号同时给出同方向才成立（AND）
+template <typename... Signals>
+class AllOf {
+    static_assert(sizeof...(Signals) > 0, "AllOf needs at least one signal");
+
+public:
+    explicit AllOf(Signals... s) : signals_(std::move(s)...) {}
+
+    int update(double price) {
+        // 所有子信号都必须 update，保证各自状态推进
+        int results[sizeof...(Signals)];
+        std::size_t i = 0;
+        std::apply([&](auto&... sig) { ((results[i++] = sig.update(price)), ...); }, signals_);
+        for (std::size_t k = 1; k < sizeof...(Signals); ++k) {
+            if (results[k] != results[0]) return 0;
+        }
+        return results[0];
+    }
+    void reset() {
+        std::apply([](auto&... sig) { (sig.reset(), ...); }, signals_);
+    }
+
+private:
+    std::tuple<Signals...> signals_;
+};
+
+// ---------------- 仓位 ----------------
+
+struct FixedSize {
+    explicit FixedSize(double q) : quantity(q) {}
+    double size(int direction, double) const { return direction * quantity; }
+    double quantity;
+};
+
+// 固定金额，按价格折算股数并向下取整到一手（100 股）
+struct FixedNotional {
+    explicit FixedNotional(double n) : notional(n) {}
+    double size(int direction, double price) const {
+        if (!(price > 0.0) || !std::isfinite(price)) return 0.0;   // 含 NaN
+        const double lots = std::floor(notional / price / 100.0);
+        return direction * lots * 100.0;
+    }
+    double notional;
+};
+
+// ---------------- 取价 ----------------
+
+struct ClosePrice {
+    template <typename BarT>
+    double operator()(const BarT& bar) const { return bar.close; }
+};
+
+struct RawPrice {
+    double operator()(double price) const { return price; }
+};
+
+// ---------------- 组合 ----------------
+
+struct PipelineDecision {
+    int direction = 0;      // +1 买 / -1 卖 / 0 不动
+    double quantity = 0.0;  // 带符号数量
+
+    explicit operator bool() const { return direction != 0; }
+};
+
+template <typename PriceFn, typename Signal, typename Sizing>
+class Pipeline {
+public:
+    Pipeline(PriceFn price, Signal signal, Sizing sizing)
+        : price_(std::move(price)), signal_(std::move(signal)), sizing_(std::move(sizing)) {}
+
+    template <typename BarT>
+    PipelineDecision onBar(const BarT& bar) {
+        const double price = price_(bar);
+        const int direction = signal_.update(price);
+        if (direction == 0) return {};
+        // 仓位规则算不出数量（价格缺失等）时不下单，不输出 NaN 数量
+        const double quantity = sizing_.size(direction, price);
+        if (std::isnan(quantity)) return {};
+        return {direction, quantity};
+    }
+
+    void reset() { signal_.reset(); }
+
+private:
+    PriceFn price_;
+    Signal signal_;
+    Sizing sizing_;
+};
+
+template <typename PriceFn, typename Signal, typename Sizing>
+Pipeline<PriceFn, Signal, Sizing> makePipeline(PriceFn price, Signal signal, Sizing sizing)
+{
+    return Pipeline<PriceFn, Signal, Sizing>(std::move(price), std::move(signal), std::move(sizing));
+}
+
+// ---------------- 与动态接口互通 ----------------
+
+// 插件/运行时配置使用的虚接口
+template <typename BarT>
+class IBarPipeline {
+public:
+    virtual ~IBarPipeline() = default;
+    virtual PipelineDecision onBar(const BarT& bar) = 0;
+    virtual void reset() = 0;
+};
+
+// 把静态流水线包装成 IBarPipeline：外层一次虚调用，内部仍完全内联
+template <typename BarT, typename P>
+class PipelineAdapter final : public IBarPipeline<BarT> {
+public:
+    explicit PipelineAdapter(P pipeline) : pipeline_(std::move(pipeline)) {}
+
+    PipelineDecision onBar(const BarT& bar) override { return pipeline_.onBar(bar); }
+    void reset() override { pipeline_.reset(); }
+
+    P& pipeline() { return pipeline_; }
+
+private:
+    P pipeline_;
+};
+
+template <typename BarT, typename P>
+std::unique_ptr<IBarPipeline<BarT>> makeDynamic(P pipeline)
+{
+    return std::make_unique<PipelineAdapter<BarT, P>>(std::move(pipeline));
+}
+
+} // namespace strategies
+} // namespace domain
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace domain {
+namespace strategies {
+
+// 回测成交记录（列式）
+// 每个字段一列连续存放，一笔成交约 40 字节，不为每行分配对象或字符串；标的、策略名只存下标，
+// 名字表每次回测一份。回测结束后以 shared_ptr<const TradeLog> 交出，界面模型直接持有同一份数据，
+// 需要显示哪一行时再用 row(i) 临时拼出来。
+class TradeLog {
+public:
+    // 按需拼出的一行；字符串是指向名字表的视图，TradeLog 存活期间有效
+    struct Row {
+        std::size_t bar = 0;
+        std::int32_t date = 0;
+        std::string_view strategy;
+        std::string_view symbol;
+        double price = 0.0;
+        double quantity = 0.0;      // 带符号，正买负卖
+        double commission = 0.0;
+
+        bool buy() const { return quantity > 0.0; }
+        double amount() const { return price * (quantity < 0.0 ? -quantity : quantity); }
+    };
+
+    TradeLog() = default;
+    TradeLog(std::vector<std::string> symbols, std::vector<std::string> strategies)
+        : symbols_(std::move(symbols)), strategies_(std::move(strategies)) {}
+
+    void reserve(std::size_t n);
+    void append(std::size_t bar, std::int32_t date, std::uint32_t strategy, std::uint32_t symbol,
+                double price, double quantity, double commission);
+    void clear();
+
+    std::size_t size() const { return price_.size(); }
+    bool empty() const { return price_.empty(); }
+    // 下标越界抛 std::out_of_range
+    Row row(std::size_t i) const;
+
+    // 列访问，用于统计、导出等批量处理
+    const std::vector<std::uint32_t>& bars() const { return bar_; }
+    const std::vector<std::int32_t>& dates() const { return date_; }
+    const std::vector<std::uint32_t>& strategyIndices() const { return strategy_; }
+    const std::vector<std::uint32_t>& symbolIndices() const { return symbol_; }
+    const std::vector<double>& prices() const { return price_; }
+    const std::vector<double>& quantities() const { return quantity_; }
+    const std::vector<double>& commissions() const { return commission_; }
+
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    const std::vector<std::string>& strategies() const { return strategies_; }
+
+    // 列数据与名字表占用的字节数（按容量计）
+    std::size_t memoryBytes() const;
+
+private:
+    std::vector<std::string> symbols_;
+    std::vector<std::string> strategies_;
+    std::vector<std::uint32_t> bar_;
+    std::vector<std::int32_t> date_;
+    std::vector<std::uint32_t> strategy_;
+    std::vector<std::uint32_t> symbol_;
+    std::vector<double> price_;
+    std::vector<double> quantity_;
+    std::vector<double> commission_;
+};
+
+// 多份成交记录拼成一个按行号访问的只读列表，给界面的列表模型用
+// 只保存各段的 shared_ptr 和行数前缀和，不复制成交数据；追加一整段只产生一次插入通知：
+//
+//   void TradeRecordModel::appendTrades(std::shared_ptr<const TradeLog> log) {
+//       const auto range = view_.peekAppend(*log);
+//       if (range.count == 0) return;
+//       beginInsertRows({}, int(range.first), int(range.first + range.count - 1));
+//       view_.append(std::move(log));
+//       endInsertRows();
+//   }
+//   QVariant TradeRecordModel::data(const QModelIndex& index, int role) const {
+//       const auto row = view_.row(index.row());   // 只拼出可见的行
+//       ...
+//   }
+class TradeLogView {
+public:
+    struct Range {
+        std::size_t first = 0;
+        std::size_t count = 0;
+    };
+
+    // append 之后新行将占据的区间（不修改视图）
+    Range peekAppend(const TradeLog& log) const { return {size_, log.size()}; }
+    // 追加一整段，返回新行的区间；空记录不追加
+    Range append(std::shared_ptr<const TradeLog> log);
+    void clear();
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t segmentCount() const { return segments_.size(); }
+
+    // 行号越界抛 std::out_of_range
+    TradeLog::Row row(std::size_t i) const;
+
+private:
+    struct Segment {
+        std::shared_ptr<const TradeLog> log;
+        std::size_t first;   // 该段第一行的全局行号
+    };
+
+    std::vector<Segment> segments_;
+    std::size_t size_ = 0;
+};
+
+} // namespace strategies
+} // namespace domain
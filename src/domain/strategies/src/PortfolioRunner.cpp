@@ -0,0 +1,504 @@
+#include "PortfolioRunner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "IndicatorCache.h"
+#include "foundation/log/instrumentation.hpp"
+#include "foundation/memory/Arena.hpp"
+
+namespace domain {
+namespace strategies {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+indicators::IndicatorType indicatorType(SharedIndicatorKind kind)
+{
+    switch (kind) {
+    case SharedIndicatorKind::Sma: return indicators::IndicatorType::Sma;
+    case SharedIndicatorKind::Ema: return indicators::IndicatorType::Ema;
+    case SharedIndicatorKind::StdDev: return indicators::IndicatorType::StdDev;
+    case SharedIndicatorKind::Rsi: return indicators::IndicatorType::Rsi;
+    }
+    throw std::invalid_argument("PortfolioRunner: unknown indicator kind");
+}
+
+// 交给策略的回测级内存：每次 run 一个新的实例，转发给策略专用的 arena。
+// run 结束后实例作废，上一次 run 留下的容器再向它申请内存（push_back 扩容等）直接抛 std::logic_error，
+// 而不是拿到已经分给本次 run 的内存
+class StrategyRunResource : public std::pmr::memory_resource {
+public:
+    explicit StrategyRunResource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+    void expire() { expired_ = true; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (expired_) {
+            throw std::logic_error("PortfolioRunner: container from a previous run's runArena(); rebuild it in onStart");
+        }
+        return upstream_->allocate(bytes, alignment);
+    }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}   // arena 单调分配，释放是空操作
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    std::pmr::memory_resource* upstream_;
+    bool expired_ = false;
+};
+
+struct PendingOrder {
+    std::size_t slot;
+    std::size_t symbol;
+    double quantity;
+    double reserved;   // 买单下单时预留的资金（含手续费），卖单为 0
+};
+
+} // namespace
+
+struct PortfolioRunner::Impl {
+    struct Slot {
+        std::shared_ptr<IPortfolioStrategy> strategy;
+        double weight = 1.0;
+        double initialCapital = 0.0;
+        double cash = 0.0;
+        double reservedCash = 0.0;              // 当根 bar 已下买单占用的资金
+        std::vector<double> positions;
+        std::vector<double> pendingQuantity;    // 当根 bar 已下未成交数量
+        std::vector<double> pendingSells;       // 其中卖单的数量（<= 0）
+        std::size_t orders = 0;
+        double commission = 0.0;
+        std::vector<double> equityCurve;
+    };
+
+    double totalCapital;
+    std::unique_ptr<IBrokerSimulator> broker;
+    // 策略的回测级内存与运行器自己的缓冲区分开：策略误用旧容器最多破坏策略自己的数据。
+    // 每次 run 换一个 StrategyRunResource；旧实例保留到运行器析构，旧容器析构时还能安全地调用它。
+    // 必须声明在 slots 之前：策略（及其容器）先于这些资源析构
+    foundation::memory::MonotonicArena strategyArena{16 * 1024};
+    std::vector<std::unique_ptr<StrategyRunResource>> strategyResources;
+    std::vector<Slot> slots;
+
+    // 回测级 / bar 级内存；runArena 上的容器在 run 开始时重建
+    foundation::memory::MonotonicArena runArena{64 * 1024};
+    foundation::memory::MonotonicArena stepArena{16 * 1024};
+
+    const MarketFrame* frame = nullptr;
+    std::size_t t = 0;
+    std::pmr::vector<double> lastPrice{&runArena};
+
+    // 指标去重交给 IndicatorCache：相同 (标的, 类型, 周期) 共享一个流式实例，每根 bar 只更新一次
+    indicators::IndicatorCache indicatorCache;
+    std::vector<indicators::IndicatorCache::StreamHandle> indicatorHandles;   // IndicatorHandle::index 指向这里
+    std::vector<std::uint32_t> indicatorSymbols;                              // 有指标的标的，每根 bar 只推这些
+    std::size_t indicatorRequests = 0;
+
+    std::pmr::vector<PendingOrder> pending{&runArena};
+    std::pmr::vector<double> netQuantity{&runArena};
+    std::pmr::vector<double> grossQuantity{&runArena};
+    std::pmr::vector<double> buyQuantity{&runArena};
+    std::pmr::vector<double> pendingBuys{&runArena};   // 当根 bar 各标的已下买单总量（所有策略）
+    TradeLog* trades = nullptr;   // 本次 run 的成交记录，run 结束后交给 PortfolioReport
+    std::size_t lastTradeCount = 0;   // 上一次 run 的成交笔数，用来预留列容量
+
+    double currentPrice(std::size_t symbol) const { return frame->at(t, symbol); }
+
+    void checkSymbol(std::size_t symbol) const {
+        if (symbol >= frame->symbolCount()) throw std::out_of_range("PortfolioRunner: symbol index out of range");
+    }
+
+    // 先换掉引用 runArena 的容器，再整体重置
+    void resetArenas() {
+        std::pmr::vector<double>(&runArena).swap(lastPrice);
+        std::pmr::vector<PendingOrder>(&runArena).swap(pending);
+        std::pmr::vector<double>(&runArena).swap(netQuantity);
+        std::pmr::vector<double>(&runArena).swap(grossQuantity);
+        std::pmr::vector<double>(&runArena).swap(buyQuantity);
+        std::pmr::vector<double>(&runArena).swap(pendingBuys);
+        runArena.reset();
+        stepArena.reset();
+        if (!strategyResources.empty()) strategyResources.back()->expire();
+        strategyArena.reset();
+        strategyResources.push_back(std::make_unique<StrategyRunResource>(&strategyArena));
+    }
+
+    double slotEquity(const Slot& slot) const {
+        double equity = slot.cash;
+        for (std::size_t s = 0; s < slot.positions.size(); ++s) {
+            if (slot.positions[s] != 0.0) equity += slot.positions[s] * lastPrice[s];
+        }
+        return equity;
+    }
+
+    IndicatorHandle requestIndicator(std::size_t symbol, SharedIndicatorKind kind, std::size_t period) {
+        if (period == 0 || period >= (1u << 24)) throw std::invalid_argument("PortfolioRunner: invalid indicator period");
+        checkSymbol(symbol);
+        ++indicatorRequests;
+        const auto symbolId = static_cast<std::uint32_t>(symbol);
+        const indicators::IndicatorKey key{symbolId, indicatorType(kind), static_cast<std::uint32_t>(period), 0.0};
+        indicatorHandles.push_back(indicatorCache.acquire(key));
+        if (std::find(indicatorSymbols.begin(), indicatorSymbols.end(), symbolId) == indicatorSymbols.end()) {
+            indicatorSymbols.push_back(symbolId);
+        }
+        return IndicatorHandle{static_cast<std::int32_t>(indicatorHandles.size() - 1)};
+    }
+
+    void submit(std::size_t slotIndex, std::size_t symbol, double quantity) {
+        checkSymbol(symbol);
+        if (quantity == 0.0 || std::isnan(quantity)) return;
+        const double price = currentPrice(symbol);
+        if (std::isnan(price) || price <= 0.0) return;  // 停牌不能交易
+
+        Slot& slot = slots[slotIndex];
+        double reserved = 0.0;
+        if (quantity < 0.0) {
+            // A 股不能卖空：最多卖出已成交持仓减去本 bar 已下的卖单。
+            // 同 bar 的买单不算数——settle 可能把它缩量到 0
+            quantity = std::max(quantity, -(slot.positions[symbol] + slot.pendingSells[symbol]));
+            if (quantity < 0.0) slot.pendingSells[symbol] += quantity;
+        } else {
+            // 资金不足时按可用资金截断；按买方滑点后的价格加手续费预留。
+            // 撮合价可能随数量变化，这里按本 bar 该标的全部买单合成一笔估价（净额不会超过它）；
+            // 估不准的部分由 settle 缩量兜底
+            // 估价用的数量先按参考价能买到的上限截断，避免一笔远超资金的目标仓位把估价推到天上
+            const double available = std::max(0.0, slot.cash - slot.reservedCash);
+            const double affordable = std::min(quantity, std::floor(available / price));
+            const double buyPrice = std::max(price, broker->fillPrice(symbol, pendingBuys[symbol] + affordable, price));
+            quantity = std::min(quantity, std::floor(available / buyPrice));
+            // 手续费随成交额单调不减，按截断前的手续费再扣一次即可保证不超支
+            if (quantity > 0.0) {
+                const double fee = broker->commission(quantity * buyPrice);
+                quantity = std::min(quantity, std::floor(std::max(0.0, available - fee) / buyPrice));
+            }
+            if (quantity > 0.0) {
+                reserved = quantity * buyPrice + broker->commission(quantity * buyPrice);
+                slot.reservedCash += reserved;
+                pendingBuys[symbol] += quantity;
+            }
+        }
+        if (quantity == 0.0) return;
+
+        slot.pendingQuantity[symbol] += quantity;
+        ++slot.orders;
+        pending.push_back({slotIndex, symbol, quantity, reserved});
+    }
+
+    // 按当前 pending 计算各标的的买/卖成交均价与净额手续费，不修改账户
+    void priceNetted(std::pmr::vector<double>& buyFill, std::pmr::vector<double>& sellFill,
+                     std::pmr::vector<double>& commission) {
+        const std::size_t n = frame->symbolCount();
+        netQuantity.assign(n, 0.0);
+        grossQuantity.assign(n, 0.0);
+        buyQuantity.assign(n, 0.0);
+        for (const auto& o : pending) {
+            netQuantity[o.symbol] += o.quantity;
+            grossQuantity[o.symbol] += std::fabs(o.quantity);
+            if (o.quantity > 0.0) buyQuantity[o.symbol] += o.quantity;
+        }
+        std::fill(buyFill.begin(), buyFill.end(), kNaN);
+        std::fill(sellFill.begin(), sellFill.end(), kNaN);
+        std::fill(commission.begin(), commission.end(), 0.0);
+        for (std::size_t s = 0; s < n; ++s) {
+            if (grossQuantity[s] == 0.0) continue;
+            const double ref = currentPrice(s);
+            const double net = netQuantity[s];
+            buyFill[s] = ref;
+            sellFill[s] = ref;
+            if (net == 0.0) continue;   // 完全内部对冲，不经过撮合
+
+            const double netFill = broker->fillPrice(s, net, ref);
+            commission[s] = broker->commission(std::fabs(net) * netFill);
+            const double buys = buyQuantity[s];
+            const double sells = grossQuantity[s] - buys;
+            if (net > 0.0) {
+                buyFill[s] = (sells * ref + net * netFill) / buys;
+            } else {
+                sellFill[s] = (buys * ref - net * netFill) / sells;
+            }
+        }
+    }
+
+    double commissionShare(const PendingOrder& o, const std::pmr::vector<double>& commission) const {
+        return commission[o.symbol] * std::fabs(o.quantity) / grossQuantity[o.symbol];
+    }
+
+    // 按标的轧差 -> 净额撮合 -> 按数量比例分摊手续费
+    // 内部对冲的部分按参考价成交；净额部分按撮合价成交，只计入净额所在一方的均价，
+    // 对手一方不会拿到对它有利的滑点价。
+    // 撮合价/手续费与数量有关时，轧差后的实际成本可能超过下单时的预留：
+    // 这样的买单按预留额缩量后重新撮合，直到每笔买单都在预留之内。
+    // 卖单分摊的手续费（如最低佣金）可能超过卖出所得，倒贴的总额超过账户空闲现金时撤掉该账户这类卖单。
+    // 两者合起来保证结算后现金不会为负
+    void settle(PortfolioReport& report) {
+        if (pending.empty()) return;
+        const std::size_t n = frame->symbolCount();
+        std::pmr::vector<double> buyFill(n, kNaN, &stepArena);
+        std::pmr::vector<double> sellFill(n, kNaN, &stepArena);
+        std::pmr::vector<double> commission(n, 0.0, &stepArena);
+        std::pmr::vector<double> sellLoss(slots.size(), 0.0, &stepArena);
+
+        for (;;) {
+            priceNetted(buyFill, sellFill, commission);
+            bool trimmed = false;
+            std::fill(sellLoss.begin(), sellLoss.end(), 0.0);
+            for (const auto& o : pending) {
+                if (o.quantity >= 0.0) continue;
+                const double loss = commissionShare(o, commission) + o.quantity * sellFill[o.symbol];
+                if (loss > 0.0) sellLoss[o.slot] += loss;
+            }
+            for (auto& o : pending) {
+                if (o.quantity >= 0.0) continue;
+                const Slot& slot = slots[o.slot];
+                if (sellLoss[o.slot] <= slot.cash - slot.reservedCash) continue;
+                // 买单不超过预留，空闲现金兜不住倒贴；撤掉的卖单不再回来，循环同样必然结束
+                if (commissionShare(o, commission) + o.quantity * sellFill[o.symbol] > 0.0) {
+                    o.quantity = 0.0;
+                    trimmed = true;
+                }
+            }
+            for (auto& o : pending) {
+                if (o.quantity <= 0.0) continue;
+                const double price = buyFill[o.symbol];
+                const double share = commissionShare(o, commission);
+                if (o.quantity * price + share <= o.reserved * (1.0 + 1e-12)) continue;
+                // 每次至少少买一股，数量单调下降，循环必然结束
+                const double fit = std::floor(std::max(0.0, o.reserved - share) / price);
+                o.quantity = std::max(0.0, std::min(fit, o.quantity - 1.0));
+                trimmed = true;
+            }
+            if (!trimmed) break;
+        }
+
+        for (std::size_t s = 0; s < n; ++s) {
+            report.grossTraded += grossQuantity[s];
+            report.netTraded += std::fabs(netQuantity[s]);
+        }
+
+        for (const auto& o : pending) {
+            if (o.quantity == 0.0) continue;   // 被缩量到 0 的买单、被撤掉的卖单
+            Slot& slot = slots[o.slot];
+            const double price = o.quantity > 0.0 ? buyFill[o.symbol] : sellFill[o.symbol];
+            const double share = commissionShare(o, commission);
+            slot.cash -= o.quantity * price + share;
+            slot.commission += share;
+            slot.positions[o.symbol] += o.quantity;
+            trades->append(t, frame->dates[t], static_cast<std::uint32_t>(o.slot), static_cast<std::uint32_t>(o.symbol),
+                           price, o.quantity, share);
+        }
+
+        for (auto& slot : slots) {
+            std::fill(slot.pendingQuantity.begin(), slot.pendingQuantity.end(), 0.0);
+            std::fill(slot.pendingSells.begin(), slot.pendingSells.end(), 0.0);
+            slot.reservedCash = 0.0;
+        }
+        std::fill(pendingBuys.begin(), pendingBuys.end(), 0.0);
+        pending.clear();
+    }
+};
+
+// ==================== SimpleBrokerSimulator ====================
+
+double SimpleBrokerSimulator::fillPrice(std::size_t, double netQuantity, double refPrice)
+{
+    const double slip = refPrice * slippageBps_ / 10000.0;
+    return netQuantity > 0.0 ? refPrice + slip : refPrice - slip;
+}
+
+double SimpleBrokerSimulator::commission(double notional) const
+{
+    if (notional <= 0.0) return 0.0;
+    return std::max(notional * commissionRate_, minCommission_);
+}
+
+// ==================== StrategySetup / StrategyContext ====================
+
+IndicatorHandle StrategySetup::indicator(std::size_t symbol, SharedIndicatorKind kind, std::size_t period)
+{
+    return runner_.impl_->requestIndicator(symbol, kind, period);
+}
+
+std::size_t StrategySetup::symbolIndex(const std::string& symbol) const
+{
+    const auto& symbols = runner_.impl_->frame->symbols;
+    auto it = std::find(symbols.begin(), symbols.end(), symbol);
+    if (it == symbols.end()) throw std::out_of_range("PortfolioRunner: unknown symbol " + symbol);
+    return static_cast<std::size_t>(it - symbols.begin());
+}
+
+std::size_t StrategySetup::symbolCount() const
+{
+    return runner_.impl_->frame->symbolCount();
+}
+
+std::pmr::memory_resource* StrategySetup::runArena() const
+{
+    return runner_.impl_->strategyResources.back().get();
+}
+
+std::int32_t StrategyContext::date() const { return runner_.impl_->frame->dates[runner_.impl_->t]; }
+std::size_t StrategyContext::barIndex() const { return runner_.impl_->t; }
+std::size_t StrategyContext::symbolCount() const { return runner_.impl_->frame->symbolCount(); }
+double StrategyContext::price(std::size_t symbol) const
+{
+    runner_.impl_->checkSymbol(symbol);
+    return runner_.impl_->currentPrice(symbol);
+}
+
+double StrategyContext::value(IndicatorHandle h) const
+{
+    if (!h.valid()) return kNaN;
+    const auto& handles = runner_.impl_->indicatorHandles;
+    if (static_cast<std::size_t>(h.index) >= handles.size()) {
+        throw std::out_of_range("PortfolioRunner: indicator handle out of range");
+    }
+    return handles[h.index].value();
+}
+
+double StrategyContext::cash() const { return runner_.impl_->slots[slot_].cash; }
+double StrategyContext::position(std::size_t symbol) const
+{
+    runner_.impl_->checkSymbol(symbol);
+    return runner_.impl_->slots[slot_].positions[symbol];
+}
+double StrategyContext::equity() const { return runner_.impl_->slotEquity(runner_.impl_->slots[slot_]); }
+
+void StrategyContext::order(std::size_t symbol, double quantity)
+{
+    runner_.impl_->submit(slot_, symbol, quantity);
+}
+
+std::pmr::memory_resource* StrategyContext::scratch() const
+{
+    return &runner_.impl_->stepArena;
+}
+
+void StrategyContext::orderTarget(std::size_t symbol, double targetQuantity)
+{
+    runner_.impl_->checkSymbol(symbol);
+    const auto& slot = runner_.impl_->slots[slot_];
+    order(symbol, targetQuantity - slot.positions[symbol] - slot.pendingQuantity[symbol]);
+}
+
+// ==================== PortfolioRunner ====================
+
+PortfolioRunner::PortfolioRunner(double totalCapital, std::unique_ptr<IBrokerSimulator> broker)
+    : impl_(std::make_unique<Impl>())
+{
+    impl_->totalCapital = totalCapital;
+    impl_->broker = std::move(broker);
+}
+
+PortfolioRunner::~PortfolioRunner() = default;
+
+void PortfolioRunner::addStrategy(std::shared_ptr<IPortfolioStrategy> strategy, double capitalWeight)
+{
+    if (!strategy) throw std::invalid_argument("PortfolioRunner: null strategy");
+    if (capitalWeight <= 0.0) throw std::invalid_argument("PortfolioRunner: capital weight must be positive");
+    Impl::Slot slot;
+    slot.strategy = std::move(strategy);
+    slot.weight = capitalWeight;
+    impl_->slots.push_back(std::move(slot));
+}
+
+std::size_t PortfolioRunner::strategyCount() const
+{
+    return impl_->slots.size();
+}
+
+PortfolioReport PortfolioRunner::run(const MarketFrame& frame)
+{
+    Impl& d = *impl_;
+    if (frame.close.size() != frame.symbolCount() * frame.barCount()) {
+        throw std::invalid_argument("PortfolioRunner: close matrix size does not match symbols x dates");
+    }
+    d.resetArenas();
+    d.frame = &frame;
+    d.t = 0;
+    d.lastPrice.assign(frame.symbolCount(), 0.0);
+    d.pendingBuys.assign(frame.symbolCount(), 0.0);
+    d.indicatorHandles.clear();
+    d.indicatorSymbols.clear();
+    d.indicatorCache.clear();
+    d.indicatorRequests = 0;
+
+    double weightSum = 0.0;
+    for (const auto& slot : d.slots) weightSum += slot.weight;
+    for (auto& slot : d.slots) {
+        slot.initialCapital = weightSum > 0.0 ? d.totalCapital * slot.weight / weightSum : 0.0;
+        slot.cash = slot.initialCapital;
+        slot.reservedCash = 0.0;
+        slot.positions.assign(frame.symbolCount(), 0.0);
+        slot.pendingQuantity.assign(frame.symbolCount(), 0.0);
+        slot.pendingSells.assign(frame.symbolCount(), 0.0);
+        slot.orders = 0;
+        slot.commission = 0.0;
+        slot.equityCurve.clear();
+        slot.equityCurve.reserve(frame.barCount());
+    }
+
+    StrategySetup setup(*this);
+    for (auto& slot : d.slots) slot.strategy->onStart(setup);
+
+    PortfolioReport report;
+    report.equityCurve.reserve(frame.barCount());
+    std::vector<std::string> strategyNames;
+    for (const auto& slot : d.slots) strategyNames.push_back(slot.strategy->name());
+    auto trades = std::make_shared<TradeLog>(frame.symbols, std::move(strategyNames));
+    trades->reserve(d.lastTradeCount);
+    d.trades = trades.get();
+    std::vector<StrategyContext> contexts;
+    contexts.reserve(d.slots.size());
+    for (std::size_t i = 0; i < d.slots.size(); ++i) contexts.push_back(StrategyContext(*this, i));
+
+    for (d.t = 0; d.t < frame.barCount(); ++d.t) {
+        for (std::size_t s = 0; s < frame.symbolCount(); ++s) {
+            const double p = frame.at(d.t, s);
+            if (!std::isnan(p)) d.lastPrice[s] = p;
+        }
+        // 共享指标：每根 bar 每个标的推一次，停牌的 NaN 由指标自己跳过
+        for (std::uint32_t s : d.indicatorSymbols) d.indicatorCache.onBar(s, d.t + 1, frame.at(d.t, s));
+        {
+            ENGINE_PROBE(foundation::metrics::Stage::StrategyStep);
+            for (std::size_t i = 0; i < d.slots.size(); ++i) d.slots[i].strategy->onBar(contexts[i]);
+        }
+        {
+            ENGINE_PROBE(foundation::metrics::Stage::OrderSimulation);
+            d.settle(report);
+        }
+        report.scratchPeakBytes = std::max(report.scratchPeakBytes, d.stepArena.used());
+        d.stepArena.reset();
+
+        double total = 0.0;
+        for (auto& slot : d.slots) {
+            const double equity = d.slotEquity(slot);
+            slot.equityCurve.push_back(equity);
+            total += equity;
+        }
+        report.equityCurve.push_back(total);
+    }
+
+    report.sharedIndicators = d.indicatorCache.stats().streamEntries;
+    report.indicatorRequests = d.indicatorRequests;
+    for (auto& slot : d.slots) {
+        StrategyReport r;
+        r.name = slot.strategy->name();
+        r.initialCapital = slot.initialCapital;
+        r.finalEquity = slot.equityCurve.empty() ? slot.initialCapital : slot.equityCurve.back();
+        r.orders = slot.orders;
+        r.commission = slot.commission;
+        r.equityCurve = std::move(slot.equityCurve);
+        report.strategies.push_back(std::move(r));
+    }
+    d.lastTradeCount = trades->size();
+    report.trades = std::move(trades);
+    d.trades = nullptr;
+    d.frame = nullptr;
+    return report;
+}
+
+} // namespace strategies
+} // namespace domain
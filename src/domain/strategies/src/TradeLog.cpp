@@ -0,0 +1,97 @@
+#include "TradeLog.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace domain {
+namespace strategies {
+
+// ==================== TradeLog ====================
+
+void TradeLog::reserve(std::size_t n)
+{
+    bar_.reserve(n);
+    date_.reserve(n);
+    strategy_.reserve(n);
+    symbol_.reserve(n);
+    price_.reserve(n);
+    quantity_.reserve(n);
+    commission_.reserve(n);
+}
+
+void TradeLog::append(std::size_t bar, std::int32_t date, std::uint32_t strategy, std::uint32_t symbol,
+                      double price, double quantity, double commission)
+{
+    bar_.push_back(static_cast<std::uint32_t>(bar));
+    date_.push_back(date);
+    strategy_.push_back(strategy);
+    symbol_.push_back(symbol);
+    price_.push_back(price);
+    quantity_.push_back(quantity);
+    commission_.push_back(commission);
+}
+
+void TradeLog::clear()
+{
+    bar_.clear();
+    date_.clear();
+    strategy_.clear();
+    symbol_.clear();
+    price_.clear();
+    quantity_.clear();
+    commission_.clear();
+}
+
+TradeLog::Row TradeLog::row(std::size_t i) const
+{
+    if (i >= size()) throw std::out_of_range("TradeLog: row index out of range");
+    Row r;
+    r.bar = bar_[i];
+    r.date = date_[i];
+    if (strategy_[i] < strategies_.size()) r.strategy = strategies_[strategy_[i]];
+    if (symbol_[i] < symbols_.size()) r.symbol = symbols_[symbol_[i]];
+    r.price = price_[i];
+    r.quantity = quantity_[i];
+    r.commission = commission_[i];
+    return r;
+}
+
+std::size_t TradeLog::memoryBytes() const
+{
+    std::size_t bytes = bar_.capacity() * sizeof(std::uint32_t) + date_.capacity() * sizeof(std::int32_t) +
+                        strategy_.capacity() * sizeof(std::uint32_t) + symbol_.capacity() * sizeof(std::uint32_t) +
+                        (price_.capacity() + quantity_.capacity() + commission_.capacity()) * sizeof(double);
+    for (const auto& s : symbols_) bytes += sizeof(std::string) + s.capacity();
+    for (const auto& s : strategies_) bytes += sizeof(std::string) + s.capacity();
+    return bytes;
+}
+
+// ==================== TradeLogView ====================
+
+TradeLogView::Range TradeLogView::append(std::shared_ptr<const TradeLog> log)
+{
+    if (!log || log->empty()) return {size_, 0};
+    const Range range{size_, log->size()};
+    segments_.push_back({std::move(log), size_});
+    size_ += range.count;
+    return range;
+}
+
+void TradeLogView::clear()
+{
+    segments_.clear();
+    size_ = 0;
+}
+
+TradeLog::Row TradeLogView::row(std::size_t i) const
+{
+    if (i >= size_) throw std::out_of_range("TradeLogView: row index out of range");
+    // 第一个起始行号大于 i 的段的前一段
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), i,
+                               [](std::size_t row, const Segment& s) { return row < s.first; });
+    --it;
+    return it->log->row(i - it->first);
+}
+
+} // namespace strategies
+} // namespace domain
@@ -0,0 +1,431 @@
+// 引擎基准套件（bench_engine）
+// 在可复现的合成行情上测量各环节吞吐，结果以 JSON 输出，便于按提交记录跟踪回归。
+//
+// 用法：bench_engine [--symbols N] [--bars N] [--freq daily|minute] [--seed N]
+//                    [--repeat N] [--threads N] [--filter 子串] [--out 文件]
+// 构建：cmake -S src/engine/bench -B build-bench && cmake --build build-bench（见同目录 CMakeLists.txt）
+//
+// 场景：
+//   dispatch           报价经 ConflatingQuoteQueue 发布/取出并分发给回调
+//   indicator_update   IndicatorCache 流式更新 SMA/EMA/RSI
+//   ma_backtest        均线交叉策略在 PortfolioRunner 上的完整回测
+//   parallel_backtest  多组参数的回测分到 N 个线程并行
+//
+// 每个场景先热身一次，再计时 repeat 次，报告最优与中位数。
+// 每次运行都计算一个结果校验值，多次运行不一致时进程返回非零。
+// 计时时关闭 ENGINE_PROBE；之后再开着探针跑一次，按阶段（stages）报告样本数与耗时分布。
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IndicatorCache.h"
+#include "PortfolioRunner.h"
+#include "QuoteStream.h"
+#include "SyntheticMarket.h"
+#include "foundation/log/instrumentation.hpp"
+
+using namespace engine::bench;
+using foundation::metrics::Instrumentation;
+
+namespace {
+
+struct BenchConfig {
+    SyntheticMarketOptions market;
+    int repeat = 5;
+    std::size_t threads = 0;   // 0 = 硬件线程数
+    std::string filter;
+    std::string out;
+};
+
+struct BenchResult {
+    std::string name;
+    std::size_t items = 0;      // 每次运行处理的 (标的, bar) 数
+    std::vector<double> samplesNs;
+    double checksum = 0.0;
+    bool deterministic = true;
+    std::vector<Instrumentation::StageSummary> stages;   // 开探针那一次的分阶段数据，只含有样本的阶段
+
+    double best() const { return *std::min_element(samplesNs.begin(), samplesNs.end()); }
+    double median() const {
+        auto s = samplesNs;
+        std::sort(s.begin(), s.end());
+        return s[s.size() / 2];
+    }
+    double nsPerItem() const { return median() / static_cast<double>(items); }
+    // 计时分辨率不够时中位数可能是 0，此时不给吞吐（JSON 里不能出现 inf）
+    double itemsPerSec() const { return nsPerItem() > 0.0 ? 1e9 / nsPerItem() : 0.0; }
+};
+
+template <typename F>
+BenchResult measure(const std::string& name, std::size_t items, int repeat, F&& run)
+{
+    BenchResult r;
+    r.name = name;
+    r.items = items;
+    const auto check = [&r](double c) {
+        if (c != r.checksum && !(std::isnan(c) && std::isnan(r.checksum))) r.deterministic = false;
+    };
+    Instrumentation::setEnabled(false);
+    r.checksum = run();   // 热身
+    for (int i = 0; i < repeat; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const double c = run();
+        const auto t1 = std::chrono::steady_clock::now();
+        r.samplesNs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        check(c);
+    }
+
+    Instrumentation::reset();
+    Instrumentation::setEnabled(true);
+    check(run());
+    Instrumentation::setEnabled(false);
+    for (const auto& stage : Instrumentation::snapshot()) {
+        if (stage.count > 0) r.stages.push_back(stage);
+    }
+    return r;
+}
+
+// ---------- dispatch ----------
+
+double runDispatch(const SyntheticMarket& m)
+{
+    engine::ConflatingQuoteQueue queue(m.symbolCount());
+    double sum = 0.0;
+    std::uint64_t events = 0;
+    const std::function<void(const engine::LiveTick&)> handler = [&](const engine::LiveTick& tick) {
+        sum += tick.last;
+        ++events;
+    };
+    const std::size_t S = m.symbolCount();
+    engine::LiveTick tick;
+    for (std::size_t t = 0; t < m.barCount(); ++t) {
+        for (std::size_t s = 0; s < S; ++s) {
+            const std::size_t i = t * S + s;
+            if (std::isnan(m.close[i])) continue;
+            tick.symbolId = static_cast<std::uint32_t>(s);
+            tick.date = m.dates[t];
+            tick.time = m.times[t] * 100000;
+            tick.last = m.close[i];
+            tick.open = m.open[i];
+            tick.high = m.high[i];
+            tick.low = m.low[i];
+            tick.volume = m.volume[i];
+            queue.publish(tick);
+        }
+        while (queue.poll(tick)) handler(tick);
+    }
+    return sum + static_cast<double>(events);
+}
+
+// ---------- indicator_update ----------
+
+double runIndicatorUpdate(const SyntheticMarket& m)
+{
+    using domain::indicators::IndicatorCache;
+    using domain::indicators::IndicatorKey;
+    using domain::indicators::IndicatorType;
+
+    IndicatorCache cache;
+    const std::size_t S = m.symbolCount();
+    std::vector<IndicatorCache::StreamHandle> handles;
+    handles.reserve(S * 4);
+    for (std::size_t s = 0; s < S; ++s) {
+        const auto id = static_cast<std::uint32_t>(s);
+        handles.push_back(cache.acquire(IndicatorKey{id, IndicatorType::Sma, 5, 0.0}));
+        handles.push_back(cache.acquire(IndicatorKey{id, IndicatorType::Sma, 20, 0.0}));
+        handles.push_back(cache.acquire(IndicatorKey{id, IndicatorType::Ema, 12, 0.0}));
+        handles.push_back(cache.acquire(IndicatorKey{id, IndicatorType::Rsi, 14, 0.0}));
+    }
+    for (std::size_t t = 0; t < m.barCount(); ++t) {
+        for (std::size_t s = 0; s < S; ++s) {
+            const double c = m.close[t * S + s];
+            if (!std::isnan(c)) cache.onBar(static_cast<std::uint32_t>(s), t + 1, c);
+        }
+    }
+    double sum = 0.0;
+    for (const auto& h : handles) {
+        const double v = h.value();
+        if (std::isfinite(v)) sum += v;
+    }
+    return sum;
+}
+
+// ---------- ma_backtest / parallel_backtest ----------
+
+using namespace domain::strategies;
+
+// 全市场均线交叉：快线在慢线之上时持有等权仓位（整手），否则空仓
+class MovingAverageCrossStrategy : public IPortfolioStrategy {
+public:
+    MovingAverageCrossStrategy(std::size_t fast, std::size_t slow) : fast_(fast), slow_(slow) {}
+
+    std::string name() const override { return "ma_" + std::to_string(fast_) + "_" + std::to_string(slow_); }
+
+    void onStart(StrategySetup& setup) override {
+        for (std::size_t s = 0; s < setup.symbolCount(); ++s) {
+            fastHandles_.push_back(setup.indicator(s, SharedIndicatorKind::Sma, fast_));
+            slowHandles_.push_back(setup.indicator(s, SharedIndicatorKind::Sma, slow_));
+        }
+    }
+
+    void onBar(StrategyContext& ctx) override {
+        const std::size_t n = ctx.symbolCount();
+        const double budget = ctx.equity() / static_cast<double>(n);
+        for (std::size_t s = 0; s < n; ++s) {
+            const double price = ctx.price(s);
+            const double f = ctx.value(fastHandles_[s]);
+            const double sl = ctx.value(slowHandles_[s]);
+            if (std::isnan(price) || std::isnan(f) || std::isnan(sl)) continue;
+            const double target = f > sl ? std::floor(budget / price / 100.0) * 100.0 : 0.0;
+            if (target != ctx.position(s)) ctx.orderTarget(s, target);
+        }
+    }
+
+private:
+    std::size_t fast_;
+    std::size_t slow_;
+    std::vector<IndicatorHandle> fastHandles_;
+    std::vector<IndicatorHandle> slowHandles_;
+};
+
+double runBacktest(const MarketFrame& frame, std::size_t fast, std::size_t slow)
+{
+    PortfolioRunner runner(1e7);
+    runner.addStrategy(std::make_shared<MovingAverageCrossStrategy>(fast, slow));
+    return runner.run(frame).strategies.front().finalEquity;
+}
+
+// 参数网格：(5, 20), (5, 30), (10, 30), (10, 60) ...
+std::pair<std::size_t, std::size_t> gridParams(std::size_t job)
+{
+    static const std::size_t fasts[] = {5, 10};
+    static const std::size_t slows[] = {20, 30, 60, 120};
+    return {fasts[job % 2], slows[(job / 2) % 4]};
+}
+
+double runParallelBacktests(const MarketFrame& frame, std::size_t threads, std::size_t jobs)
+{
+    std::vector<double> equity(jobs, 0.0);
+    std::vector<std::thread> workers;
+    for (std::size_t w = 0; w < threads; ++w) {
+        workers.emplace_back([&, w] {
+            for (std::size_t j = w; j < jobs; j += threads) {
+                const auto [fast, slow] = gridParams(j);
+                equity[j] = runBacktest(frame, fast, slow);
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    double sum = 0.0;
+    for (double e : equity) sum += e;
+    return sum;
+}
+
+// ---------- 输出 ----------
+
+std::string jsonEscape(const std::string& s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+const char* compilerName()
+{
+#if defined(_MSC_VER)
+    return "msvc";
+#elif defined(__clang__)
+    return "clang";
+#elif defined(__GNUC__)
+    return "gcc";
+#else
+    return "unknown";
+#endif
+}
+
+std::string toJson(const BenchConfig& cfg, std::uint64_t marketChecksum, const std::vector<BenchResult>& results)
+{
+    std::string out;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"suite\":\"bench_engine\",\"schema\":1,"
+                  "\"config\":{\"symbols\":%zu,\"bars\":%zu,\"freq\":\"%s\",\"seed\":%llu,\"repeat\":%d,"
+                  "\"threads\":%zu,\"market_checksum\":\"%016llx\"},"
+                  "\"env\":{\"compiler\":\"%s\",\"optimized\":%s,\"hardware_threads\":%u},\"results\":[",
+                  cfg.market.symbols, cfg.market.bars,
+                  cfg.market.frequency == BarFrequency::Minute ? "minute" : "daily",
+                  static_cast<unsigned long long>(cfg.market.seed), cfg.repeat, cfg.threads,
+                  static_cast<unsigned long long>(marketChecksum), compilerName(),
+#if defined(NDEBUG)
+                  "true",
+#else
+                  "false",
+#endif
+                  std::thread::hardware_concurrency());
+    out += buf;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"name\":\"%s\",\"items\":%zu,\"best_ns\":%.0f,\"median_ns\":%.0f,"
+                      "\"ns_per_item\":%.3f,\"items_per_sec\":%.0f,\"checksum\":%.17g,\"deterministic\":%s,\"stages\":{",
+                      i ? "," : "", jsonEscape(r.name).c_str(), r.items, r.best(), r.median(), r.nsPerItem(),
+                      r.itemsPerSec(), std::isfinite(r.checksum) ? r.checksum : 0.0,
+                      r.deterministic ? "true" : "false");
+        out += buf;
+        for (std::size_t k = 0; k < r.stages.size(); ++k) {
+            const auto& st = r.stages[k];
+            std::snprintf(buf, sizeof(buf),
+                          "%s\"%s\":{\"samples\":%llu,\"total_ms\":%.3f,\"mean_us\":%.3f,\"p50_us\":%.3f,"
+                          "\"p99_us\":%.3f,\"max_us\":%.3f}",
+                          k ? "," : "", foundation::metrics::stageName(st.stage),
+                          static_cast<unsigned long long>(st.count), st.totalMillis, st.meanMicros, st.p50Micros,
+                          st.p99Micros, st.maxMicros);
+            out += buf;
+        }
+        out += "}}";
+    }
+    out += "]}";
+    return out;
+}
+
+[[noreturn]] void usage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--symbols N] [--bars N] [--freq daily|minute] [--seed N] [--repeat N] "
+                 "[--threads N] [--filter NAME] [--out FILE]\n"
+                 "  --symbols/--bars/--repeat take positive integers, --seed/--threads non-negative ones\n",
+                 argv0);
+    std::exit(2);
+}
+
+// 十进制非负整数；空串、负号、多余字符都不接受
+bool parseCount(const std::string& value, unsigned long long& out)
+{
+    if (value.empty() || value[0] < '0' || value[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    out = std::strtoull(value.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+BenchConfig parseArgs(int argc, char** argv)
+{
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) usage(argv[0]);
+        const std::string value = argv[++i];
+        unsigned long long n = 0;
+        // 标的数、bar 数、重复次数必须为正：为 0 时没有可计时的数据，每项耗时会除以 0
+        const auto positive = [&] {
+            if (!parseCount(value, n) || n == 0) usage(argv[0]);
+            return n;
+        };
+        const auto nonNegative = [&] {
+            if (!parseCount(value, n)) usage(argv[0]);
+            return n;
+        };
+        if (arg == "--symbols") {
+            cfg.market.symbols = static_cast<std::size_t>(positive());
+        } else if (arg == "--bars") {
+            cfg.market.bars = static_cast<std::size_t>(positive());
+        } else if (arg == "--freq") {
+            if (value == "daily") {
+                cfg.market.frequency = BarFrequency::Daily;
+            } else if (value == "minute") {
+                cfg.market.frequency = BarFrequency::Minute;
+            } else {
+                usage(argv[0]);
+            }
+        } else if (arg == "--seed") {
+            cfg.market.seed = nonNegative();
+        } else if (arg == "--repeat") {
+            cfg.repeat = static_cast<int>(std::min<unsigned long long>(positive(), 1000000));
+        } else if (arg == "--threads") {
+            cfg.threads = static_cast<std::size_t>(nonNegative());
+        } else if (arg == "--filter") {
+            cfg.filter = value;
+        } else if (arg == "--out") {
+            cfg.out = value;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (cfg.threads == 0) cfg.threads = std::max(1u, std::thread::hardware_concurrency());
+    return cfg;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const BenchConfig cfg = parseArgs(argc, argv);
+    Instrumentation::calibrate();
+
+    SyntheticMarket market;
+    try {
+        market = generateSyntheticMarket(cfg.market);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_engine: %s\n", e.what());
+        return 2;
+    }
+    const MarketFrame frame = market.toFrame();
+    const std::size_t items = market.symbolCount() * market.barCount();
+    const auto selected = [&](const char* name) {
+        return cfg.filter.empty() || std::strstr(name, cfg.filter.c_str()) != nullptr;
+    };
+
+    std::vector<BenchResult> results;
+    if (selected("dispatch")) {
+        results.push_back(measure("dispatch", items, cfg.repeat, [&] { return runDispatch(market); }));
+    }
+    if (selected("indicator_update")) {
+        results.push_back(measure("indicator_update", items, cfg.repeat, [&] { return runIndicatorUpdate(market); }));
+    }
+    if (selected("ma_backtest")) {
+        results.push_back(measure("ma_backtest", items, cfg.repeat, [&] { return runBacktest(frame, 5, 20); }));
+    }
+    if (selected("parallel_backtest")) {
+        const std::size_t jobs = std::max<std::size_t>(8, cfg.threads);
+        results.push_back(measure("parallel_backtest", items * jobs, cfg.repeat,
+                                  [&] { return runParallelBacktests(frame, cfg.threads, jobs); }));
+    }
+
+    const std::string json = toJson(cfg, market.checksum(), results);
+    if (cfg.out.empty()) {
+        std::printf("%s\n", json.c_str());
+    } else {
+        std::ofstream out(cfg.out, std::ios::binary | std::ios::trunc);
+        out << json << '\n';
+        if (!out) {
+            std::fprintf(stderr, "bench_engine: cannot write %s\n", cfg.out.c_str());
+            return 1;
+        }
+    }
+
+    for (const auto& r : results) {
+        std::fprintf(stderr, "%-18s %10.2f ns/item %14.0f items/s%s\n", r.name.c_str(), r.nsPerItem(),
+                     r.itemsPerSec(), r.deterministic ? "" : "  NON-DETERMINISTIC");
+        for (const auto& st : r.stages) {
+            std::fprintf(stderr, "  %-16s %12llu samples %10.3f ms %10.3f us mean %10.3f us p99\n",
+                         foundation::metrics::stageName(st.stage), static_cast<unsigned long long>(st.count),
+                         st.totalMillis, st.meanMicros, st.p99Micros);
+        }
+        if (!r.deterministic) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+// 订单/成交对象的分配：逐个 new（unique_ptr + unordered_map）vs TradingLedger（对象池 + 句柄）
+// 高换手策略每根 bar 对大部分标的下单、分笔成交、撤掉剩余，订单和成交对象频繁创建销毁。
+// 全局 operator new 被替换为计数版本，直接数出每根 bar 的堆分配次数；两种实现的已实现盈亏必须一致。
+// 用法：OrderPoolBench [symbols] [bars]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include "TradingLedger.h"
+
+using namespace engine;
+
+namespace {
+std::atomic<std::uint64_t> g_heapAllocations{0};
+} // namespace
+
+void* operator new(std::size_t n)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// 每根 bar 的委托：标的、方向、数量、两笔成交的比例、价格
+struct Intent {
+    std::uint32_t symbolId;
+    OrderSide side;
+    double quantity;
+    double firstFillRatio;
+    bool secondFill;
+    double price;
+};
+
+std::vector<std::vector<Intent>> makeIntents(std::size_t symbols, std::size_t bars)
+{
+    std::vector<std::vector<Intent>> out(bars);
+    std::vector<double> price(symbols, 10.0);
+    std::vector<double> held(symbols, 0.0);
+    std::uint64_t seed = 7;
+    auto next = [&] {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(seed >> 40) / 16777216.0;
+    };
+    for (std::size_t t = 0; t < bars; ++t) {
+        for (std::size_t s = 0; s < symbols; ++s) {
+            price[s] = std::max(1.0, price[s] * (1.0 + (next() - 0.5) * 0.04));
+            if (next() < 0.2) continue;
+            Intent in;
+            in.symbolId = static_cast<std::uint32_t>(s);
+            // 有持仓时一半概率卖出（不超过持仓），否则买入
+            in.side = held[s] > 0.0 && next() < 0.5 ? OrderSide::Sell : OrderSide::Buy;
+            in.quantity = in.side == OrderSide::Sell ? held[s] : 100.0 * (1 + static_cast<int>(next() * 10));
+            in.firstFillRatio = next() < 0.7 ? 1.0 : 0.5;
+            in.secondFill = in.firstFillRatio < 1.0 && next() < 0.5;
+            in.price = std::round(price[s] * 100.0) / 100.0;
+            const double filled = in.secondFill ? in.quantity : in.quantity * in.firstFillRatio;
+            held[s] += in.side == OrderSide::Buy ? filled : -filled;
+            out[t].push_back(in);
+        }
+    }
+    return out;
+}
+
+// 对照：订单逐个 new，成交放进每根 bar 新建的 vector
+double runHeap(const std::vector<std::vector<Intent>>& intents)
+{
+    struct Pos {
+        double quantity = 0.0;
+        double avgCost = 0.0;
+    };
+    std::unordered_map<std::uint64_t, std::unique_ptr<Order>> orders;
+    std::unordered_map<std::uint32_t, std::unique_ptr<Pos>> positions;
+    std::uint64_t nextId = 1;
+    double realized = 0.0;
+    for (const auto& bar : intents) {
+        std::vector<Fill> fills;
+        std::vector<std::uint64_t> ids;
+        for (const Intent& in : bar) {
+            auto o = std::make_unique<Order>();
+            o->id = nextId++;
+            o->symbolId = in.symbolId;
+            o->side = in.side;
+            o->quantity = in.quantity;
+            ids.push_back(o->id);
+            orders.emplace(o->id, std::move(o));
+        }
+        for (std::size_t i = 0; i < bar.size(); ++i) {
+            const Intent& in = bar[i];
+            Order& o = *orders.at(ids[i]);
+            const double first = in.quantity * in.firstFillRatio;
+            for (double q : {first, in.secondFill ? in.quantity - first : 0.0}) {
+                if (q <= 0.0) continue;
+                o.filledQuantity += q;
+                Fill f;
+                f.orderId = o.id;
+                f.symbolId = o.symbolId;
+                f.side = o.side;
+                f.quantity = q;
+                f.price = in.price;
+                fills.push_back(f);
+            }
+        }
+        for (const Fill& f : fills) {
+            auto& p = positions[f.symbolId];
+            if (!p) p = std::make_unique<Pos>();
+            if (f.side == OrderSide::Buy) {
+                p->avgCost = (p->avgCost * p->quantity + f.price * f.quantity) / (p->quantity + f.quantity);
+                p->quantity += f.quantity;
+            } else {
+                realized += (f.price - p->avgCost) * f.quantity;
+                p->quantity -= f.quantity;
+                if (p->quantity == 0.0) positions.erase(f.symbolId);
+            }
+        }
+        for (std::uint64_t id : ids) orders.erase(id);   // 成交完或撤单后释放
+    }
+    return realized;
+}
+
+double runLedger(const std::vector<std::vector<Intent>>& intents, std::size_t symbols)
+{
+    TradingLedger::Options options;
+    options.symbols = symbols;
+    options.expectedOpenOrders = symbols;
+    options.expectedStepFills = symbols * 2;
+    TradingLedger ledger(options);
+    std::vector<OrderHandle> handles;
+    handles.reserve(symbols);
+    for (const auto& bar : intents) {
+        handles.clear();
+        for (const Intent& in : bar) {
+            handles.push_back(ledger.submit(in.symbolId, in.side, in.quantity, 0.0, 0));
+        }
+        for (std::size_t i = 0; i < bar.size(); ++i) {
+            const Intent& in = bar[i];
+            const double first = in.quantity * in.firstFillRatio;
+            ledger.fill(handles[i], first, in.price);
+            if (in.secondFill) ledger.fill(handles[i], in.quantity - first, in.price);
+            ledger.cancel(handles[i]);   // 已全部成交的返回 false
+        }
+        ledger.endStep();
+    }
+    return ledger.realizedPnl();
+}
+
+struct Outcome {
+    double ms = 0.0;
+    double allocsPerBar = 0.0;
+    double realized = 0.0;
+};
+
+template <typename F>
+Outcome measure(F&& run, std::size_t bars)
+{
+    run();   // 预热
+    const auto allocs0 = g_heapAllocations.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    Outcome o;
+    o.realized = run();
+    const auto t1 = std::chrono::steady_clock::now();
+    o.ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    o.allocsPerBar = static_cast<double>(g_heapAllocations.load() - allocs0) / static_cast<double>(bars);
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000;
+    const std::size_t bars = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 1000;
+
+    const auto intents = makeIntents(symbols, bars);
+    const Outcome heap = measure([&] { return runHeap(intents); }, bars);
+    const Outcome pooled = measure([&] { return runLedger(intents, symbols); }, bars);
+
+    if (std::abs(heap.realized - pooled.realized) > 1e-6 * std::max(1.0, std::abs(heap.realized))) {
+        std::fprintf(stderr, "result mismatch: %f %f\n", heap.realized, pooled.realized);
+        return 1;
+    }
+
+    std::printf("{\"bench\":\"order_pool\",\"symbols\":%zu,\"bars\":%zu,"
+                "\"heap_ms\":%.3f,\"pool_ms\":%.3f,\"heap_allocs_per_bar\":%.2f,\"pool_allocs_per_bar\":%.2f,"
+                "\"realized_pnl\":%.2f}\n",
+                symbols, bars, heap.ms, pooled.ms, heap.allocsPerBar, pooled.allocsPerBar, pooled.realized);
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include "SyntheticMarket.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "TradingCalendar.h"
+
+namespace engine {
+namespace bench {
+
+namespace {
+
+constexpr double kTradingDaysPerYear = 244.0;
+
+class SplitMix64 {
+public:
+    explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // (0, 1)
+    double uniform() { return (static_cast<double>(next() >> 11) + 0.5) * (1.0 / 9007199254740992.0); }
+
+    double normal() {
+        if (hasSpare_) {
+            hasSpare_ = false;
+            return spare_;
+        }
+        const double r = std::sqrt(-2.0 * std::log(uniform()));
+        const double theta = 6.283185307179586 * uniform();
+        spare_ = r * std::sin(theta);
+        hasSpare_ = true;
+        return r * std::cos(theta);
+    }
+
+private:
+    std::uint64_t state_;
+    double spare_ = 0.0;
+    bool hasSpare_ = false;
+};
+
+std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream)
+{
+    SplitMix64 mix(seed ^ (stream * 0xd1b54a32d192ed03ULL));
+    return mix.next();
+}
+
+std::string symbolCode(std::size_t index)
+{
+    // 前一半放沪市 600xxx，后一半放深市 000xxx；只要求唯一
+    char buf[32];
+    if (index % 2 == 0) {
+        std::snprintf(buf, sizeof(buf), "%06zu.SH", 600000 + index / 2);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%06zu.SZ", 1 + index / 2);
+    }
+    return buf;
+}
+
+void fnv(std::uint64_t& h, const void* data, std::size_t n)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+}
+
+} // namespace
+
+domain::strategies::MarketFrame SyntheticMarket::toFrame() const
+{
+    domain::strategies::MarketFrame frame;
+    frame.symbols = symbols;
+    frame.dates = dates;
+    frame.close = close;
+    return frame;
+}
+
+std::uint64_t SyntheticMarket::checksum() const
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (const auto& s : symbols) fnv(h, s.data(), s.size());
+    fnv(h, dates.data(), dates.size() * sizeof(std::int32_t));
+    fnv(h, times.data(), times.size() * sizeof(std::int32_t));
+    for (const auto* col : {&open, &high, &low, &close, &volume}) fnv(h, col->data(), col->size() * sizeof(double));
+    return h;
+}
+
+SyntheticMarket generateSyntheticMarket(const SyntheticMarketOptions& options)
+{
+    if (options.symbols == 0 || options.bars == 0) {
+        throw std::invalid_argument("SyntheticMarket: symbols and bars must be positive");
+    }
+    if (options.marketCorrelation < 0.0 || options.marketCorrelation > 1.0) {
+        throw std::invalid_argument("SyntheticMarket: marketCorrelation must be in [0, 1]");
+    }
+
+    const bool minute = options.frequency == BarFrequency::Minute;
+    const std::size_t barsPerDay = minute ? static_cast<std::size_t>(domain::market::TradingCalendar::kMinutesPerSession) : 1;
+    const std::size_t days = (options.bars + barsPerDay - 1) / barsPerDay;
+
+    // 合成数据不关心节假日，只跳过周末
+    const int firstYear = options.startDate / 10000;
+    const int lastYear = firstYear + static_cast<int>(days / 240) + 2;
+    const domain::market::TradingCalendar calendar(firstYear, lastYear, {});
+    const int firstDay = calendar.indexOf(calendar.onOrAfter(options.startDate));
+
+    SyntheticMarket m;
+    const std::size_t S = options.symbols;
+    const std::size_t T = options.bars;
+    m.symbols.reserve(S);
+    for (std::size_t s = 0; s < S; ++s) m.symbols.push_back(symbolCode(s));
+    m.dates.resize(T);
+    m.times.resize(T);
+    for (std::size_t t = 0; t < T; ++t) {
+        m.dates[t] = calendar.dateAt(firstDay + static_cast<int>(t / barsPerDay));
+        m.times[t] = minute ? domain::market::TradingCalendar::timeOfMinute(static_cast<int>(t % barsPerDay)) : 1500;
+    }
+    for (auto* col : {&m.open, &m.high, &m.low, &m.close, &m.volume}) col->resize(S * T);
+
+    const double dt = 1.0 / (kTradingDaysPerYear * static_cast<double>(barsPerDay));
+    const double sigma = options.annualVolatility * std::sqrt(dt);
+    const double drift = (options.annualDrift - 0.5 * options.annualVolatility * options.annualVolatility) * dt;
+    const double wMarket = std::sqrt(options.marketCorrelation);
+    const double wIdio = std::sqrt(1.0 - options.marketCorrelation);
+
+    // 市场因子序列所有标的共用，流号 0
+    std::vector<double> marketShock(T);
+    {
+        SplitMix64 rng(streamSeed(options.seed, 0));
+        for (auto& z : marketShock) z = rng.normal();
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t s = 0; s < S; ++s) {
+        SplitMix64 rng(streamSeed(options.seed, s + 1));
+        double price = 5.0 + 45.0 * rng.uniform();
+        const double baseVolume = std::floor(1e5 + 9e5 * rng.uniform());
+        for (std::size_t t = 0; t < T; ++t) {
+            const std::size_t i = t * S + s;
+            // 每根 bar 消耗固定个数的随机数，停牌与否不影响后续走势
+            const double z = wMarket * marketShock[t] + wIdio * rng.normal();
+            const double gap = rng.normal();
+            const double wickUp = std::fabs(rng.normal());
+            const double wickDown = std::fabs(rng.normal());
+            const double volNoise = rng.normal();
+            const bool suspended = options.suspendProbability > 0.0 && rng.uniform() < options.suspendProbability;
+
+            const double open = price * std::exp(0.1 * sigma * gap);
+            const double close = price * std::exp(drift + sigma * z);
+            price = close;
+            if (suspended) {
+                m.open[i] = m.high[i] = m.low[i] = m.close[i] = m.volume[i] = nan;
+                continue;
+            }
+            m.open[i] = open;
+            m.close[i] = close;
+            m.high[i] = std::max(open, close) * (1.0 + 0.5 * sigma * wickUp);
+            m.low[i] = std::min(open, close) * (1.0 - std::min(0.5 * sigma * wickDown, 0.5));
+            // 成交量随波动放大，按手（100 股）取整
+            const double v = baseVolume * std::exp(0.3 * volNoise) * (1.0 + std::fabs(z));
+            m.volume[i] = std::floor(v / 100.0) * 100.0;
+        }
+    }
+    return m;
+}
+
+} // namespace bench
+} // namespace engine
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PortfolioRunner.h"
+
+namespace engine {
+namespace bench {
+
+// 可复现的合成行情
+// 每个标的按几何布朗运动生成收盘价，收益 = 共同市场因子 + 个股噪声，
+// 开高低量由同一随机流派生。随机数用自带的 splitmix64 + Box-Muller，
+// 不依赖 std::normal_distribution（其输出随标准库实现而不同），
+// 同一个种子在 MSVC / GCC 上得到同样的行情，基准结果可以跨机器对比。
+// 每个标的的随机流只由 (seed, 标的序号) 决定，扩大标的数不会改变已有标的的走势。
+
+enum class BarFrequency { Daily, Minute };
+
+struct SyntheticMarketOptions {
+    std::size_t symbols = 300;
+    std::size_t bars = 1000;
+    BarFrequency frequency = BarFrequency::Daily;
+    std::uint64_t seed = 20240101;
+    std::int32_t startDate = 20150105;     // 取该日及之后的第一个交易日
+    double annualDrift = 0.05;
+    double annualVolatility = 0.30;
+    double marketCorrelation = 0.3;        // 个股收益对市场因子的方差占比 [0, 1]
+    double suspendProbability = 0.0;       // 每根 bar 停牌的概率，停牌 bar 各字段为 NaN
+};
+
+// 行情按时间优先存放：close[t * symbolCount + s]
+struct SyntheticMarket {
+    std::vector<std::string> symbols;
+    std::vector<std::int32_t> dates;       // YYYYMMDD
+    std::vector<std::int32_t> times;       // HHMM，日线固定为 1500
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+
+    std::size_t symbolCount() const { return symbols.size(); }
+    std::size_t barCount() const { return dates.size(); }
+    double closeAt(std::size_t t, std::size_t s) const { return close[t * symbols.size() + s]; }
+
+    // 转成组合回测用的行情帧（只含收盘价）
+    domain::strategies::MarketFrame toFrame() const;
+    // 全部字段的 FNV-1a 摘要，用来确认两次生成的数据完全一致
+    std::uint64_t checksum() const;
+};
+
+SyntheticMarket generateSyntheticMarket(const SyntheticMarketOptions& options);
+
+} // namespace bench
+} // namespace engine
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "foundation/Utils/LatencyHistogram.h"
+#include "foundation/log/metrics.hpp"
+
+namespace engine {
+
+// 实时行情链路（feature_flags.realtime_data）
+//
+//   IQuoteSource ──原始报文──> IQuoteDecoder ──LiveTick──> ConflatingQuoteQueue ──> TickHandler（投递到 EventBus）
+//     (源线程)                   (源线程)                    (无锁、有界、按标的合并)     (消费线程)
+//
+// 策略跟不上行情时，队列里每个标的只保留最新一笔报价，旧报价被合并掉而不是排队，
+// 所以队列长度不会超过标的数，延迟也不会越积越大。
+// 测试时用 SimulatedQuoteSource 替换真实行情源。
+
+// 归一化后的报价，字段与 domain/model 的 Tick 一一对应；定长、可平凡拷贝，便于无锁传递
+struct LiveTick {
+    std::uint32_t symbolId = 0;
+    std::int32_t date = 0;          // YYYYMMDD
+    std::int32_t time = 0;          // HHMMSSmmm
+    std::uint32_t reserved = 0;
+    double last = 0.0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double preClose = 0.0;
+    double volume = 0.0;
+    double amount = 0.0;
+    double bid1 = 0.0;
+    double ask1 = 0.0;
+    double bidVolume1 = 0.0;
+    double askVolume1 = 0.0;
+    std::uint64_t seq = 0;            // 同一标的内的发布序号，由队列填写
+    std::uint64_t recvNanos = 0;      // 收到原始报文的时刻（steadyNanos）
+    std::uint64_t publishNanos = 0;   // 进入队列的时刻
+};
+
+// 标的代码 <-> 连续编号；编号用作队列槽位下标
+// 容量在构造时固定：代码表与开放寻址的哈希表一次分配好，查已有代码无锁、不分配内存，
+// 只有登记新代码时加锁。行情源线程每笔报价都要查一次，已知标的最好在启动时 preregister。
+class SymbolRegistry {
+public:
+    explicit SymbolRegistry(std::size_t capacity);
+
+    // 新代码自动分配编号；超出容量抛 std::length_error
+    std::uint32_t idOf(std::string_view code);
+    // 只查不建，不存在返回 false；无锁
+    bool find(std::string_view code, std::uint32_t& id) const;
+    // 批量登记，返回成功登记（含已存在）的个数；超出容量的忽略
+    std::size_t preregister(const std::vector<std::string>& codes);
+    std::string codeOf(std::uint32_t id) const;
+    std::size_t size() const { return size_.load(std::memory_order_acquire); }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    std::size_t capacity_;
+    std::size_t tableMask_;
+    std::unique_ptr<std::string[]> codes_;                    // 下标即编号，发布后不再修改
+    std::unique_ptr<std::atomic<std::uint32_t>[]> table_;     // 编号 + 1，0 为空槽
+    std::atomic<std::size_t> size_{0};
+    std::mutex insertMutex_;
+};
+
+// 原始报文
+struct RawQuote {
+    std::string payload;
+    std::uint64_t recvNanos = 0;
+};
+
+using RawQuoteSink = std::function<void(RawQuote&&)>;
+
+// 行情源：在自己的线程里收报文并回调 sink；stop 后不再回调
+class IQuoteSource {
+public:
+    virtual ~IQuoteSource() = default;
+    virtual std::string name() const = 0;
+    virtual void start(RawQuoteSink sink) = 0;
+    virtual void stop() = 0;
+};
+
+// 报文解码；一条报文可以包含多只标的，逐个回调
+class IQuoteDecoder {
+public:
+    virtual ~IQuoteDecoder() = default;
+    // 返回成功解码的报价数
+    virtual std::size_t decode(const RawQuote& raw, SymbolRegistry& symbols,
+                               const std::function<void(const LiveTick&)>& emit) = 0;
+};
+
+// 新浪 hq_str 格式：var hq_str_sh600000="名称,今开,昨收,现价,最高,最低,买一,卖一,成交量,成交额,
+//                    买一量,买一价,...,卖一量,卖一价,...,日期,时间,...";  多行以 '\n' 或 ';' 分隔
+class SinaQuoteDecoder : public IQuoteDecoder {
+public:
+    std::size_t decode(const RawQuote& raw, SymbolRegistry& symbols,
+                       const std::function<void(const LiveTick&)>& emit) override;
+};
+
+// 有界无锁队列 + 按标的合并
+// 每个标的一个槽位（seqlock 保存最新报价）；环形队列里存的是"有新报价的标的编号"，
+// 每个标的在队列中最多出现一次，所以容量等于标的数即可，永远不会满。
+// 发布方可以是多个线程；消费方只能有一个线程。
+class ConflatingQuoteQueue {
+public:
+    explicit ConflatingQuoteQueue(std::size_t maxSymbols);
+    ~ConflatingQuoteQueue();
+
+    ConflatingQuoteQueue(const ConflatingQuoteQueue&) = delete;
+    ConflatingQuoteQueue& operator=(const ConflatingQuoteQueue&) = delete;
+
+    // 写入最新报价；该标的已有未消费的报价时直接覆盖（计入 conflated）
+    void publish(LiveTick tick);
+    // 取出一个标的的最新报价；队列为空返回 false
+    bool poll(LiveTick& out);
+
+    std::size_t capacity() const { return slotCount_; }
+    std::uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    std::uint64_t conflated() const { return conflated_.load(std::memory_order_relaxed); }
+    std::uint64_t delivered() const { return delivered_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t kWords = sizeof(LiveTick) / sizeof(std::uint64_t);
+    static_assert(sizeof(LiveTick) % sizeof(std::uint64_t) == 0, "LiveTick must be a whole number of words");
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> version{0};   // 奇数表示正在写
+        std::atomic<bool> pending{false};
+        std::array<std::atomic<std::uint64_t>, kWords> words{};
+        std::uint64_t lastDelivered = 0;           // 仅消费线程访问
+    };
+
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> sequence{0};
+        std::uint32_t value = 0;
+    };
+
+    bool push(std::uint32_t id);
+    bool pop(std::uint32_t& id);
+    void writeSlot(Slot& slot, LiveTick& tick);
+    void readSlot(const Slot& slot, LiveTick& out) const;
+
+    std::size_t slotCount_;
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t ringMask_;
+    std::unique_ptr<Cell[]> ring_;
+    alignas(64) std::atomic<std::uint64_t> enqueuePos_{0};
+    alignas(64) std::atomic<std::uint64_t> dequeuePos_{0};
+    alignas(64) std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> conflated_{0};
+    std::atomic<std::uint64_t> delivered_{0};
+};
+
+// 模拟行情源：随机游走价格，按新浪格式生成报文，用于测试和压测
+class SimulatedQuoteSource : public IQuoteSource {
+public:
+    struct Options {
+        std::vector<std::string> symbols;
+        double quotesPerSecond = 10000.0;   // 总速率，<= 0 表示尽快发送
+        std::size_t symbolsPerMessage = 1;
+        std::uint64_t maxQuotes = 0;        // 0 表示不限
+        unsigned seed = 7;
+    };
+
+    explicit SimulatedQuoteSource(Options options);
+    ~SimulatedQuoteSource() override;
+
+    std::string name() const override { return "simulated"; }
+    void start(RawQuoteSink sink) override;
+    void stop() override;
+
+    std::uint64_t sent() const { return sent_.load(std::memory_order_relaxed); }
+    bool finished() const { return finished_.load(std::memory_order_acquire); }
+
+private:
+    void run(RawQuoteSink sink);
+
+    Options options_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<std::uint64_t> sent_{0};
+    std::thread thread_;
+};
+
+using TickHandler = std::function<void(const LiveTick&)>;
+
+// 组装整条链路；handler 在消费线程里调用，通常由 EngineImpl 绑定为向 EventBus 发布 Tick 事件
+class QuotePipeline {
+public:
+    struct Options {
+        std::size_t maxSymbols = 8192;
+        bool ownConsumerThread = true;   // false 时由调用方在自己的循环里调用 drain()
+    };
+
+    struct Stats {
+        std::uint64_t messages = 0;
+        std::uint64_t decoded = 0;
+        std::uint64_t decodeErrors = 0;
+        std::uint64_t published = 0;
+        std::uint64_t conflated = 0;
+        std::uint64_t delivered = 0;
+    };
+
+    QuotePipeline(std::unique_ptr<IQuoteSource> source, std::unique_ptr<IQuoteDecoder> decoder,
+                  TickHandler handler, Options options);
+    QuotePipeline(std::unique_ptr<IQuoteSource> source, std::unique_ptr<IQuoteDecoder> decoder,
+                  TickHandler handler);
+    ~QuotePipeline();
+
+    void start();
+    void stop();
+
+    // 消费至多 maxTicks 笔，返回实际处理数；ownConsumerThread = false 时使用
+    std::size_t drain(std::size_t maxTicks = SIZE_MAX);
+
+    SymbolRegistry& symbols() { return symbols_; }
+    Stats stats() const;
+
+    // 各阶段延迟（纳秒）：
+    //   decode     收到报文 -> 进入队列
+    //   queue      进入队列 -> 被消费
+    //   handler    handler 执行耗时
+    //   endToEnd   收到报文 -> handler 返回
+    const foundation::utils::LatencyHistogram& decodeLatency() const { return decodeLatency_; }
+    const foundation::utils::LatencyHistogram& queueLatency() const { return queueLatency_; }
+    const foundation::utils::LatencyHistogram& handlerLatency() const { return handlerLatency_; }
+    const foundation::utils::LatencyHistogram& endToEndLatency() const { return endToEndLatency_; }
+    // 多行文本，每个阶段一行
+    std::string latencyReport() const;
+    // 计数与各阶段 p50/p99 挂到全局指标注册表（标签 feed="name"），析构时自动注销
+    void bindMetrics(const std::string& name);
+
+private:
+    void onRaw(RawQuote&& raw);
+    void consumeLoop();
+
+    std::unique_ptr<IQuoteSource> source_;
+    std::unique_ptr<IQuoteDecoder> decoder_;
+    TickHandler handler_;
+    Options options_;
+    SymbolRegistry symbols_;
+    ConflatingQuoteQueue queue_;
+
+    std::atomic<bool> running_{false};
+    std::thread consumer_;
+
+    std::atomic<std::uint64_t> messages_{0};
+    std::atomic<std::uint64_t> decoded_{0};
+    std::atomic<std::uint64_t> decodeErrors_{0};
+
+    foundation::utils::LatencyHistogram decodeLatency_;
+    foundation::utils::LatencyHistogram queueLatency_;
+    foundation::utils::LatencyHistogram handlerLatency_;
+    foundation::utils::LatencyHistogram endToEndLatency_;
+
+    std::vector<foundation::metrics::CallbackHandle> metricHandles_;
+};
+
+} // namespace engine
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "foundation/memory/ObjectPool.hpp"
+
+namespace engine {
+
+// 撮合模拟用的交易实体
+// 订单、成交、持仓都放在 ObjectPool 里，按句柄引用；一个 TradingLedger 只在一个线程上使用，
+// 并行回测时每个线程各持一份（池子天然按线程隔离）。
+//
+// 生命周期：
+//   submit   创建订单
+//   fill     创建一笔成交并更新持仓；订单全部成交后变为 Filled
+//   cancel   撤单，订单变为 Cancelled
+//   endStep  一根 bar/一个撮合周期结束：回收本周期的成交和已终结的订单，它们的句柄从此失效
+// 持仓在数量归零时回收，再次开仓复用槽位。
+// 池子和内部数组长到稳定大小之后，上面这些操作不再分配任何内存。
+
+enum class OrderSide : std::uint8_t { Buy, Sell };
+
+enum class OrderStatus : std::uint8_t { New, PartiallyFilled, Filled, Cancelled };
+
+struct Order {
+    std::uint64_t id = 0;
+    std::uint32_t symbolId = 0;
+    OrderSide side = OrderSide::Buy;
+    OrderStatus status = OrderStatus::New;
+    std::int32_t date = 0;           // YYYYMMDD
+    double quantity = 0.0;           // 委托数量（正数）
+    double limitPrice = 0.0;         // 0 表示市价
+    double filledQuantity = 0.0;
+    double avgFillPrice = 0.0;
+
+    double remaining() const { return quantity - filledQuantity; }
+    bool finished() const { return status == OrderStatus::Filled || status == OrderStatus::Cancelled; }
+};
+
+struct Fill {
+    std::uint64_t orderId = 0;
+    std::uint32_t symbolId = 0;
+    OrderSide side = OrderSide::Buy;
+    std::int32_t date = 0;
+    double quantity = 0.0;
+    double price = 0.0;
+    double commission = 0.0;
+};
+
+// 净持仓：quantity 为正是多头、为负是空头
+struct Position {
+    std::uint32_t symbolId = 0;
+    double quantity = 0.0;
+    double avgCost = 0.0;
+    std::int32_t openedDate = 0;
+};
+
+using OrderHandle = foundation::memory::PoolHandle<Order>;
+using FillHandle = foundation::memory::PoolHandle<Fill>;
+using PositionHandle = foundation::memory::PoolHandle<Position>;
+
+class TradingLedger {
+public:
+    struct Options {
+        std::size_t symbols = 0;               // symbolId 的取值范围 [0, symbols)
+        std::size_t expectedOpenOrders = 1024; // 预热容量；超出时池子按块增长
+        std::size_t expectedStepFills = 1024;
+        double commissionRate = 0.0;           // 按成交额收取
+    };
+
+    // upstream：池子的块从这里申请，可以传 foundation::memory::threadLocalPool()
+    explicit TradingLedger(const Options& options,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    TradingLedger(const TradingLedger&) = delete;
+    TradingLedger& operator=(const TradingLedger&) = delete;
+
+    // quantity 必须为正，symbolId 越界抛 std::out_of_range
+    OrderHandle submit(std::uint32_t symbolId, OrderSide side, double quantity, double limitPrice, std::int32_t date);
+    // 成交 quantity（不超过剩余数量）；订单已失效或已终结抛 std::invalid_argument
+    FillHandle fill(OrderHandle order, double quantity, double price);
+    // 已失效或已终结的订单返回 false
+    bool cancel(OrderHandle order);
+    // 回收本周期的成交与已终结的订单
+    void endStep();
+
+    // 句柄失效时返回 nullptr
+    const Order* order(OrderHandle h) const { return orders_.get(h); }
+    const Fill* fill(FillHandle h) const { return fills_.get(h); }
+    // 空仓返回 nullptr
+    const Position* position(std::uint32_t symbolId) const;
+
+    // 本周期的成交，按发生顺序；endStep 之后清空
+    const std::vector<FillHandle>& stepFills() const { return stepFills_; }
+
+    // 按槽位顺序访问未终结的订单：f(OrderHandle, const Order&)
+    template <typename F>
+    void forEachOpenOrder(F&& f) {
+        orders_.forEach([&](OrderHandle h, Order& o) {
+            if (!o.finished()) f(h, static_cast<const Order&>(o));
+        });
+    }
+
+    std::size_t liveOrders() const { return orders_.size(); }
+    std::size_t openPositions() const { return positions_.size(); }
+    double realizedPnl() const { return realizedPnl_; }
+    double totalCommission() const { return totalCommission_; }
+    // 三个池子累计向上游申请块的次数；稳定运行后不再增长
+    std::size_t poolChunkAllocations() const {
+        return orders_.chunkAllocations() + fills_.chunkAllocations() + positions_.chunkAllocations();
+    }
+
+private:
+    void applyToPosition(std::uint32_t symbolId, double signedQuantity, double price, std::int32_t date);
+
+    double commissionRate_;
+    foundation::memory::ObjectPool<Order> orders_;
+    foundation::memory::ObjectPool<Fill> fills_;
+    foundation::memory::ObjectPool<Position> positions_;
+    std::vector<PositionHandle> bySymbol_;
+    std::vector<FillHandle> stepFills_;
+    std::vector<OrderHandle> finished_;   // 本周期终结、等待 endStep 回收的订单
+    std::uint64_t nextOrderId_ = 1;
+    double realizedPnl_ = 0.0;
+    double totalCommission_ = 0.0;
+};
+
+} // namespace engine
@@ -0,0 +1,536 @@
+#include "QuoteStream.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include "foundation/log/instrumentation.hpp"
+
+using foundation::utils::steadyNanos;
+
+namespace engine {
+
+// ==================== SymbolRegistry ====================
+
+SymbolRegistry::SymbolRegistry(std::size_t capacity) : capacity_(capacity)
+{
+    // 装载因子不超过 1/2，探测链很短
+    std::size_t table = 2;
+    while (table < capacity_ * 2) table <<= 1;
+    tableMask_ = table - 1;
+    codes_ = std::make_unique<std::string[]>(capacity_);
+    table_ = std::make_unique<std::atomic<std::uint32_t>[]>(table);
+    for (std::size_t i = 0; i < table; ++i) table_[i].store(0, std::memory_order_relaxed);
+}
+
+bool SymbolRegistry::find(std::string_view code, std::uint32_t& id) const
+{
+    for (std::size_t i = std::hash<std::string_view>()(code) & tableMask_;; i = (i + 1) & tableMask_) {
+        // acquire 与登记时的 release 配对，读到编号时对应的代码已经写好
+        const std::uint32_t e = table_[i].load(std::memory_order_acquire);
+        if (e == 0) return false;
+        if (codes_[e - 1] == code) {
+            id = e - 1;
+            return true;
+        }
+    }
+}
+
+std::uint32_t SymbolRegistry::idOf(std::string_view code)
+{
+    std::uint32_t id;
+    if (find(code, id)) return id;
+
+    std::lock_guard<std::mutex> lock(insertMutex_);
+    if (find(code, id)) return id;   // 等锁期间可能已被别的线程登记
+    const std::size_t n = size_.load(std::memory_order_relaxed);
+    if (n >= capacity_) throw std::length_error("SymbolRegistry: capacity exceeded");
+    id = static_cast<std::uint32_t>(n);
+    codes_[id].assign(code.data(), code.size());
+    std::size_t i = std::hash<std::string_view>()(code) & tableMask_;
+    while (table_[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & tableMask_;
+    table_[i].store(id + 1, std::memory_order_release);
+    size_.store(n + 1, std::memory_order_release);
+    return id;
+}
+
+std::size_t SymbolRegistry::preregister(const std::vector<std::string>& codes)
+{
+    std::size_t ok = 0;
+    for (const auto& code : codes) {
+        try {
+            idOf(code);
+            ++ok;
+        } catch (const std::length_error&) {
+            break;
+        }
+    }
+    return ok;
+}
+
+std::string SymbolRegistry::codeOf(std::uint32_t id) const
+{
+    return id < size() ? codes_[id] : std::string();
+}
+
+// ==================== SinaQuoteDecoder ====================
+
+namespace {
+
+bool parseNumber(std::string_view s, double& out)
+{
+    if (s.empty()) return false;
+    const auto r = std::from_chars(s.data(), s.data() + s.size(), out);
+    return r.ec == std::errc();
+}
+
+bool parseDigits(std::string_view s, int& out)
+{
+    out = 0;
+    if (s.empty()) return false;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        out = out * 10 + (c - '0');
+    }
+    return true;
+}
+
+// "2024-01-05" -> 20240105
+bool parseDashedDate(std::string_view s, std::int32_t& out)
+{
+    int y, m, d;
+    if (s.size() != 10 || s[4] != '-' || s[7] != '-') return false;
+    if (!parseDigits(s.substr(0, 4), y) || !parseDigits(s.substr(5, 2), m) || !parseDigits(s.substr(8, 2), d)) {
+        return false;
+    }
+    out = y * 10000 + m * 100 + d;
+    return true;
+}
+
+// "14:59:58" -> 145958000
+bool parseClock(std::string_view s, std::int32_t& out)
+{
+    int h, m, sec;
+    if (s.size() != 8 || s[2] != ':' || s[5] != ':') return false;
+    if (!parseDigits(s.substr(0, 2), h) || !parseDigits(s.substr(3, 2), m) || !parseDigits(s.substr(6, 2), sec)) {
+        return false;
+    }
+    out = (h * 10000 + m * 100 + sec) * 1000;
+    return true;
+}
+
+// 解析一条 var hq_str_xxx="..."，失败返回 false
+bool decodeSinaLine(std::string_view line, SymbolRegistry& symbols, LiveTick& tick)
+{
+    constexpr std::string_view kPrefix = "hq_str_";
+    const auto p = line.find(kPrefix);
+    if (p == std::string_view::npos) return false;
+    const auto eq = line.find('=', p);
+    const auto q1 = line.find('"', eq);
+    const auto q2 = line.rfind('"');
+    if (eq == std::string_view::npos || q1 == std::string_view::npos || q2 <= q1) return false;
+
+    const std::string_view code = line.substr(p + kPrefix.size(), eq - p - kPrefix.size());
+    const std::string_view body = line.substr(q1 + 1, q2 - q1 - 1);
+    if (code.empty() || body.empty()) return false;   // 停牌或无效代码时 body 为空
+
+    std::string_view fields[33];
+    std::size_t n = 0;
+    std::size_t start = 0;
+    while (n < 33) {
+        const auto comma = body.find(',', start);
+        fields[n++] = body.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start);
+        if (comma == std::string_view::npos) break;
+        start = comma + 1;
+    }
+    if (n < 32) return false;
+
+    tick = LiveTick{};
+    if (!parseNumber(fields[1], tick.open) || !parseNumber(fields[2], tick.preClose) ||
+        !parseNumber(fields[3], tick.last) || !parseNumber(fields[4], tick.high) ||
+        !parseNumber(fields[5], tick.low) || !parseNumber(fields[8], tick.volume) ||
+        !parseNumber(fields[9], tick.amount) || !parseNumber(fields[10], tick.bidVolume1) ||
+        !parseNumber(fields[11], tick.bid1) || !parseNumber(fields[20], tick.askVolume1) ||
+        !parseNumber(fields[21], tick.ask1) || !parseDashedDate(fields[30], tick.date) ||
+        !parseClock(fields[31], tick.time)) {
+        return false;
+    }
+    // 标的数超出登记表容量时丢弃这一行，由调用方计入解码错误
+    try {
+        tick.symbolId = symbols.idOf(code);
+    } catch (const std::length_error&) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::size_t SinaQuoteDecoder::decode(const RawQuote& raw, SymbolRegistry& symbols,
+                                     const std::function<void(const LiveTick&)>& emit)
+{
+    std::string_view rest(raw.payload);
+    std::size_t ok = 0;
+    while (!rest.empty()) {
+        const auto end = rest.find_first_of(";\n");
+        const std::string_view line = rest.substr(0, end);
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+        if (line.find_first_not_of(" \r\t") == std::string_view::npos) continue;
+
+        LiveTick tick;
+        if (!decodeSinaLine(line, symbols, tick)) continue;
+        tick.recvNanos = raw.recvNanos;
+        emit(tick);
+        ++ok;
+    }
+    return ok;
+}
+
+// ==================== ConflatingQuoteQueue ====================
+
+ConflatingQuoteQueue::ConflatingQuoteQueue(std::size_t maxSymbols)
+    : slotCount_(std::max<std::size_t>(1, maxSymbols))
+{
+    std::size_t ring = 2;
+    while (ring < slotCount_) ring <<= 1;
+    ringMask_ = ring - 1;
+    slots_ = std::make_unique<Slot[]>(slotCount_);
+    ring_ = std::make_unique<Cell[]>(ring);
+    for (std::size_t i = 0; i < ring; ++i) ring_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+ConflatingQuoteQueue::~ConflatingQuoteQueue() = default;
+
+// Vyukov 有界 MPMC 环形队列
+bool ConflatingQuoteQueue::push(std::uint32_t id)
+{
+    std::uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = ring_[pos & ringMask_];
+        const std::uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.value = id;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ConflatingQuoteQueue::pop(std::uint32_t& id)
+{
+    std::uint64_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = ring_[pos & ringMask_];
+        const std::uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                id = cell.value;
+                cell.sequence.store(pos + ringMask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ConflatingQuoteQueue::writeSlot(Slot& slot, LiveTick& tick)
+{
+    // 同一标的可能有多个发布线程，先把版本号从偶数 CAS 成奇数拿到写权
+    std::uint64_t v = slot.version.load(std::memory_order_relaxed);
+    for (;;) {
+        if (v & 1) {
+            v = slot.version.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.version.compare_exchange_weak(v, v + 1, std::memory_order_acquire, std::memory_order_relaxed)) break;
+    }
+    // 奇数版本号必须先于数据可见，否则读者可能看到新数据配旧的偶数版本号
+    std::atomic_thread_fence(std::memory_order_release);
+    tick.seq = v / 2 + 1;
+    std::uint64_t words[kWords];
+    std::memcpy(words, &tick, sizeof(tick));
+    for (std::size_t i = 0; i < kWords; ++i) slot.words[i].store(words[i], std::memory_order_relaxed);
+    slot.version.store(v + 2, std::memory_order_release);
+}
+
+void ConflatingQuoteQueue::readSlot(const Slot& slot, LiveTick& out) const
+{
+    std::uint64_t words[kWords];
+    for (;;) {
+        const std::uint64_t v1 = slot.version.load(std::memory_order_acquire);
+        if (v1 & 1) continue;
+        for (std::size_t i = 0; i < kWords; ++i) words[i] = slot.words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == v1) break;
+    }
+    std::memcpy(&out, words, sizeof(out));
+}
+
+void ConflatingQuoteQueue::publish(LiveTick tick)
+{
+    if (tick.symbolId >= slotCount_) throw std::out_of_range("ConflatingQuoteQueue: symbol id out of range");
+    Slot& slot = slots_[tick.symbolId];
+    tick.publishNanos = steadyNanos();
+    writeSlot(slot, tick);
+    published_.fetch_add(1, std::memory_order_relaxed);
+    // 已经在队列里的标的不再入队，消费时直接读到这笔最新报价
+    if (slot.pending.exchange(true, std::memory_order_acq_rel)) {
+        conflated_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    push(tick.symbolId);   // 每个标的最多入队一次，容量 >= 标的数，不会失败
+}
+
+bool ConflatingQuoteQueue::poll(LiveTick& out)
+{
+    std::uint32_t id;
+    while (pop(id)) {
+        Slot& slot = slots_[id];
+        // 先清标记再读：读之后到达的报价会重新入队，不会丢。
+        // 必须用读-改-写：单纯的 store 可能被排到读槽位之后，发布方看到旧的 true 而不入队，最新报价就丢了；
+        // exchange 与发布方的 exchange 在 pending 上全序，发布方在它之前写入的报价一定能被下面读到
+        slot.pending.exchange(false, std::memory_order_acq_rel);
+        readSlot(slot, out);
+        // 清标记与读之间到达的报价会被读到并再次入队，这里去掉重复投递
+        if (out.seq == slot.lastDelivered) continue;
+        slot.lastDelivered = out.seq;
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// ==================== SimulatedQuoteSource ====================
+
+SimulatedQuoteSource::SimulatedQuoteSource(Options options) : options_(std::move(options))
+{
+    if (options_.symbols.empty()) throw std::invalid_argument("SimulatedQuoteSource: no symbols");
+    options_.symbolsPerMessage = std::max<std::size_t>(1, options_.symbolsPerMessage);
+}
+
+SimulatedQuoteSource::~SimulatedQuoteSource()
+{
+    stop();
+}
+
+void SimulatedQuoteSource::start(RawQuoteSink sink)
+{
+    if (running_.exchange(true)) return;
+    finished_.store(false, std::memory_order_release);
+    thread_ = std::thread([this, sink = std::move(sink)]() mutable { run(std::move(sink)); });
+}
+
+void SimulatedQuoteSource::stop()
+{
+    running_.store(false);
+    if (thread_.joinable()) thread_.join();
+}
+
+void SimulatedQuoteSource::run(RawQuoteSink sink)
+{
+    std::mt19937_64 rng(options_.seed);
+    std::normal_distribution<double> step(0.0, 0.001);
+    std::vector<double> price(options_.symbols.size(), 10.0);
+    std::vector<double> volume(options_.symbols.size(), 0.0);
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::uint64_t sent = 0;
+    std::size_t cursor = 0;
+    char line[512];
+    RawQuote raw;
+
+    while (running_.load(std::memory_order_relaxed) && (options_.maxQuotes == 0 || sent < options_.maxQuotes)) {
+        raw.payload.clear();
+        for (std::size_t k = 0; k < options_.symbolsPerMessage; ++k) {
+            const std::size_t i = cursor++ % options_.symbols.size();
+            price[i] = std::max(0.01, price[i] * (1.0 + step(rng)));
+            volume[i] += 100.0;
+            const double p = std::round(price[i] * 100.0) / 100.0;
+            const int secs = static_cast<int>((sent / 1000) % 7200);
+            const int hh = 9 + (30 + secs / 60) / 60;
+            const int mm = (30 + secs / 60) % 60;
+            const int ss = secs % 60;
+            const int len = std::snprintf(
+                line, sizeof(line),
+                "var hq_str_%s=\"SIM,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f,%.2f,"
+                "100,%.2f,0,0,0,0,0,0,0,0,100,%.2f,0,0,0,0,0,0,0,0,2024-01-05,%02d:%02d:%02d,00\";\n",
+                options_.symbols[i].c_str(), p, p, p, p, p, p - 0.01, p + 0.01, volume[i], volume[i] * p,
+                p - 0.01, p + 0.01, hh, mm, ss);
+            raw.payload.append(line, static_cast<std::size_t>(len));
+            ++sent;
+        }
+        raw.recvNanos = steadyNanos();
+        sink(std::move(raw));
+        raw = RawQuote{};
+        sent_.store(sent, std::memory_order_relaxed);
+
+        if (options_.quotesPerSecond > 0.0) {
+            const auto due = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(sent / options_.quotesPerSecond));
+            std::this_thread::sleep_until(due);
+        }
+    }
+    finished_.store(true, std::memory_order_release);
+}
+
+// ==================== QuotePipeline ====================
+
+QuotePipeline::QuotePipeline(std::unique_ptr<IQuoteSource> source, std::unique_ptr<IQuoteDecoder> decoder,
+                             TickHandler handler, Options options)
+    : source_(std::move(source)), decoder_(std::move(decoder)), handler_(std::move(handler)),
+      options_(options), symbols_(options.maxSymbols), queue_(options.maxSymbols)
+{
+    if (!source_ || !decoder_ || !handler_) throw std::invalid_argument("QuotePipeline: source, decoder and handler are required");
+}
+
+QuotePipeline::QuotePipeline(std::unique_ptr<IQuoteSource> source, std::unique_ptr<IQuoteDecoder> decoder,
+                             TickHandler handler)
+    : QuotePipeline(std::move(source), std::move(decoder), std::move(handler), Options{})
+{
+}
+
+QuotePipeline::~QuotePipeline()
+{
+    metricHandles_.clear();
+    stop();
+}
+
+void QuotePipeline::start()
+{
+    if (running_.exchange(true)) return;
+    if (options_.ownConsumerThread) consumer_ = std::thread([this] { consumeLoop(); });
+    source_->start([this](RawQuote&& raw) { onRaw(std::move(raw)); });
+}
+
+void QuotePipeline::stop()
+{
+    if (!running_.exchange(false)) return;
+    source_->stop();
+    if (consumer_.joinable()) consumer_.join();
+}
+
+void QuotePipeline::onRaw(RawQuote&& raw)
+{
+    messages_.fetch_add(1, std::memory_order_relaxed);
+    std::size_t n = 0;
+    // 在行情源线程里回调，异常不能抛出去（会直接终止进程）：计为解码错误，已发布的报价照常计数
+    try {
+        n = decoder_->decode(raw, symbols_, [this, &n](const LiveTick& tick) {
+            queue_.publish(tick);
+            decodeLatency_.record(steadyNanos() - tick.recvNanos);
+            ++n;
+        });
+    } catch (const std::exception&) {
+        decodeErrors_.fetch_add(1, std::memory_order_relaxed);
+        decoded_.fetch_add(n, std::memory_order_relaxed);
+        return;
+    }
+    if (n == 0) decodeErrors_.fetch_add(1, std::memory_order_relaxed);
+    decoded_.fetch_add(n, std::memory_order_relaxed);
+}
+
+std::size_t QuotePipeline::drain(std::size_t maxTicks)
+{
+    std::size_t n = 0;
+    LiveTick tick;
+    while (n < maxTicks && queue_.poll(tick)) {
+        const std::uint64_t dequeued = steadyNanos();
+        queueLatency_.record(dequeued - tick.publishNanos);
+        {
+            ENGINE_PROBE(foundation::metrics::Stage::Dispatch);
+            handler_(tick);
+        }
+        const std::uint64_t done = steadyNanos();
+        handlerLatency_.record(done - dequeued);
+        endToEndLatency_.record(done - tick.recvNanos);
+        ++n;
+    }
+    return n;
+}
+
+void QuotePipeline::consumeLoop()
+{
+    // 忙等一小段再让出 CPU，兼顾延迟与空闲时的占用
+    int idle = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain(256) > 0) {
+            idle = 0;
+        } else if (++idle < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    drain();
+}
+
+QuotePipeline::Stats QuotePipeline::stats() const
+{
+    Stats s;
+    s.messages = messages_.load(std::memory_order_relaxed);
+    s.decoded = decoded_.load(std::memory_order_relaxed);
+    s.decodeErrors = decodeErrors_.load(std::memory_order_relaxed);
+    s.published = queue_.published();
+    s.conflated = queue_.conflated();
+    s.delivered = queue_.delivered();
+    return s;
+}
+
+std::string QuotePipeline::latencyReport() const
+{
+    return "decode    " + decodeLatency_.summary() + "\n" +
+           "queue     " + queueLatency_.summary() + "\n" +
+           "handler   " + handlerLatency_.summary() + "\n" +
+           "endToEnd  " + endToEndLatency_.summary() + "\n";
+}
+
+void QuotePipeline::bindMetrics(const std::string& name)
+{
+    metricHandles_.clear();   // 重复绑定时旧句柄先注销
+    auto& registry = foundation::metrics::MetricsRegistry::instance();
+    std::vector<foundation::metrics::CallbackHandle> handles;
+    const foundation::metrics::Labels labels{{"feed", name}};
+    auto addCount = [&](const char* metric, std::uint64_t Stats::*field) {
+        handles.push_back(registry.counterCallback(metric, labels, [this, field] {
+            return static_cast<double>(stats().*field);
+        }));
+    };
+    addCount("quote_messages_total", &Stats::messages);
+    addCount("quote_decode_errors_total", &Stats::decodeErrors);
+    addCount("quote_published_total", &Stats::published);
+    addCount("quote_conflated_total", &Stats::conflated);
+    addCount("quote_delivered_total", &Stats::delivered);
+
+    const std::pair<const char*, const foundation::utils::LatencyHistogram*> stages[] = {
+        {"decode", &decodeLatency_}, {"queue", &queueLatency_}, {"handler", &handlerLatency_},
+        {"end_to_end", &endToEndLatency_}};
+    for (const auto& [stage, hist] : stages) {
+        for (double q : {50.0, 99.0}) {
+            auto l = labels;
+            l["stage"] = stage;
+            l["quantile"] = q == 50.0 ? "0.5" : "0.99";
+            handles.push_back(registry.gaugeCallback("quote_latency_ns", l, [hist, q] {
+                return static_cast<double>(hist->percentile(q));
+            }));
+        }
+    }
+    metricHandles_ = std::move(handles);
+}
+
+} // namespace engine
@@ -0,0 +1,130 @@
+#include "TradingLedger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace engine {
+
+TradingLedger::TradingLedger(const Options& options, std::pmr::memory_resource* upstream)
+    : commissionRate_(options.commissionRate),
+      orders_(upstream),
+      fills_(upstream),
+      positions_(upstream),
+      bySymbol_(options.symbols)
+{
+    orders_.reserve(options.expectedOpenOrders);
+    fills_.reserve(options.expectedStepFills);
+    stepFills_.reserve(options.expectedStepFills);
+    finished_.reserve(options.expectedOpenOrders);
+}
+
+OrderHandle TradingLedger::submit(std::uint32_t symbolId, OrderSide side, double quantity, double limitPrice,
+                                  std::int32_t date)
+{
+    if (symbolId >= bySymbol_.size()) throw std::out_of_range("TradingLedger: symbolId out of range");
+    if (!(quantity > 0.0)) throw std::invalid_argument("TradingLedger: order quantity must be positive");
+    Order o;
+    o.id = nextOrderId_++;
+    o.symbolId = symbolId;
+    o.side = side;
+    o.date = date;
+    o.quantity = quantity;
+    o.limitPrice = limitPrice;
+    return orders_.create(o);
+}
+
+FillHandle TradingLedger::fill(OrderHandle h, double quantity, double price)
+{
+    Order* o = orders_.get(h);
+    if (!o) throw std::invalid_argument("TradingLedger: stale order handle");
+    if (o->finished()) throw std::invalid_argument("TradingLedger: order already finished");
+    if (!(quantity > 0.0) || quantity > o->remaining()) {
+        throw std::invalid_argument("TradingLedger: fill quantity out of range");
+    }
+
+    const double filled = o->filledQuantity + quantity;
+    o->avgFillPrice = (o->avgFillPrice * o->filledQuantity + price * quantity) / filled;
+    o->filledQuantity = filled;
+    o->status = o->remaining() > 0.0 ? OrderStatus::PartiallyFilled : OrderStatus::Filled;
+    if (o->status == OrderStatus::Filled) finished_.push_back(h);
+
+    Fill f;
+    f.orderId = o->id;
+    f.symbolId = o->symbolId;
+    f.side = o->side;
+    f.date = o->date;
+    f.quantity = quantity;
+    f.price = price;
+    f.commission = std::abs(quantity * price) * commissionRate_;
+    totalCommission_ += f.commission;
+
+    applyToPosition(o->symbolId, o->side == OrderSide::Buy ? quantity : -quantity, price, o->date);
+
+    const FillHandle fh = fills_.create(f);
+    stepFills_.push_back(fh);
+    return fh;
+}
+
+bool TradingLedger::cancel(OrderHandle h)
+{
+    Order* o = orders_.get(h);
+    if (!o || o->finished()) return false;
+    o->status = OrderStatus::Cancelled;
+    finished_.push_back(h);
+    return true;
+}
+
+void TradingLedger::endStep()
+{
+    for (const FillHandle h : stepFills_) fills_.destroy(h);
+    stepFills_.clear();
+    for (const OrderHandle h : finished_) orders_.destroy(h);
+    finished_.clear();
+}
+
+const Position* TradingLedger::position(std::uint32_t symbolId) const
+{
+    if (symbolId >= bySymbol_.size()) return nullptr;
+    return positions_.get(bySymbol_[symbolId]);
+}
+
+void TradingLedger::applyToPosition(std::uint32_t symbolId, double signedQuantity, double price, std::int32_t date)
+{
+    PositionHandle& slot = bySymbol_[symbolId];
+    Position* p = positions_.get(slot);
+    if (!p) {
+        Position fresh;
+        fresh.symbolId = symbolId;
+        fresh.quantity = signedQuantity;
+        fresh.avgCost = price;
+        fresh.openedDate = date;
+        slot = positions_.create(fresh);
+        return;
+    }
+
+    if ((p->quantity > 0.0) == (signedQuantity > 0.0)) {
+        // 加仓：按数量加权摊薄成本
+        const double q = p->quantity + signedQuantity;
+        p->avgCost = (p->avgCost * p->quantity + price * signedQuantity) / q;
+        p->quantity = q;
+        return;
+    }
+
+    // 减仓：平掉的部分按成本结算盈亏，超出部分反向开仓
+    const double closing = std::min(std::abs(signedQuantity), std::abs(p->quantity));
+    realizedPnl_ += (price - p->avgCost) * closing * (p->quantity > 0.0 ? 1.0 : -1.0);
+    const double q = p->quantity + signedQuantity;
+    if (q == 0.0) {
+        positions_.destroy(slot);
+        slot = PositionHandle();
+    } else if ((q > 0.0) != (p->quantity > 0.0)) {
+        p->quantity = q;
+        p->avgCost = price;
+        p->openedDate = date;
+    } else {
+        p->quantity = q;
+    }
+}
+
+} // namespace engine
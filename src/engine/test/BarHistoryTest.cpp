@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "BarHistory.h"
+
+using domain::model::BarHistory;
+using domain::model::HistoryWindow;
+
+namespace {
+
+BarHistory<int> makeHistory(int n)
+{
+    std::vector<int> bars;
+    for (int i = 0; i < n; ++i) bars.push_back(i);
+    return BarHistory<int>(std::move(bars));
+}
+
+} // namespace
+
+TEST(BarHistoryTest, WindowSeesOnlyVisibleBars)
+{
+    auto h = makeHistory(10);
+    EXPECT_FALSE(h.hasCurrent());
+    EXPECT_THROW(h.current(), std::out_of_range);
+    for (int i = 0; i < 5; ++i) ASSERT_TRUE(h.advance());
+
+    const auto w = h.window(3);
+    ASSERT_EQ(w.size(), 3u);
+    EXPECT_EQ(w.front(), 2);
+    EXPECT_EQ(w.back(), 4);
+    EXPECT_EQ(w.ago(1), 3);
+    EXPECT_EQ(w.last(2).front(), 3);
+    EXPECT_THROW(h.window(6), std::out_of_range);
+    EXPECT_EQ(h.windowUpTo(100).size(), 5u);
+    EXPECT_THROW(w.at(3), std::out_of_range);
+}
+
+TEST(BarHistoryTest, AdvanceAndRewindInvalidateWindows)
+{
+    auto h = makeHistory(4);
+    h.advance();
+    const auto w = h.all();
+    const auto sub = w.last(1);
+    EXPECT_TRUE(w.valid());
+    h.advance();
+    EXPECT_FALSE(w.valid());
+    EXPECT_FALSE(sub.valid());
+
+    const auto w2 = h.all();
+    h.rewind();
+    EXPECT_FALSE(w2.valid());
+    EXPECT_EQ(h.visibleCount(), 0u);
+}
+
+TEST(BarHistoryTest, AppendInvalidatesOnReallocation)
+{
+    BarHistory<int> h;
+    h.reserve(2);
+    h.append(1);
+    h.advance();
+    const auto w = h.all();
+    h.append(2);            // 容量够，不搬移
+    EXPECT_TRUE(w.valid());
+    h.append(3);            // 扩容
+    EXPECT_FALSE(w.valid());
+}
+
+TEST(BarHistoryTest, WindowsFollowMovedHistory)
+{
+    auto h = makeHistory(5);
+    h.advance();
+    h.advance();
+    const auto w = h.all();
+
+    BarHistory<int> moved(std::move(h));
+    EXPECT_TRUE(w.valid());                 // 数据随 moved 转移，窗口仍然有效
+    EXPECT_EQ(w.back(), 1);
+    EXPECT_EQ(h.visibleCount(), 0u);        // 源对象变为空
+    EXPECT_FALSE(h.advance());
+
+    moved.advance();
+    EXPECT_FALSE(w.valid());                // 新所有者推进后失效
+
+    BarHistory<int> target = makeHistory(3);
+    target.advance();
+    const auto old = target.all();
+    target = std::move(moved);
+    EXPECT_FALSE(old.valid());              // 被覆盖的历史发出的窗口失效
+    EXPECT_EQ(target.current(), 2);
+}
+
+TEST(BarHistoryTest, DestroyedHistoryInvalidatesWindows)
+{
+    HistoryWindow<int> w;
+    EXPECT_TRUE(w.valid());                 // 默认构造的空窗口
+    {
+        auto h = makeHistory(3);
+        h.advance();
+        w = h.all();
+        EXPECT_TRUE(w.valid());
+    }
+    EXPECT_FALSE(w.valid());
+}
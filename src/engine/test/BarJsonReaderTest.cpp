@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BarJsonReader.h"
+
+using namespace domain::market;
+
+namespace {
+
+// n 行东方财富格式，日期 20240101 + i，收盘 10 + i
+std::string eastmoneyJson(int n, const std::string& pad = "")
+{
+    std::string json = R"({"rc":0,"data":{"code":"600000","klines":[)";
+    for (int i = 0; i < n; ++i) {
+        if (i) json += ",";
+        json += pad + "\"2024-01-" + (i + 1 < 10 ? "0" : "") + std::to_string(i + 1) + "," + std::to_string(9 + i) +
+                "," + std::to_string(10 + i) + "," + std::to_string(11 + i) + "," + std::to_string(8 + i) + ",1000,10000\"";
+    }
+    return json + "]}}";
+}
+
+BarJsonLayout arrayLayout()
+{
+    BarJsonLayout l;
+    l.format = BarJsonLayout::RowFormat::Array;
+    return l;
+}
+
+std::string readError(const BarJsonReader& reader, const std::string& json)
+{
+    try {
+        reader.readAll(json);
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return {};
+}
+
+} // namespace
+
+TEST(BarJsonReaderTest, ReadsSinaObjectRows)
+{
+    const std::string json = R"([
+        {"day":"2024-01-02","open":"7.100","high":"7.250","low":"7.050","close":"7.200","volume":"123456"},
+        {"day":"2024-01-03 15:00:00","open":7.2,"high":7.3,"low":7.1,"close":7.25,"volume":98765,
+         "extra":{"close":1.0,"list":[1,2,3]}}
+    ])";
+    BarJsonStats stats;
+    const BarColumns bars = BarJsonReader(BarJsonLayout::sinaKline()).readAll(json, &stats);
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_EQ(bars.date[0], 20240102);
+    EXPECT_DOUBLE_EQ(bars.open[0], 7.1);
+    EXPECT_DOUBLE_EQ(bars.close[0], 7.2);
+    EXPECT_DOUBLE_EQ(bars.volume[0], 123456.0);
+    EXPECT_TRUE(std::isnan(bars.amount[0]));   // sina 没有成交额
+    EXPECT_EQ(bars.date[1], 20240103);
+    EXPECT_DOUBLE_EQ(bars.close[1], 7.25);     // 嵌套对象里的同名键不覆盖
+    EXPECT_EQ(stats.rows, 2u);
+    EXPECT_EQ(stats.skipped, 0u);
+    EXPECT_TRUE(stats.found);
+}
+
+TEST(BarJsonReaderTest, ReadsEastmoneyCsvAndStopsAtTargetArray)
+{
+    // 目标数组之后的内容不再解析，即使它是坏的
+    const std::string json = eastmoneyJson(3) + "garbage";
+    const std::string valid = json.substr(0, json.size() - 1 - std::string("garbage").size()) + ",\"more\":[1,2]}";
+    const BarJsonReader reader(BarJsonLayout::eastmoneyKline());
+    for (const auto& text : {json, valid}) {
+        const BarColumns bars = reader.readAll(text);
+        ASSERT_EQ(bars.size(), 3u);
+        EXPECT_EQ(bars.date[2], 20240103);
+        EXPECT_DOUBLE_EQ(bars.open[2], 11.0);   // 东方财富列序：日期,开,收,高,低
+        EXPECT_DOUBLE_EQ(bars.close[2], 12.0);
+        EXPECT_DOUBLE_EQ(bars.high[2], 13.0);
+        EXPECT_DOUBLE_EQ(bars.low[2], 10.0);
+        EXPECT_DOUBLE_EQ(bars.amount[2], 10000.0);
+    }
+}
+
+TEST(BarJsonReaderTest, SkipsRowsMissingDateOrClose)
+{
+    const std::string json = R"([
+        ["2024-01-02", 1, 2, 0.5, 1.5, 100, 150],
+        ["2024-01-03", 1, 2, 0.5, null, 100, 150],
+        [null, 1, 2, 0.5, 1.5, 100, 150],
+        ["not a date", 1, 2, 0.5, 1.5],
+        [20240104, null, null, null, "1.75"],
+        ["2024-01-05", 1, 2, 0.5, "n/a", 100],
+        []
+    ])";
+    BarJsonStats stats;
+    const BarColumns bars = BarJsonReader(arrayLayout()).readAll(json, &stats);
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_EQ(bars.date[0], 20240102);
+    EXPECT_EQ(bars.date[1], 20240104);   // 整数日期
+    EXPECT_DOUBLE_EQ(bars.close[1], 1.75);
+    EXPECT_TRUE(std::isnan(bars.open[1]));   // 缺的非关键字段为 NaN
+    EXPECT_TRUE(std::isnan(bars.volume[1]));
+    EXPECT_EQ(stats.rows, 2u);
+    EXPECT_EQ(stats.skipped, 5u);
+}
+
+TEST(BarJsonReaderTest, MissingTargetArrayIsNotAnError)
+{
+    BarJsonStats stats;
+    const BarColumns bars =
+        BarJsonReader(BarJsonLayout::eastmoneyKline()).readAll(R"({"rc":102,"data":null})", &stats);
+    EXPECT_TRUE(bars.empty());
+    EXPECT_FALSE(stats.found);
+
+    // 同名键但不在目标路径上
+    const BarColumns other =
+        BarJsonReader(BarJsonLayout::eastmoneyKline()).readAll(R"({"klines":["2024-01-02,1,2,3,4,5,6"]})", &stats);
+    EXPECT_TRUE(other.empty());
+    EXPECT_FALSE(stats.found);
+}
+
+TEST(BarJsonReaderTest, MalformedInputThrowsWithOffset)
+{
+    const BarJsonReader reader(BarJsonLayout::sinaKline());
+    EXPECT_NE(readError(reader, R"([{"day":"2024-01-02","close":1.0)").find("unexpected end of input"),
+              std::string::npos);
+    EXPECT_NE(readError(reader, R"([{"day":"2024-01-02","close":01}])").find("invalid number at offset 29"),
+              std::string::npos);
+    EXPECT_NE(readError(reader, R"([{"day":"2024-01-02" "close":1}])").find("expected ','"), std::string::npos);
+    EXPECT_NE(readError(reader, "[{\"day\":\"2024-01-02\n\"}]").find("control character"), std::string::npos);
+    EXPECT_NE(readError(reader, "").find("unexpected end of input at offset 0"), std::string::npos);
+    EXPECT_TRUE(readError(reader, "[]").empty());
+}
+
+TEST(BarJsonReaderTest, BatchBoundariesDoNotChangeResult)
+{
+    const std::string json = eastmoneyJson(10);
+    const BarColumns whole = BarJsonReader(BarJsonLayout::eastmoneyKline(), 100).readAll(json);
+    ASSERT_EQ(whole.size(), 10u);
+
+    for (std::size_t batchSize : {1u, 3u, 4u, 9u, 10u, 11u}) {
+        SCOPED_TRACE(batchSize);
+        std::vector<std::size_t> sizes;
+        BarColumns joined;
+        const BarJsonStats stats = BarJsonReader(BarJsonLayout::eastmoneyKline(), batchSize)
+                                       .read(json, [&](BarColumns& batch) {
+                                           sizes.push_back(batch.size());
+                                           for (std::size_t i = 0; i < batch.size(); ++i) joined.appendRow(batch, i);
+                                       });
+        EXPECT_EQ(stats.batches, (10 + batchSize - 1) / batchSize);
+        ASSERT_EQ(sizes.size(), stats.batches);
+        for (std::size_t i = 0; i + 1 < sizes.size(); ++i) EXPECT_EQ(sizes[i], batchSize);
+        EXPECT_EQ(joined.date, whole.date);
+        EXPECT_EQ(joined.close, whole.close);
+        EXPECT_EQ(joined.amount, whole.amount);
+    }
+}
+
+TEST(BarJsonReaderTest, ValuesStraddlingScanBlocksParseTheSame)
+{
+    // 字符串和空白按 16 字节成块扫描：逐个改变前置空白，让引号、转义和数字落在块内不同位置
+    const BarColumns expected = BarJsonReader(BarJsonLayout::eastmoneyKline()).readAll(eastmoneyJson(5));
+    for (std::size_t pad = 0; pad <= 33; ++pad) {
+        SCOPED_TRACE(pad);
+        const BarColumns bars = BarJsonReader(BarJsonLayout::eastmoneyKline()).readAll(eastmoneyJson(5, std::string(pad, ' ')));
+        EXPECT_EQ(bars.date, expected.date);
+        EXPECT_EQ(bars.close, expected.close);
+
+        // 对象行：键里带转义（"close" 即 "close"），值前后带不同长度的空白
+        const std::string ws(pad, '\n');
+        const std::string json = "[{" + ws + "\"day\":" + ws + "\"2024-01-02\"," + ws + "\"clo\\u0073e\":" + ws +
+                                 "\"" + std::string(pad % 17, '0') + "7.5\"}]";
+        const BarColumns rows = BarJsonReader(BarJsonLayout::sinaKline()).readAll(json);
+        ASSERT_EQ(rows.size(), 1u);
+        EXPECT_DOUBLE_EQ(rows.close[0], 7.5);
+    }
+}
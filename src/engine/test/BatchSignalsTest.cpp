@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "BatchSignals.h"
+
+using namespace domain::signals;
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// rows x stride 的矩阵，前 cols 列为随机游走（约 10% NaN），填充列写入会制造交叉的值，
+// 以确认实现不会读到行尾之外
+std::vector<double> makeMatrix(std::size_t rows, std::size_t cols, std::size_t stride, std::uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<double> m(rows * stride);
+    for (std::size_t r = 0; r < rows; ++r) {
+        double x = 0.0;
+        for (std::size_t c = 0; c < stride; ++c) {
+            x += step(rng);
+            if (c >= cols) {
+                m[r * stride + c] = (c % 2) ? 1e9 : -1e9;
+            } else {
+                m[r * stride + c] = u(rng) < 0.1 ? kNaN : x;
+            }
+        }
+    }
+    return m;
+}
+
+// 逐 bar 标量参考实现，与 CrossSignal 的语义一致
+struct ScalarCross {
+    std::vector<std::vector<int>> dir;   // [row][col]: +1 / -1 / 0
+};
+
+template <typename ValueAt, typename OtherAt>
+ScalarCross scalarCross(std::size_t rows, std::size_t cols, ValueAt value, OtherAt other)
+{
+    ScalarCross out;
+    out.dir.assign(rows, std::vector<int>(cols, 0));
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 1; c < cols; ++c) {
+            const double a0 = value(r, c - 1), b0 = other(r, c - 1);
+            const double a1 = value(r, c), b1 = other(r, c);
+            if (std::isnan(a0) || std::isnan(b0) || std::isnan(a1) || std::isnan(b1)) continue;
+            const bool prevAbove = a0 > b0;
+            const bool above = a1 > b1;
+            if (above && !prevAbove) out.dir[r][c] = +1;
+            if (!above && prevAbove) out.dir[r][c] = -1;
+        }
+    }
+    return out;
+}
+
+void expectSameCross(const CrossResult& got, const ScalarCross& want)
+{
+    std::size_t ups = 0;
+    std::size_t downs = 0;
+    for (std::size_t r = 0; r < want.dir.size(); ++r) {
+        long long lastUp = -1;
+        for (std::size_t c = 0; c < want.dir[r].size(); ++c) {
+            const int d = want.dir[r][c];
+            ASSERT_EQ(got.up.test(r, c), d == +1) << "row " << r << " col " << c;
+            ASSERT_EQ(got.down.test(r, c), d == -1) << "row " << r << " col " << c;
+            if (d == +1) {
+                ++ups;
+                lastUp = static_cast<long long>(c);
+            }
+            if (d == -1) ++downs;
+        }
+        EXPECT_EQ(got.up.lastSetInRow(r), lastUp);
+    }
+    EXPECT_EQ(got.up.count(), ups);
+    EXPECT_EQ(got.down.count(), downs);
+}
+
+} // namespace
+
+TEST(BatchSignalsTest, CrossMatchesScalarReference)
+{
+    // 覆盖不足一个字、恰好一个字、跨字边界以及 SIMD 尾部
+    for (std::size_t cols : {1u, 3u, 63u, 64u, 65u, 127u, 130u, 257u}) {
+        const std::size_t rows = 7;
+        const auto fast = makeMatrix(rows, cols, cols, 1000 + cols);
+        const auto slow = makeMatrix(rows, cols, cols, 2000 + cols);
+
+        const CrossResult got = batchCross(SeriesMatrix(fast.data(), rows, cols), SeriesMatrix(slow.data(), rows, cols));
+        const ScalarCross want = scalarCross(
+            rows, cols, [&](std::size_t r, std::size_t c) { return fast[r * cols + c]; },
+            [&](std::size_t r, std::size_t c) { return slow[r * cols + c]; });
+        SCOPED_TRACE(cols);
+        expectSameCross(got, want);
+    }
+}
+
+TEST(BatchSignalsTest, HonoursRowStride)
+{
+    const std::size_t rows = 5;
+    const std::size_t cols = 70;
+    const std::size_t stride = 83;
+    const auto fast = makeMatrix(rows, cols, stride, 7);
+    const auto slow = makeMatrix(rows, cols, stride, 8);
+
+    const CrossResult got =
+        batchCross(SeriesMatrix(fast.data(), rows, cols, stride), SeriesMatrix(slow.data(), rows, cols, stride));
+    const ScalarCross want = scalarCross(
+        rows, cols, [&](std::size_t r, std::size_t c) { return fast[r * stride + c]; },
+        [&](std::size_t r, std::size_t c) { return slow[r * stride + c]; });
+    expectSameCross(got, want);
+}
+
+TEST(BatchSignalsTest, ThresholdCrossAndLevels)
+{
+    const std::size_t rows = 4;
+    const std::size_t cols = 100;
+    const std::size_t stride = 101;
+    const auto values = makeMatrix(rows, cols, stride, 42);
+    const SeriesMatrix m(values.data(), rows, cols, stride);
+    const std::vector<double> thresholds{-2.0, 0.0, 1.5, 3.0};
+
+    const ScalarCross fixed = scalarCross(
+        rows, cols, [&](std::size_t r, std::size_t c) { return values[r * stride + c]; },
+        [](std::size_t, std::size_t) { return 0.5; });
+    expectSameCross(batchThresholdCross(m, 0.5), fixed);
+
+    const ScalarCross perRow = scalarCross(
+        rows, cols, [&](std::size_t r, std::size_t c) { return values[r * stride + c]; },
+        [&](std::size_t r, std::size_t) { return thresholds[r]; });
+    expectSameCross(batchThresholdCross(m, thresholds.data()), perRow);
+
+    const SignalBitset above = batchAbove(m, 0.5);
+    const SignalBitset below = batchBelow(m, 0.5);
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < cols; ++c) {
+            const double v = values[r * stride + c];
+            // NaN 既不在上方也不在下方
+            EXPECT_EQ(above.test(r, c), v > 0.5);
+            EXPECT_EQ(below.test(r, c), v < 0.5);
+        }
+    }
+}
+
+TEST(BatchSignalsTest, EventsAreSortedBySymbolThenTime)
+{
+    const std::vector<double> fast{1, 3, 1, 3, kNaN, 3, 1, 1, 1, 1};
+    const std::vector<double> slow(fast.size(), 2.0);
+    const CrossResult r = batchCross(SeriesMatrix(fast.data(), 2, 5), SeriesMatrix(slow.data(), 2, 5));
+
+    const auto events = r.events();
+    ASSERT_EQ(events.size(), 4u);
+    // 第 0 行：1 上穿、2 下穿、3 上穿；NaN 所在的 bar 不产生信号
+    EXPECT_EQ(events[0].symbol, 0u);
+    EXPECT_EQ(events[0].time, 1u);
+    EXPECT_EQ(events[0].direction, 1);
+    EXPECT_EQ(events[1].time, 2u);
+    EXPECT_EQ(events[1].direction, -1);
+    EXPECT_EQ(events[2].time, 3u);
+    // 第 1 行：3 -> 1 下穿
+    EXPECT_EQ(events[3].symbol, 1u);
+    EXPECT_EQ(events[3].time, 1u);
+    EXPECT_EQ(events[3].direction, -1);
+}
+
+TEST(BatchSignalsTest, RejectsMismatchedShapes)
+{
+    const std::vector<double> a(10, 1.0);
+    EXPECT_THROW(batchCross(SeriesMatrix(a.data(), 2, 5), SeriesMatrix(a.data(), 1, 5)), std::invalid_argument);
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "IndicatorCache.h"
+#include "StaticPipeline.h"
+
+using namespace domain::indicators;
+
+namespace {
+
+std::vector<double> ramp(std::size_t n, double start)
+{
+    std::vector<double> v(n);
+    for (std::size_t i = 0; i < n; ++i) v[i] = start + static_cast<double>(i);
+    return v;
+}
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+bool sameValue(double a, double b)
+{
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+// 随机游走价格，夹杂停牌（NaN）
+std::vector<double> prices(std::size_t n, double level, std::uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> z(0.0, 1.0);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<double> v(n);
+    double p = level;
+    for (auto& x : v) {
+        p += z(rng);
+        x = u(rng) < 0.05 ? kNaN : p;
+    }
+    return v;
+}
+
+} // namespace
+
+TEST(IndicatorCacheTest, SeriesHitRequiresSameVersionAndLength)
+{
+    IndicatorCache cache;
+    const IndicatorKey key{1, IndicatorType::Sma, 3, 0.0};
+    std::vector<double> data = ramp(10, 1.0);
+
+    auto a = cache.series(key, data.data(), data.size(), 1);
+    auto b = cache.series(key, data.data(), data.size(), 1);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(cache.stats().seriesHits, 1u);
+
+    // 同一块缓冲区内容改变、版本号改变：必须重新计算
+    data = ramp(10, 100.0);
+    auto c = cache.series(key, data.data(), data.size(), 2);
+    EXPECT_NE(a, c);
+    EXPECT_DOUBLE_EQ((*c)[2], 101.0);
+
+    // 同一版本但长度不同也不是同一份数据
+    auto d = cache.series(key, data.data(), 5, 2);
+    EXPECT_EQ(d->size(), 5u);
+    EXPECT_EQ(cache.stats().seriesMisses, 3u);
+}
+
+TEST(IndicatorCacheTest, ConcurrentRequestsForDifferentLengthsDoNotShareResults)
+{
+    const IndicatorKey key{7, IndicatorType::Ema, 5, 0.0};
+    const std::vector<double> data = ramp(20000, 1.0);
+    for (int round = 0; round < 20; ++round) {
+        IndicatorCache cache;
+        std::vector<std::thread> threads;
+        std::vector<std::size_t> sizes(8);
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            threads.emplace_back([&, i] {
+                const std::size_t n = data.size() - (i % 2) * 1000;
+                sizes[i] = cache.series(key, data.data(), n, 1)->size() == n;
+            });
+        }
+        for (auto& t : threads) t.join();
+        for (std::size_t ok : sizes) EXPECT_EQ(ok, 1u);
+        const auto s = cache.stats();
+        EXPECT_EQ(s.seriesHits + s.seriesMisses, sizes.size());
+    }
+}
+
+TEST(IndicatorCacheTest, StreamingSharesInstancesAndMatchesBatch)
+{
+    IndicatorCache cache;
+    const IndicatorKey sma{3, IndicatorType::Sma, 5, 0.0};
+    const IndicatorKey rsi{3, IndicatorType::Rsi, 14, 0.0};
+    auto a = cache.acquire(sma);
+    auto b = cache.acquire(sma);
+    auto r = cache.acquire(rsi);
+    auto other = cache.acquire(IndicatorKey{4, IndicatorType::Sma, 5, 0.0});
+    EXPECT_EQ(cache.stats().streamHits, 1u);
+    EXPECT_EQ(cache.stats().streamEntries, 3u);
+    EXPECT_THROW(cache.acquire(IndicatorKey{3, IndicatorType::Sma, 0, 0.0}), std::invalid_argument);
+
+    const auto input = prices(300, 50.0, 1);
+    std::vector<double> wantSma(input.size());
+    std::vector<double> wantRsi(input.size());
+    computeIndicator(IndicatorType::Sma, 5, 0.0, input.data(), input.size(), wantSma.data());
+    computeIndicator(IndicatorType::Rsi, 14, 0.0, input.data(), input.size(), wantRsi.data());
+
+    for (std::size_t t = 0; t < input.size(); ++t) {
+        cache.onBar(3, t + 1, input[t]);
+        cache.onBar(3, t + 1, 1e9);   // 同一根 bar 重复推送被忽略
+        ASSERT_TRUE(sameValue(a.value(), wantSma[t])) << "bar " << t;
+        ASSERT_TRUE(sameValue(r.value(), wantRsi[t])) << "bar " << t;
+        EXPECT_TRUE(sameValue(a.value(), b.value()));
+    }
+    EXPECT_TRUE(std::isnan(other.value()));   // 其它标的不受影响
+    const auto s = cache.stats();
+    EXPECT_EQ(s.updates, 2 * input.size());
+    EXPECT_EQ(s.skippedUpdates, input.size());
+
+    // 句柄释放后才会被清理
+    a = IndicatorCache::StreamHandle();
+    EXPECT_EQ(cache.purgeUnused(), 0u);
+    b = IndicatorCache::StreamHandle();
+    other = IndicatorCache::StreamHandle();
+    EXPECT_EQ(cache.purgeUnused(), 2u);
+    EXPECT_EQ(cache.stats().streamEntries, 1u);
+}
+
+TEST(IndicatorCacheTest, NaNSkippingMatchesStaticPipeline)
+{
+    const auto input = prices(500, 20.0, 2);
+    std::vector<double> sma(input.size());
+    std::vector<double> ema(input.size());
+    computeIndicator(IndicatorType::Sma, 10, 0.0, input.data(), input.size(), sma.data());
+    computeIndicator(IndicatorType::Ema, 10, 0.0, input.data(), input.size(), ema.data());
+
+    domain::strategies::Sma refSma(10);
+    domain::strategies::Ema refEma(10);
+    for (std::size_t t = 0; t < input.size(); ++t) {
+        ASSERT_TRUE(sameValue(sma[t], refSma.update(input[t]))) << "bar " << t;
+        ASSERT_TRUE(sameValue(ema[t], refEma.update(input[t]))) << "bar " << t;
+    }
+    // 停牌 bar 保持上一个值，而不是输出 NaN
+    for (std::size_t t = 30; t < input.size(); ++t) {
+        if (std::isnan(input[t])) {
+            EXPECT_EQ(sma[t], sma[t - 1]);
+        }
+    }
+}
+
+TEST(IndicatorCacheTest, StdDevIsAccurateAtPriceLevel)
+{
+    // 价格在 1e6 量级、波动在 1e-2 量级：朴素的 sumSq/n - mean^2 在这里只剩噪声
+    const std::uint32_t period = 20;
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> z(0.0, 0.01);
+    std::vector<double> input(5000);
+    for (auto& x : input) x = 1e6 + z(rng);
+
+    std::vector<double> out(input.size());
+    computeIndicator(IndicatorType::StdDev, period, 0.0, input.data(), input.size(), out.data());
+    for (std::size_t t = period - 1; t < input.size(); ++t) {
+        double mean = 0.0;
+        for (std::size_t k = t + 1 - period; k <= t; ++k) mean += input[k];
+        mean /= period;
+        double m2 = 0.0;
+        for (std::size_t k = t + 1 - period; k <= t; ++k) m2 += (input[k] - mean) * (input[k] - mean);
+        const double exact = std::sqrt(m2 / period);
+        ASSERT_NEAR(out[t], exact, exact * 1e-6) << "bar " << t;
+    }
+    EXPECT_TRUE(std::isnan(out[period - 2]));
+}
+
+TEST(IndicatorCacheTest, SeriesEvictsLeastRecentlyUsed)
+{
+    // 每项约 100 个 double，上限只够放两项
+    IndicatorCache::Options options;
+    options.maxSeriesBytes = 2 * (100 * sizeof(double) + 256);
+    IndicatorCache cache(options);
+    const std::vector<double> data = ramp(100, 1.0);
+    const IndicatorKey k1{1, IndicatorType::Sma, 3, 0.0};
+    const IndicatorKey k2{2, IndicatorType::Sma, 3, 0.0};
+    const IndicatorKey k3{3, IndicatorType::Sma, 3, 0.0};
+
+    auto s1 = cache.series(k1, data.data(), data.size(), 1);
+    cache.series(k2, data.data(), data.size(), 1);
+    cache.series(k1, data.data(), data.size(), 1);   // k1 变为最近使用
+    cache.series(k3, data.data(), data.size(), 1);   // 淘汰 k2
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.seriesEntries, 2u);
+    EXPECT_LE(stats.seriesBytes, options.maxSeriesBytes);
+
+    const auto misses = stats.seriesMisses;
+    cache.series(k1, data.data(), data.size(), 1);
+    EXPECT_EQ(cache.stats().seriesMisses, misses);
+    cache.series(k2, data.data(), data.size(), 1);
+    EXPECT_EQ(cache.stats().seriesMisses, misses + 1);
+    // 已返回的序列不受淘汰影响
+    EXPECT_DOUBLE_EQ((*s1)[2], 2.0);
+
+    // 单项超过上限时仍保留刚插入的一项
+    IndicatorCache::Options tiny;
+    tiny.maxSeriesBytes = 1;
+    IndicatorCache small(tiny);
+    small.series(k1, data.data(), data.size(), 1);
+    EXPECT_EQ(small.stats().seriesEntries, 1u);
+}
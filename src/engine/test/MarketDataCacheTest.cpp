@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MarketDataCache.h"
+#include "foundation/testing/TempDir.h"
+
+using namespace domain::market;
+namespace stdfs = std::filesystem;
+
+namespace {
+
+class MarketDataCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = foundation::testutil::freshTempDir("market_data_cache_test");
+    }
+    void TearDown() override { stdfs::remove_all(dir_); }
+
+    stdfs::path dir_;
+};
+
+BarColumns makeBars(std::vector<std::int32_t> dates)
+{
+    BarColumns b;
+    for (auto d : dates) {
+        const double px = 10.0 + (d % 100) * 0.01;
+        b.date.push_back(d);
+        b.open.push_back(px);
+        b.high.push_back(px + 0.1);
+        b.low.push_back(px - 0.1);
+        b.close.push_back(px);
+        b.volume.push_back(1000.0);
+        b.amount.push_back(px * 1000.0);
+    }
+    return b;
+}
+
+} // namespace
+
+TEST_F(MarketDataCacheTest, CoverStopsAtLastReturnedBar)
+{
+    MarketDataCache cache(dir_.string());
+    int calls = 0;
+    auto fetcher = [&](const std::string&, const DateRange&, const std::string&) {
+        ++calls;
+        FetchResult r;
+        r.bars = makeBars({20240102, 20240103});
+        return r;
+    };
+    const auto bars = cache.fetchThrough("600000.SH", {20240101, 20240110}, fetcher);
+    EXPECT_EQ(bars.size(), 2u);
+    const auto missing = cache.missingRanges("600000.SH", {20240101, 20240110});
+    ASSERT_EQ(missing.size(), 1u);
+    EXPECT_EQ(missing.front(), (DateRange{20240104, 20240110}));
+    EXPECT_EQ(cache.lastBarDate("600000.SH"), 20240103);
+}
+
+TEST_F(MarketDataCacheTest, EmptyFetchDoesNotRecordCover)
+{
+    MarketDataCache cache(dir_.string());
+    int calls = 0;
+    auto fetcher = [&](const std::string&, const DateRange&, const std::string&) {
+        ++calls;
+        return FetchResult{};
+    };
+    cache.fetchThrough("600000.SH", {20240101, 20240105}, fetcher);
+    cache.fetchThrough("600000.SH", {20240101, 20240105}, fetcher);
+    EXPECT_EQ(calls, 2);
+    EXPECT_TRUE(cache.segments("600000.SH").empty());
+    EXPECT_EQ(cache.lastBarDate("600000.SH"), 0);
+}
+
+TEST_F(MarketDataCacheTest, SendsSegmentEtagAndHandlesNotModified)
+{
+    MarketDataCache cache(dir_.string());
+    std::vector<std::string> sentTags;
+    auto fetcher = [&](const std::string&, const DateRange& range, const std::string& etag) {
+        sentTags.push_back(etag);
+        FetchResult r;
+        if (range.from == 20240101) {
+            r.bars = makeBars({20240102, 20240103});
+            r.etag = "v1";
+        } else {
+            r.notModified = true;
+            r.etag = "v2";
+        }
+        return r;
+    };
+    cache.fetchThrough("600000.SH", {20240101, 20240103}, fetcher);
+    const auto bars = cache.fetchThrough("600000.SH", {20240101, 20240110}, fetcher);
+    ASSERT_EQ(sentTags.size(), 2u);
+    EXPECT_EQ(sentTags[0], "");
+    EXPECT_EQ(sentTags[1], "v1");
+    EXPECT_EQ(bars.size(), 2u);
+    EXPECT_EQ(cache.stats().notModified, 1u);
+    // 304 带回的新 ETag 记到分段上，下次请求带新 ETag
+    EXPECT_EQ(cache.etagFor("600000.SH", {20240104, 20240110}), "v2");
+    EXPECT_EQ(cache.lastBarDate("600000.SH"), 20240103);
+}
+
+TEST_F(MarketDataCacheTest, NotModifiedDoesNotGrowIndex)
+{
+    MarketDataCache cache(dir_.string());
+    int round = 0;
+    auto fetcher = [&](const std::string&, const DateRange& range, const std::string&) {
+        FetchResult r;
+        if (range.from == 20240101) {
+            r.bars = makeBars({20240102, 20240103});
+            r.etag = "v0";
+        } else {
+            // 每次 304 都带回一个新 ETag，第 3 次起不再变
+            r.notModified = true;
+            r.etag = "v" + std::to_string(std::min(++round, 3));
+        }
+        return r;
+    };
+    cache.fetchThrough("600000.SH", {20240101, 20240103}, fetcher);
+    for (int i = 0; i < 5; ++i) cache.fetchThrough("600000.SH", {20240101, 20240110}, fetcher);
+    EXPECT_EQ(cache.stats().notModified, 5u);
+    // 索引仍只有一行，ETag 是最后一次 304 带回的
+    const auto segs = cache.segments("600000.SH");
+    ASSERT_EQ(segs.size(), 1u);
+    EXPECT_EQ(segs[0].etag, "v3");
+    EXPECT_EQ(segs[0].rows, 2u);
+    EXPECT_EQ(cache.etagFor("600000.SH", {20240104, 20240110}), "v3");
+}
+
+TEST_F(MarketDataCacheTest, CompactDoesNotDropConcurrentStores)
+{
+    MarketDataCache cache(dir_.string());
+    cache.store("600000.SH", {20240101, 20240101}, makeBars({20240101}));
+    std::thread writer([&] {
+        for (std::int32_t d = 20240102; d <= 20240128; ++d) cache.store("600000.SH", {d, d}, makeBars({d}));
+    });
+    for (int i = 0; i < 50; ++i) cache.compact("600000.SH");
+    writer.join();
+    EXPECT_TRUE(cache.missingRanges("600000.SH", {20240101, 20240128}).empty());
+    EXPECT_EQ(cache.read("600000.SH", {20240101, 20240128}).size(), 28u);
+    cache.compact("600000.SH");
+    EXPECT_EQ(cache.segments("600000.SH").size(), 1u);
+    EXPECT_EQ(cache.verify("600000.SH"), 0u);
+}
+
+TEST_F(MarketDataCacheTest, CompactDeletesUnreferencedBlocks)
+{
+    MarketDataCache cache(dir_.string());
+    auto blockPath = [&](const std::string& hash) {
+        return stdfs::path(cache.root()) / "objects" / hash.substr(0, 2) / (hash + ".blk");
+    };
+    for (std::int32_t d = 20240102; d <= 20240104; ++d) cache.store("600000.SH", {d, d}, makeBars({d}));
+    // 与 600000.SH 第一个分段内容相同，共用同一个块
+    cache.store("600000.SZ", {20240102, 20240102}, makeBars({20240102}));
+    const auto before = cache.segments("600000.SH");
+    ASSERT_EQ(before.size(), 3u);
+    ASSERT_EQ(cache.segments("600000.SZ").front().hash, before[0].hash);
+
+    // 中断的 compact 留下的块与写了一半的临时文件
+    const std::string orphanData = MarketDataCache::encodeBlock(makeBars({20230103}));
+    const auto orphanPath = blockPath(MarketDataCache::contentHash(orphanData));
+    stdfs::create_directories(orphanPath.parent_path());
+    std::ofstream(orphanPath, std::ios::binary) << orphanData;
+    const auto tmpPath = stdfs::path(orphanPath.string() + ".tmp.1.1");
+    std::ofstream(tmpPath) << "partial";
+
+    cache.compact("600000.SH");
+    const auto after = cache.segments("600000.SH");
+    ASSERT_EQ(after.size(), 1u);
+    EXPECT_TRUE(stdfs::exists(blockPath(after[0].hash)));
+    EXPECT_TRUE(stdfs::exists(blockPath(before[0].hash)));   // 600000.SZ 仍在引用
+    EXPECT_FALSE(stdfs::exists(blockPath(before[1].hash)));
+    EXPECT_FALSE(stdfs::exists(blockPath(before[2].hash)));
+    EXPECT_FALSE(stdfs::exists(orphanPath));
+    EXPECT_FALSE(stdfs::exists(tmpPath));
+    EXPECT_EQ(cache.verify("600000.SH"), 0u);
+    EXPECT_EQ(cache.verify("600000.SZ"), 0u);
+    EXPECT_EQ(cache.read("600000.SH", {20240101, 20240110}).size(), 3u);
+}
+
+TEST_F(MarketDataCacheTest, SeparateInstancesShareDirectorySafely)
+{
+    // 两个实例各有自己的 mutex_，相当于两个进程：只能靠目录锁与唯一临时文件名保证不丢分段
+    MarketDataCache a(dir_.string());
+    MarketDataCache b(dir_.string());
+    a.store("600000.SH", {20240101, 20240101}, makeBars({20240101}));
+    std::thread writer([&] {
+        for (std::int32_t d = 20240102; d <= 20240128; ++d) b.store("600000.SH", {d, d}, makeBars({d}));
+    });
+    std::thread sameBlock([&] {
+        // 与 writer 写同样内容的数据块，同一个目标路径被并发写
+        for (std::int32_t d = 20240102; d <= 20240128; ++d) a.store("600000.SZ", {d, d}, makeBars({d}));
+    });
+    for (int i = 0; i < 50; ++i) a.compact("600000.SH");
+    writer.join();
+    sameBlock.join();
+    EXPECT_TRUE(b.missingRanges("600000.SH", {20240101, 20240128}).empty());
+    EXPECT_EQ(a.read("600000.SH", {20240101, 20240128}).size(), 28u);
+    EXPECT_EQ(a.verify("600000.SZ"), 0u);
+    for (const auto& e : stdfs::recursive_directory_iterator(dir_)) {
+        EXPECT_EQ(e.path().string().find(".tmp"), std::string::npos) << e.path();
+    }
+}
+
+TEST_F(MarketDataCacheTest, ResponseReadsNeverSeeHalfWrittenPairs)
+{
+    MarketDataCache writer(dir_.string());
+    MarketDataCache reader(dir_.string());
+    const std::string url = "https://example.com/daily?code=600000";
+    writer.storeResponse(url, "body-0", "e0");
+    std::thread t([&] {
+        for (int i = 1; i <= 200; ++i) writer.storeResponse(url, "body-" + std::to_string(i), "e" + std::to_string(i));
+    });
+    for (int i = 0; i < 200; ++i) {
+        const auto r = reader.loadResponse(url);
+        ASSERT_TRUE(r.has_value());
+        EXPECT_EQ(r->body.substr(5), r->etag.substr(1));
+    }
+    t.join();
+    EXPECT_EQ(reader.stats().corruptBlocks, 0u);
+}
+
+TEST_F(MarketDataCacheTest, StatsExportToMetricsRegistry)
+{
+    MarketDataCache cache(dir_.string());
+    cache.bindMetrics("cache_test");
+    auto fetcher = [](const std::string&, const DateRange& range, const std::string&) {
+        FetchResult r;
+        r.bars = makeBars({range.from});
+        return r;
+    };
+    cache.fetchThrough("600000.SH", {20240102, 20240102}, fetcher);   // miss
+    cache.fetchThrough("600000.SH", {20240102, 20240102}, fetcher);   // hit
+    const std::string text = foundation::metrics::MetricsRegistry::instance().exportText();
+    EXPECT_NE(text.find("# TYPE market_cache_requests_total counter"), std::string::npos);
+    EXPECT_NE(text.find("market_cache_requests_total{cache=\"cache_test\",result=\"hit\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("market_cache_requests_total{cache=\"cache_test\",result=\"miss\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("market_cache_hit_rate{cache=\"cache_test\"} 0.5"), std::string::npos);
+}
+
+TEST_F(MarketDataCacheTest, RebindMetricsReplacesSeries)
+{
+    MarketDataCache cache(dir_.string());
+    cache.bindMetrics("cache_rebind");
+    EXPECT_NO_THROW(cache.bindMetrics("cache_rebind"));   // 同名重复绑定：旧句柄先注销
+    cache.bindMetrics("cache_rebind_2");
+    auto fetcher = [](const std::string&, const DateRange& range, const std::string&) {
+        FetchResult r;
+        r.bars = makeBars({range.from});
+        return r;
+    };
+    cache.fetchThrough("600000.SH", {20240102, 20240102}, fetcher);   // miss
+    const std::string text = foundation::metrics::MetricsRegistry::instance().exportText();
+    EXPECT_NE(text.find("market_cache_requests_total{cache=\"cache_rebind_2\",result=\"miss\"} 1"), std::string::npos);
+    EXPECT_EQ(text.find("cache=\"cache_rebind\""), std::string::npos);
+}
@@ -0,0 +1,354 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MarketDataSync.h"
+
+using namespace domain::market;
+namespace stdfs = std::filesystem;
+
+namespace {
+
+class MarketDataSyncTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = stdfs::temp_directory_path() /
+               ("market_data_sync_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        stdfs::remove_all(dir_);
+        stdfs::create_directories(dir_);
+    }
+    void TearDown() override { stdfs::remove_all(dir_); }
+
+    static SyncOptions fastOptions() {
+        SyncOptions o;
+        o.workers = 1;
+        o.requestsPerSecond = 0.0;
+        o.retryBaseDelay = std::chrono::milliseconds(1);
+        o.retryMaxDelay = std::chrono::milliseconds(2);
+        return o;
+    }
+
+    stdfs::path dir_;
+};
+
+BarColumns makeBars(std::vector<std::int32_t> dates)
+{
+    BarColumns b;
+    for (auto d : dates) {
+        b.date.push_back(d);
+        b.open.push_back(10.0);
+        b.high.push_back(10.5);
+        b.low.push_back(9.5);
+        b.close.push_back(10.2);
+        b.volume.push_back(1000.0);
+        b.amount.push_back(10200.0);
+    }
+    return b;
+}
+
+// 模拟数据源：记录每次请求，按脚本返回或抛错
+struct MockFetcher {
+    struct Call {
+        DateRange range;
+        std::string etag;
+    };
+    std::vector<Call> calls;
+    std::vector<std::function<FetchResult(const DateRange&)>> script;
+
+    RangeFetcher fetcher() {
+        return [this](const std::string&, const DateRange& range, const std::string& etag) {
+            calls.push_back({range, etag});
+            return script.at(calls.size() - 1)(range);
+        };
+    }
+};
+
+// 假时钟：sleep 直接把时间往前拨，限速测试不用真的等
+struct FakeClock {
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point t{};
+
+    SyncClock clock() {
+        SyncClock c;
+        c.now = [this] {
+            std::lock_guard<std::mutex> lock(mutex);
+            return t;
+        };
+        c.sleep = [this](std::chrono::steady_clock::duration d) {
+            std::lock_guard<std::mutex> lock(mutex);
+            t += d;
+        };
+        return c;
+    }
+    double seconds() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::chrono::duration<double>(t.time_since_epoch()).count();
+    }
+};
+
+} // namespace
+
+TEST_F(MarketDataSyncTest, RetriesRetryableErrorsThenStores)
+{
+    MarketDataCache cache(dir_.string());
+    MockFetcher mock;
+    mock.script.push_back([](const DateRange&) -> FetchResult { throw FetchError("timeout"); });
+    mock.script.push_back([](const DateRange&) -> FetchResult { throw FetchError("timeout"); });
+    mock.script.push_back([](const DateRange&) {
+        FetchResult r;
+        r.bars = makeBars({20240102, 20240103});
+        r.etag = "v1";
+        return r;
+    });
+    MarketDataSync sync(cache, mock.fetcher(), fastOptions());
+    const auto report = sync.sync({"600000.SH"}, 20240110, 20240101);
+    ASSERT_EQ(report.results.size(), 1u);
+    const auto& r = report.results[0];
+    EXPECT_TRUE(r.ok);
+    EXPECT_EQ(r.attempts, 3);
+    EXPECT_EQ(r.newBars, 2u);
+    // 高水位取最后一根 bar，而不是请求的终点
+    EXPECT_EQ(r.highWater, 20240103);
+    EXPECT_EQ(sync.highWaterMark("600000.SH"), 20240103);
+    EXPECT_EQ(report.requests, 3u);
+}
+
+TEST_F(MarketDataSyncTest, NonRetryableErrorStopsAndRetriesAreBounded)
+{
+    MarketDataCache cache(dir_.string());
+    MockFetcher mock;
+    for (int i = 0; i < 10; ++i) mock.script.push_back([](const DateRange&) -> FetchResult { throw FetchError("503"); });
+    SyncOptions options = fastOptions();
+    options.maxRetries = 1;
+    MarketDataSync sync(cache, mock.fetcher(), options);
+    auto report = sync.sync({"600000.SH"}, 20240110, 20240101);
+    EXPECT_FALSE(report.results[0].ok);
+    EXPECT_EQ(report.results[0].attempts, 2);
+
+    MockFetcher fatal;
+    fatal.script.push_back([](const DateRange&) -> FetchResult { throw FetchError("unknown symbol", false); });
+    MarketDataSync sync2(cache, fatal.fetcher(), fastOptions());
+    report = sync2.sync({"600000.SH"}, 20240110, 20240101);
+    EXPECT_FALSE(report.results[0].ok);
+    EXPECT_EQ(report.results[0].attempts, 1);
+    EXPECT_EQ(report.results[0].error, "unknown symbol");
+}
+
+TEST_F(MarketDataSyncTest, NotModifiedAndEmptyResponsesKeepHighWater)
+{
+    MarketDataCache cache(dir_.string());
+    MockFetcher mock;
+    mock.script.push_back([](const DateRange&) {
+        FetchResult r;
+        r.bars = makeBars({20240102, 20240103});
+        r.etag = "v1";
+        return r;
+    });
+    mock.script.push_back([](const DateRange&) {
+        FetchResult r;
+        r.notModified = true;
+        return r;
+    });
+    mock.script.push_back([](const DateRange&) { return FetchResult{}; });
+    mock.script.push_back([](const DateRange&) {
+        FetchResult r;
+        r.bars = makeBars({20240108});
+        r.etag = "v2";
+        return r;
+    });
+    MarketDataSync sync(cache, mock.fetcher(), fastOptions());
+
+    sync.sync({"600000.SH"}, 20240105, 20240101);
+    auto report = sync.sync({"600000.SH"}, 20240110, 20240101);   // 304
+    EXPECT_TRUE(report.results[0].ok);
+    EXPECT_EQ(report.results[0].highWater, 20240103);
+    EXPECT_EQ(report.results[0].newBars, 0u);
+    report = sync.sync({"600000.SH"}, 20240110, 20240101);        // 空结果
+    EXPECT_EQ(report.results[0].highWater, 20240103);
+    report = sync.sync({"600000.SH"}, 20240110, 20240101);
+    EXPECT_EQ(report.results[0].highWater, 20240108);
+    EXPECT_EQ(report.results[0].newBars, 1u);
+
+    ASSERT_EQ(mock.calls.size(), 4u);
+    EXPECT_EQ(mock.calls[0].etag, "");
+    for (std::size_t i = 1; i < 4; ++i) {
+        // 304 和空结果之后仍从最后一根 bar 的下一天请求，并带上已有分段的 ETag
+        EXPECT_EQ(mock.calls[i].range, (DateRange{20240104, 20240110}));
+        EXPECT_EQ(mock.calls[i].etag, "v1");
+    }
+    EXPECT_EQ(cache.read("600000.SH", {20240101, 20240110}).size(), 3u);
+}
+
+TEST_F(MarketDataSyncTest, MaxRetriesComesFromConfig)
+{
+    const auto config = foundation::config::ConfigSnapshot::Builder()
+                            .mergeJson(R"({"network": {"max_retries": 5}})")
+                            .build();
+    EXPECT_EQ(syncOptionsFromConfig(*config).maxRetries, 5);
+    const auto empty = foundation::config::ConfigSnapshot::Builder().build();
+    EXPECT_EQ(syncOptionsFromConfig(*empty).maxRetries, SyncOptions().maxRetries);
+}
+
+TEST_F(MarketDataSyncTest, StorageErrorIsReportedWithoutRefetching)
+{
+    MarketDataCache cache(dir_.string());
+    // 索引文件的位置被目录占住，追加索引必然失败
+    stdfs::create_directories(dir_ / "market" / "index" / "600000.SH.idx");
+    MockFetcher mock;
+    for (int i = 0; i < 3; ++i) {
+        mock.script.push_back([](const DateRange&) {
+            FetchResult r;
+            r.bars = makeBars({20240102});
+            return r;
+        });
+    }
+    MarketDataSync sync(cache, mock.fetcher(), fastOptions());
+    const auto report = sync.sync({"600000.SH"}, 20240110, 20240101);
+    const auto& r = report.results[0];
+    EXPECT_FALSE(r.ok);
+    EXPECT_EQ(r.attempts, 1);
+    EXPECT_EQ(mock.calls.size(), 1u);
+    EXPECT_NE(r.error.find("cannot store"), std::string::npos) << r.error;
+    EXPECT_EQ(report.failed, 1u);
+}
+
+TEST_F(MarketDataSyncTest, LocalStoreErrorIsReportedPerSymbol)
+{
+    MarketDataCache cache(dir_.string());
+    // 锁文件的位置被目录占住，读高水位就会失败；以前会在工作线程里抛出、进程 terminate
+    stdfs::create_directories(dir_ / "market" / "lock");
+    MockFetcher mock;
+    SyncOptions options = fastOptions();
+    options.workers = 2;
+    MarketDataSync sync(cache, mock.fetcher(), options);
+    const auto report = sync.sync({"600000.SH", "000001.SZ"}, 20240110, 20240101);
+    ASSERT_EQ(report.results.size(), 2u);
+    for (const auto& r : report.results) {
+        EXPECT_FALSE(r.ok);
+        EXPECT_EQ(r.attempts, 0);
+        EXPECT_NE(r.error.find("cannot read local store"), std::string::npos) << r.error;
+    }
+    EXPECT_TRUE(mock.calls.empty());
+    EXPECT_EQ(report.failed, 2u);
+    EXPECT_EQ(report.requests, 0u);
+}
+
+TEST_F(MarketDataSyncTest, ManyWorkersSyncEverySymbolOnce)
+{
+    MarketDataCache cache(dir_.string());
+    std::vector<std::string> symbols;
+    for (int i = 0; i < 40; ++i) symbols.push_back("6000" + std::to_string(10 + i) + ".SH");
+    // 其中一个本地已是最新，不应发请求
+    cache.store(symbols[5], {20240101, 20240110}, makeBars({20240110}));
+
+    std::mutex mutex;
+    std::multiset<std::string> fetched;
+    std::atomic<int> inFlight{0};
+    std::atomic<int> maxInFlight{0};
+    std::atomic<int> flaky{0};
+    auto fetcher = [&](const std::string& symbol, const DateRange&, const std::string&) {
+        const int now = ++inFlight;
+        int seen = maxInFlight.load();
+        while (now > seen && !maxInFlight.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fetched.insert(symbol);
+        }
+        --inFlight;
+        if (symbol == symbols[7]) throw FetchError("unknown symbol", false);
+        if (symbol == symbols[9] && flaky++ == 0) throw FetchError("timeout");
+        FetchResult r;
+        r.bars = makeBars({20240102, 20240103});
+        return r;
+    };
+
+    SyncOptions options = fastOptions();
+    options.workers = 8;
+    MarketDataSync sync(cache, fetcher, options);
+    const auto report = sync.sync(symbols, 20240110, 20240101);
+
+    ASSERT_EQ(report.results.size(), symbols.size());
+    for (std::size_t i = 0; i < symbols.size(); ++i) EXPECT_EQ(report.results[i].symbol, symbols[i]);
+    EXPECT_GT(maxInFlight.load(), 1);
+    EXPECT_TRUE(report.results[5].skipped);
+    EXPECT_EQ(fetched.count(symbols[5]), 0u);
+    EXPECT_FALSE(report.results[7].ok);
+    EXPECT_EQ(report.results[9].attempts, 2);
+    EXPECT_EQ(report.skipped, 1u);
+    EXPECT_EQ(report.failed, 1u);
+    EXPECT_EQ(report.succeeded, symbols.size() - 2);
+    EXPECT_EQ(report.newBars, 2 * (symbols.size() - 2));
+    // 除跳过的一个外每个标的恰好请求一次，重试的那个多一次；请求计数跨线程汇总正确
+    EXPECT_EQ(report.requests, (symbols.size() - 1) + 1);
+    EXPECT_EQ(fetched.size(), report.requests);
+    for (std::size_t i = 0; i < symbols.size(); ++i) {
+        if (i == 5 || i == 7) continue;
+        EXPECT_EQ(sync.highWaterMark(symbols[i]), 20240103) << symbols[i];
+    }
+}
+
+TEST_F(MarketDataSyncTest, RateLimitSpacesRequestsOnFakeClock)
+{
+    MarketDataCache cache(dir_.string());
+    FakeClock clock;
+    std::vector<double> callTimes;
+    auto fetcher = [&](const std::string&, const DateRange&, const std::string&) {
+        callTimes.push_back(clock.seconds());
+        return FetchResult{};
+    };
+    SyncOptions options = fastOptions();
+    options.requestsPerSecond = 10.0;
+    options.burst = 3.0;
+    options.clock = clock.clock();
+    MarketDataSync sync(cache, fetcher, options);
+    std::vector<std::string> symbols;
+    for (int i = 0; i < 13; ++i) symbols.push_back("S" + std::to_string(i));
+    sync.sync(symbols, 20240110, 20240101);
+
+    ASSERT_EQ(callTimes.size(), 13u);
+    // 前 burst 个请求不等待，之后每 0.1 秒一个
+    for (std::size_t i = 0; i < 3; ++i) EXPECT_DOUBLE_EQ(callTimes[i], 0.0);
+    for (std::size_t i = 3; i < callTimes.size(); ++i) {
+        EXPECT_NEAR(callTimes[i] - callTimes[i - 1], 0.1, 1e-6) << "request " << i;
+    }
+    EXPECT_NEAR(clock.seconds(), 1.0, 1e-6);
+}
+
+TEST_F(MarketDataSyncTest, RequestsExportLatencyAndOutcome)
+{
+    auto& registry = foundation::metrics::MetricsRegistry::instance();
+    auto& ok = registry.counter("market_sync_requests_total", {{"result", "ok"}});
+    auto& retryable = registry.counter("market_sync_requests_total", {{"result", "retryable_error"}});
+    foundation::utils::LatencyHistogram latency;
+    registry.histogram("market_sync_request_latency_ns").snapshot(latency);
+    const auto okBefore = ok.value();
+    const auto retryableBefore = retryable.value();
+    const auto latencyBefore = latency.count();
+
+    MarketDataCache cache(dir_.string());
+    MockFetcher mock;
+    mock.script.push_back([](const DateRange&) -> FetchResult { throw FetchError("timeout"); });
+    mock.script.push_back([](const DateRange&) {
+        FetchResult r;
+        r.bars = makeBars({20240102});
+        return r;
+    });
+    MarketDataSync sync(cache, mock.fetcher(), fastOptions());
+    sync.sync({"600000.SH"}, 20240110, 20240101);
+
+    EXPECT_EQ(ok.value() - okBefore, 1u);
+    EXPECT_EQ(retryable.value() - retryableBefore, 1u);
+    registry.histogram("market_sync_request_latency_ns").snapshot(latency);
+    EXPECT_EQ(latency.count() - latencyBefore, 2u);
+}
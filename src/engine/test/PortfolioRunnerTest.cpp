@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+#include "PortfolioRunner.h"
+
+using namespace domain::strategies;
+
+namespace {
+
+class ScriptedStrategy : public IPortfolioStrategy {
+public:
+    explicit ScriptedStrategy(std::function<void(StrategyContext&)> onBar) : onBar_(std::move(onBar)) {}
+    std::string name() const override { return "scripted"; }
+    void onBar(StrategyContext& ctx) override { onBar_(ctx); }
+
+private:
+    std::function<void(StrategyContext&)> onBar_;
+};
+
+// 申请一个共享指标，每根 bar 记录其值
+class IndicatorReader : public IPortfolioStrategy {
+public:
+    IndicatorReader(SharedIndicatorKind kind, std::size_t period) : kind_(kind), period_(period) {}
+    std::string name() const override { return "reader"; }
+    void onStart(StrategySetup& setup) override {
+        handle_ = setup.indicator(0, kind_, period_);
+        values.clear();
+    }
+    void onBar(StrategyContext& ctx) override { values.push_back(ctx.value(handle_)); }
+
+    std::vector<double> values;
+
+private:
+    SharedIndicatorKind kind_;
+    std::size_t period_;
+    IndicatorHandle handle_;
+};
+
+MarketFrame makeFrame(std::vector<double> closes)
+{
+    MarketFrame f;
+    f.symbols = {"600000.SH"};
+    for (std::size_t t = 0; t < closes.size(); ++t) f.dates.push_back(static_cast<std::int32_t>(20240102 + t));
+    f.close = std::move(closes);
+    return f;
+}
+
+// 冲击成本随净额线性增长：每 100 股加价 1%
+class ImpactBroker : public IBrokerSimulator {
+public:
+    double fillPrice(std::size_t, double netQuantity, double refPrice) override {
+        return refPrice * (1.0 + 0.01 * std::fabs(netQuantity) / 100.0 * (netQuantity > 0.0 ? 1.0 : -1.0));
+    }
+    double commission(double notional) const override { return notional > 0.0 ? 5.0 : 0.0; }
+};
+
+} // namespace
+
+TEST(PortfolioRunnerTest, SizeDependentCostNeverDrivesCashNegative)
+{
+    // 三个策略同一根 bar 全仓买同一只股票：单笔估价时每笔都付得起，
+    // 合并后净额更大、冲击价更高，结算时必须缩量而不是把现金扣成负数
+    PortfolioRunner runner(30000.0, std::make_unique<ImpactBroker>());
+    std::vector<double> cash(3, -1.0);
+    for (std::size_t i = 0; i < 3; ++i) {
+        runner.addStrategy(std::make_shared<ScriptedStrategy>([&cash, i](StrategyContext& ctx) {
+            if (ctx.barIndex() == 0) ctx.order(0, 1e9);
+            else cash[i] = ctx.cash();
+        }));
+    }
+    const auto report = runner.run(makeFrame({10.0, 10.0}));
+    ASSERT_GT(report.trades->size(), 0u);
+    double bought = 0.0;
+    for (std::size_t r = 0; r < report.trades->size(); ++r) bought += report.trades->row(r).quantity;
+    EXPECT_GT(bought, 0.0);
+    for (double c : cash) EXPECT_GE(c, 0.0);
+    EXPECT_GE(report.equityCurve.front(), 0.0);
+}
+
+TEST(PortfolioRunnerTest, BuyReservationCoversSlippageAndCommission)
+{
+    // 100 基点滑点，万三佣金，最低 5 元；全仓买入后现金不能为负
+    PortfolioRunner runner(10000.0, std::make_unique<SimpleBrokerSimulator>(100.0, 0.0003, 5.0));
+    double cashAfter = -1.0;
+    runner.addStrategy(std::make_shared<ScriptedStrategy>([&](StrategyContext& ctx) {
+        if (ctx.barIndex() == 0) ctx.order(0, 1e9);
+        else cashAfter = ctx.cash();
+    }));
+    const auto report = runner.run(makeFrame({10.0, 10.0}));
+    ASSERT_EQ(report.trades->size(), 1u);
+    EXPECT_GE(cashAfter, 0.0);
+    // 每股 10.1 元：989 股 = 9988.9 + 5 元佣金 <= 10000
+    EXPECT_DOUBLE_EQ(report.trades->row(0).quantity, 989.0);
+    EXPECT_DOUBLE_EQ(report.trades->row(0).price, 10.1);
+}
+
+TEST(PortfolioRunnerTest, NettedSlippageOnlyHitsTheNetSide)
+{
+    PortfolioRunner runner(2e6, std::make_unique<SimpleBrokerSimulator>(100.0, 0.0, 0.0));
+    runner.addStrategy(std::make_shared<ScriptedStrategy>([](StrategyContext& ctx) {
+        if (ctx.barIndex() == 1) ctx.order(0, 300.0);
+    }));
+    runner.addStrategy(std::make_shared<ScriptedStrategy>([](StrategyContext& ctx) {
+        if (ctx.barIndex() == 0) ctx.order(0, 100.0);
+        if (ctx.barIndex() == 1) ctx.order(0, -100.0);
+    }));
+    const auto report = runner.run(makeFrame({10.0, 20.0}));
+    const TradeLog& log = *report.trades;
+    ASSERT_EQ(log.size(), 3u);
+    // 第二根 bar：净买 200 股按 20.2 成交，内部对冲的 100 股按 20 成交
+    const auto buy = log.row(1);
+    const auto sell = log.row(2);
+    ASSERT_TRUE(buy.buy());
+    ASSERT_FALSE(sell.buy());
+    EXPECT_DOUBLE_EQ(sell.price, 20.0);
+    EXPECT_DOUBLE_EQ(buy.price, (100.0 * 20.0 + 200.0 * 20.2) / 300.0);
+    EXPECT_DOUBLE_EQ(report.netTraded, 100.0 + 200.0);
+    EXPECT_DOUBLE_EQ(report.grossTraded, 100.0 + 400.0);
+}
+
+TEST(PortfolioRunnerTest, StrategiesShareIndicatorInstances)
+{
+    PortfolioRunner runner(1e6);
+    auto a = std::make_shared<IndicatorReader>(SharedIndicatorKind::Sma, 2);
+    auto b = std::make_shared<IndicatorReader>(SharedIndicatorKind::Sma, 2);
+    auto c = std::make_shared<IndicatorReader>(SharedIndicatorKind::Ema, 2);
+    runner.addStrategy(a);
+    runner.addStrategy(b);
+    runner.addStrategy(c);
+
+    const double nan = std::nan("");
+    for (int pass = 0; pass < 2; ++pass) {   // 第二次 run 从头预热，不沿用上次的状态
+        const auto report = runner.run(makeFrame({1.0, 3.0, nan, 5.0}));
+        EXPECT_EQ(report.indicatorRequests, 3u);
+        EXPECT_EQ(report.sharedIndicators, 2u);
+        ASSERT_EQ(a->values.size(), 4u);
+        EXPECT_TRUE(std::isnan(a->values[0]));
+        EXPECT_DOUBLE_EQ(a->values[1], 2.0);
+        EXPECT_DOUBLE_EQ(a->values[2], 2.0);   // 停牌保持上一个值
+        EXPECT_DOUBLE_EQ(a->values[3], 4.0);
+        for (std::size_t t = 1; t < 4; ++t) EXPECT_EQ(a->values[t], b->values[t]);
+        EXPECT_DOUBLE_EQ(c->values[1], 7.0 / 3.0);   // alpha = 2/3，以首值为种子
+        EXPECT_NEAR(c->values[3], 37.0 / 9.0, 1e-12);
+    }
+}
+
+TEST(PortfolioRunnerTest, SellCannotUseSameBarBuysThatSettleMayTrim)
+{
+    // 第一个策略同一根 bar 先全仓买再卖出同样数量，按自己的买量估价预留资金；
+    // 后面五个策略全仓买入推高净额冲击价，第一个策略的买单在结算时被缩量。
+    // 卖单只能按已成交持仓（0）截断，否则会卖出比实际买到的更多，变成卖空
+    PortfolioRunner runner(6000.0, std::make_unique<ImpactBroker>());
+    double positionAfter = -1.0;
+    runner.addStrategy(std::make_shared<ScriptedStrategy>([&](StrategyContext& ctx) {
+        if (ctx.barIndex() == 0) {
+            ctx.order(0, 100.0);
+            ctx.order(0, -100.0);
+        } else {
+            positionAfter = ctx.position(0);
+        }
+    }));
+    for (int i = 0; i < 5; ++i) {
+        runner.addStrategy(std::make_shared<ScriptedStrategy>([](StrategyContext& ctx) {
+            if (ctx.barIndex() == 0) ctx.order(0, 1e9);
+        }));
+    }
+    const auto report = runner.run(makeFrame({10.0, 10.0}));
+    EXPECT_GE(positionAfter, 0.0);
+    for (std::size_t r = 0; r < report.trades->size(); ++r) EXPECT_TRUE(report.trades->row(r).buy());
+}
+
+TEST(PortfolioRunnerTest, OutOfRangeSymbolThrowsEverywhere)
+{
+    PortfolioRunner runner(1000.0, std::make_unique<SimpleBrokerSimulator>(0.0, 0.0, 0.0));
+    int thrown = 0;
+    runner.addStrategy(std::make_shared<ScriptedStrategy>([&](StrategyContext& ctx) {
+        if (ctx.barIndex() != 0) return;
+        const std::size_t bad = ctx.symbolCount();
+        try { ctx.price(bad); } catch (const std::out_of_range&) { ++thrown; }
+        try { ctx.position(bad); } catch (const std::out_of_range&) { ++thrown; }
+        try { ctx.order(bad, 100.0); } catch (const std::out_of_range&) { ++thrown; }
+        try { ctx.orderTarget(bad, 100.0); } catch (const std::out_of_range&) { ++thrown; }
+    }));
+    runner.run(makeFrame({10.0, 10.0}));
+    EXPECT_EQ(thrown, 4);
+}
+
+TEST(PortfolioRunnerTest, UnknownIndicatorHandleThrows)
+{
+    PortfolioRunner runner(1000.0, std::make_unique<SimpleBrokerSimulator>(0.0, 0.0, 0.0));
+    int thrown = 0;
+    double invalid = 0.0;
+    runner.addStrategy(std::make_shared<ScriptedStrategy>([&](StrategyContext& ctx) {
+        if (ctx.barIndex() != 0) return;
+        invalid = ctx.value(IndicatorHandle{});
+        try { ctx.value(IndicatorHandle{7}); } catch (const std::out_of_range&) { ++thrown; }
+    }));
+    runner.run(makeFrame({10.0, 10.0}));
+    EXPECT_TRUE(std::isnan(invalid));
+    EXPECT_EQ(thrown, 1);
+}
+
+TEST(PortfolioRunnerTest, SellCommissionAboveProceedsNeverDrivesCashNegative)
+{
+    // 最低佣金 5 元、无滑点。A 全仓买入后现金为 0，B 留有余钱（分两根 bar 买，佣金不分摊）；
+    // 股价跌到 0.02 后两者同一根 bar 清仓：
+    // 卖出所得不够付佣金，A 兜不住倒贴的部分，卖单被撤；B 的空闲现金够，照常成交
+    PortfolioRunner runner(200.0, std::make_unique<SimpleBrokerSimulator>(0.0, 0.0003, 5.0));
+    std::vector<double> cash(2, -1.0);
+    std::vector<double> position(2, -1.0);
+    const double buys[] = {1e9, 50.0};
+    const std::size_t buyBar[] = {1, 0};
+    for (std::size_t i = 0; i < 2; ++i) {
+        runner.addStrategy(std::make_shared<ScriptedStrategy>([&, i](StrategyContext& ctx) {
+            if (ctx.barIndex() == buyBar[i]) ctx.order(0, buys[i]);
+            else if (ctx.barIndex() == 2) ctx.orderTarget(0, 0.0);
+            cash[i] = ctx.cash();
+            position[i] = ctx.position(0);
+        }));
+    }
+    runner.run(makeFrame({1.0, 1.0, 0.02, 0.02}));
+    EXPECT_GE(cash[0], 0.0);
+    EXPECT_DOUBLE_EQ(position[0], 95.0);
+    // B：100 - 50 - 5 = 45，卖出 50 * 0.02 = 1，再付 5 元佣金
+    EXPECT_DOUBLE_EQ(cash[1], 41.0);
+    EXPECT_DOUBLE_EQ(position[1], 0.0);
+}
+
+namespace {
+
+// 回测级容器放在策略成员里；rebuild 为 false 时故意沿用上一次 run 的容器
+class ArenaHistoryStrategy : public IPortfolioStrategy {
+public:
+    explicit ArenaHistoryStrategy(bool rebuild) : rebuild_(rebuild) {}
+    std::string name() const override { return "arena_history"; }
+    void onStart(StrategySetup& setup) override {
+        if (rebuild_ || !history_) history_ = std::make_unique<std::pmr::vector<double>>(setup.runArena());
+        else history_->clear();
+    }
+    void onBar(StrategyContext& ctx) override { history_->push_back(ctx.price(0)); }
+
+    std::unique_ptr<std::pmr::vector<double>> history_;
+
+private:
+    bool rebuild_;
+};
+
+} // namespace
+
+TEST(PortfolioRunnerTest, StaleRunArenaContainerFailsFast)
+{
+    const MarketFrame frame = makeFrame({10.0, 11.0, 12.0, 13.0});
+
+    PortfolioRunner good(1000.0, std::make_unique<SimpleBrokerSimulator>(0.0, 0.0, 0.0));
+    auto rebuilt = std::make_shared<ArenaHistoryStrategy>(true);
+    good.addStrategy(rebuilt);
+    good.run(frame);
+    good.run(frame);
+    ASSERT_EQ(rebuilt->history_->size(), 4u);
+    EXPECT_DOUBLE_EQ(rebuilt->history_->back(), 13.0);
+
+    // 第二次 run 的 bar 更多，旧容器扩容时向已作废的资源申请内存，立即失败
+    PortfolioRunner bad(1000.0, std::make_unique<SimpleBrokerSimulator>(0.0, 0.0, 0.0));
+    auto stale = std::make_shared<ArenaHistoryStrategy>(false);
+    bad.addStrategy(stale);
+    bad.run(frame);
+    EXPECT_THROW(bad.run(makeFrame({10.0, 11.0, 12.0, 13.0, 14.0, 15.0})), std::logic_error);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PriceAdjuster.h"
+
+using namespace domain::data;
+
+TEST(PriceAdjusterTest, ForwardAndBackwardAdjustment)
+{
+    PriceAdjuster adj;
+    adj.addFactor("600000.SH", 20230103, 2.0);
+    const std::vector<std::int32_t> dates{20230101, 20230102, 20230103, 20230104};
+    const std::vector<double> prices{10.0, 10.0, 5.0, 5.0};
+
+    const auto fwd = adj.adjusted("600000.SH", AdjustMode::Forward, 0, dates.data(), prices.data(), dates.size());
+    EXPECT_DOUBLE_EQ((*fwd)[0], 5.0);
+    EXPECT_DOUBLE_EQ((*fwd)[3], 5.0);
+    const auto bwd = adj.adjusted("600000.SH", AdjustMode::Backward, 0, dates.data(), prices.data(), dates.size());
+    EXPECT_DOUBLE_EQ((*bwd)[0], 10.0);
+    EXPECT_DOUBLE_EQ((*bwd)[3], 10.0);
+}
+
+// 因子 = 前收盘 / 除权参考价，参考价 = (前收盘 - 派息 + 配股价 * 配股数) / (1 + 送转 + 配股数)
+TEST(PriceAdjusterTest, CorporateActionFactors)
+{
+    auto factorOf = [](const CorporateAction& action, double prevClose) {
+        AdjustmentFactorTable table;
+        table.addAction(action, prevClose);
+        return table.latest();
+    };
+
+    // 10 派 5 元：参考价 10 - 0.5 = 9.5
+    CorporateAction dividend;
+    dividend.exDate = 20230601;
+    dividend.cashDividend = 0.5;
+    EXPECT_DOUBLE_EQ(factorOf(dividend, 10.0), 10.0 / 9.5);
+
+    // 10 送 5：参考价 20 / 1.5
+    CorporateAction bonus;
+    bonus.exDate = 20230601;
+    bonus.bonusShares = 0.5;
+    EXPECT_DOUBLE_EQ(factorOf(bonus, 20.0), 1.5);
+
+    // 10 配 3，配股价 8：参考价 (12 + 2.4) / 1.3，因子 15.6 / 14.4
+    CorporateAction rights;
+    rights.exDate = 20230601;
+    rights.rightsShares = 0.3;
+    rights.rightsPrice = 8.0;
+    EXPECT_DOUBLE_EQ(factorOf(rights, 12.0), 13.0 / 12.0);
+
+    // 同日 10 派 5 元再送 5：参考价 (10.5 - 0.5) / 1.5，因子 1.575
+    CorporateAction combined;
+    combined.exDate = 20230601;
+    combined.cashDividend = 0.5;
+    combined.bonusShares = 0.5;
+    EXPECT_DOUBLE_EQ(factorOf(combined, 10.5), 1.575);
+
+    // 派息不低于前收盘时参考价非正
+    dividend.cashDividend = 10.0;
+    EXPECT_THROW(factorOf(dividend, 10.0), std::invalid_argument);
+}
+
+TEST(PriceAdjusterTest, FactorsAccumulateInDateOrder)
+{
+    AdjustmentFactorTable table;
+    CorporateAction bonus;
+    bonus.exDate = 20230601;
+    bonus.bonusShares = 0.5;
+    table.addAction(bonus, 20.0);
+    table.addFactor(20240601, 10.0 / 9.5);
+
+    EXPECT_DOUBLE_EQ(table.cumulativeAt(20230531), 1.0);
+    EXPECT_DOUBLE_EQ(table.cumulativeAt(20230601), 1.5);
+    EXPECT_DOUBLE_EQ(table.cumulativeAt(20240531), 1.5);
+    EXPECT_DOUBLE_EQ(table.cumulativeAt(20240601), 1.5 * 10.0 / 9.5);
+
+    EXPECT_THROW(table.addFactor(20240101, 1.1), std::invalid_argument);
+}
+
+TEST(PriceAdjusterTest, SameExDateIsRejected)
+{
+    PriceAdjuster adj;
+    adj.addFactor("A", 20230103, 2.0);
+    // 重复导入同一天的因子不能叠加成 4 倍
+    EXPECT_THROW(adj.addFactor("A", 20230103, 2.0), std::invalid_argument);
+
+    CorporateAction dividend;
+    dividend.exDate = 20230103;
+    dividend.cashDividend = 0.5;
+    EXPECT_THROW(adj.addAction("A", dividend, 10.0), std::invalid_argument);
+
+    const std::vector<std::int32_t> dates{20230102, 20230103};
+    const std::vector<double> prices{10.0, 5.0};
+    const auto bwd = adj.adjusted("A", AdjustMode::Backward, 0, dates.data(), prices.data(), dates.size());
+    EXPECT_DOUBLE_EQ((*bwd)[1], 10.0);
+}
+
+TEST(PriceAdjusterTest, CacheKeyedOnDataVersionAndTail)
+{
+    PriceAdjuster adj;
+    adj.addFactor("A", 20230102, 2.0);
+    std::vector<std::int32_t> dates{20230101, 20230102, 20230103};
+    std::vector<double> prices{10.0, 5.0, 6.0};
+
+    const auto a = adj.adjusted("A", AdjustMode::Backward, 1, dates.data(), prices.data(), 3);
+    const auto b = adj.adjusted("A", AdjustMode::Backward, 1, dates.data(), prices.data(), 3);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(adj.cacheHits(), 1u);
+
+    // 原地修正数据时调用方换版本号，同一地址也不会命中旧结果
+    prices[1] = 7.0;
+    const auto c = adj.adjusted("A", AdjustMode::Backward, 2, dates.data(), prices.data(), 3);
+    EXPECT_NE(a, c);
+    EXPECT_DOUBLE_EQ((*c)[1], 14.0);
+    EXPECT_EQ(adj.cacheMisses(), 2u);
+
+    // 尾部追加 bar：版本号不变，条数与末日期变化即失效
+    dates.push_back(20230104);
+    prices.push_back(8.0);
+    const auto e = adj.adjusted("A", AdjustMode::Backward, 2, dates.data(), prices.data(), 4);
+    EXPECT_DOUBLE_EQ((*e)[3], 16.0);
+    EXPECT_EQ(adj.cacheMisses(), 3u);
+
+    // 因子表变化同样失效
+    adj.addFactor("A", 20230103, 1.5);
+    const auto d = adj.adjusted("A", AdjustMode::Backward, 2, dates.data(), prices.data(), 4);
+    EXPECT_DOUBLE_EQ((*d)[2], 18.0);
+    EXPECT_EQ(adj.cacheMisses(), 4u);
+}
+
+TEST(PriceAdjusterTest, CacheIsBoundedByLru)
+{
+    PriceAdjuster adj(2);
+    const std::vector<std::int32_t> dates{20230101};
+    const std::vector<double> prices{1.0};
+    auto get = [&](const std::string& s) {
+        return adj.adjusted(s, AdjustMode::Forward, 0, dates.data(), prices.data(), 1);
+    };
+
+    get("A");
+    get("B");
+    get("A");          // A 变为最近使用
+    get("C");          // 淘汰 B
+    EXPECT_EQ(adj.cacheSize(), 2u);
+    const auto misses = adj.cacheMisses();
+    get("A");
+    EXPECT_EQ(adj.cacheMisses(), misses);
+    get("B");
+    EXPECT_EQ(adj.cacheMisses(), misses + 1);
+    EXPECT_EQ(adj.cacheSize(), 2u);
+
+    adj.invalidate("A");
+    adj.clearCache();
+    EXPECT_EQ(adj.cacheSize(), 0u);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "QuoteStream.h"
+
+using namespace engine;
+
+namespace {
+
+std::string sinaLine(const std::string& code, double price)
+{
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "var hq_str_%s=\"SIM,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,100,1000,"
+                  "100,%.2f,0,0,0,0,0,0,0,0,100,%.2f,0,0,0,0,0,0,0,0,2024-01-05,09:30:00,00\";\n",
+                  code.c_str(), price, price, price, price, price, price, price, price, price);
+    return buf;
+}
+
+// 在 start() 里同步把给定报文全部交给 sink
+class ScriptedSource : public IQuoteSource {
+public:
+    explicit ScriptedSource(std::vector<std::string> messages) : messages_(std::move(messages)) {}
+    std::string name() const override { return "scripted"; }
+    void start(RawQuoteSink sink) override {
+        for (auto& m : messages_) sink(RawQuote{m, 0});
+    }
+    void stop() override {}
+
+private:
+    std::vector<std::string> messages_;
+};
+
+} // namespace
+
+TEST(QuoteStreamTest, SymbolRegistryLooksUpAndBoundsCapacity)
+{
+    SymbolRegistry reg(3);
+    EXPECT_EQ(reg.preregister({"sh600000", "sz000001"}), 2u);
+    std::uint32_t id = 99;
+    ASSERT_TRUE(reg.find("sz000001", id));
+    EXPECT_EQ(id, 1u);
+    EXPECT_FALSE(reg.find("sh600001", id));
+    EXPECT_EQ(reg.idOf("sh600001"), 2u);
+    EXPECT_EQ(reg.idOf("sh600000"), 0u);
+    EXPECT_EQ(reg.codeOf(2), "sh600001");
+    EXPECT_EQ(reg.codeOf(3), "");
+    EXPECT_THROW(reg.idOf("sh688001"), std::length_error);
+    EXPECT_EQ(reg.size(), 3u);
+}
+
+TEST(QuoteStreamTest, SymbolRegistryConcurrentRegistrationIsConsistent)
+{
+    SymbolRegistry reg(256);
+    std::vector<std::vector<std::uint32_t>> seen(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < seen.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 200; ++i) seen[t].push_back(reg.idOf("s" + std::to_string(i)));
+        });
+    }
+    for (auto& th : threads) th.join();
+    EXPECT_EQ(reg.size(), 200u);
+    for (std::size_t t = 1; t < seen.size(); ++t) EXPECT_EQ(seen[t], seen[0]);
+    for (int i = 0; i < 200; ++i) EXPECT_EQ(reg.codeOf(seen[0][i]), "s" + std::to_string(i));
+}
+
+TEST(QuoteStreamTest, RegistryOverflowCountsAsDecodeError)
+{
+    std::string overflow = sinaLine("sh600002", 10.0) + sinaLine("sh600003", 11.0);
+    auto source = std::make_unique<ScriptedSource>(
+        std::vector<std::string>{sinaLine("sh600000", 9.0) + sinaLine("sh600001", 9.5), overflow});
+    std::vector<LiveTick> ticks;
+    QuotePipeline::Options options;
+    options.maxSymbols = 2;
+    options.ownConsumerThread = false;
+    QuotePipeline pipeline(std::move(source), std::make_unique<SinaQuoteDecoder>(),
+                           [&](const LiveTick& t) { ticks.push_back(t); }, options);
+    pipeline.start();
+    pipeline.drain();
+    pipeline.stop();
+    const auto s = pipeline.stats();
+    EXPECT_EQ(s.messages, 2u);
+    EXPECT_EQ(s.decoded, 2u);
+    EXPECT_EQ(s.decodeErrors, 1u);
+    EXPECT_EQ(ticks.size(), 2u);
+}
+
+TEST(QuoteStreamTest, ConflatingQueueNeverLosesTheNewestQuote)
+{
+    // 发布方每发两笔就等消费方追上最新一笔；如果最新报价被丢，消费方永远等不到它
+    ConflatingQuoteQueue queue(1);
+    constexpr int kRounds = 2000;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    std::atomic<int> consumed{-1};
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        for (int i = 0; i < kRounds && !done.load(); ++i) {
+            LiveTick t;
+            t.last = i;
+            queue.publish(t);
+            if (i % 2 == 0) continue;   // 隔一笔制造合并
+            while (consumed.load(std::memory_order_acquire) < i && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    LiveTick out;
+    double lastSeen = -1.0;
+    while (lastSeen < kRounds - 1 && std::chrono::steady_clock::now() < deadline) {
+        if (!queue.poll(out)) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_GT(out.last, lastSeen);
+        lastSeen = out.last;
+        consumed.store(static_cast<int>(out.last), std::memory_order_release);
+    }
+    done.store(true);
+    producer.join();
+    EXPECT_EQ(lastSeen, kRounds - 1);
+    EXPECT_EQ(queue.published(), static_cast<std::uint64_t>(kRounds));
+}
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "IndicatorCache.h"
+#include "SignalExpression.h"
+#include "StaticPipeline.h"
+
+using namespace domain::signals;
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+using Op = SignalExpression::Op;
+
+const std::vector<std::string> kFields{"close", "volume"};
+
+// 编译失败时返回异常消息，成功返回空串
+std::string compileError(const std::string& text)
+{
+    try {
+        SignalExpression::compile(text, kFields, {{"threshold", 10.0}});
+    } catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+    return {};
+}
+
+std::size_t countOps(const SignalExpression& e, Op op)
+{
+    std::size_t n = 0;
+    for (const auto& in : e.plan()) n += in.op == op;
+    return n;
+}
+
+// 逐点求单 bar 表达式的值（只用 close 字段）
+double eval1(const std::string& text, double close)
+{
+    const auto e = SignalExpression::compile(text, kFields);
+    const double volume = 0.0;
+    const double* cols[] = {&close, &volume};
+    double out = kNaN;
+    e.evaluate(cols, 1, &out);
+    return out;
+}
+
+bool sameValue(double a, double b)
+{
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+bool closeValue(double a, double b)
+{
+    return (std::isnan(a) && std::isnan(b)) || std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+
+// 随机游走行情，约 5% 的 bar 缺数据
+void makeBars(std::size_t n, std::uint64_t seed, std::vector<double>& close, std::vector<double>& volume)
+{
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> z(0.0, 0.3);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    close.resize(n);
+    volume.resize(n);
+    double p = 10.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        p += z(rng);
+        close[i] = u(rng) < 0.05 ? kNaN : p;
+        volume[i] = 1000.0 + 500.0 * u(rng);
+    }
+}
+
+} // namespace
+
+TEST(SignalExpressionTest, ParseErrorsReportPosition)
+{
+    EXPECT_NE(compileError("close >").find("expected expression at 7"), std::string::npos);
+    EXPECT_NE(compileError("close $ 1").find("unexpected character '$' at 6"), std::string::npos);
+    EXPECT_NE(compileError("close > foo").find("unknown identifier 'foo' at 11"), std::string::npos);
+    EXPECT_NE(compileError("bar(close)").find("unknown function 'bar'"), std::string::npos);
+    EXPECT_NE(compileError("(close > 1").find("expected ')' at 10"), std::string::npos);
+    EXPECT_NE(compileError("sma(close 5)").find("expected ',' at 10"), std::string::npos);
+    EXPECT_NE(compileError("sma(close, 0)").find("positive integer"), std::string::npos);
+    EXPECT_NE(compileError("sma(close, volume)").find("must be a constant"), std::string::npos);
+    EXPECT_NE(compileError("close > 1 )").find("unexpected ')' at 10"), std::string::npos);
+    EXPECT_TRUE(compileError("sma(close, 5) > threshold").empty());
+}
+
+TEST(SignalExpressionTest, RejectsExcessiveNesting)
+{
+    const std::size_t ok = SignalExpression::kMaxDepth / 2;
+    EXPECT_TRUE(compileError(std::string(ok, '(') + "close" + std::string(ok, ')')).empty());
+
+    // 深度远超限制（足以在无保护时打爆栈）也只是普通的语法错误
+    const std::size_t deep = 100000;
+    EXPECT_NE(compileError(std::string(deep, '(') + "close" + std::string(deep, ')')).find("nested too deeply"),
+              std::string::npos);
+    EXPECT_NE(compileError(std::string(deep, '-') + "close").find("nested too deeply"), std::string::npos);
+    std::string calls;
+    for (std::size_t i = 0; i < deep; ++i) calls += "abs(";
+    EXPECT_NE(compileError(calls + "close").find("nested too deeply"), std::string::npos);
+}
+
+TEST(SignalExpressionTest, OperatorPrecedenceAndAssociativity)
+{
+    EXPECT_DOUBLE_EQ(eval1("close - 1 - 1", 5.0), 3.0);        // 左结合
+    EXPECT_DOUBLE_EQ(eval1("close / 2 / 5", 20.0), 2.0);
+    EXPECT_DOUBLE_EQ(eval1("close + 2 * 3", 1.0), 7.0);        // * 高于 +
+    EXPECT_DOUBLE_EQ(eval1("(close + 2) * 3", 1.0), 9.0);
+    EXPECT_DOUBLE_EQ(eval1("-close * 2", 3.0), -6.0);          // 一元最高
+    EXPECT_DOUBLE_EQ(eval1("close > 1 + 2", 3.5), 1.0);        // 算术高于比较
+    // & 高于 |：1 | (0 & 0) = 1，若按 (1 | 0) & 0 则为 0
+    EXPECT_DOUBLE_EQ(eval1("close > 0 | close > 5 & close > 6", 1.0), 1.0);
+    EXPECT_DOUBLE_EQ(eval1("!close > 0", 2.0), 0.0);           // (!close) > 0
+    EXPECT_DOUBLE_EQ(eval1("close >= 2 && close != 3", 2.0), 1.0);
+    // 比较/逻辑遇到 NaN 为 0，算术传播 NaN
+    EXPECT_DOUBLE_EQ(eval1("close != 1", kNaN), 0.0);
+    EXPECT_TRUE(std::isnan(eval1("close + 1", kNaN)));
+}
+
+TEST(SignalExpressionTest, FoldsConstants)
+{
+    const auto e = SignalExpression::compile("close > (1 + 2) * threshold - max(1, 4)", kFields, {{"threshold", 5.0}});
+    // 只剩 input、折叠后的常量 11 和比较
+    ASSERT_EQ(e.instructionCount(), 3u);
+    EXPECT_EQ(e.plan()[0].op, Op::Input);
+    EXPECT_EQ(e.plan()[1].op, Op::Const);
+    EXPECT_DOUBLE_EQ(e.plan()[1].value, 11.0);
+    EXPECT_EQ(e.plan()[2].op, Op::Gt);
+
+    const auto c = SignalExpression::compile("2 * 3 > 5", kFields);
+    ASSERT_EQ(c.instructionCount(), 1u);
+    EXPECT_DOUBLE_EQ(c.plan()[0].value, 1.0);
+}
+
+TEST(SignalExpressionTest, DeduplicatesCommonSubexpressions)
+{
+    const auto e = SignalExpression::compile(
+        "cross(sma(close, 5), sma(close, 20)) & sma(close, 5) > 0 & volume > sma(volume, 20) & sma(close, 20) > 0",
+        kFields);
+    EXPECT_EQ(countOps(e, Op::Sma), 3u);     // sma(close,5) / sma(close,20) / sma(volume,20)
+    EXPECT_EQ(countOps(e, Op::Input), 2u);
+    EXPECT_EQ(countOps(e, Op::Const), 1u);   // 0
+    EXPECT_EQ(countOps(e, Op::Cross), 1u);
+    EXPECT_EQ(e.warmup(), 20u);
+
+    // 窗口参数不同不是同一个子表达式
+    const auto f = SignalExpression::compile("sma(close, 5) > sma(close, 6)", kFields);
+    EXPECT_EQ(countOps(f, Op::Sma), 2u);
+}
+
+TEST(SignalExpressionTest, StreamingMatchesBatch)
+{
+    const std::vector<std::string> exprs{
+        "cross(sma(close, 5), ema(close, 12)) & volume > sma(volume, 10)",
+        "count(close > ref(close, 1), 5) >= 3",
+        "ref(crossunder(ema(close, 3), sma(close, 8)), 2) | abs(close - ref(close, 3)) > 0.5",
+        "min(close, sma(close, 4)) / max(close, 1) - close * 0.1",
+    };
+    std::vector<double> close;
+    std::vector<double> volume;
+    makeBars(600, 11, close, volume);
+    const double* cols[] = {close.data(), volume.data()};
+
+    for (const auto& text : exprs) {
+        SCOPED_TRACE(text);
+        const auto e = SignalExpression::compile(text, kFields);
+        std::vector<double> batch(close.size());
+        e.evaluate(cols, close.size(), batch.data());
+
+        SignalStream stream(e);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (std::size_t t = 0; t < close.size(); ++t) {
+                const double bar[] = {close[t], volume[t]};
+                const double v = stream.update(bar);
+                ASSERT_TRUE(sameValue(v, batch[t])) << "bar " << t << ": " << v << " vs " << batch[t];
+                EXPECT_EQ(stream.signal(), batch[t] != 0.0 && !std::isnan(batch[t]));
+            }
+            stream.reset();   // reset 后重放结果不变
+        }
+    }
+}
+
+TEST(SignalExpressionTest, EvaluateUniverseMatchesPerRow)
+{
+    const std::size_t rows = 6;
+    const std::size_t cols = 150;
+    const std::size_t stride = 160;
+    std::vector<double> close(rows * stride, 1e9);
+    std::vector<double> volume(rows * stride, 1e9);
+    std::vector<std::vector<double>> rowClose(rows);
+    std::vector<std::vector<double>> rowVolume(rows);
+    for (std::size_t r = 0; r < rows; ++r) {
+        makeBars(cols, 100 + r, rowClose[r], rowVolume[r]);
+        std::copy(rowClose[r].begin(), rowClose[r].end(), close.begin() + static_cast<std::ptrdiff_t>(r * stride));
+        std::copy(rowVolume[r].begin(), rowVolume[r].end(), volume.begin() + static_cast<std::ptrdiff_t>(r * stride));
+    }
+
+    const auto e = SignalExpression::compile("close > sma(close, 10) & volume > ref(volume, 1)", kFields);
+    const SignalBitset bits = e.evaluateUniverse(
+        {SeriesMatrix(close.data(), rows, cols, stride), SeriesMatrix(volume.data(), rows, cols, stride)});
+    ASSERT_EQ(bits.rows(), rows);
+    ASSERT_EQ(bits.cols(), cols);
+
+    std::vector<double> out(cols);
+    for (std::size_t r = 0; r < rows; ++r) {
+        const double* rowCols[] = {rowClose[r].data(), rowVolume[r].data()};
+        e.evaluate(rowCols, cols, out.data());
+        for (std::size_t t = 0; t < cols; ++t) {
+            ASSERT_EQ(bits.test(r, t), out[t] != 0.0 && !std::isnan(out[t])) << "row " << r << " col " << t;
+        }
+    }
+
+    EXPECT_THROW(e.evaluateUniverse({SeriesMatrix(close.data(), rows, cols, stride)}), std::invalid_argument);
+    EXPECT_THROW(e.evaluateUniverse({SeriesMatrix(close.data(), rows, cols, stride),
+                                     SeriesMatrix(volume.data(), rows - 1, cols, stride)}),
+                 std::invalid_argument);
+}
+
+TEST(SignalExpressionTest, WindowFunctionsFollowIndicatorCacheRules)
+{
+    // 预热期内夹着缺失 bar，之后也随机缺失：三条路径必须逐 bar 一致
+    std::vector<double> close, volume;
+    makeBars(400, 11, close, volume);
+    close[1] = close[2] = close[7] = kNaN;
+
+    for (const int period : {1, 5, 20}) {
+        const std::string n = std::to_string(period);
+        const auto smaExpr = SignalExpression::compile("sma(close, " + n + ")", kFields);
+        const auto emaExpr = SignalExpression::compile("ema(close, " + n + ")", kFields);
+        const double* cols[] = {close.data(), volume.data()};
+        std::vector<double> sma(close.size()), ema(close.size());
+        smaExpr.evaluate(cols, close.size(), sma.data());
+        emaExpr.evaluate(cols, close.size(), ema.data());
+
+        const auto p = static_cast<std::uint32_t>(period);
+        std::vector<double> cacheSma(close.size()), cacheEma(close.size());
+        domain::indicators::computeIndicator(domain::indicators::IndicatorType::Sma, p, 0.0, close.data(), close.size(), cacheSma.data());
+        domain::indicators::computeIndicator(domain::indicators::IndicatorType::Ema, p, 0.0, close.data(), close.size(), cacheEma.data());
+
+        domain::strategies::Sma pipeSma(static_cast<std::size_t>(period));
+        domain::strategies::Ema pipeEma(static_cast<std::size_t>(period));
+        SignalStream stream(smaExpr);
+        for (std::size_t t = 0; t < close.size(); ++t) {
+            const double bar[] = {close[t], volume[t]};
+            ASSERT_TRUE(sameValue(sma[t], stream.update(bar))) << "n=" << n << " bar " << t;
+            ASSERT_TRUE(closeValue(sma[t], cacheSma[t])) << "n=" << n << " bar " << t;
+            ASSERT_TRUE(closeValue(ema[t], cacheEma[t])) << "n=" << n << " bar " << t;
+            ASSERT_TRUE(closeValue(sma[t], pipeSma.update(close[t]))) << "n=" << n << " bar " << t;
+            ASSERT_TRUE(closeValue(ema[t], pipeEma.update(close[t]))) << "n=" << n << " bar " << t;
+        }
+    }
+}
+
+TEST(SignalExpressionTest, CountIsNaNUntilTheWindowFills)
+{
+    const auto e = SignalExpression::compile("count(close, 3)", kFields);
+    const std::vector<double> close{1.0, kNaN, 0.0, 1.0, 1.0, kNaN, 0.0};
+    const std::vector<double> volume(close.size(), 0.0);
+    const double* cols[] = {close.data(), volume.data()};
+    std::vector<double> out(close.size());
+    e.evaluate(cols, close.size(), out.data());
+
+    EXPECT_TRUE(std::isnan(out[0]));
+    EXPECT_TRUE(std::isnan(out[1]));   // 缺失 bar 不计入窗口
+    EXPECT_TRUE(std::isnan(out[2]));
+    EXPECT_DOUBLE_EQ(out[3], 2.0);     // 1, 0, 1
+    EXPECT_DOUBLE_EQ(out[4], 2.0);     // 0, 1, 1
+    EXPECT_DOUBLE_EQ(out[5], 2.0);     // 保持上一个值
+    EXPECT_DOUBLE_EQ(out[6], 2.0);     // 1, 1, 0
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "StaticPipeline.h"
+
+using namespace domain::strategies;
+
+TEST(StaticPipelineTest, RejectsZeroPeriod)
+{
+    EXPECT_THROW(Sma(0), std::invalid_argument);
+    EXPECT_THROW(Ema(0), std::invalid_argument);
+}
+
+TEST(StaticPipelineTest, SmaSkipsNaNInputs)
+{
+    Sma sma(3);
+    EXPECT_TRUE(std::isnan(sma.update(1.0)));
+    EXPECT_TRUE(std::isnan(sma.update(kPipelineNaN)));   // 预热期的缺失值不计数
+    EXPECT_TRUE(std::isnan(sma.update(2.0)));
+    EXPECT_DOUBLE_EQ(sma.update(3.0), 2.0);
+    EXPECT_DOUBLE_EQ(sma.update(kPipelineNaN), 2.0);       // 保持上一个值
+    EXPECT_DOUBLE_EQ(sma.update(4.0), 3.0);
+    // 之后的结果不受 NaN 影响
+    EXPECT_DOUBLE_EQ(sma.update(5.0), 4.0);
+    EXPECT_DOUBLE_EQ(sma.update(6.0), 5.0);
+}
+
+TEST(StaticPipelineTest, EmaSkipsNaNInputs)
+{
+    Ema ema(2);
+    EXPECT_TRUE(std::isnan(ema.update(kPipelineNaN)));
+    EXPECT_TRUE(std::isnan(ema.update(3.0)));
+    const double v = ema.update(6.0);
+    EXPECT_DOUBLE_EQ(v, 3.0 + 2.0 / 3.0 * 3.0);
+    EXPECT_DOUBLE_EQ(ema.update(kPipelineNaN), v);
+    EXPECT_FALSE(std::isnan(ema.update(6.0)));
+}
+
+namespace {
+
+struct TestBar {
+    double close;
+};
+
+// 与 IStrategy 动态链路同构的虚函数版本：指标 -> 信号 -> 仓位 各自一层虚调用
+class IIndicatorV {
+public:
+    virtual ~IIndicatorV() = default;
+    virtual double update(double x) = 0;
+    virtual bool ready() const = 0;
+};
+
+template <typename Ind>
+class IndicatorV : public IIndicatorV {
+public:
+    explicit IndicatorV(Ind ind) : ind_(std::move(ind)) {}
+    double update(double x) override { return ind_.update(x); }
+    bool ready() const override { return ind_.ready(); }
+
+private:
+    Ind ind_;
+};
+
+class CrossV {
+public:
+    CrossV(std::unique_ptr<IIndicatorV> f, std::unique_ptr<IIndicatorV> s) : fast_(std::move(f)), slow_(std::move(s)) {}
+
+    int update(double price) {
+        const double f = fast_->update(price);
+        const double s = slow_->update(price);
+        if (!fast_->ready() || !slow_->ready()) return 0;
+        if (std::isnan(price) || std::isnan(f) || std::isnan(s)) return 0;
+        const bool above = f > s;
+        const int signal = (hasPrev_ && above != prevAbove_) ? (above ? 1 : -1) : 0;
+        prevAbove_ = above;
+        hasPrev_ = true;
+        return signal;
+    }
+
+private:
+    std::unique_ptr<IIndicatorV> fast_;
+    std::unique_ptr<IIndicatorV> slow_;
+    bool prevAbove_ = false;
+    bool hasPrev_ = false;
+};
+
+// 随机游走收盘价，夹杂停牌（NaN）
+std::vector<TestBar> makeBars(std::size_t n)
+{
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> z(0.0, 0.02);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<TestBar> bars(n);
+    double p = 10.0;
+    for (auto& b : bars) {
+        p *= std::exp(z(rng));
+        b.close = u(rng) < 0.03 ? kPipelineNaN : p;
+    }
+    return bars;
+}
+
+} // namespace
+
+TEST(StaticPipelineTest, PipelineComposesPriceSignalAndSizing)
+{
+    auto p = makePipeline(RawPrice{}, CrossOver<Identity, Sma>(Identity{}, Sma(3)), FixedSize(100));
+    // Sma(3) 在第 3 根就绪：3 > 2 记录为在上方；1 < 2 下穿；5 > 3 上穿
+    const double prices[] = {1.0, 2.0, 3.0, 1.0, 5.0, 5.0};
+    const int expected[] = {0, 0, 0, -1, 1, 0};
+    for (std::size_t i = 0; i < 6; ++i) {
+        const PipelineDecision d = p.onBar(prices[i]);
+        EXPECT_EQ(d.direction, expected[i]) << "bar " << i;
+        EXPECT_DOUBLE_EQ(d.quantity, expected[i] * 100.0);
+        EXPECT_EQ(static_cast<bool>(d), expected[i] != 0);
+    }
+
+    // reset 后重新预热，不会拿旧状态产生信号
+    p.reset();
+    EXPECT_FALSE(p.onBar(1.0));
+    EXPECT_FALSE(p.onBar(2.0));
+    EXPECT_FALSE(p.onBar(3.0));
+    EXPECT_EQ(p.onBar(1.0).direction, -1);
+}
+
+TEST(StaticPipelineTest, IdentityNaNBarIsSkipped)
+{
+    // 停牌 bar 的价格为 NaN：不能当成"跌破均线"发卖出信号，恢复后也不能再发一次买入
+    auto p = makePipeline(RawPrice{}, CrossOver<Identity, Sma>(Identity{}, Sma(3)), FixedSize(100));
+    std::vector<PipelineDecision> d;
+    for (double price : {10.0, 11.0, 12.0, kPipelineNaN, 12.5}) d.push_back(p.onBar(price));
+    for (const auto& x : d) {
+        EXPECT_EQ(x.direction, 0);
+        EXPECT_FALSE(std::isnan(x.quantity));
+    }
+
+    auto band = makePipeline(RawPrice{}, Band<Identity>(Identity{}, 30.0, 70.0), FixedNotional(10000.0));
+    EXPECT_FALSE(band.onBar(50.0));
+    EXPECT_FALSE(band.onBar(kPipelineNaN));
+    const PipelineDecision buy = band.onBar(25.0);     // 与上一根有效值 50 比较，照常下穿
+    EXPECT_EQ(buy.direction, 1);
+    EXPECT_DOUBLE_EQ(buy.quantity, 400.0);
+    EXPECT_DOUBLE_EQ(FixedNotional(10000.0).size(1, kPipelineNaN), 0.0);
+}
+
+TEST(StaticPipelineTest, BandAllOfAndNotionalSizing)
+{
+    auto band = makePipeline(RawPrice{}, Band<Identity>(Identity{}, 30.0, 70.0), FixedNotional(10000.0));
+    EXPECT_FALSE(band.onBar(50.0));
+    const PipelineDecision buy = band.onBar(25.0);     // 下穿下轨买入
+    EXPECT_EQ(buy.direction, 1);
+    EXPECT_DOUBLE_EQ(buy.quantity, 400.0);             // 10000 / 25 = 400 股，整手
+    EXPECT_FALSE(band.onBar(50.0));
+    const PipelineDecision sell = band.onBar(80.0);    // 上穿上轨卖出
+    EXPECT_EQ(sell.direction, -1);
+    EXPECT_DOUBLE_EQ(sell.quantity, -100.0);           // 10000 / 80 = 125 -> 100 股
+
+    // 两个信号方向一致才成立；各自的状态都要推进
+    auto all = makePipeline(RawPrice{},
+                            AllOf<CrossOver<Identity, Sma>, CrossOver<Identity, Ema>>(
+                                CrossOver<Identity, Sma>(Identity{}, Sma(2)), CrossOver<Identity, Ema>(Identity{}, Ema(2))),
+                            FixedSize(1));
+    all.onBar(2.0);
+    all.onBar(1.0);
+    EXPECT_EQ(all.onBar(3.0).direction, 1);    // sma 2, ema 2.44：都上穿
+    EXPECT_EQ(all.onBar(3.5).direction, 0);    // 仍在两条线上方
+    EXPECT_EQ(all.onBar(1.0).direction, -1);   // sma 2.25, ema 1.72：都下穿
+    EXPECT_EQ(all.onBar(1.6).direction, 0);    // sma 1.3 上穿，ema 1.64 仍在下方：方向不一致
+}
+
+TEST(StaticPipelineTest, AdapterForwardsThroughVirtualInterface)
+{
+    const auto bars = makeBars(500);
+    auto direct = makePipeline(ClosePrice{}, CrossOver<Sma, Ema>(Sma(5), Ema(10)), FixedSize(100));
+    std::unique_ptr<IBarPipeline<TestBar>> dynamic =
+        makeDynamic<TestBar>(makePipeline(ClosePrice{}, CrossOver<Sma, Ema>(Sma(5), Ema(10)), FixedSize(100)));
+
+    int signals = 0;
+    for (const auto& b : bars) {
+        const PipelineDecision a = direct.onBar(b);
+        const PipelineDecision d = dynamic->onBar(b);
+        ASSERT_EQ(a.direction, d.direction);
+        ASSERT_EQ(a.quantity, d.quantity);
+        signals += a.direction != 0;
+    }
+    EXPECT_GT(signals, 0);
+
+    // reset 通过虚接口传到内部流水线
+    dynamic->reset();
+    auto& inner = static_cast<PipelineAdapter<TestBar, decltype(direct)>&>(*dynamic).pipeline();
+    direct.reset();
+    for (const auto& b : bars) ASSERT_EQ(inner.onBar(b).direction, direct.onBar(b).direction);
+}
+
+TEST(StaticPipelineTest, FusedMatchesVirtualDispatch)
+{
+    const auto bars = makeBars(5000);
+    struct Config {
+        std::size_t fast;
+        std::size_t slow;
+    };
+    for (const Config c : {Config{5, 20}, Config{1, 2}, Config{12, 26}}) {
+        SCOPED_TRACE(c.fast);
+        auto fused = makePipeline(ClosePrice{}, CrossOver<Sma, Ema>(Sma(c.fast), Ema(c.slow)), FixedNotional(50000.0));
+        CrossV virt(std::make_unique<IndicatorV<Sma>>(Sma(c.fast)), std::make_unique<IndicatorV<Ema>>(Ema(c.slow)));
+        const FixedNotional sizing(50000.0);
+
+        int signals = 0;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            const PipelineDecision a = fused.onBar(bars[i]);
+            const int d = virt.update(bars[i].close);
+            const double q = d == 0 ? 0.0 : sizing.size(d, bars[i].close);
+            ASSERT_EQ(a.direction, d) << "bar " << i;
+            ASSERT_EQ(a.quantity, q) << "bar " << i;
+            signals += d != 0;
+        }
+        EXPECT_GT(signals, 10);
+    }
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TradeLog.h"
+
+using namespace domain::strategies;
+
+namespace {
+
+// n 笔成交，第 i 笔价格为 base + i，买卖交替
+std::shared_ptr<const TradeLog> makeLog(std::size_t n, double base)
+{
+    auto log = std::make_shared<TradeLog>(std::vector<std::string>{"600000.SH", "000001.SZ"},
+                                          std::vector<std::string>{"momentum"});
+    log->reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        log->append(i, static_cast<std::int32_t>(20240102 + i), 0, static_cast<std::uint32_t>(i % 2),
+                    base + static_cast<double>(i), i % 2 ? -100.0 : 100.0, 5.0);
+    }
+    return log;
+}
+
+} // namespace
+
+TEST(TradeLogTest, RowsResolveNamesAndColumnsStayAligned)
+{
+    auto log = makeLog(3, 10.0);
+    ASSERT_EQ(log->size(), 3u);
+
+    const TradeLog::Row r = log->row(1);
+    EXPECT_EQ(r.bar, 1u);
+    EXPECT_EQ(r.date, 20240103);
+    EXPECT_EQ(r.strategy, "momentum");
+    EXPECT_EQ(r.symbol, "000001.SZ");
+    EXPECT_DOUBLE_EQ(r.price, 11.0);
+    EXPECT_FALSE(r.buy());
+    EXPECT_DOUBLE_EQ(r.amount(), 1100.0);
+
+    EXPECT_EQ(log->prices().size(), 3u);
+    EXPECT_EQ(log->symbolIndices()[2], 0u);
+    EXPECT_GT(log->memoryBytes(), 0u);
+    EXPECT_THROW(log->row(3), std::out_of_range);
+}
+
+TEST(TradeLogTest, UnknownNameIndicesGiveEmptyViews)
+{
+    TradeLog log({"600000.SH"}, {});
+    log.append(0, 20240102, 3, 7, 10.0, 100.0, 0.0);
+    const TradeLog::Row r = log.row(0);
+    EXPECT_TRUE(r.strategy.empty());
+    EXPECT_TRUE(r.symbol.empty());
+
+    log.clear();
+    EXPECT_TRUE(log.empty());
+}
+
+TEST(TradeLogTest, ViewConcatenatesSegmentsWithoutCopying)
+{
+    TradeLogView view;
+    auto a = makeLog(3, 10.0);
+    auto b = makeLog(4, 20.0);
+
+    const auto peek = view.peekAppend(*a);
+    EXPECT_EQ(peek.first, 0u);
+    EXPECT_EQ(peek.count, 3u);
+    EXPECT_EQ(view.size(), 0u);
+
+    auto ra = view.append(a);
+    EXPECT_EQ(ra.first, 0u);
+    EXPECT_EQ(ra.count, 3u);
+    // 空记录不追加，也不占段
+    auto re = view.append(std::make_shared<TradeLog>());
+    EXPECT_EQ(re.first, 3u);
+    EXPECT_EQ(re.count, 0u);
+    auto rb = view.append(b);
+    EXPECT_EQ(rb.first, 3u);
+    EXPECT_EQ(rb.count, 4u);
+
+    ASSERT_EQ(view.size(), 7u);
+    EXPECT_EQ(view.segmentCount(), 2u);
+    EXPECT_EQ(a.use_count(), 2);
+
+    // 每一行落到正确的段、正确的段内行号
+    for (std::size_t i = 0; i < 3; ++i) EXPECT_DOUBLE_EQ(view.row(i).price, 10.0 + static_cast<double>(i));
+    for (std::size_t i = 3; i < 7; ++i) EXPECT_DOUBLE_EQ(view.row(i).price, 20.0 + static_cast<double>(i - 3));
+    EXPECT_EQ(view.row(6).strategy, "momentum");
+    EXPECT_THROW(view.row(7), std::out_of_range);
+
+    view.clear();
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(a.use_count(), 1);
+    EXPECT_THROW(view.row(0), std::out_of_range);
+}
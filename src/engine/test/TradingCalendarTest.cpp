@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "TradingCalendar.h"
+
+using domain::market::TradingCalendar;
+
+TEST(TradingCalendarTest, ValidatesCalendarDates)
+{
+    EXPECT_TRUE(TradingCalendar::isValidDate(20230228));
+    EXPECT_FALSE(TradingCalendar::isValidDate(20230229));
+    EXPECT_TRUE(TradingCalendar::isValidDate(20240229));    // 闰年
+    EXPECT_FALSE(TradingCalendar::isValidDate(21000229));   // 整百年非闰年
+    EXPECT_TRUE(TradingCalendar::isValidDate(20000229));    // 整四百年闰年
+    EXPECT_FALSE(TradingCalendar::isValidDate(20230230));
+    EXPECT_FALSE(TradingCalendar::isValidDate(20230431));
+    EXPECT_FALSE(TradingCalendar::isValidDate(20231301));
+    EXPECT_FALSE(TradingCalendar::isValidDate(20230100));
+    EXPECT_FALSE(TradingCalendar::isValidDate(0));
+    EXPECT_FALSE(TradingCalendar::isValidDate(-20230101));
+}
+
+TEST(TradingCalendarTest, RejectsInvalidDates)
+{
+    EXPECT_THROW(TradingCalendar(2023, 2023, {20230230}), std::invalid_argument);
+    EXPECT_THROW(TradingCalendar(2023, 2023, {}, {20231301}), std::invalid_argument);
+
+    const TradingCalendar cal(2023, 2023, {20230123});
+    // 20230230 按天数换算会落到 3 月 2 日（交易日），必须不被接受
+    EXPECT_TRUE(cal.isTradingDay(20230302));
+    EXPECT_FALSE(cal.isTradingDay(20230230));
+    EXPECT_EQ(cal.indexOf(20230230), -1);
+    EXPECT_THROW(cal.nextTradingDay(20230230), std::invalid_argument);
+    EXPECT_THROW(cal.onOrAfter(20230431), std::invalid_argument);
+    EXPECT_THROW(cal.tradingDaysBetween(20230101, 20230132), std::invalid_argument);
+}
+
+TEST(TradingCalendarTest, NavigatesTradingDays)
+{
+    const TradingCalendar cal(2023, 2023, {20230123}, {20230120});
+    EXPECT_FALSE(cal.isTradingDay(20230121));   // 周六
+    EXPECT_FALSE(cal.isTradingDay(20230123));   // 假日
+    EXPECT_TRUE(cal.isHalfDay(20230120));
+    EXPECT_EQ(cal.nextTradingDay(20230120), 20230124);
+    EXPECT_EQ(cal.prevTradingDay(20230124), 20230120);
+    EXPECT_EQ(cal.onOrAfter(20230121), 20230124);
+    EXPECT_EQ(cal.tradingDaysBetween(20230120, 20230124), 2);
+    EXPECT_EQ(cal.minutesInDay(20230120), TradingCalendar::kMinutesPerHalfDay);
+}
+
+TEST(TradingCalendarTest, DatesOutsideRangeReturnZero)
+{
+    const TradingCalendar cal(2023, 2023, {});
+    EXPECT_EQ(cal.nextTradingDay(20221230), 20230102);
+    EXPECT_EQ(cal.onOrAfter(20200101), 20230102);
+    EXPECT_EQ(cal.prevTradingDay(20221230), 0);
+    EXPECT_EQ(cal.nextTradingDay(20231229), 0);
+    EXPECT_EQ(cal.onOrAfter(20240102), 0);
+    EXPECT_EQ(cal.prevTradingDay(20250101), 20231229);
+    EXPECT_EQ(cal.tradingDaysBetween(20221201, 20230106), 5);
+    EXPECT_EQ(cal.tradingDaysBetween(20240101, 20240201), 0);
+    EXPECT_THROW(cal.addTradingDays(20231229, 1), std::out_of_range);
+    EXPECT_EQ(TradingCalendar::civilFromDays(TradingCalendar::daysFromCivil(20240229) + 1), 20240301);
+}
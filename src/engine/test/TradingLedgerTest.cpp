@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "TradingLedger.h"
+
+using namespace engine;
+
+namespace {
+
+TradingLedger::Options options(std::size_t symbols, double commissionRate = 0.0)
+{
+    TradingLedger::Options o;
+    o.symbols = symbols;
+    o.expectedOpenOrders = 16;
+    o.expectedStepFills = 16;
+    o.commissionRate = commissionRate;
+    return o;
+}
+
+} // namespace
+
+TEST(TradingLedgerTest, PartialFillsAverageThePriceAndFinishTheOrder)
+{
+    TradingLedger ledger(options(1, 0.001));
+    const OrderHandle h = ledger.submit(0, OrderSide::Buy, 300.0, 0.0, 20240102);
+
+    ledger.fill(h, 100.0, 10.0);
+    ASSERT_NE(ledger.order(h), nullptr);
+    EXPECT_EQ(ledger.order(h)->status, OrderStatus::PartiallyFilled);
+    EXPECT_DOUBLE_EQ(ledger.order(h)->remaining(), 200.0);
+
+    ledger.fill(h, 200.0, 11.5);
+    EXPECT_EQ(ledger.order(h)->status, OrderStatus::Filled);
+    EXPECT_DOUBLE_EQ(ledger.order(h)->avgFillPrice, 11.0);
+    EXPECT_DOUBLE_EQ(ledger.totalCommission(), (1000.0 + 2300.0) * 0.001);
+    EXPECT_EQ(ledger.stepFills().size(), 2u);
+
+    // 已终结的订单不能再成交或撤单
+    EXPECT_THROW(ledger.fill(h, 1.0, 10.0), std::invalid_argument);
+    EXPECT_FALSE(ledger.cancel(h));
+
+    const Position* p = ledger.position(0);
+    ASSERT_NE(p, nullptr);
+    EXPECT_DOUBLE_EQ(p->quantity, 300.0);
+    EXPECT_DOUBLE_EQ(p->avgCost, 11.0);
+}
+
+TEST(TradingLedgerTest, RejectsInvalidArguments)
+{
+    TradingLedger ledger(options(2));
+    EXPECT_THROW(ledger.submit(2, OrderSide::Buy, 100.0, 0.0, 20240102), std::out_of_range);
+    EXPECT_THROW(ledger.submit(0, OrderSide::Buy, 0.0, 0.0, 20240102), std::invalid_argument);
+    EXPECT_THROW(ledger.submit(0, OrderSide::Sell, -5.0, 0.0, 20240102), std::invalid_argument);
+
+    const OrderHandle h = ledger.submit(0, OrderSide::Buy, 100.0, 0.0, 20240102);
+    EXPECT_THROW(ledger.fill(h, 0.0, 10.0), std::invalid_argument);
+    EXPECT_THROW(ledger.fill(h, 101.0, 10.0), std::invalid_argument);
+    EXPECT_THROW(ledger.fill(OrderHandle(), 1.0, 10.0), std::invalid_argument);
+    EXPECT_EQ(ledger.position(5), nullptr);
+}
+
+TEST(TradingLedgerTest, EndStepInvalidatesFillsAndFinishedOrdersOnly)
+{
+    TradingLedger ledger(options(1));
+    const OrderHandle filled = ledger.submit(0, OrderSide::Buy, 100.0, 0.0, 20240102);
+    const OrderHandle cancelled = ledger.submit(0, OrderSide::Buy, 100.0, 9.0, 20240102);
+    const OrderHandle open = ledger.submit(0, OrderSide::Buy, 100.0, 9.5, 20240102);
+    const FillHandle f = ledger.fill(filled, 100.0, 10.0);
+    ASSERT_TRUE(ledger.cancel(cancelled));
+    ASSERT_NE(ledger.fill(f), nullptr);
+
+    std::vector<OrderHandle> seen;
+    ledger.forEachOpenOrder([&](OrderHandle h, const Order&) { seen.push_back(h); });
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0], open);
+
+    ledger.endStep();
+    EXPECT_EQ(ledger.fill(f), nullptr);
+    EXPECT_EQ(ledger.order(filled), nullptr);
+    EXPECT_EQ(ledger.order(cancelled), nullptr);
+    ASSERT_NE(ledger.order(open), nullptr);
+    EXPECT_TRUE(ledger.stepFills().empty());
+    EXPECT_EQ(ledger.liveOrders(), 1u);
+
+    // 回收的槽位被复用，旧句柄仍然失效
+    const OrderHandle next = ledger.submit(0, OrderSide::Sell, 50.0, 0.0, 20240103);
+    EXPECT_EQ(ledger.order(filled), nullptr);
+    EXPECT_EQ(ledger.order(next)->quantity, 50.0);
+}
+
+TEST(TradingLedgerTest, NetsPositionsAndRealizesPnl)
+{
+    TradingLedger ledger(options(1));
+    auto trade = [&](OrderSide side, double qty, double price) {
+        ledger.fill(ledger.submit(0, side, qty, 0.0, 20240102), qty, price);
+    };
+
+    trade(OrderSide::Buy, 100.0, 10.0);
+    trade(OrderSide::Buy, 100.0, 12.0);
+    EXPECT_DOUBLE_EQ(ledger.position(0)->avgCost, 11.0);
+
+    // 部分平仓
+    trade(OrderSide::Sell, 50.0, 13.0);
+    EXPECT_DOUBLE_EQ(ledger.realizedPnl(), 100.0);
+    EXPECT_DOUBLE_EQ(ledger.position(0)->quantity, 150.0);
+    EXPECT_DOUBLE_EQ(ledger.position(0)->avgCost, 11.0);
+
+    // 卖出超过持仓：平掉 150，反向开空 50，成本为成交价
+    trade(OrderSide::Sell, 200.0, 10.0);
+    EXPECT_DOUBLE_EQ(ledger.realizedPnl(), 100.0 - 150.0);
+    EXPECT_DOUBLE_EQ(ledger.position(0)->quantity, -50.0);
+    EXPECT_DOUBLE_EQ(ledger.position(0)->avgCost, 10.0);
+
+    // 空头回补到零，持仓回收
+    trade(OrderSide::Buy, 50.0, 8.0);
+    EXPECT_DOUBLE_EQ(ledger.realizedPnl(), -50.0 + 100.0);
+    EXPECT_EQ(ledger.position(0), nullptr);
+    EXPECT_EQ(ledger.openPositions(), 0u);
+}
+
+TEST(TradingLedgerTest, SteadyStateDoesNotGrowPools)
+{
+    TradingLedger ledger(options(4));
+    auto step = [&](std::int32_t date) {
+        for (std::uint32_t s = 0; s < 4; ++s) {
+            const OrderHandle buy = ledger.submit(s, OrderSide::Buy, 100.0, 0.0, date);
+            ledger.fill(buy, 100.0, 10.0 + s);
+            const OrderHandle sell = ledger.submit(s, OrderSide::Sell, 100.0, 0.0, date);
+            ledger.fill(sell, 100.0, 10.5 + s);
+        }
+        ledger.endStep();
+    };
+
+    step(20240102);
+    const std::size_t chunks = ledger.poolChunkAllocations();
+    for (std::int32_t d = 0; d < 1000; ++d) step(20240103 + d);
+    EXPECT_EQ(ledger.poolChunkAllocations(), chunks);
+    EXPECT_EQ(ledger.liveOrders(), 0u);
+    EXPECT_EQ(ledger.openPositions(), 0u);
+    EXPECT_NEAR(ledger.realizedPnl(), 1001 * 4 * 50.0, 1e-6);
+}
@@ -0,0 +1,128 @@
+// 时间解析/格式化：std::get_time / strftime vs foundation::utils::timefmt
+// 用法：TimeFormatBench [iterations] [rounds]
+// 加速比依赖标准库实现（MSVC 的 strftime 慢得多，glibc 上格式化约 3 倍起），只报告不判定
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "foundation/Utils/time_format.hpp"
+
+using namespace foundation::utils::timefmt;
+
+namespace {
+
+// 对照：std::get_time 解析（按 UTC 解释）
+std::int64_t parseWithGetTime(const std::string& s)
+{
+    std::tm tm{};
+    std::istringstream in(s);
+    in >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    const std::int64_t days = daysFromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    return (days * 86400 + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec) * 1000;
+}
+
+// 对照：strftime 格式化
+std::size_t formatWithStrftime(std::int64_t millis, char* out)
+{
+    const std::time_t secs = static_cast<std::time_t>(millis / 1000);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &secs);
+#else
+    gmtime_r(&secs, &tm);
+#endif
+    return std::strftime(out, 32, "%Y-%m-%d %H:%M:%S", &tm);
+}
+
+// 取 rounds 次中最快的一次，单位 ns/次
+template <typename F>
+double bestNs(int rounds, std::size_t iterations, F&& f)
+{
+    double best = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) f(i);
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations);
+        if (round == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+struct Pair {
+    double slowNs = 0.0;
+    double fastNs = 0.0;
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 200000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+    if (n == 0 || rounds <= 0) {
+        std::fprintf(stderr, "iterations and rounds must be positive\n");
+        return 2;
+    }
+    // 标准库版本慢一个数量级，少跑一些
+    const std::size_t slowN = std::max<std::size_t>(n / 10, 1);
+
+    std::vector<std::string> rows;
+    rows.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back(formatDateTime(dateToMillis(20100101) + static_cast<std::int64_t>(i) * 3600000 * 7));
+    }
+    for (const auto& r : rows) {
+        std::int64_t v = 0;
+        if (!parseDateTime(r, v) || v != parseWithGetTime(r)) {
+            std::fprintf(stderr, "result mismatch: %s\n", r.c_str());
+            return 1;
+        }
+    }
+
+    std::int64_t sink = 0;
+    char buf[64];
+    Pair parse, format, log;
+    parse.slowNs = bestNs(rounds, slowN, [&](std::size_t i) { sink += parseWithGetTime(rows[i % rows.size()]); });
+    parse.fastNs = bestNs(rounds, n, [&](std::size_t i) {
+        std::int64_t v = 0;
+        parseDateTime(rows[i % rows.size()], v);
+        sink += v;
+    });
+
+    // 每 7 小时一个时间戳，几乎每次都换日期，日期缓存基本不命中
+    format.slowNs = bestNs(rounds, slowN, [&](std::size_t i) {
+        sink += static_cast<std::int64_t>(formatWithStrftime(static_cast<std::int64_t>(i) * 25200000, buf));
+    });
+    format.fastNs = bestNs(rounds, n, [&](std::size_t i) {
+        sink += static_cast<std::int64_t>(formatDateTime(static_cast<std::int64_t>(i) * 25200000, buf));
+    });
+
+    // 日志行：时间戳递增、大多落在同一天
+    const std::int64_t logBase = dateToMillis(20240102) + 9 * 3600000LL;
+    log.slowNs = bestNs(rounds, slowN, [&](std::size_t i) {
+        sink += static_cast<std::int64_t>(formatWithStrftime(logBase + static_cast<std::int64_t>(i) * 137, buf));
+    });
+    log.fastNs = bestNs(rounds, n, [&](std::size_t i) {
+        sink += static_cast<std::int64_t>(formatDateTime(logBase + static_cast<std::int64_t>(i) * 137, buf));
+    });
+    if (sink == 0) {
+        std::fprintf(stderr, "result mismatch: empty sink\n");
+        return 1;
+    }
+
+    std::printf("{\"bench\":\"time_format\",\"iterations\":%zu,"
+                "\"parse\":{\"get_time_ns\":%.1f,\"fast_ns\":%.1f,\"speedup\":%.2f},"
+                "\"format\":{\"strftime_ns\":%.1f,\"fast_ns\":%.1f,\"speedup\":%.2f},"
+                "\"log\":{\"strftime_ns\":%.1f,\"fast_ns\":%.1f,\"speedup\":%.2f}}\n",
+                n, parse.slowNs, parse.fastNs, parse.slowNs / parse.fastNs, format.slowNs, format.fastNs,
+                format.slowNs / format.fastNs, log.slowNs, log.fastNs, log.slowNs / log.fastNs);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace foundation {
+namespace fs {
+
+// 批量异步读文件
+// 回测启动时要读几千个标的文件，逐个同步读时大部分时间在等磁盘。这里同时保持很多个读请求在途，
+// 让设备队列一直是满的，读完一个就把缓冲区交给回调（可以派发到线程池上解析），读和解析重叠进行。
+//
+// Linux 上用 io_uring：一个 I/O 线程负责提交和收割，queueDepth 个读请求同时在途，不需要对应数量的线程；
+// 内核不支持或被 seccomp 禁用时退回线程池，ioThreads 个线程各自阻塞读；运行中 io_uring_enter 意外出错
+// （如 ENOMEM）时 I/O 线程改为同步读，在途和排队的请求照常完成，backend() 随之变为 ThreadPool。
+// st_size 为 0 的文件（/proc 等伪文件）读到 EOF 为止。
+//
+//   AsyncFileReader reader;
+//   for (const auto& path : files) {
+//       reader.read(path, [](AsyncReadResult&& r) { if (r.ok()) parse(r.path, r.data); });
+//   }
+//   reader.wait();
+//
+// 回调默认在 I/O 线程上直接执行，回调耗时会拖慢后续提交；解析较重时通过 dispatch 交给线程池。
+
+struct AsyncReadResult {
+    std::string path;
+    std::uint64_t tag = 0;   // read() 时传入的用户数据，原样带回
+    std::string data;        // 文件全部内容
+    int error = 0;           // 系统错误码，0 表示成功
+    std::string message;
+
+    bool ok() const { return error == 0; }
+};
+
+using AsyncReadCallback = std::function<void(AsyncReadResult&& result)>;
+
+enum class AsyncReaderBackend : std::uint8_t {
+    Auto,        // 能用 io_uring 就用，否则线程池
+    IoUring,     // 必须用 io_uring，不可用时构造抛 std::runtime_error
+    ThreadPool
+};
+
+const char* asyncReaderBackendName(AsyncReaderBackend backend);
+
+struct AsyncReaderOptions {
+    AsyncReaderBackend backend = AsyncReaderBackend::Auto;
+    std::size_t queueDepth = 64;   // 同时在途的读请求数（io_uring 的提交队列深度）
+    std::size_t ioThreads = 8;     // 线程池后端的读线程数
+    // 回调派发：传入执行回调的任务；为空时在 I/O 线程上直接执行。
+    // 接线程池时形如 [&pool](std::function<void()> task) { pool.submit(std::move(task)); }
+    std::function<void(std::function<void()>)> dispatch;
+};
+
+class AsyncFileReader {
+public:
+    explicit AsyncFileReader(AsyncReaderOptions options = AsyncReaderOptions());
+    // 析构时等待所有已提交的读完成
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    // 线程安全；打开失败、读失败同样通过回调报告（error 非 0），不抛异常
+    void read(std::string path, AsyncReadCallback callback, std::uint64_t tag = 0);
+
+    // 等待所有已提交的读都已交给回调（使用 dispatch 时只保证已派发，不保证回调已执行完）
+    void wait();
+
+    // 实际使用的后端：IoUring 或 ThreadPool
+    AsyncReaderBackend backend() const;
+    // 已提交但还没交给回调的请求数
+    std::size_t pending() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace fs
+} // namespace foundation
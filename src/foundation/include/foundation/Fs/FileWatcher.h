@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace foundation {
+namespace fs {
+
+// 文件/目录变化监视
+// Linux 上用 inotify + epoll：只监视目录（同一目录下的多个文件共用一个 inotify watch），
+// 没有变化时线程阻塞在 epoll_wait 上，不占 CPU；编辑器"写临时文件再改名"的保存方式
+// 也能正确识别。其它平台或 inotify 不可用时退回定时 stat 轮询。
+// 被监视的目录被删除或改名时，监视它的 watch 收到一次 Removed（目录 watch 收到目录本身），
+// 之后每 100ms 尝试重新挂上，目录重新出现时再按当前状态报告一次，此后照常收到事件。
+//
+// 突发写入会被合并：同一路径在 coalesce 时间内的多次事件只回调一次（最长延迟 maxDelay），
+// 一次回调里带上同一个 watch 在这段时间内变化的所有路径。
+//
+//   FileWatcher watcher;
+//   watcher.watchFile("data/config/system/override.json", [](const std::vector<FileChange>& changes) { ... });
+//   watcher.watchDirectory("data/drop", onNewFiles);
+//   watcher.start();
+//
+// 回调在监视线程上执行，不要在回调里做耗时操作；回调里可以调用 watch/unwatch。
+
+enum class FileEvent : std::uint8_t {
+    Created,
+    Modified,
+    Removed
+};
+
+const char* fileEventName(FileEvent event);
+
+struct FileChange {
+    std::string path;
+    FileEvent event;
+};
+
+using FileChangeCallback = std::function<void(const std::vector<FileChange>& changes)>;
+
+enum class FileWatcherBackend : std::uint8_t {
+    Auto,      // 平台支持时用原生事件，否则轮询
+    Native,    // 必须用原生事件，不可用时构造抛 std::runtime_error
+    Polling
+};
+
+struct FileWatcherOptions {
+    FileWatcherBackend backend = FileWatcherBackend::Auto;
+    std::chrono::milliseconds coalesce{50};        // 路径安静这么久后才回调
+    std::chrono::milliseconds maxDelay{1000};      // 持续写入时最多延迟这么久
+    std::chrono::milliseconds pollInterval{500};   // 轮询后端的扫描间隔
+};
+
+class FileWatcher {
+public:
+    using WatchId = std::uint64_t;
+
+    explicit FileWatcher(FileWatcherOptions options = FileWatcherOptions());
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // 监视单个文件（文件可以暂时不存在，但所在目录必须存在）；目录不存在抛 std::runtime_error
+    WatchId watchFile(const std::string& path, FileChangeCallback callback);
+    // 监视目录下的直接子项（不递归）
+    WatchId watchDirectory(const std::string& path, FileChangeCallback callback);
+    // 返回后不会再有该 watch 的回调开始执行（回调线程内调用除外）
+    void unwatch(WatchId id);
+
+    void start();
+    void stop();
+
+    // 实际使用的后端：Native 或 Polling
+    FileWatcherBackend backend() const;
+    std::size_t watchCount() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace fs
+} // namespace foundation
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace foundation {
+namespace fs {
+
+// 内存映射文件
+// 读大文件（行情数据块、日志回放、CSV 批量导入）时直接在映射上解析，省掉 read 到用户缓冲区的一次拷贝，
+// 页缓存里的数据在多个进程/多次打开之间共享。
+//
+//   auto file = MappedFile::open("data/market/objects/ab/abcd.blk");
+//   file.advise(MapAdvice::Sequential);
+//   parse(file.view());
+//
+// MappedFile 是一个轻量句柄：拷贝只增加引用计数，最后一个句柄（包括 slice 出来的子视图）析构时才解除映射，
+// 因此可以把句柄交给其它线程而不必关心谁最后用完。并发读是安全的；读写映射上的并发写需要调用方自己同步。
+//
+// 映射期间文件被其它进程截断时，访问截断部分会收到 SIGBUS（Windows 上为访问异常），
+// 只映射本程序自己管理、不会被截断的文件。
+//
+// 失败抛 std::runtime_error，消息里带路径和系统错误。
+
+enum class MapAccess : std::uint8_t {
+    ReadOnly,
+    ReadWrite,     // 写入会落回文件（flush 后保证落盘）
+    CopyOnWrite    // 可写，但修改只在本进程可见，不写回文件
+};
+
+enum class MapAdvice : std::uint8_t {
+    Normal,
+    Sequential,    // 顺序扫描：加大预读，读过的页可以尽早回收
+    Random,        // 随机访问：关闭预读
+    WillNeed,      // 马上要用：后台预读进页缓存
+    DontNeed       // 暂时不用：允许回收
+};
+
+struct MapOptions {
+    MapAccess access = MapAccess::ReadOnly;
+    std::uint64_t offset = 0;   // 从文件的这个偏移开始映射，不要求页对齐
+    std::size_t length = 0;     // 0 表示映射到文件末尾
+    // ReadWrite：文件不存在时创建，且不足这么大时扩展到这么大（新增部分为 0）；0 表示不创建也不扩展
+    std::uint64_t createSize = 0;
+    MapAdvice advice = MapAdvice::Normal;
+    bool populate = false;      // 映射时预先读入全部页，之后访问不再缺页
+    bool hugePages = false;     // 尽量使用大页（尽力而为，是否生效见 hugePagesApplied）
+};
+
+class MappedFile {
+public:
+    MappedFile() = default;   // 空映射
+
+    static MappedFile open(const std::string& path, const MapOptions& options = MapOptions());
+    // 匿名映射（不对应文件，内容初始为 0，可读写），供需要大块页对齐内存的场合使用
+    static MappedFile anonymous(std::size_t size, bool hugePages = false);
+
+    const char* data() const { return data_; }
+    // 只读映射上调用抛 std::logic_error
+    char* writableData() const;
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    MapAccess access() const;
+    const std::string& path() const;
+    bool hugePagesApplied() const;
+
+    // 与本句柄共享同一个映射的子视图；offset/length 超出范围时截断到末尾
+    MappedFile slice(std::size_t offset, std::size_t length = static_cast<std::size_t>(-1)) const;
+
+    // 访问模式提示，作用于本视图的范围；平台不支持的提示静默忽略
+    void advise(MapAdvice advice) const;
+    // ReadWrite 映射把本视图范围内的修改写回文件；async 为 false 时等待写完
+    void flush(bool async = false) const;
+
+    static std::size_t pageSize();
+
+private:
+    struct Mapping;
+
+    MappedFile(std::shared_ptr<const Mapping> mapping, const char* data, std::size_t size)
+        : mapping_(std::move(mapping)), data_(data), size_(size) {}
+
+    std::shared_ptr<const Mapping> mapping_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace fs
+} // namespace foundation
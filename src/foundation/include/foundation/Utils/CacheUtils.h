@@ -0,0 +1,380 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "foundation/log/metrics.hpp"
+
+namespace foundation {
+namespace utils {
+
+// 通用并发缓存
+// 用于 K 线数据块、HTTP 响应、指标结果等：
+//   - 按 key 哈希分片，每个分片一把锁，不同分片之间互不阻塞
+//   - 按字节数计容量（Sizer 计算每个值的大小），超限淘汰
+//   - 淘汰策略：LRU，或 TinyLFU（LRU + 频率草图准入，防止一次性扫描冲掉热点）
+//   - 可选 TTL，过期项在访问时惰性清除
+//   - 命中/未命中/淘汰/过期/拒绝 计数
+//
+//   ConcurrentCache<std::string, std::string> cache(CacheOptions{64u << 20});
+//   cache.put("k", "v");
+//   if (auto v = cache.get("k")) use(*v);
+//   auto v = cache.getOrLoad("k", [] { return load(); });
+//
+// 值以 shared_ptr<const V> 返回，被淘汰后调用方持有的副本仍然有效
+
+enum class EvictionPolicy {
+    Lru,
+    TinyLfu
+};
+
+struct CacheOptions {
+    std::size_t capacityBytes = 64u << 20;
+    std::size_t shards = 16;                              // 取整到 2 的幂
+    EvictionPolicy policy = EvictionPolicy::Lru;
+    std::chrono::milliseconds ttl{0};                     // 0 表示不过期
+    std::size_t entryOverhead = 64;                       // 每项的固定簿记开销（字节）
+
+    CacheOptions() = default;
+    explicit CacheOptions(std::size_t bytes) : capacityBytes(bytes) {}
+};
+
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t insertions = 0;
+    std::uint64_t evictions = 0;
+    std::uint64_t expirations = 0;
+    std::uint64_t rejections = 0;    // TinyLFU 拒绝准入的次数
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+
+    double hitRate() const {
+        const std::uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+    // 单行文本，便于写日志
+    std::string toString() const;
+};
+
+// 默认大小估算：sizeof(V)，字符串和 vector 额外加上堆内存
+template <typename V>
+struct CacheSizer {
+    std::size_t operator()(const V&) const { return sizeof(V); }
+};
+
+template <>
+struct CacheSizer<std::string> {
+    std::size_t operator()(const std::string& v) const { return sizeof(std::string) + v.capacity(); }
+};
+
+template <typename T, typename A>
+struct CacheSizer<std::vector<T, A>> {
+    std::size_t operator()(const std::vector<T, A>& v) const { return sizeof(v) + v.capacity() * sizeof(T); }
+};
+
+// TinyLFU 使用的 4 位 Count-Min 草图
+// 每个分片一个；累计 sampleSize 次记录后所有计数减半，让频率随时间衰减
+class FrequencySketch {
+public:
+    explicit FrequencySketch(std::size_t expectedEntries = 1024);
+
+    void increment(std::uint64_t hash);
+    std::uint32_t estimate(std::uint64_t hash) const;
+    void clear();
+
+private:
+    std::size_t indexOf(std::uint64_t hash, int row) const;
+    void halve();
+
+    std::vector<std::uint64_t> table_;   // 每个 64 位字存 16 个 4 位计数
+    std::size_t mask_ = 0;
+    std::size_t sampleSize_ = 0;
+    std::size_t additions_ = 0;
+};
+
+// 把缓存统计注册为 MetricsRegistry 回调：*_total 为计数器（cache_hits_total{cache="name"} 等），其余为仪表
+std::vector<metrics::CallbackHandle> bindCacheMetrics(const std::string& name, std::function<CacheStats()> stats);
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename Sizer = CacheSizer<V>>
+class ConcurrentCache {
+public:
+    using ValuePtr = std::shared_ptr<const V>;
+    using Clock = std::chrono::steady_clock;
+
+    explicit ConcurrentCache(const CacheOptions& options = CacheOptions(), Hash hash = Hash(), Sizer sizer = Sizer())
+        : options_(options), hash_(std::move(hash)), sizer_(std::move(sizer)) {
+        std::size_t n = 1;
+        while (n < options_.shards) n <<= 1;
+        shardMask_ = n - 1;
+        const std::size_t perShard = options_.capacityBytes / n;
+        shards_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            // 草图大小按"每项约 1KB"估算条目数，只影响精度不影响正确性
+            shards_.push_back(std::make_unique<Shard>(perShard, perShard / 1024 + 64));
+        }
+    }
+
+    ConcurrentCache(const ConcurrentCache&) = delete;
+    ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+    ValuePtr get(const K& key) {
+        const std::uint64_t h = mix(hash_(key));
+        Shard& s = shardFor(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (options_.policy == EvictionPolicy::TinyLfu) s.sketch.increment(h);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        if (expired(it->second)) {
+            removeLocked(s, it);
+            expirations_.fetch_add(1, std::memory_order_relaxed);
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        s.lru.splice(s.lru.begin(), s.lru, it->second.lru);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second.value;
+    }
+
+    // 插入或替换；返回 false 表示被 TinyLFU 拒绝，或单项超过分片容量
+    bool put(const K& key, V value, std::chrono::milliseconds ttl = std::chrono::milliseconds(-1)) {
+        return putShared(key, std::make_shared<const V>(std::move(value)), ttl);
+    }
+
+    bool putShared(const K& key, ValuePtr value, std::chrono::milliseconds ttl = std::chrono::milliseconds(-1)) {
+        if (!value) return false;
+        const std::size_t bytes = sizer_(*value) + options_.entryOverhead;
+        const std::uint64_t h = mix(hash_(key));
+        Shard& s = shardFor(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (bytes > s.capacity) {
+            rejections_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto it = s.map.find(key);
+        if (it != s.map.end()) {
+            // 替换：旧值的字节先扣掉
+            s.bytes -= it->second.bytes;
+            it->second.value = std::move(value);
+            it->second.bytes = bytes;
+            it->second.expireAt = expiryFor(ttl);
+            s.bytes += bytes;
+            s.lru.splice(s.lru.begin(), s.lru, it->second.lru);
+            evictLocked(s, &key);
+            insertions_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (options_.policy == EvictionPolicy::TinyLfu && s.bytes + bytes > s.capacity && !s.lru.empty()) {
+            // 新项的访问频率不高于淘汰候选时拒绝准入
+            const std::uint32_t candidate = s.sketch.estimate(h);
+            const std::uint32_t victim = s.sketch.estimate(mix(hash_(s.lru.back())));
+            if (candidate <= victim) {
+                rejections_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        s.lru.push_front(key);
+        Entry e;
+        e.value = std::move(value);
+        e.bytes = bytes;
+        e.expireAt = expiryFor(ttl);
+        e.lru = s.lru.begin();
+        s.map.emplace(key, std::move(e));
+        s.bytes += bytes;
+        evictLocked(s, &key);
+        insertions_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 未命中时调用 loader 加载并写入；loader 在锁外执行
+    // 多个线程同时未命中同一个 key 时，可能各自加载一次，以最后写入的为准
+    template <typename Loader>
+    ValuePtr getOrLoad(const K& key, Loader&& loader,
+                       std::chrono::milliseconds ttl = std::chrono::milliseconds(-1)) {
+        if (auto v = get(key)) return v;
+        ValuePtr loaded = std::make_shared<const V>(loader());
+        putShared(key, loaded, ttl);
+        return loaded;
+    }
+
+    bool contains(const K& key) const {
+        const std::uint64_t h = mix(hash_(key));
+        const Shard& s = shardFor(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.map.find(key);
+        return it != s.map.end() && !expired(it->second);
+    }
+
+    bool erase(const K& key) {
+        const std::uint64_t h = mix(hash_(key));
+        Shard& s = shardFor(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) return false;
+        removeLocked(s, it);
+        return true;
+    }
+
+    // 主动清理所有已过期的项，返回清理个数
+    std::size_t purgeExpired() {
+        if (options_.ttl.count() <= 0 && !anyTtl_.load(std::memory_order_relaxed)) return 0;
+        std::size_t removed = 0;
+        for (auto& sp : shards_) {
+            Shard& s = *sp;
+            std::lock_guard<std::mutex> lock(s.mutex);
+            for (auto it = s.map.begin(); it != s.map.end();) {
+                if (expired(it->second)) {
+                    auto next = std::next(it);
+                    removeLocked(s, it);
+                    it = next;
+                    ++removed;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        expirations_.fetch_add(removed, std::memory_order_relaxed);
+        return removed;
+    }
+
+    void clear() {
+        for (auto& sp : shards_) {
+            std::lock_guard<std::mutex> lock(sp->mutex);
+            sp->map.clear();
+            sp->lru.clear();
+            sp->bytes = 0;
+            sp->sketch.clear();
+        }
+    }
+
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (auto& sp : shards_) {
+            std::lock_guard<std::mutex> lock(sp->mutex);
+            n += sp->map.size();
+        }
+        return n;
+    }
+
+    CacheStats stats() const {
+        CacheStats st;
+        st.hits = hits_.load(std::memory_order_relaxed);
+        st.misses = misses_.load(std::memory_order_relaxed);
+        st.insertions = insertions_.load(std::memory_order_relaxed);
+        st.evictions = evictions_.load(std::memory_order_relaxed);
+        st.expirations = expirations_.load(std::memory_order_relaxed);
+        st.rejections = rejections_.load(std::memory_order_relaxed);
+        for (auto& sp : shards_) {
+            std::lock_guard<std::mutex> lock(sp->mutex);
+            st.entries += sp->map.size();
+            st.bytes += sp->bytes;
+        }
+        return st;
+    }
+
+    const CacheOptions& options() const { return options_; }
+
+    // 导出到全局指标注册表；缓存析构时自动注销
+    void bindMetrics(const std::string& name) {
+        metricHandles_.clear();   // 先注销旧序列，同名同标签不能重复注册
+        metricHandles_ = bindCacheMetrics(name, [this] { return stats(); });
+    }
+
+private:
+    struct Entry {
+        ValuePtr value;
+        std::size_t bytes = 0;
+        Clock::time_point expireAt = Clock::time_point::max();
+        typename std::list<K>::iterator lru;
+    };
+
+    struct Shard {
+        Shard(std::size_t cap, std::size_t expected) : capacity(cap), sketch(expected) {}
+
+        mutable std::mutex mutex;
+        std::unordered_map<K, Entry, Hash> map;
+        std::list<K> lru;   // 头部为最近使用
+        std::size_t bytes = 0;
+        std::size_t capacity;
+        FrequencySketch sketch;
+    };
+
+    using MapIter = typename std::unordered_map<K, Entry, Hash>::iterator;
+
+    // 对用户哈希再做一次混合，避免 std::hash<int> 这类恒等哈希分片不均
+    static std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    Shard& shardFor(std::uint64_t h) { return *shards_[h & shardMask_]; }
+    const Shard& shardFor(std::uint64_t h) const { return *shards_[h & shardMask_]; }
+
+    Clock::time_point expiryFor(std::chrono::milliseconds ttl) {
+        if (ttl.count() < 0) ttl = options_.ttl;
+        if (ttl.count() == 0) return Clock::time_point::max();
+        anyTtl_.store(true, std::memory_order_relaxed);
+        return Clock::now() + ttl;
+    }
+
+    static bool expired(const Entry& e) {
+        return e.expireAt != Clock::time_point::max() && Clock::now() >= e.expireAt;
+    }
+
+    void removeLocked(Shard& s, MapIter it) {
+        s.bytes -= it->second.bytes;
+        s.lru.erase(it->second.lru);
+        s.map.erase(it);
+    }
+
+    // keep：刚写入的 key，不淘汰自己
+    void evictLocked(Shard& s, const K* keep) {
+        while (s.bytes > s.capacity && !s.lru.empty()) {
+            auto victimKey = std::prev(s.lru.end());
+            if (keep && *victimKey == *keep) break;
+            auto it = s.map.find(*victimKey);
+            removeLocked(s, it);
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CacheOptions options_;
+    Hash hash_;
+    Sizer sizer_;
+    std::size_t shardMask_ = 0;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<bool> anyTtl_{false};
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> insertions_{0};
+    std::atomic<std::uint64_t> evictions_{0};
+    std::atomic<std::uint64_t> expirations_{0};
+    std::atomic<std::uint64_t> rejections_{0};
+
+    // 放在最后：析构时最先注销，之后不会再有回调访问本对象
+    std::vector<metrics::CallbackHandle> metricHandles_;
+};
+
+} // namespace utils
+} // namespace foundation
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace foundation {
+namespace utils {
+
+// steady_clock 纳秒时间戳，延迟打点统一用这个
+inline std::uint64_t steadyNanos()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// 对数-线性分桶的延迟直方图（HDR 风格）
+// 每个 2 的幂区间再均分 16 个子桶，相对误差约 6%；覆盖 0 ~ 2^44 ns（约 4.9 小时）
+// record 只有几次 relaxed 原子操作，可以多线程同时写；读取得到的是近似一致的快照
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 44;
+    static constexpr int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::uint64_t nanos) {
+        buckets_[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(nanos, std::memory_order_relaxed);
+        std::uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (nanos > prev && !max_.compare_exchange_weak(prev, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+    // 只有一个写线程时使用：读-改-写不带 lock 前缀，其它线程仍可并发读取
+    void recordSingleWriter(std::uint64_t nanos) {
+        auto& b = buckets_[bucketOf(nanos)];
+        b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+        if (nanos > max_.load(std::memory_order_relaxed)) max_.store(nanos, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const;
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+    // p 取 0~100，返回所在桶的上界
+    std::uint64_t percentile(double p) const;
+
+    // 把 other 的计数累加进来（用于按线程聚合）
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    // 单行摘要：count mean p50 p90 p99 p999 max（单位 us）
+    std::string summary() const;
+
+    static int bucketOf(std::uint64_t v) {
+        if (v < static_cast<std::uint64_t>(kSubBuckets)) return static_cast<int>(v);
+        int exp = 63 - countLeadingZeros(v);
+        if (exp > kMaxExponent) return kBucketCount - 1;
+        const int shift = exp - kSubBucketBits;
+        const int sub = static_cast<int>((v >> shift) & (kSubBuckets - 1));
+        return (shift + 1) * kSubBuckets + sub;
+    }
+    // 桶内的最大值
+    static std::uint64_t bucketUpperBound(int bucket);
+
+private:
+    static int countLeadingZeros(std::uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse64(&idx, v);
+        return 63 - static_cast<int>(idx);
+#else
+        return __builtin_clzll(v);
+#endif
+    }
+
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+} // namespace utils
+} // namespace foundation
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace foundation {
+namespace utils {
+
+// 固定格式时间的快速解析/格式化
+// 只处理项目里实际用到的几种格式，手写解析，不依赖 locale，
+// 用于 CSV 每一行、日志每一行这类热路径，替代 std::get_time / strftime
+//
+// 支持的格式：
+//   YYYY-MM-DD
+//   YYYYMMDD
+//   YYYY-MM-DD HH:MM:SS
+//   YYYY-MM-DD HH:MM:SS.fff   （日期与时间之间也接受 'T'）
+//
+// 时间值统一为 "自 1970-01-01 00:00:00 起的毫秒数"，按墙上时间解释，不做时区换算
+namespace timefmt {
+
+// 公历日期 -> 1970-01-01 起的天数
+// 1970~2099 年走预计算的月首表，其余年份退化为纯算术
+int daysFromCivil(int year, int month, int day);
+// 天数 -> 公历日期
+void civilFromDays(int days, int& year, int& month, int& day);
+
+// 日期部分：YYYY-MM-DD 或 YYYYMMDD，输出 YYYYMMDD 整数
+bool parseDate(std::string_view s, std::int32_t& yyyymmdd);
+// 日期或日期时间，输出毫秒时间戳；只有日期时为当日 00:00:00
+bool parseDateTime(std::string_view s, std::int64_t& epochMillis);
+
+// 下面的格式化函数写入调用方提供的缓冲区，返回写入的字符数（不含结尾 '\0'）
+// 缓冲区至少需要 kDateTimeMillisLength + 1 字节
+// 超出 0000-01-01 .. 9999-12-31 的输入（含负数）钳到该范围的端点
+constexpr std::size_t kDateLength = 10;             // YYYY-MM-DD
+constexpr std::size_t kCompactDateLength = 8;       // YYYYMMDD
+constexpr std::size_t kDateTimeLength = 19;         // YYYY-MM-DD HH:MM:SS
+constexpr std::size_t kDateTimeMillisLength = 23;   // YYYY-MM-DD HH:MM:SS.fff
+
+std::size_t formatDate(std::int32_t yyyymmdd, char* out);
+std::size_t formatCompactDate(std::int32_t yyyymmdd, char* out);
+std::size_t formatDateTime(std::int64_t epochMillis, char* out, bool withMillis = false);
+
+std::string formatDate(std::int32_t yyyymmdd);
+std::string formatDateTime(std::int64_t epochMillis, bool withMillis = false);
+
+// YYYYMMDD <-> 毫秒时间戳
+std::int64_t dateToMillis(std::int32_t yyyymmdd);
+std::int32_t millisToDate(std::int64_t epochMillis);
+
+} // namespace timefmt
+} // namespace utils
+} // namespace foundation
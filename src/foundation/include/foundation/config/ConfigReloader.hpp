@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "foundation/Fs/FileWatcher.h"
+#include "foundation/config/ConfigSnapshot.hpp"
+
+namespace foundation {
+namespace config {
+
+// 配置热加载
+// 后台线程盯住分层配置的来源文件（foundation.json / profiles/<profile>.json / system/override.json），
+// 平台支持时由 FileWatcher 的事件驱动，只按较长的 backstopInterval 兜底对账；否则按 pollInterval 比较大小与修改时间；
+// 发现变化后等待 debounce 时间内不再变化（编辑器保存常常是"截断 + 多次写入"），
+// 然后在本线程重新合并，内容确实变了才通过 ConfigStore::publish() 原子地换上新快照。
+//
+//   ConfigStore store(loadLayeredConfig("data/config", "production"));
+//   store.subscribe("log", [](const ConfigSnapshot& s) { setLogLevel(s.getString("log.level")); });
+//   ConfigReloader reloader(store, {"data/config", "production"});
+//   reloader.start();
+//
+// 解析、合并都在热加载线程上完成，读者只会看到旧快照或新快照，不会被阻塞。
+// 新文件有语法错误时保留旧快照，错误记在 status() 里，修好后下一次变化会再次加载。
+// 监听者抛出的异常同样只记在 status() 里，不会中断热加载线程。
+struct ConfigReloadOptions {
+    std::string configDir;
+    std::string profile;
+    std::chrono::milliseconds pollInterval{200};   // 没有原生文件事件时的轮询间隔
+    // 有原生文件事件时仍按这个间隔比较一次大小与修改时间，兜住丢失的事件
+    // （inotify 队列溢出、目录被删除重建后监视失效等）
+    std::chrono::milliseconds backstopInterval{5000};
+    std::chrono::milliseconds debounce{300};
+    bool useFileWatcher = true;
+};
+
+class ConfigReloader {
+public:
+    struct Status {
+        std::uint64_t checks = 0;      // 检测到变化并尝试加载的次数
+        std::uint64_t reloads = 0;     // 成功发布新快照的次数
+        std::uint64_t unchanged = 0;   // 文件变了但合并结果相同，未发布
+        std::uint64_t failures = 0;
+        std::uint64_t listenerFailures = 0;   // 新快照已发布，但有监听者抛了异常
+        std::string lastError;
+    };
+
+    ConfigReloader(ConfigStore& store, ConfigReloadOptions options);
+    ~ConfigReloader();
+
+    ConfigReloader(const ConfigReloader&) = delete;
+    ConfigReloader& operator=(const ConfigReloader&) = delete;
+
+    void start();
+    void stop();
+
+    // 立即重新加载（不等 debounce）；发布了新快照返回 true
+    // 加载失败或监听者抛异常都不往外抛，记录到 status()
+    bool reloadNow();
+    // 外部文件监视器通知来源有变化；按 debounce 合并后加载
+    void notifyChanged();
+
+    Status status() const;
+    // 被监视的来源文件（按合并顺序）
+    const std::vector<std::string>& sources() const { return sources_; }
+
+private:
+    struct Fingerprint {
+        bool exists = false;
+        std::uintmax_t size = 0;
+        std::int64_t mtime = 0;
+        bool operator==(const Fingerprint& o) const {
+            return exists == o.exists && size == o.size && mtime == o.mtime;
+        }
+        bool operator!=(const Fingerprint& o) const { return !(*this == o); }
+    };
+
+    std::vector<Fingerprint> fingerprints() const;
+    void run();
+
+    ConfigStore& store_;
+    const ConfigReloadOptions options_;
+    std::vector<std::string> sources_;
+
+    std::mutex reloadMutex_;   // reloadNow 可能与后台线程并发调用
+    std::unique_ptr<foundation::fs::FileWatcher> watcher_;
+    bool eventDriven_ = false;   // 所有来源都由原生文件事件覆盖，只需低频兜底轮询
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    bool notified_ = false;
+    Status status_;
+    std::thread thread_;
+};
+
+} // namespace config
+} // namespace foundation
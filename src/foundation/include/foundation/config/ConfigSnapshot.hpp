@@ -0,0 +1,399 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace foundation {
+namespace config {
+
+// 扁平化配置快照
+// 把 foundation.json + profiles/<profile>.json + system/override.json 合并后的配置树
+// 展开成 "runtime.executor.workers" -> 值 的扁平表，构建后只读：
+//   - 点分路径一次哈希、一次探测即可命中，不再逐层遍历节点
+//   - 每个叶子在构建时就预先转换好 bool / int / double / string，读取时不再解析
+//   - 数组元素用下标作为路径段："symbols.0"、"symbols.1"
+//
+// 热路径上用 ConfigStore 发放的类型化句柄：
+//
+//   static auto workers = store.handle<std::int64_t>("runtime.executor.workers", 4);
+//   pool.resize(workers.get());          // 一次原子读
+//
+// 重新加载时 ConfigStore::publish() 原子地替换快照（RCU 方式：旧快照由仍持有它的读者
+// 的 shared_ptr 保活，最后一个读者放手时释放），并把新值写进所有存活的句柄。
+// 读者不会看到半新半旧的快照。读取都不加锁：标量句柄的 get() 是一次原子读；snapshot() 与字符串句柄
+// 读的是每线程缓存的 shared_ptr，版本号没变时只多一次引用计数的原子加（见 detail::PublishedPtr）。
+
+// 路径的预计算哈希；频繁查询的路径可以构造一次反复使用
+std::uint64_t hashConfigPath(std::string_view path);
+
+class ConfigKey {
+public:
+    explicit ConfigKey(std::string path) : path_(std::move(path)), hash_(hashConfigPath(path_)) {}
+
+    const std::string& path() const { return path_; }
+    std::uint64_t hash() const { return hash_; }
+
+private:
+    std::string path_;
+    std::uint64_t hash_;
+};
+
+struct ConfigValue {
+    enum class Type : std::uint8_t { Null, Bool, Int, Double, String };
+
+    Type type = Type::Null;
+    // 各种表示在构建时算好；对应 has* 为 false 表示无法转换（如 "abc" 转 int）
+    bool hasBool = false;
+    bool hasInt = false;
+    bool hasDouble = false;
+    bool boolValue = false;
+    std::int64_t intValue = 0;
+    double doubleValue = 0.0;
+    std::string text;   // 原始文本（字符串原样，数字/布尔为规范化文本）
+
+    static ConfigValue null();
+    static ConfigValue fromBool(bool v);
+    static ConfigValue fromInt(std::int64_t v);
+    static ConfigValue fromDouble(double v);
+    // 字符串会尝试转换成 bool（true/false/1/0/yes/no/on/off）和数字
+    static ConfigValue fromString(std::string v);
+
+    // 取 T 表示；无法转换返回 false
+    template <typename T>
+    bool as(T& out) const;
+};
+
+template <>
+inline bool ConfigValue::as<bool>(bool& out) const
+{
+    out = boolValue;
+    return hasBool;
+}
+
+template <>
+inline bool ConfigValue::as<std::int64_t>(std::int64_t& out) const
+{
+    out = intValue;
+    return hasInt;
+}
+
+template <>
+inline bool ConfigValue::as<int>(int& out) const
+{
+    if (!hasInt || intValue < INT32_MIN || intValue > INT32_MAX) return false;
+    out = static_cast<int>(intValue);
+    return true;
+}
+
+template <>
+inline bool ConfigValue::as<double>(double& out) const
+{
+    out = doubleValue;
+    return hasDouble;
+}
+
+template <>
+inline bool ConfigValue::as<std::string>(std::string& out) const
+{
+    if (type == Type::Null) return false;
+    out = text;
+    return true;
+}
+
+class ConfigSnapshot {
+public:
+    class Builder;
+
+    ConfigSnapshot(const ConfigSnapshot&) = delete;
+    ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+    // 不存在返回 nullptr
+    const ConfigValue* find(std::string_view path) const { return find(path, hashConfigPath(path)); }
+    const ConfigValue* find(const ConfigKey& key) const { return find(key.path(), key.hash()); }
+    bool contains(std::string_view path) const { return find(path) != nullptr; }
+
+    // 不存在或类型无法转换时返回默认值
+    template <typename T>
+    T get(std::string_view path, T def) const {
+        T out;
+        const ConfigValue* v = find(path);
+        return (v && v->as(out)) ? out : def;
+    }
+    std::string getString(std::string_view path, const std::string& def = std::string()) const {
+        return get<std::string>(path, def);
+    }
+
+    // 不存在或类型无法转换时抛 std::runtime_error
+    template <typename T>
+    T require(std::string_view path) const {
+        T out;
+        const ConfigValue* v = find(path);
+        if (!v) throw std::runtime_error("config: missing key " + std::string(path));
+        if (!v->as(out)) throw std::runtime_error("config: key " + std::string(path) + " has incompatible type");
+        return out;
+    }
+
+    // prefix 下的所有叶子路径（按字典序）；prefix 为空返回全部
+    std::vector<std::string> keys(std::string_view prefix = std::string_view()) const;
+    // prefix 的直接子节点名（去重，按字典序），例如 children("database") -> connection, enabled, ...
+    std::vector<std::string> children(std::string_view prefix) const;
+    // prefix 子树（prefix 为空时为全部）的路径与值是否与 other 完全相同
+    bool sameAs(const ConfigSnapshot& other, std::string_view prefix = std::string_view()) const;
+
+    std::size_t size() const { return entries_.size(); }
+    // 单调递增的版本号，由 ConfigStore 发布时分配；直接 build() 的快照为 0
+    std::uint64_t version() const { return version_; }
+    // 参与合并的来源（文件路径或调用方给的名字），按合并顺序
+    const std::vector<std::string>& sources() const { return sources_; }
+
+private:
+    friend class Builder;
+    friend class ConfigStore;
+    ConfigSnapshot() = default;
+
+    const ConfigValue* find(std::string_view path, std::uint64_t hash) const;
+
+    struct Entry {
+        std::string path;
+        std::uint64_t hash;
+        ConfigValue value;
+    };
+
+    std::vector<Entry> entries_;        // 按路径排序
+    std::vector<std::uint32_t> index_;  // 开放寻址：entries_ 下标 + 1，0 为空槽
+    std::uint64_t mask_ = 0;
+    std::uint64_t version_ = 0;
+    std::vector<std::string> sources_;
+};
+
+// 按层合并；后合并的层覆盖先合并的层
+// 覆盖是按路径进行的：后一层把 "a" 设成标量会删掉之前所有 "a.*"，反之亦然；
+// 设成空对象 {} 或数组会删掉之前的 "a" 与所有 "a.*"
+class ConfigSnapshot::Builder {
+public:
+    // JSON 文本，允许 // 与 /* */ 注释；语法错误抛 std::runtime_error（带来源名与行号）
+    Builder& mergeJson(std::string_view text, const std::string& sourceName = "<json>");
+    // 文件不存在时：required 为 true 抛 std::runtime_error，否则跳过
+    Builder& mergeFile(const std::string& path, bool required = true);
+    // 已有快照作为一层
+    Builder& merge(const ConfigSnapshot& other);
+    Builder& set(const std::string& path, ConfigValue value);
+
+    // 构建结果在交给 ConfigStore 发布之前可以自由传递；内容始终只读
+    std::shared_ptr<ConfigSnapshot> build() const;
+
+private:
+    // 删掉 path、它的所有子路径，以及路径上作为叶子的祖先
+    void clear(const std::string& path);
+
+    std::map<std::string, ConfigValue, std::less<>> values_;
+    std::vector<std::string> sources_;
+};
+
+// 标准三层：<dir>/foundation/foundation.json（必需）、<dir>/profiles/<profile>.json、
+// <dir>/system/override.json（后两者可缺省）；profile 为空时跳过 profile 层
+std::shared_ptr<ConfigSnapshot> loadLayeredConfig(const std::string& configDir, const std::string& profile);
+
+// 句柄内部的值单元
+namespace detail {
+
+template <typename T>
+struct HandleCell {
+    std::string path;
+    T def;
+    std::atomic<T> value;
+
+    HandleCell(std::string p, T d) : path(std::move(p)), def(d), value(d) {}
+};
+
+// 读多写少的 shared_ptr 发布点（RCU 式）
+// std::atomic_load(shared_ptr) 在 libstdc++ 里要进按地址散列的全局互斥锁池。这里写者换上新指针后
+// 把版本号加一；读者在本线程缓存（发布点编号, 版本号, 指针），版本号没变时直接拷贝缓存的 shared_ptr，
+// 只有版本号变了之后的第一次读取才走一次 atomic_load。
+// 每个线程对每种 T 缓存 kCacheSlots 个发布点（按编号直接映射，冲突时互相覆盖，只是多走慢路径）；
+// 代价是被换下的旧值要等读过它的线程再次读取或退出后才释放。写者之间由调用方串行化。
+template <typename T>
+class PublishedPtr {
+public:
+    explicit PublishedPtr(std::shared_ptr<const T> initial = nullptr) : ptr_(std::move(initial)), id_(nextId()) {}
+
+    PublishedPtr(const PublishedPtr&) = delete;
+    PublishedPtr& operator=(const PublishedPtr&) = delete;
+
+    std::shared_ptr<const T> load() const {
+        const std::uint64_t v = version_.load(std::memory_order_acquire);
+        Slot& slot = cache()[id_ % kCacheSlots];
+        if (slot.id != id_ || slot.version != v) {
+            slot.value = std::atomic_load(&ptr_);
+            slot.id = id_;
+            slot.version = v;
+        }
+        return slot.value;
+    }
+
+    std::shared_ptr<const T> exchange(std::shared_ptr<const T> next) {
+        auto previous = std::atomic_exchange(&ptr_, std::move(next));
+        version_.fetch_add(1, std::memory_order_release);
+        return previous;
+    }
+    void store(std::shared_ptr<const T> next) { exchange(std::move(next)); }
+
+private:
+    static constexpr std::size_t kCacheSlots = 16;
+
+    struct Slot {
+        std::uint64_t id = 0;
+        std::uint64_t version = 0;
+        std::shared_ptr<const T> value;
+    };
+
+    static Slot* cache() {
+        thread_local Slot slots[kCacheSlots];
+        return slots;
+    }
+    // 编号全局唯一、从 1 开始：发布点销毁后同一地址上的新发布点不会命中旧缓存
+    static std::uint64_t nextId() {
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<const T> ptr_;   // 只通过 std::atomic_load / atomic_exchange 访问
+    std::atomic<std::uint64_t> version_{0};
+    const std::uint64_t id_;
+};
+
+struct StringCell {
+    std::string path;
+    std::string def;
+    PublishedPtr<std::string> value;
+};
+
+} // namespace detail
+
+// 标量配置句柄：创建时解析一次路径，之后 get() 只是一次原子读
+// T 可以是 bool、std::int64_t、int、double
+template <typename T>
+class ConfigHandle {
+    static_assert(std::is_same<T, bool>::value || std::is_same<T, std::int64_t>::value ||
+                      std::is_same<T, int>::value || std::is_same<T, double>::value,
+                  "ConfigHandle supports bool, int, int64_t and double; use ConfigStringHandle for strings");
+
+public:
+    ConfigHandle() = default;
+    T get() const { return cell_->value.load(std::memory_order_relaxed); }
+    const std::string& path() const { return cell_->path; }
+    bool valid() const { return cell_ != nullptr; }
+
+private:
+    friend class ConfigStore;
+    explicit ConfigHandle(std::shared_ptr<detail::HandleCell<T>> cell) : cell_(std::move(cell)) {}
+    std::shared_ptr<detail::HandleCell<T>> cell_;
+};
+
+// 字符串句柄：返回的 shared_ptr 在重新加载后依旧有效
+class ConfigStringHandle {
+public:
+    ConfigStringHandle() = default;
+    std::shared_ptr<const std::string> get() const { return cell_->value.load(); }
+    const std::string& path() const { return cell_->path; }
+    bool valid() const { return cell_ != nullptr; }
+
+private:
+    friend class ConfigStore;
+    explicit ConfigStringHandle(std::shared_ptr<detail::StringCell> cell) : cell_(std::move(cell)) {}
+    std::shared_ptr<detail::StringCell> cell_;
+};
+
+// 当前配置的持有者
+class ConfigStore {
+public:
+    using Listener = std::function<void(const ConfigSnapshot& oldSnapshot, const ConfigSnapshot& newSnapshot)>;
+
+    explicit ConfigStore(std::shared_ptr<ConfigSnapshot> initial);
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    // 当前快照；持有返回值期间快照不会被释放
+    std::shared_ptr<const ConfigSnapshot> snapshot() const { return current_.load(); }
+    std::uint64_t version() const { return snapshot()->version(); }
+
+    // 替换当前快照：分配新版本号，刷新所有句柄，然后按注册顺序通知监听者
+    // 多个线程同时 publish 时串行执行；读者不受影响
+    // 同一个快照只能发布一次（版本号写在快照上），重复发布抛 std::invalid_argument
+    // 监听者抛出的异常不影响快照替换和其它监听者：全部通知完后重新抛出第一个异常
+    void publish(std::shared_ptr<ConfigSnapshot> next);
+
+    template <typename T>
+    ConfigHandle<T> handle(const std::string& path, T def);
+    ConfigStringHandle stringHandle(const std::string& path, const std::string& def = std::string());
+
+    // 监听在 publish 的线程上同步调用；返回的编号用于 removeListener
+    std::size_t addListener(Listener listener);
+    // 只在 prefix 子树的内容变化时调用 fn(新快照)，例如 subscribe("log", ...) 只关心日志配置
+    std::size_t subscribe(const std::string& prefix, std::function<void(const ConfigSnapshot&)> fn);
+    void removeListener(std::size_t id);
+
+private:
+    template <typename T>
+    static void refresh(detail::HandleCell<T>& cell, const ConfigSnapshot& snap) {
+        cell.value.store(snap.get<T>(cell.path, cell.def), std::memory_order_relaxed);
+    }
+    static void refresh(detail::StringCell& cell, const ConfigSnapshot& snap);
+
+    template <typename T>
+    std::vector<std::weak_ptr<detail::HandleCell<T>>>& cells();
+
+    detail::PublishedPtr<ConfigSnapshot> current_;
+
+    std::mutex publishMutex_;   // 串行化 publish（含监听回调）
+
+    // 以下只在持有 mutex_ 时访问
+    mutable std::mutex mutex_;
+    std::uint64_t nextVersion_ = 1;
+    std::vector<std::weak_ptr<detail::HandleCell<bool>>> boolCells_;
+    std::vector<std::weak_ptr<detail::HandleCell<int>>> intCells_;
+    std::vector<std::weak_ptr<detail::HandleCell<std::int64_t>>> int64Cells_;
+    std::vector<std::weak_ptr<detail::HandleCell<double>>> doubleCells_;
+    std::vector<std::weak_ptr<detail::StringCell>> stringCells_;
+    std::vector<std::pair<std::size_t, Listener>> listeners_;
+    std::size_t nextListenerId_ = 1;
+};
+
+template <>
+inline std::vector<std::weak_ptr<detail::HandleCell<bool>>>& ConfigStore::cells<bool>() { return boolCells_; }
+template <>
+inline std::vector<std::weak_ptr<detail::HandleCell<int>>>& ConfigStore::cells<int>() { return intCells_; }
+template <>
+inline std::vector<std::weak_ptr<detail::HandleCell<std::int64_t>>>& ConfigStore::cells<std::int64_t>() {
+    return int64Cells_;
+}
+template <>
+inline std::vector<std::weak_ptr<detail::HandleCell<double>>>& ConfigStore::cells<double>() { return doubleCells_; }
+
+template <typename T>
+ConfigHandle<T> ConfigStore::handle(const std::string& path, T def)
+{
+    auto cell = std::make_shared<detail::HandleCell<T>>(path, def);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 在锁内读取当前快照，保证不会错过并发的 publish
+    refresh(*cell, *current_.load());
+    auto& list = cells<T>();
+    list.erase(std::remove_if(list.begin(), list.end(), [](const auto& w) { return w.expired(); }), list.end());
+    list.push_back(cell);
+    return ConfigHandle<T>(std::move(cell));
+}
+
+} // namespace config
+} // namespace foundation
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace foundation {
+namespace json {
+
+// 事件式（SAX）JSON 解析
+// json_facade 基于 DOM，整棵树都要建出来；几 MB 的行情接口响应里真正要的只是某个数组的元素，
+// 建 DOM 的分配和拷贝远大于解析本身。这里直接扫描输入并回调，不建节点；堆上只有嵌套栈和转义解码缓冲区，
+// 它们随最深的嵌套和最长的转义字符串增长，与文档大小无关：
+//   - 字符串没有转义时回调拿到的是指向输入缓冲区的 string_view，零拷贝；
+//     有转义时解码到内部缓冲区，view 只在本次回调内有效
+//   - 在字符串内部查找引号/反斜杠、跳过空白时用 SSE2 一次检查 16 字节（无 SSE2 时逐字节）
+//   - 迭代实现，嵌套深度只受 maxDepth 限制，不会栈溢出
+//
+// 回调返回 false 表示提前结束（例如已经拿到需要的字段），此时 parse 返回的 stopped 为 true。
+
+class JsonSaxHandler {
+public:
+    virtual ~JsonSaxHandler() = default;
+
+    virtual bool onNull() { return true; }
+    virtual bool onBool(bool) { return true; }
+    // 没有小数点和指数、且在 int64 范围内的数字走 onInt，其它（包括 -0）走 onDouble
+    virtual bool onInt(std::int64_t) { return true; }
+    virtual bool onDouble(double) { return true; }
+    virtual bool onString(std::string_view) { return true; }
+    virtual bool onKey(std::string_view) { return true; }
+    virtual bool onStartObject() { return true; }
+    virtual bool onEndObject() { return true; }
+    virtual bool onStartArray() { return true; }
+    virtual bool onEndArray() { return true; }
+};
+
+struct JsonSaxOptions {
+    std::size_t maxDepth = 512;
+    bool allowComments = false;   // 允许 // 与 /* */ 注释（配置文件）
+};
+
+struct JsonSaxResult {
+    bool ok = false;
+    bool stopped = false;     // 回调要求提前结束（ok 仍为 true）
+    std::size_t offset = 0;   // 出错或停止的位置（字节偏移）
+    std::string error;
+
+    explicit operator bool() const { return ok; }
+};
+
+JsonSaxResult parseJsonSax(std::string_view text, JsonSaxHandler& handler,
+                           const JsonSaxOptions& options = JsonSaxOptions());
+
+// 把数字文本转换为 double / int64（不依赖 locale），整段匹配才算成功；
+// 供接口里"数字放在字符串里"的字段（"7.10"）使用
+bool parseJsonNumber(std::string_view s, double& out);
+bool parseJsonNumber(std::string_view s, std::int64_t& out);
+
+} // namespace json
+} // namespace foundation
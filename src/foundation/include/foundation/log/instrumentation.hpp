@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "foundation/Utils/LatencyHistogram.h"
+#include "foundation/log/metrics.hpp"
+
+// rdtsc 只在 x86/x64 上可用；MSVC ARM64 等其它目标走 steady_clock
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ASTOCK_PROBE_RDTSC 1
+#elif !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define ASTOCK_PROBE_RDTSC 1
+#endif
+
+// 编译期总开关；关闭后 ENGINE_PROBE 展开为空
+#ifndef ASTOCK_ENABLE_PROBES
+#define ASTOCK_ENABLE_PROBES 1
+#endif
+
+namespace foundation {
+namespace metrics {
+
+// 回测/实盘链路的阶段划分
+enum class Stage : std::uint8_t {
+    DataDecode,        // BarJsonReader 解析行情
+    Dispatch,          // QuotePipeline 把一笔行情交给处理函数
+    IndicatorUpdate,   // IndicatorCache::onBar
+    SignalEval,        // SignalExpression / SignalStream / BatchSignals 计算
+    StrategyStep,      // PortfolioRunner 一根 bar 上所有策略的 onBar
+    OrderSimulation,   // PortfolioRunner 一根 bar 的撮合结算
+    Count
+};
+
+const char* stageName(Stage stage);
+
+// 内置打点
+// 关键路径上放 ENGINE_PROBE(stage)，作用域结束时记录耗时到本线程的直方图。
+// 放在 foundation 里是因为 domain 层（指标、信号、行情解析、组合回测）也要打点。
+// 每个线程第一次打点时注册一份自己的直方图，之后的记录只写本线程的数据（无锁、无共享写），
+// dump 时再把所有线程的数据合并；线程退出时它的直方图并入一份归档后释放。
+//
+//   void IndicatorCache::onBar(std::uint32_t symbolId, std::uint64_t barSeq, double price) {
+//       ENGINE_PROBE(foundation::metrics::Stage::IndicatorUpdate);
+//       ...
+//   }
+//
+//   std::cout << foundation::metrics::Instrumentation::report();
+//
+// 计时源：x86/x64 上用 rdtsc，换算系数由 calibrate() 对 steady_clock 校准，其它平台（含 MSVC ARM64）
+// 用 steady_clock。跑之前先调用一次 calibrate()，校准的 20ms 等待不落在任何探针里；
+// 没校准就打点时，第一次换算只做约 100us 的粗校准，之后 calibrate() 会覆盖这个系数。
+// 运行时可以用 setEnabled(false) 关掉，关掉后每个探针只剩一次 relaxed 读。
+class Instrumentation {
+public:
+    struct StageSummary {
+        Stage stage;
+        std::uint64_t count = 0;
+        double totalMillis = 0.0;
+        double meanMicros = 0.0;
+        double p50Micros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+    };
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+
+    // 当前计时读数（rdtsc 周期或纳秒）
+    static std::uint64_t now() {
+#if defined(ASTOCK_PROBE_RDTSC)
+        return __rdtsc();
+#else
+        return foundation::utils::steadyNanos();
+#endif
+    }
+    // 计时读数差 -> 纳秒
+    static std::uint64_t toNanos(std::uint64_t ticks);
+    // 在 window 时长内对 steady_clock 校准换算系数，返回每纳秒的计时读数；可重复调用
+    static double calibrate(std::chrono::nanoseconds window = std::chrono::milliseconds(20));
+    static bool calibrated() { return nanosPerTick_.load(std::memory_order_relaxed) > 0.0; }
+    // 回到未校准状态（测试用）
+    static void resetCalibration();
+
+    // 记录一次耗时（纳秒）到本线程
+    static void record(Stage stage, std::uint64_t nanos);
+
+    // 合并所有线程的数据（含已退出线程归档的部分）
+    static StageSummary summary(Stage stage);
+    static std::array<StageSummary, static_cast<std::size_t>(Stage::Count)> snapshot();
+    // 表格文本，每个阶段一行
+    static std::string report();
+    // 清零所有线程的数据（线程注册保留）；与打点并发时个别样本可能残留
+    static void reset();
+    // 当前登记的存活线程数；线程退出时数据并入归档并注销
+    static std::size_t threadCount();
+    // 各阶段样本数、累计耗时与 p50/p99/max 挂到全局指标注册表（标签 engine="name", stage=...），
+    // 导出时才合并；返回的句柄析构时注销
+    [[nodiscard]] static std::vector<CallbackHandle> bindMetrics(const std::string& name);
+
+private:
+    static std::atomic<bool> enabled_;
+    static std::atomic<double> nanosPerTick_;   // 0 表示尚未校准
+};
+
+// RAII 探针
+class ScopedProbe {
+public:
+    explicit ScopedProbe(Stage stage)
+        : stage_(stage), start_(Instrumentation::enabled() ? Instrumentation::now() : 0) {}
+    ~ScopedProbe() {
+        if (start_ != 0) Instrumentation::record(stage_, Instrumentation::toNanos(Instrumentation::now() - start_));
+    }
+
+    ScopedProbe(const ScopedProbe&) = delete;
+    ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+private:
+    Stage stage_;
+    std::uint64_t start_;
+};
+
+} // namespace metrics
+} // namespace foundation
+
+#define ENGINE_PROBE_CONCAT_INNER(a, b) a##b
+#define ENGINE_PROBE_CONCAT(a, b) ENGINE_PROBE_CONCAT_INNER(a, b)
+
+#if ASTOCK_ENABLE_PROBES
+#define ENGINE_PROBE(stage) ::foundation::metrics::ScopedProbe ENGINE_PROBE_CONCAT(engineProbe_, __LINE__)(stage)
+#else
+#define ENGINE_PROBE(stage) ((void)0)
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "foundation/Utils/LatencyHistogram.h"
+
+namespace foundation {
+namespace metrics {
+
+// 指标子系统
+// 计数器、仪表、直方图按名字（+ 标签）注册在全局 MetricsRegistry 里，
+// 调用方拿到引用后缓存起来，热路径上只做一次无竞争的原子操作：
+//
+//   static auto& requests = MetricsRegistry::instance().counter("net_requests_total", {{"host", "sina"}});
+//   requests.inc();
+//
+//   static auto& latency = MetricsRegistry::instance().histogram("net_request_latency_ns");
+//   latency.record(elapsedNanos);
+//
+// 计数器与直方图分成 kMetricShards 个分片：线程第一次写入时按顺序轮流分到一个分片，之后固定写它，
+// 读取时求和/合并。线程数不超过分片数时各写各的缓存行；超过后多个线程共享分片（原子操作仍然正确，
+// 只是会有争用）。
+// 队列深度、缓存命中率这类"拉取型"数据用 gaugeCallback 注册回调，导出时才读取；
+// 对象内部已经累计好的单调计数（命中次数等）用 counterCallback，导出类型为 counter。
+// 回调句柄析构时自动注销（会等正在进行的那次调用结束），回调里捕获的对象可以安全销毁。
+// 回调在注册表锁外调用，回调里可以读写其它指标，但不能注销自己。
+//
+// 导出：exportText() 为 Prometheus 文本格式，writeJsonFile() 写 JSON 快照。
+
+using Labels = std::map<std::string, std::string>;
+
+constexpr std::size_t kMetricShards = 16;
+
+// 当前线程使用的分片号（线程首次调用时轮流分配，取模 kMetricShards）
+std::size_t threadShard();
+
+class Counter {
+public:
+    void inc(std::uint64_t n = 1) { cells_[threadShard()].value.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const;
+    void reset();
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> value{0};
+    };
+    std::array<Cell, kMetricShards> cells_;
+};
+
+class Gauge {
+public:
+    void set(double v) { value_.store(v, std::memory_order_relaxed); }
+    void add(double d);
+    double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value_{0.0};
+};
+
+class Histogram {
+public:
+    void record(std::uint64_t v) { shards_[threadShard()].record(v); }
+    // 合并各分片
+    void snapshot(foundation::utils::LatencyHistogram& out) const;
+    void reset();
+
+private:
+    std::array<foundation::utils::LatencyHistogram, kMetricShards> shards_;
+};
+
+class MetricsRegistry;
+
+// 回调注册句柄；析构时注销
+class CallbackHandle {
+public:
+    CallbackHandle() = default;
+    ~CallbackHandle() { release(); }
+    CallbackHandle(CallbackHandle&& o) noexcept : registry_(o.registry_), id_(o.id_) { o.id_ = 0; }
+    CallbackHandle& operator=(CallbackHandle&& o) noexcept;
+    CallbackHandle(const CallbackHandle&) = delete;
+    CallbackHandle& operator=(const CallbackHandle&) = delete;
+
+    void release();
+    bool active() const { return id_ != 0; }
+
+private:
+    friend class MetricsRegistry;
+    CallbackHandle(MetricsRegistry* registry, std::uint64_t id) : registry_(registry), id_(id) {}
+    MetricsRegistry* registry_ = nullptr;
+    std::uint64_t id_ = 0;
+};
+
+struct MetricSample {
+    enum class Type { Counter, Gauge, Histogram };
+    std::string name;
+    Labels labels;
+    Type type = Type::Counter;
+    double value = 0.0;            // 计数器/仪表的值
+    std::uint64_t count = 0;       // 直方图
+    double sum = 0.0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p90 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t max = 0;
+};
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    MetricsRegistry();
+    ~MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // 同名同标签返回同一个对象；引用在注册表生命周期内有效
+    // 名字只能包含 [a-zA-Z0-9_:]，同名不同类型或同名同标签已注册为回调时抛 std::invalid_argument
+    Counter& counter(const std::string& name, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const Labels& labels = {});
+    Histogram& histogram(const std::string& name, const Labels& labels = {});
+
+    // 导出时调用 fn 取值，分别作为仪表 / 计数器输出（fn 须单调不减）。
+    // 与已注册的同名指标类型不同，或同名同标签已有对象/回调时抛 std::invalid_argument
+    [[nodiscard]] CallbackHandle gaugeCallback(const std::string& name, const Labels& labels,
+                                               std::function<double()> fn);
+    [[nodiscard]] CallbackHandle counterCallback(const std::string& name, const Labels& labels,
+                                                 std::function<double()> fn);
+
+    std::vector<MetricSample> snapshot() const;
+    std::string exportText() const;
+    std::string exportJson() const;
+    // 先写临时文件再改名
+    void writeJsonFile(const std::string& path) const;
+
+    // 所有计数器与直方图清零（测试用）
+    void resetAll();
+
+private:
+    friend class CallbackHandle;
+    CallbackHandle addCallback(const std::string& name, const Labels& labels, MetricSample::Type type,
+                               std::function<double()> fn);
+    void unregister(std::uint64_t id);
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace metrics
+} // namespace foundation
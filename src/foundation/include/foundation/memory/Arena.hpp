@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace foundation {
+namespace memory {
+
+// 短生命周期内存
+// 回测里大量对象只活一根 bar（订单、事件、排序用的临时数组）或一次回测，逐个 new/delete
+// 既慢又让分配器碎片化。这里提供几种 std::pmr::memory_resource，配合 std::pmr 容器使用：
+//
+//   MonotonicArena   单调分配，释放是空操作，reset() 一次性作废全部内存；
+//                    已申请的块保留复用，稳定运行后不再向上游申请
+//   threadLocalPool  每线程一个按尺寸分桶的池，适合频繁分配/释放的小对象
+//   CountingResource 转发给上游并计数，用来观察分配次数
+//
+//   MonotonicArena scratch(64 * 1024);
+//   for (...) {
+//       std::pmr::vector<Order> orders(&scratch);
+//       ...
+//       scratch.reset();   // orders 之类的容器必须已经析构
+//   }
+//
+// 这些资源都不是线程安全的（CountingResource 的计数器除外），一个资源只在一个线程上使用。
+
+// 转发给上游并统计次数和字节数
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    std::uint64_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+    std::uint64_t deallocations() const { return deallocations_.load(std::memory_order_relaxed); }
+    std::uint64_t bytesAllocated() const { return bytes_.load(std::memory_order_relaxed); }
+    // 当前未释放的字节数
+    std::uint64_t liveBytes() const { return live_.load(std::memory_order_relaxed); }
+    void resetCounters();
+
+    std::pmr::memory_resource* upstream() const { return upstream_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::atomic<std::uint64_t> allocations_{0};
+    std::atomic<std::uint64_t> deallocations_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> live_{0};
+};
+
+// 单调分配器
+// 与 std::pmr::monotonic_buffer_resource 的区别：release() 之后后者会把块全部还给上游，
+// 每根 bar 重置一次就意味着每根 bar 都要重新 malloc；MonotonicArena::reset() 保留已有的块，
+// 块多于一个时合并成一个总容量相同的块，之后的轮次只在一块连续内存里移动指针。
+class MonotonicArena : public std::pmr::memory_resource {
+public:
+    // initialChunk：第一次向上游申请的块大小，之后按 2 倍增长
+    explicit MonotonicArena(std::size_t initialChunk = 4096,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    // 先使用调用方提供的缓冲区（比如栈上数组），用完再向上游申请；缓冲区不归 arena 所有
+    MonotonicArena(void* buffer, std::size_t size,
+                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~MonotonicArena() override;
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    // 作废已分配的全部内存，保留块供下一轮使用
+    void reset();
+    // 作废并把块还给上游（调用方的缓冲区保留）
+    void release();
+
+    std::size_t used() const { return used_; }              // 自上次 reset 起分配出去的字节数（含对齐填充）
+    std::size_t capacity() const { return capacity_; }      // 持有的块总大小
+    std::size_t peak() const { return peak_; }              // 历史最大 used
+    std::size_t chunkCount() const { return chunks_.size(); }
+    std::uint64_t upstreamAllocations() const { return upstreamAllocations_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Chunk {
+        char* data;
+        std::size_t size;
+        bool owned;
+    };
+
+    void* allocateSlow(std::size_t bytes, std::size_t alignment);
+    void freeOwnedChunks();
+
+    std::pmr::memory_resource* upstream_;
+    std::vector<Chunk> chunks_;
+    std::size_t current_ = 0;      // 正在使用的块
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t nextChunk_;
+    std::size_t used_ = 0;
+    std::size_t capacity_ = 0;
+    std::size_t peak_ = 0;
+    std::uint64_t upstreamAllocations_ = 0;
+};
+
+// 作用域结束时 reset
+class ArenaResetGuard {
+public:
+    explicit ArenaResetGuard(MonotonicArena& arena) : arena_(arena) {}
+    ~ArenaResetGuard() { arena_.reset(); }
+
+    ArenaResetGuard(const ArenaResetGuard&) = delete;
+    ArenaResetGuard& operator=(const ArenaResetGuard&) = delete;
+
+private:
+    MonotonicArena& arena_;
+};
+
+// 当前线程的池分配器（std::pmr::unsynchronized_pool_resource，上游为 new/delete）。
+// 从这里分配的内存必须在同一个线程上释放，且不能活过线程本身——线程退出时池被销毁。
+std::pmr::memory_resource* threadLocalPool();
+
+} // namespace memory
+} // namespace foundation
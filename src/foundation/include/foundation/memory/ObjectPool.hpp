@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace foundation {
+namespace memory {
+
+// 定类型对象池
+// 订单、成交这类对象高频创建销毁，每次 new/delete 都要进全局分配器。对象池按块（kChunkSlots 个槽位）
+// 向上游申请内存，销毁的槽位挂进空闲链表，下次创建直接复用；池子长到稳定大小后不再分配任何内存。
+// 槽位按 Align（默认缓存行）对齐，相邻对象不会落在同一条缓存行上；块不搬移，对象地址在销毁前一直有效。
+//
+// 对外给的是句柄（槽位下标 + 代数）而不是指针：槽位每次销毁代数加一，旧句柄的代数对不上，
+//   get(h)         总是检查代数，过期句柄返回 nullptr
+//   operator[](h)  不检查，Debug 下用断言捕获"释放后使用"
+//
+//   ObjectPool<Order> orders;
+//   orders.reserve(4096);                 // 预热，之后的 create 不再分配
+//   auto h = orders.create(symbol, qty);
+//   orders[h].filled += q;
+//   orders.destroy(h);                    // h 从此失效，orders.get(h) == nullptr
+//
+// 不是线程安全的：每个线程用自己的池（见 threadLocalObjectPool），句柄不能跨池使用。
+
+constexpr std::size_t kCacheLineSize = 64;
+
+template <typename T>
+class PoolHandle {
+public:
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    PoolHandle() = default;
+
+    bool valid() const { return index_ != kInvalidIndex; }
+    std::uint32_t index() const { return index_; }
+    std::uint32_t generation() const { return generation_; }
+
+    bool operator==(const PoolHandle& o) const { return index_ == o.index_ && generation_ == o.generation_; }
+    bool operator!=(const PoolHandle& o) const { return !(*this == o); }
+
+private:
+    template <typename, std::size_t> friend class ObjectPool;
+    PoolHandle(std::uint32_t index, std::uint32_t generation) : index_(index), generation_(generation) {}
+
+    std::uint32_t index_ = kInvalidIndex;
+    std::uint32_t generation_ = 0;
+};
+
+template <typename T, std::size_t Align = kCacheLineSize>
+class ObjectPool {
+public:
+    using Handle = PoolHandle<T>;
+    static constexpr std::size_t kChunkSlots = 256;
+
+    explicit ObjectPool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) : upstream_(upstream) {}
+
+    ~ObjectPool() {
+        clear();
+        for (Slot* chunk : chunks_) upstream_->deallocate(chunk, sizeof(Slot) * kChunkSlots, alignof(Slot));
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    Handle create(Args&&... args) {
+        if (freeHead_ == kNone) grow();
+        const std::uint32_t index = freeHead_;
+        Slot& s = slot(index);
+        ::new (static_cast<void*>(s.storage)) T(std::forward<Args>(args)...);
+        freeHead_ = s.nextFree;
+        ++s.generation;   // 变为奇数：存活
+        ++size_;
+        return Handle(index, s.generation);
+    }
+
+    // 过期或无效句柄返回 false，不做任何事
+    bool destroy(Handle h) {
+        if (!contains(h)) return false;
+        Slot& s = slot(h.index_);
+        object(s)->~T();
+        ++s.generation;   // 变为偶数：空闲
+        s.nextFree = freeHead_;
+        freeHead_ = h.index_;
+        --size_;
+        return true;
+    }
+
+    bool contains(Handle h) const {
+        return h.index_ < capacity() && slot(h.index_).generation == h.generation_ && (h.generation_ & 1u);
+    }
+
+    T* get(Handle h) { return contains(h) ? object(slot(h.index_)) : nullptr; }
+    const T* get(Handle h) const { return contains(h) ? object(slot(h.index_)) : nullptr; }
+
+    T& operator[](Handle h) {
+        assert(contains(h) && "ObjectPool: stale or invalid handle");
+        return *object(slot(h.index_));
+    }
+    const T& operator[](Handle h) const {
+        assert(contains(h) && "ObjectPool: stale or invalid handle");
+        return *object(slot(h.index_));
+    }
+
+    // 预先分配至少 n 个槽位
+    void reserve(std::size_t n) {
+        while (capacity() < n) grow();
+    }
+
+    // 销毁所有存活对象（保留内存）；所有句柄失效
+    void clear() {
+        for (std::uint32_t i = 0; i < capacity(); ++i) {
+            Slot& s = slot(i);
+            if (s.generation & 1u) destroy(Handle(i, s.generation));
+        }
+    }
+
+    // 按槽位顺序访问存活对象：f(Handle, T&)
+    template <typename F>
+    void forEach(F&& f) {
+        for (std::uint32_t i = 0; i < capacity(); ++i) {
+            Slot& s = slot(i);
+            if (s.generation & 1u) f(Handle(i, s.generation), *object(s));
+        }
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::uint32_t capacity() const { return static_cast<std::uint32_t>(chunks_.size() * kChunkSlots); }
+    // 向上游申请块的次数；稳定运行后不再增长
+    std::size_t chunkAllocations() const { return chunks_.size(); }
+
+private:
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+    static constexpr std::size_t kSlotAlign = Align > alignof(T) ? Align : alignof(T);
+
+    struct alignas(kSlotAlign) Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::uint32_t generation;   // 奇数存活，偶数空闲
+        std::uint32_t nextFree;
+    };
+
+    static T* object(Slot& s) { return std::launder(reinterpret_cast<T*>(s.storage)); }
+    static const T* object(const Slot& s) { return std::launder(reinterpret_cast<const T*>(s.storage)); }
+
+    Slot& slot(std::uint32_t i) { return chunks_[i / kChunkSlots][i % kChunkSlots]; }
+    const Slot& slot(std::uint32_t i) const { return chunks_[i / kChunkSlots][i % kChunkSlots]; }
+
+    void grow() {
+        if (capacity() > kNone - kChunkSlots) throw std::length_error("ObjectPool: too many objects");
+        chunks_.reserve(chunks_.size() + 1);
+        auto* chunk = static_cast<Slot*>(upstream_->allocate(sizeof(Slot) * kChunkSlots, alignof(Slot)));
+        const auto base = capacity();
+        // 新块的槽位按下标顺序挂到空闲链表头部，先用下标小的
+        for (std::uint32_t i = 0; i < kChunkSlots; ++i) {
+            chunk[i].generation = 0;
+            chunk[i].nextFree = i + 1 < kChunkSlots ? base + i + 1 : freeHead_;
+        }
+        chunks_.push_back(chunk);
+        freeHead_ = base;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::vector<Slot*> chunks_;
+    std::uint32_t freeHead_ = kNone;
+    std::size_t size_ = 0;
+};
+
+// 当前线程的 T 对象池（线程退出时销毁），适合每个回测线程各自独占的场合
+template <typename T, std::size_t Align = kCacheLineSize>
+ObjectPool<T, Align>& threadLocalObjectPool()
+{
+    thread_local ObjectPool<T, Align> pool;
+    return pool;
+}
+
+} // namespace memory
+} // namespace foundation
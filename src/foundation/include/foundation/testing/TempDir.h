@@ -0,0 +1,32 @@
+#pragma once
+
+// 仅供 gtest 测试使用：依赖 gtest，库代码不要包含
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace foundation {
+namespace testutil {
+
+// 当前测试独占的空临时目录 <tmp>/<prefix>_<随机种子>_<测试名>，已存在则先清空。
+// 名字带 gtest 随机种子，同一台机器上并行跑的多个测试进程互不干扰；
+// 参数化测试名中的 '/' 换成 '_'。调用方在 TearDown 里 remove_all
+inline std::filesystem::path freshTempDir(const std::string& prefix)
+{
+    const auto* unit = ::testing::UnitTest::GetInstance();
+    const auto* info = unit->current_test_info();
+    std::string name = info ? std::string(info->test_suite_name()) + "_" + info->name() : std::string("global");
+    for (auto& c : name) {
+        if (c == '/') c = '_';
+    }
+    const auto dir =
+        std::filesystem::temp_directory_path() / (prefix + "_" + std::to_string(unit->random_seed()) + "_" + name);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+} // namespace testutil
+} // namespace foundation
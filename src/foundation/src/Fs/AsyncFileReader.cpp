@@ -0,0 +1,536 @@
+#include "foundation/Fs/AsyncFileReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace foundation {
+namespace fs {
+
+const char* asyncReaderBackendName(AsyncReaderBackend backend)
+{
+    switch (backend) {
+    case AsyncReaderBackend::Auto: return "auto";
+    case AsyncReaderBackend::IoUring: return "io_uring";
+    case AsyncReaderBackend::ThreadPool: return "thread_pool";
+    }
+    return "unknown";
+}
+
+namespace {
+
+struct Request {
+    std::string path;
+    std::uint64_t tag = 0;
+    AsyncReadCallback callback;
+};
+
+AsyncReadResult makeError(Request& req, int error, const char* what)
+{
+    AsyncReadResult r;
+    r.path = std::move(req.path);
+    r.tag = req.tag;
+    r.error = error;
+    r.message = std::string(what) + " " + r.path + ": " + std::system_category().message(error);
+    return r;
+}
+
+#if defined(__linux__)
+
+// 打开文件并取大小；失败返回 -errno
+int openForRead(const std::string& path, std::size_t& size)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -errno;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return -err;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return -EISDIR;
+    }
+    size = static_cast<std::size_t>(st.st_size);
+    // 整个文件马上要读完，提示内核加大预读
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return fd;
+}
+
+// 大小未知时读到 EOF：/proc、sysfs 之类的伪文件 st_size 为 0 但有内容；成功返回 0，失败返回 errno
+int readUntilEof(int fd, std::string& data)
+{
+    std::size_t done = 0;
+    data.resize(4096);
+    for (;;) {
+        if (done == data.size()) data.resize(data.size() * 2);
+        const ssize_t n = ::pread(fd, &data[done], data.size() - done, static_cast<off_t>(done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        if (n == 0) break;
+        done += static_cast<std::size_t>(n);
+    }
+    data.resize(done);
+    return 0;
+}
+
+#endif
+
+// 同步读整个文件（线程池后端）
+AsyncReadResult readWholeFile(Request& req)
+{
+#if defined(__linux__)
+    std::size_t size = 0;
+    const int fd = openForRead(req.path, size);
+    if (fd < 0) return makeError(req, -fd, "cannot open");
+    AsyncReadResult r;
+    if (size == 0) {
+        const int err = readUntilEof(fd, r.data);
+        ::close(fd);
+        if (err) return makeError(req, err, "cannot read");
+    } else {
+        r.data.resize(size);
+        std::size_t done = 0;
+        while (done < size) {
+            const ssize_t n = ::pread(fd, &r.data[done], size - done, static_cast<off_t>(done));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                const int err = errno;
+                ::close(fd);
+                return makeError(req, err, "cannot read");
+            }
+            if (n == 0) break;   // 读的过程中被截断
+            done += static_cast<std::size_t>(n);
+        }
+        ::close(fd);
+        r.data.resize(done);
+    }
+#else
+    std::ifstream in(req.path, std::ios::binary);
+    if (!in) return makeError(req, errno ? errno : ENOENT, "cannot open");
+    AsyncReadResult r;
+    r.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad()) return makeError(req, errno ? errno : EIO, "cannot read");
+#endif
+    r.path = std::move(req.path);
+    r.tag = req.tag;
+    return r;
+}
+
+#if defined(__linux__)
+
+// 最小的 io_uring 封装：直接用系统调用和共享内存环，不依赖 liburing。
+// 只由 I/O 线程使用，不需要加锁；与内核之间的同步靠环头尾指针的 acquire/release。
+class Uring {
+public:
+    explicit Uring(unsigned entries) {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+        if (fd_ < 0) throw std::runtime_error(error("io_uring_setup"));
+        entries_ = p.sq_entries;
+
+        sqRingSize_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqRingSize_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) {
+            sqRing_ = nullptr;
+            throw std::runtime_error(error("mmap sq ring"));
+        }
+        if (single) {
+            cqRing_ = sqRing_;
+        } else {
+            cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                             IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) {
+                cqRing_ = nullptr;
+                throw std::runtime_error(error("mmap cq ring"));
+            }
+        }
+        sqesSize_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) throw std::runtime_error(error("mmap sqes"));
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        auto* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        localTail_ = *sqTail_;
+    }
+
+    ~Uring() {
+        if (sqes_) ::munmap(sqes_, sqesSize_);
+        if (cqRing_ && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+        if (sqRing_) ::munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    unsigned entries() const { return entries_; }
+
+    // 准备一个 readv；提交队列满时返回 false
+    bool prepareReadv(int fd, const iovec* iov, std::uint64_t offset, std::uint64_t userData) {
+        const unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (localTail_ - head >= entries_) return false;
+        const unsigned index = localTail_ & sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        // READV 从 5.1 起可用，比 READ（5.6）兼容更老的内核
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(iov);
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = userData;
+        sqArray_[index] = index;
+        ++localTail_;
+        ++unsubmitted_;
+        return true;
+    }
+
+    // 提交已准备的请求，并至少等待 waitFor 个完成；意外的错误（ENOMEM 等）抛 std::runtime_error
+    void submitAndWait(unsigned waitFor) {
+        __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+        for (;;) {
+            const unsigned flags = waitFor ? IORING_ENTER_GETEVENTS : 0;
+            const long ret = ::syscall(__NR_io_uring_enter, fd_, unsubmitted_, waitFor, flags, nullptr, 0);
+            if (ret >= 0) {
+                unsubmitted_ -= std::min<unsigned>(unsubmitted_, static_cast<unsigned>(ret));
+                return;
+            }
+            // 完成队列暂时放不下时先去收割，下一轮再提交
+            if (errno == EAGAIN || errno == EBUSY) return;
+            if (errno != EINTR) throw std::runtime_error(error("io_uring_enter"));
+        }
+    }
+
+    template <typename F>
+    void reap(F&& onCompletion) {
+        unsigned head = *cqHead_;
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cqMask_];
+            const std::uint64_t userData = cqe.user_data;
+            const int res = cqe.res;
+            ++head;
+            // 先把槽位还给内核，回调里可能继续提交
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+            onCompletion(userData, res);
+        }
+    }
+
+private:
+    static std::string error(const char* what) {
+        return std::string("AsyncFileReader: ") + what + ": " + std::system_category().message(errno);
+    }
+
+    int fd_ = -1;
+    unsigned entries_ = 0;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    std::size_t sqRingSize_ = 0;
+    std::size_t cqRingSize_ = 0;
+    std::size_t sqesSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned localTail_ = 0;
+    unsigned unsubmitted_ = 0;
+};
+
+#endif
+
+} // namespace
+
+struct AsyncFileReader::Impl {
+    AsyncReaderOptions options;
+    std::atomic<AsyncReaderBackend> actual{AsyncReaderBackend::ThreadPool};
+
+    mutable std::mutex mutex;
+    std::condition_variable workCv;   // 有新请求或要停止
+    std::condition_variable idleCv;   // outstanding 归零
+    std::deque<Request> queue;
+    std::size_t outstanding = 0;
+    bool stopping = false;
+
+    std::vector<std::thread> threads;
+#if defined(__linux__)
+    struct InFlight;
+    // 环出错时仍在内核手里的请求：缓冲区可能还会被写，必须比 ring 活得久（成员按声明逆序析构）
+    std::vector<std::unique_ptr<InFlight>> abandoned;
+    std::unique_ptr<Uring> ring;
+#endif
+
+    explicit Impl(AsyncReaderOptions opts) : options(std::move(opts)) {
+        options.queueDepth = std::max<std::size_t>(1, options.queueDepth);
+        options.ioThreads = std::max<std::size_t>(1, options.ioThreads);
+#if defined(__linux__)
+        if (options.backend != AsyncReaderBackend::ThreadPool) {
+            try {
+                ring = std::make_unique<Uring>(static_cast<unsigned>(std::min<std::size_t>(options.queueDepth, 4096)));
+                actual = AsyncReaderBackend::IoUring;
+            } catch (const std::runtime_error&) {
+                // 老内核或容器 seccomp 禁用了 io_uring
+                if (options.backend == AsyncReaderBackend::IoUring) throw;
+            }
+        }
+#else
+        if (options.backend == AsyncReaderBackend::IoUring) {
+            throw std::runtime_error("AsyncFileReader: io_uring is not available on this platform");
+        }
+#endif
+        if (actual == AsyncReaderBackend::IoUring) {
+            threads.emplace_back([this] { runRing(); });
+        } else {
+            for (std::size_t i = 0; i < options.ioThreads; ++i) threads.emplace_back([this] { runPool(); });
+        }
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workCv.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    void deliver(AsyncReadCallback callback, AsyncReadResult&& result) {
+        if (options.dispatch) {
+            try {
+                options.dispatch([cb = std::move(callback), r = std::move(result)]() mutable { cb(std::move(r)); });
+            } catch (...) {
+                // 派发失败（线程池已关闭）不能打断 I/O 线程
+            }
+        } else {
+            try {
+                callback(std::move(result));
+            } catch (...) {
+                // 回调的异常不能打断 I/O 线程
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--outstanding == 0) idleCv.notify_all();
+    }
+
+    // ---------- 线程池后端 ----------
+
+    void runPool() {
+        for (;;) {
+            Request req;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                workCv.wait(lock, [&] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                req = std::move(queue.front());
+                queue.pop_front();
+            }
+            AsyncReadCallback cb = std::move(req.callback);
+            deliver(std::move(cb), readWholeFile(req));
+        }
+    }
+
+#if defined(__linux__)
+    // ---------- io_uring 后端 ----------
+
+    struct InFlight {
+        Request req;
+        int fd = -1;
+        std::string data;
+        std::size_t done = 0;
+        iovec iov{};
+    };
+
+    void runRing() {
+        const std::size_t depth = std::min<std::size_t>(options.queueDepth, ring->entries());
+        std::vector<std::unique_ptr<InFlight>> slots(depth);
+        std::vector<std::size_t> freeSlots;
+        for (std::size_t i = depth; i-- > 0;) freeSlots.push_back(i);
+
+        auto finish = [&](std::size_t slot, int error) {
+            std::unique_ptr<InFlight> f = std::move(slots[slot]);
+            freeSlots.push_back(slot);
+            ::close(f->fd);
+            if (error) {
+                deliver(std::move(f->req.callback), makeError(f->req, error, "cannot read"));
+                return;
+            }
+            AsyncReadResult r;
+            r.path = std::move(f->req.path);
+            r.tag = f->req.tag;
+            f->data.resize(f->done);
+            r.data = std::move(f->data);
+            deliver(std::move(f->req.callback), std::move(r));
+        };
+
+        auto submitRemainder = [&](std::size_t slot) {
+            InFlight& f = *slots[slot];
+            f.iov.iov_base = &f.data[f.done];
+            f.iov.iov_len = f.data.size() - f.done;
+            // 槽位数不超过环大小，这里不会失败
+            ring->prepareReadv(f.fd, &f.iov, f.done, slot);
+        };
+
+        for (;;) {
+            // 补满在途请求；open/fstat 在本线程同步做
+            while (!freeSlots.empty()) {
+                Request req;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    const bool idle = freeSlots.size() == depth;
+                    if (idle) workCv.wait(lock, [&] { return stopping || !queue.empty(); });
+                    if (queue.empty()) {
+                        if (idle && stopping) return;
+                        break;
+                    }
+                    req = std::move(queue.front());
+                    queue.pop_front();
+                }
+                std::size_t size = 0;
+                const int fd = openForRead(req.path, size);
+                if (fd < 0) {
+                    AsyncReadCallback cb = std::move(req.callback);
+                    deliver(std::move(cb), makeError(req, -fd, "cannot open"));
+                    continue;
+                }
+                const std::size_t slot = freeSlots.back();
+                freeSlots.pop_back();
+                slots[slot] = std::make_unique<InFlight>();
+                InFlight& f = *slots[slot];
+                f.req = std::move(req);
+                f.fd = fd;
+                if (size == 0) {
+                    // 空文件或大小未知的伪文件，同步读到 EOF
+                    const int err = readUntilEof(fd, f.data);
+                    f.done = f.data.size();
+                    finish(slot, err);
+                    continue;
+                }
+                f.data.resize(size);
+                submitRemainder(slot);
+            }
+            if (freeSlots.size() == depth) continue;
+
+            try {
+                ring->submitAndWait(1);
+            } catch (const std::runtime_error&) {
+                abandonRing(slots);
+                runPool();
+                return;
+            }
+            ring->reap([&](std::uint64_t slot, int res) {
+                InFlight& f = *slots[slot];
+                if (res == -EINTR || res == -EAGAIN) {
+                    submitRemainder(slot);
+                } else if (res < 0) {
+                    finish(slot, -res);
+                } else if (res == 0) {
+                    finish(slot, 0);   // 读的过程中被截断，交出已读到的部分
+                } else {
+                    f.done += static_cast<std::size_t>(res);
+                    if (f.done < f.data.size()) {
+                        submitRemainder(slot);   // 短读，继续读剩下的
+                    } else {
+                        finish(slot, 0);
+                    }
+                }
+            });
+        }
+    }
+
+    // io_uring_enter 出了意外的错：环不再可信，本线程改为同步读。
+    // 在途请求的缓冲区留给 abandoned 直到环关闭，请求本身换新缓冲区同步重读，排队的请求由 runPool 接着处理
+    void abandonRing(std::vector<std::unique_ptr<InFlight>>& slots) {
+        actual = AsyncReaderBackend::ThreadPool;
+        for (auto& f : slots) {
+            if (!f) continue;
+            ::close(f->fd);
+            Request req = std::move(f->req);
+            abandoned.push_back(std::move(f));
+            AsyncReadCallback cb = std::move(req.callback);
+            deliver(std::move(cb), readWholeFile(req));
+        }
+    }
+#else
+    void runRing() {}
+#endif
+};
+
+AsyncFileReader::AsyncFileReader(AsyncReaderOptions options) : impl_(std::make_unique<Impl>(std::move(options))) {}
+
+AsyncFileReader::~AsyncFileReader() = default;
+
+void AsyncFileReader::read(std::string path, AsyncReadCallback callback, std::uint64_t tag)
+{
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        Request req;
+        req.path = std::move(path);
+        req.tag = tag;
+        req.callback = std::move(callback);
+        impl_->queue.push_back(std::move(req));
+        ++impl_->outstanding;
+    }
+    impl_->workCv.notify_one();
+}
+
+void AsyncFileReader::wait()
+{
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    impl_->idleCv.wait(lock, [&] { return impl_->outstanding == 0; });
+}
+
+AsyncReaderBackend AsyncFileReader::backend() const
+{
+    return impl_->actual;
+}
+
+std::size_t AsyncFileReader::pending() const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->outstanding;
+}
+
+} // namespace fs
+} // namespace foundation
@@ -0,0 +1,601 @@
+#include "foundation/Fs/FileWatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace foundation {
+namespace fs {
+
+namespace stdfs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+const char* fileEventName(FileEvent event)
+{
+    switch (event) {
+    case FileEvent::Created: return "created";
+    case FileEvent::Modified: return "modified";
+    case FileEvent::Removed: return "removed";
+    }
+    return "unknown";
+}
+
+namespace {
+
+// 后端上报的原始事件；overflow 表示内核事件队列溢出，需要当作所有路径都可能变化；
+// rescan 表示 dir 的监视丢失或刚恢复，期间的事件不可知，需要按当前状态重新判断该目录下的 watch
+struct RawEvent {
+    std::string dir;
+    std::string name;
+    FileEvent event = FileEvent::Modified;
+    bool overflow = false;
+    bool rescan = false;
+};
+
+// 事件来源：按目录登记（引用计数），等待并收集原始事件
+class EventSource {
+public:
+    virtual ~EventSource() = default;
+    virtual void addDirectory(const std::string& dir) = 0;
+    virtual void removeDirectory(const std::string& dir) = 0;
+    // 最多等待 timeout（负数表示一直等），把事件追加到 out
+    virtual void wait(std::chrono::milliseconds timeout, std::vector<RawEvent>& out) = 0;
+    // 让正在 wait 的线程尽快返回
+    virtual void wake() = 0;
+};
+
+// ==================== 轮询 ====================
+
+class PollingSource : public EventSource {
+public:
+    explicit PollingSource(std::chrono::milliseconds interval) : interval_(interval), nextPoll_(Clock::now() + interval) {}
+
+    void addDirectory(const std::string& dir) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Dir& d = dirs_[dir];
+        // 第一次登记时拍基线，已存在的文件不算新建
+        if (d.refs++ == 0) d.entries = scan(dir);
+    }
+
+    void removeDirectory(const std::string& dir) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = dirs_.find(dir);
+        if (it != dirs_.end() && --it->second.refs == 0) dirs_.erase(it);
+    }
+
+    void wait(std::chrono::milliseconds timeout, std::vector<RawEvent>& out) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto deadline = nextPoll_;
+        if (timeout.count() >= 0) deadline = std::min(deadline, Clock::now() + timeout);
+        cv_.wait_until(lock, deadline, [this] { return woken_; });
+        woken_ = false;
+        const auto now = Clock::now();
+        if (now < nextPoll_) return;
+        nextPoll_ = now + interval_;
+        for (auto& [dir, d] : dirs_) {
+            auto current = scan(dir);
+            diff(dir, d.entries, current, out);
+            d.entries = std::move(current);
+        }
+    }
+
+    void wake() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            woken_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    struct Stamp {
+        std::uintmax_t size = 0;
+        std::int64_t mtime = 0;
+        bool operator!=(const Stamp& o) const { return size != o.size || mtime != o.mtime; }
+    };
+
+    struct Dir {
+        int refs = 0;
+        std::map<std::string, Stamp> entries;
+    };
+
+    static std::map<std::string, Stamp> scan(const std::string& dir) {
+        std::map<std::string, Stamp> out;
+        std::error_code ec;
+        for (stdfs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            Stamp s;
+            std::error_code e;
+            if (it->is_regular_file(e)) s.size = it->file_size(e);
+            s.mtime = static_cast<std::int64_t>(it->last_write_time(e).time_since_epoch().count());
+            out.emplace(it->path().filename().string(), s);
+        }
+        return out;
+    }
+
+    static void diff(const std::string& dir, const std::map<std::string, Stamp>& before,
+                     const std::map<std::string, Stamp>& after, std::vector<RawEvent>& out) {
+        auto a = before.begin();
+        auto b = after.begin();
+        while (a != before.end() || b != after.end()) {
+            if (b == after.end() || (a != before.end() && a->first < b->first)) {
+                out.push_back({dir, a->first, FileEvent::Removed});
+                ++a;
+            } else if (a == before.end() || b->first < a->first) {
+                out.push_back({dir, b->first, FileEvent::Created});
+                ++b;
+            } else {
+                if (a->second != b->second) out.push_back({dir, b->first, FileEvent::Modified});
+                ++a;
+                ++b;
+            }
+        }
+    }
+
+    const std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool woken_ = false;
+    Clock::time_point nextPoll_;
+    std::map<std::string, Dir> dirs_;
+};
+
+// ==================== inotify + epoll ====================
+
+#if defined(__linux__)
+
+class InotifySource : public EventSource {
+public:
+    InotifySource() {
+        inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotifyFd_ < 0 || epollFd_ < 0 || wakeFd_ < 0) {
+            const int err = errno;
+            closeAll();
+            throw std::runtime_error(std::string("FileWatcher: inotify unavailable: ") + std::strerror(err));
+        }
+        for (int fd : {inotifyFd_, wakeFd_}) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    ~InotifySource() override { closeAll(); }
+
+    void addDirectory(const std::string& dir) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = dirs_.find(dir);
+        if (it != dirs_.end()) {
+            ++it->second.refs;
+            return;
+        }
+        const int wd = inotify_add_watch(inotifyFd_, dir.c_str(), kMask);
+        if (wd < 0) {
+            const int err = errno;
+            std::string msg = "FileWatcher: cannot watch " + dir + ": " + std::strerror(err);
+            if (err == ENOSPC) msg += " (raise fs.inotify.max_user_watches)";
+            throw std::runtime_error(msg);
+        }
+        dirs_[dir] = {wd, 1};
+        // 不同写法的路径可能指向同一个目录，内核返回同一个 wd；事件按每种写法各报一次
+        wds_[wd].push_back(dir);
+    }
+
+    void removeDirectory(const std::string& dir) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = dirs_.find(dir);
+        if (it == dirs_.end() || --it->second.refs > 0) return;
+        const int wd = it->second.wd;
+        dirs_.erase(it);
+        if (wd < 0) {
+            --lost_;
+            return;
+        }
+        auto w = wds_.find(wd);
+        if (w == wds_.end()) return;
+        w->second.erase(std::remove(w->second.begin(), w->second.end(), dir), w->second.end());
+        if (w->second.empty()) {
+            wds_.erase(w);
+            inotify_rm_watch(inotifyFd_, wd);
+        }
+    }
+
+    void wait(std::chrono::milliseconds timeout, std::vector<RawEvent>& out) override {
+        epoll_event events[2];
+        int timeoutMs = timeout.count() < 0 ? -1 : static_cast<int>(std::min<std::int64_t>(timeout.count(), 1 << 30));
+        bool retry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retry = lost_ > 0;
+        }
+        // 有目录的监视丢失时定期尝试重新挂上，目录重建后继续收到事件
+        if (retry && (timeoutMs < 0 || timeoutMs > kReattachMs)) timeoutMs = kReattachMs;
+        const int n = epoll_wait(epollFd_, events, 2, timeoutMs);
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.fd == wakeFd_) {
+                std::uint64_t v;
+                while (read(wakeFd_, &v, sizeof(v)) > 0) {
+                }
+            } else {
+                drain(out);
+            }
+        }
+        if (retry) reattach(out);
+    }
+
+    void wake() override {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto r = write(wakeFd_, &one, sizeof(one));
+    }
+
+private:
+    void drain(std::vector<RawEvent>& out) {
+        alignas(inotify_event) char buf[64 * 1024];
+        for (;;) {
+            const ssize_t len = read(inotifyFd_, buf, sizeof(buf));
+            if (len <= 0) return;   // EAGAIN：读完了
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (ssize_t off = 0; off < len;) {
+                const auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+                off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+                if (ev->mask & IN_Q_OVERFLOW) {
+                    RawEvent r;
+                    r.overflow = true;
+                    out.push_back(std::move(r));
+                    continue;
+                }
+                if (ev->mask & IN_IGNORED) {
+                    // 目录被删除或卸载，内核已自动移除 watch
+                    forgetWd(ev->wd, out);
+                    continue;
+                }
+                if (ev->mask & IN_MOVE_SELF) {
+                    // 目录被改名：watch 跟着 inode 走，原路径上已经不是它了
+                    inotify_rm_watch(inotifyFd_, ev->wd);
+                    forgetWd(ev->wd, out);
+                    continue;
+                }
+                if (ev->len == 0) continue;   // 目录自身的事件
+                auto w = wds_.find(ev->wd);
+                if (w == wds_.end()) continue;
+                FileEvent kind = FileEvent::Modified;
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    kind = FileEvent::Created;
+                } else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    kind = FileEvent::Removed;
+                }
+                for (const auto& dir : w->second) out.push_back({dir, std::string(ev->name), kind});
+            }
+        }
+    }
+
+    // watch 失效：目录仍保留登记（引用计数不变），标记为丢失，由 reattach 在目录重新出现后挂回
+    void forgetWd(int wd, std::vector<RawEvent>& out) {
+        auto w = wds_.find(wd);
+        if (w == wds_.end()) return;   // 自己 removeDirectory 移除的 watch
+        for (const auto& dir : w->second) {
+            auto it = dirs_.find(dir);
+            if (it == dirs_.end() || it->second.wd != wd) continue;
+            it->second.wd = -1;
+            ++lost_;
+            out.push_back(rescanEvent(dir));
+        }
+        wds_.erase(w);
+    }
+
+    void reattach(std::vector<RawEvent>& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [dir, entry] : dirs_) {
+            if (entry.wd >= 0) continue;
+            const int wd = inotify_add_watch(inotifyFd_, dir.c_str(), kMask);
+            if (wd < 0) continue;   // 目录还不存在，下次再试
+            entry.wd = wd;
+            --lost_;
+            wds_[wd].push_back(dir);
+            // 挂回之前目录里发生了什么不得而知，按当前状态重新判断
+            out.push_back(rescanEvent(dir));
+        }
+    }
+
+    static RawEvent rescanEvent(const std::string& dir) {
+        RawEvent r;
+        r.dir = dir;
+        r.rescan = true;
+        return r;
+    }
+
+    void closeAll() {
+        for (int* fd : {&inotifyFd_, &epollFd_, &wakeFd_}) {
+            if (*fd >= 0) close(*fd);
+            *fd = -1;
+        }
+    }
+
+    static constexpr std::uint32_t kMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                           IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+    static constexpr int kReattachMs = 100;
+
+    struct DirEntry {
+        int wd = -1;   // -1：watch 已丢失，等待重新挂上
+        int refs = 0;
+    };
+    int inotifyFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    std::mutex mutex_;
+    std::unordered_map<std::string, DirEntry> dirs_;
+    std::unordered_map<int, std::vector<std::string>> wds_;
+    std::size_t lost_ = 0;   // wd 为 -1 的目录数
+};
+
+#endif
+
+std::unique_ptr<EventSource> makeSource(const FileWatcherOptions& options, FileWatcherBackend& actual)
+{
+    if (options.backend != FileWatcherBackend::Polling) {
+#if defined(__linux__)
+        try {
+            auto source = std::make_unique<InotifySource>();
+            actual = FileWatcherBackend::Native;
+            return source;
+        } catch (const std::runtime_error&) {
+            if (options.backend == FileWatcherBackend::Native) throw;
+        }
+#else
+        if (options.backend == FileWatcherBackend::Native) {
+            throw std::runtime_error("FileWatcher: no native backend on this platform");
+        }
+#endif
+    }
+    actual = FileWatcherBackend::Polling;
+    return std::make_unique<PollingSource>(options.pollInterval);
+}
+
+// 同一路径在合并窗口内的事件合并
+FileEvent mergeEvents(FileEvent before, FileEvent after)
+{
+    if (before == FileEvent::Created && after == FileEvent::Modified) return FileEvent::Created;
+    if (before == FileEvent::Removed && after == FileEvent::Created) return FileEvent::Modified;   // 改名覆盖保存
+    return after;
+}
+
+std::string joinPath(const std::string& dir, const std::string& name)
+{
+    return (stdfs::path(dir) / name).string();
+}
+
+} // namespace
+
+// ==================== FileWatcher ====================
+
+struct FileWatcher::Impl {
+    struct Watch {
+        WatchId id;
+        std::string dir;
+        std::string name;   // 为空表示监视整个目录
+        FileChangeCallback callback;
+    };
+
+    struct Pending {
+        FileEvent event;
+        Clock::time_point first;
+        Clock::time_point last;
+    };
+
+    FileWatcherOptions options;
+    FileWatcherBackend actual = FileWatcherBackend::Polling;
+    std::unique_ptr<EventSource> source;
+
+    mutable std::mutex mutex;
+    std::map<WatchId, std::shared_ptr<Watch>> watches;
+    std::unordered_map<std::string, std::vector<WatchId>> byDir;
+    std::map<WatchId, std::map<std::string, Pending>> pending;
+    WatchId nextId = 1;
+
+    std::mutex callbackMutex;   // 回调执行期间持有；unwatch 借它等待进行中的回调
+    std::atomic<bool> running{false};
+    std::thread thread;
+    std::atomic<std::thread::id> threadId{};
+
+    WatchId add(const std::string& dir, const std::string& name, FileChangeCallback callback) {
+        if (!callback) throw std::invalid_argument("FileWatcher: empty callback");
+        std::error_code ec;
+        if (!stdfs::is_directory(dir, ec)) throw std::runtime_error("FileWatcher: no such directory " + dir);
+        source->addDirectory(dir);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto w = std::make_shared<Watch>(Watch{nextId++, dir, name, std::move(callback)});
+        watches.emplace(w->id, w);
+        byDir[dir].push_back(w->id);
+        return w->id;
+    }
+
+    void record(const Watch& w, const std::string& path, FileEvent event, Clock::time_point now) {
+        auto& paths = pending[w.id];
+        auto it = paths.find(path);
+        if (it == paths.end()) {
+            paths.emplace(path, Pending{event, now, now});
+        } else {
+            it->second.event = mergeEvents(it->second.event, event);
+            it->second.last = now;
+        }
+    }
+
+    // 原始事件 -> 各 watch 的待发事件
+    void route(const std::vector<RawEvent>& raw, Clock::time_point now) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& r : raw) {
+            if (r.overflow) {
+                // 丢了事件，保守地让每个 watch 都收到一次"已修改"
+                for (const auto& [id, w] : watches) {
+                    record(*w, w->name.empty() ? w->dir : joinPath(w->dir, w->name), FileEvent::Modified, now);
+                }
+                continue;
+            }
+            auto it = byDir.find(r.dir);
+            if (it == byDir.end()) continue;
+            if (r.rescan) {
+                // 目录监视丢失或恢复：按文件当前是否存在报告，目录 watch 报告目录本身
+                for (WatchId id : it->second) {
+                    const auto& w = watches.at(id);
+                    const std::string path = w->name.empty() ? w->dir : joinPath(w->dir, w->name);
+                    std::error_code ec;
+                    record(*w, path, stdfs::exists(path, ec) ? FileEvent::Modified : FileEvent::Removed, now);
+                }
+                continue;
+            }
+            for (WatchId id : it->second) {
+                const auto& w = watches.at(id);
+                if (w->name.empty() || w->name == r.name) record(*w, joinPath(r.dir, r.name), r.event, now);
+            }
+        }
+    }
+
+    // 取出到期的事件；返回下一次需要醒来的时间（没有待发事件时为负）
+    std::chrono::milliseconds collect(Clock::time_point now,
+                                      std::vector<std::pair<std::shared_ptr<Watch>, std::vector<FileChange>>>& due) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Clock::time_point next = Clock::time_point::max();
+        for (auto it = pending.begin(); it != pending.end();) {
+            auto w = watches.find(it->first);
+            if (w == watches.end()) {
+                it = pending.erase(it);
+                continue;
+            }
+            std::vector<FileChange> changes;
+            for (auto p = it->second.begin(); p != it->second.end();) {
+                const auto ready = std::min(p->second.last + options.coalesce, p->second.first + options.maxDelay);
+                if (now >= ready) {
+                    changes.push_back({p->first, p->second.event});
+                    p = it->second.erase(p);
+                } else {
+                    next = std::min(next, ready);
+                    ++p;
+                }
+            }
+            if (!changes.empty()) due.emplace_back(w->second, std::move(changes));
+            it = it->second.empty() ? pending.erase(it) : std::next(it);
+        }
+        if (next == Clock::time_point::max()) return std::chrono::milliseconds(-1);
+        return std::chrono::ceil<std::chrono::milliseconds>(next - now);
+    }
+
+    void run() {
+        std::vector<RawEvent> raw;
+        std::vector<std::pair<std::shared_ptr<Watch>, std::vector<FileChange>>> due;
+        std::chrono::milliseconds timeout(-1);
+        threadId.store(std::this_thread::get_id());
+        while (running.load(std::memory_order_acquire)) {
+            raw.clear();
+            source->wait(timeout, raw);
+            const auto now = Clock::now();
+            if (!raw.empty()) route(raw, now);
+            due.clear();
+            timeout = collect(now, due);
+            for (auto& [watch, changes] : due) {
+                std::lock_guard<std::mutex> cbLock(callbackMutex);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!watches.count(watch->id)) continue;   // 已被 unwatch
+                }
+                try {
+                    watch->callback(changes);
+                } catch (...) {
+                    // 回调的异常不能打断监视线程
+                }
+            }
+        }
+    }
+};
+
+FileWatcher::FileWatcher(FileWatcherOptions options) : impl_(std::make_unique<Impl>())
+{
+    impl_->options = options;
+    impl_->source = makeSource(options, impl_->actual);
+}
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+}
+
+FileWatcher::WatchId FileWatcher::watchFile(const std::string& path, FileChangeCallback callback)
+{
+    const stdfs::path p = stdfs::path(path).lexically_normal();
+    if (!p.has_filename()) throw std::invalid_argument("FileWatcher: not a file path " + path);
+    const std::string dir = p.has_parent_path() ? p.parent_path().string() : std::string(".");
+    return impl_->add(dir, p.filename().string(), std::move(callback));
+}
+
+FileWatcher::WatchId FileWatcher::watchDirectory(const std::string& path, FileChangeCallback callback)
+{
+    std::string dir = stdfs::path(path).lexically_normal().string();
+    while (dir.size() > 1 && (dir.back() == '/' || dir.back() == '\\')) dir.pop_back();
+    return impl_->add(dir, std::string(), std::move(callback));
+}
+
+void FileWatcher::unwatch(WatchId id)
+{
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto it = impl_->watches.find(id);
+        if (it == impl_->watches.end()) return;
+        dir = it->second->dir;
+        impl_->watches.erase(it);
+        impl_->pending.erase(id);
+        auto& ids = impl_->byDir[dir];
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty()) impl_->byDir.erase(dir);
+    }
+    impl_->source->removeDirectory(dir);
+    // 等正在执行的回调结束；在回调线程里调用时不能等自己
+    if (std::this_thread::get_id() != impl_->threadId.load()) {
+        std::lock_guard<std::mutex> cbLock(impl_->callbackMutex);
+    }
+}
+
+void FileWatcher::start()
+{
+    if (impl_->running.exchange(true)) return;
+    impl_->thread = std::thread([this] { impl_->run(); });
+}
+
+void FileWatcher::stop()
+{
+    if (!impl_->running.exchange(false)) return;
+    impl_->source->wake();
+    if (impl_->thread.joinable()) impl_->thread.join();
+    impl_->threadId.store(std::thread::id());
+}
+
+FileWatcherBackend FileWatcher::backend() const
+{
+    return impl_->actual;
+}
+
+std::size_t FileWatcher::watchCount() const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->watches.size();
+}
+
+} // namespace fs
+} // namespace foundation
@@ -0,0 +1,384 @@
+#include "foundation/Fs/MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace foundation {
+namespace fs {
+
+namespace {
+
+#if defined(__linux__)
+constexpr std::size_t kHugePageSize = 2u << 20;
+#endif
+
+std::string systemError(const std::string& what, const std::string& path)
+{
+#if defined(_WIN32)
+    const int err = static_cast<int>(::GetLastError());
+#else
+    const int err = errno;
+#endif
+    return "MappedFile: " + what + " " + path + ": " + std::system_category().message(err);
+}
+
+// mmap 的文件偏移必须按此对齐（Windows 上是分配粒度 64K，不是页大小）
+std::size_t offsetGranularity()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return MappedFile::pageSize();
+#endif
+}
+
+} // namespace
+
+struct MappedFile::Mapping {
+    void* base = nullptr;     // 实际映射的起始地址（已对齐）
+    std::size_t length = 0;   // 实际映射的长度
+    MapAccess access = MapAccess::ReadOnly;
+    std::string path;
+    bool anonymous = false;
+    bool hugePages = false;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE section = nullptr;
+#endif
+
+    Mapping() = default;
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping() {
+#if defined(_WIN32)
+        if (base) {
+            if (anonymous) {
+                ::VirtualFree(base, 0, MEM_RELEASE);
+            } else {
+                ::UnmapViewOfFile(base);
+            }
+        }
+        if (section) ::CloseHandle(section);
+        if (file != INVALID_HANDLE_VALUE) ::CloseHandle(file);
+#else
+        if (base) ::munmap(base, length);
+#endif
+    }
+};
+
+std::size_t MappedFile::pageSize()
+{
+#if defined(_WIN32)
+    static const std::size_t size = [] {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<std::size_t>(info.dwPageSize);
+    }();
+#else
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    return size;
+}
+
+#if defined(_WIN32)
+
+MappedFile MappedFile::open(const std::string& path, const MapOptions& options)
+{
+    auto m = std::make_shared<Mapping>();
+    m->access = options.access;
+    m->path = path;
+
+    const bool rw = options.access == MapAccess::ReadWrite;
+    const std::wstring wpath = std::filesystem::u8path(path).wstring();
+    m->file = ::CreateFileW(wpath.c_str(), rw ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                            rw && options.createSize > 0 ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m->file == INVALID_HANDLE_VALUE) throw std::runtime_error(systemError("cannot open", path));
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(m->file, &size)) throw std::runtime_error(systemError("cannot stat", path));
+    std::uint64_t fileSize = static_cast<std::uint64_t>(size.QuadPart);
+    if (rw && fileSize < options.createSize) {
+        LARGE_INTEGER want;
+        want.QuadPart = static_cast<LONGLONG>(options.createSize);
+        if (!::SetFilePointerEx(m->file, want, nullptr, FILE_BEGIN) || !::SetEndOfFile(m->file)) {
+            throw std::runtime_error(systemError("cannot extend", path));
+        }
+        fileSize = options.createSize;
+    }
+
+    if (options.offset > fileSize) throw std::runtime_error("MappedFile: offset beyond end of " + path);
+    const std::uint64_t length = options.length ? options.length : fileSize - options.offset;
+    if (length > fileSize - options.offset) throw std::runtime_error("MappedFile: range beyond end of " + path);
+    if (length == 0) return MappedFile(std::move(m), nullptr, 0);
+
+    const DWORD protect = options.access == MapAccess::ReadWrite     ? PAGE_READWRITE
+                          : options.access == MapAccess::CopyOnWrite ? PAGE_WRITECOPY
+                                                                     : PAGE_READONLY;
+    m->section = ::CreateFileMappingW(m->file, nullptr, protect, 0, 0, nullptr);
+    if (!m->section) throw std::runtime_error(systemError("cannot map", path));
+
+    const std::uint64_t aligned = options.offset - options.offset % offsetGranularity();
+    const std::size_t delta = static_cast<std::size_t>(options.offset - aligned);
+    m->length = static_cast<std::size_t>(length) + delta;
+    const DWORD access = options.access == MapAccess::ReadWrite     ? FILE_MAP_WRITE
+                         : options.access == MapAccess::CopyOnWrite ? FILE_MAP_COPY
+                                                                    : FILE_MAP_READ;
+    m->base = ::MapViewOfFile(m->section, access, static_cast<DWORD>(aligned >> 32),
+                              static_cast<DWORD>(aligned & 0xFFFFFFFFu), m->length);
+    if (!m->base) throw std::runtime_error(systemError("cannot map", path));
+    // 文件映射在 Windows 上不支持大页，hugePages 忽略
+
+    MappedFile file(std::move(m), nullptr, 0);
+    file.data_ = static_cast<const char*>(file.mapping_->base) + delta;
+    file.size_ = static_cast<std::size_t>(length);
+    if (options.advice != MapAdvice::Normal) file.advise(options.advice);
+    if (options.populate) {
+        const std::size_t page = pageSize();
+        volatile char sink = 0;
+        for (std::size_t i = 0; i < file.size_; i += page) sink = file.data_[i];
+        (void)sink;
+    }
+    return file;
+}
+
+MappedFile MappedFile::anonymous(std::size_t size, bool hugePages)
+{
+    auto m = std::make_shared<Mapping>();
+    m->access = MapAccess::ReadWrite;
+    m->anonymous = true;
+    if (size == 0) return MappedFile(std::move(m), nullptr, 0);
+
+    // 大页需要 SeLockMemoryPrivilege，没有权限时退回普通页
+    if (hugePages) {
+        const std::size_t large = ::GetLargePageMinimum();
+        if (large > 0) {
+            const std::size_t rounded = (size + large - 1) / large * large;
+            m->base = ::VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (m->base) {
+                m->length = rounded;
+                m->hugePages = true;
+            }
+        }
+    }
+    if (!m->base) {
+        m->base = ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!m->base) throw std::runtime_error(systemError("cannot allocate", "<anonymous>"));
+        m->length = size;
+    }
+    const char* data = static_cast<const char*>(m->base);
+    return MappedFile(std::move(m), data, size);
+}
+
+void MappedFile::advise(MapAdvice advice) const
+{
+    if (size_ == 0) return;
+#if _WIN32_WINNT >= 0x0602
+    if (advice == MapAdvice::WillNeed) {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<char*>(data_);
+        range.NumberOfBytes = size_;
+        ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+    }
+#endif
+    // 其它提示 Windows 没有对应接口
+    (void)advice;
+}
+
+void MappedFile::flush(bool async) const
+{
+    if (size_ == 0 || !mapping_ || mapping_->access != MapAccess::ReadWrite || mapping_->anonymous) return;
+    if (!::FlushViewOfFile(data_, size_)) throw std::runtime_error(systemError("cannot flush", mapping_->path));
+    if (!async && !::FlushFileBuffers(mapping_->file)) {
+        throw std::runtime_error(systemError("cannot flush", mapping_->path));
+    }
+}
+
+#else
+
+MappedFile MappedFile::open(const std::string& path, const MapOptions& options)
+{
+    auto m = std::make_shared<Mapping>();
+    m->access = options.access;
+    m->path = path;
+
+    const bool rw = options.access == MapAccess::ReadWrite;
+    int flags = rw ? O_RDWR : O_RDONLY;
+    if (rw && options.createSize > 0) flags |= O_CREAT;
+    const int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error(systemError("cannot open", path));
+    // 映射建立后描述符就可以关掉，映射本身持有对文件的引用
+    struct FdGuard {
+        int fd;
+        ~FdGuard() { ::close(fd); }
+    } guard{fd};
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) throw std::runtime_error(systemError("cannot stat", path));
+    std::uint64_t fileSize = static_cast<std::uint64_t>(st.st_size);
+    if (rw && fileSize < options.createSize) {
+        if (::ftruncate(fd, static_cast<off_t>(options.createSize)) != 0) {
+            throw std::runtime_error(systemError("cannot extend", path));
+        }
+        fileSize = options.createSize;
+    }
+
+    if (options.offset > fileSize) throw std::runtime_error("MappedFile: offset beyond end of " + path);
+    const std::uint64_t length = options.length ? options.length : fileSize - options.offset;
+    // 超出文件末尾的页访问会 SIGBUS，这里直接拒绝
+    if (length > fileSize - options.offset) throw std::runtime_error("MappedFile: range beyond end of " + path);
+    if (length == 0) return MappedFile(std::move(m), nullptr, 0);
+
+    const std::uint64_t aligned = options.offset - options.offset % offsetGranularity();
+    const std::size_t delta = static_cast<std::size_t>(options.offset - aligned);
+    m->length = static_cast<std::size_t>(length) + delta;
+
+    const int prot = options.access == MapAccess::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    int mapFlags = options.access == MapAccess::ReadWrite ? MAP_SHARED : MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+    if (options.populate) mapFlags |= MAP_POPULATE;
+#endif
+    void* base = ::mmap(nullptr, m->length, prot, mapFlags, fd, static_cast<off_t>(aligned));
+    if (base == MAP_FAILED) throw std::runtime_error(systemError("cannot map", path));
+    m->base = base;
+
+#if defined(MADV_HUGEPAGE)
+    // 文件映射的大页依赖内核的文件 THP 支持，不支持时 madvise 失败，按普通页继续
+    if (options.hugePages) m->hugePages = ::madvise(base, m->length, MADV_HUGEPAGE) == 0;
+#endif
+
+    MappedFile file(std::move(m), nullptr, 0);
+    file.data_ = static_cast<const char*>(base) + delta;
+    file.size_ = static_cast<std::size_t>(length);
+    if (options.advice != MapAdvice::Normal) file.advise(options.advice);
+#if !defined(MAP_POPULATE)
+    if (options.populate) file.advise(MapAdvice::WillNeed);
+#endif
+    return file;
+}
+
+MappedFile MappedFile::anonymous(std::size_t size, bool hugePages)
+{
+    auto m = std::make_shared<Mapping>();
+    m->access = MapAccess::ReadWrite;
+    m->anonymous = true;
+    if (size == 0) return MappedFile(std::move(m), nullptr, 0);
+
+#if defined(MAP_ANONYMOUS)
+    const int anonFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+#else
+    const int anonFlags = MAP_PRIVATE | MAP_ANON;
+#endif
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    // 先试预留的 hugetlbfs 大页（长度需按 2M 取整），没有预留时退回普通页 + THP
+    if (hugePages) {
+        const std::size_t rounded = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        void* base = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, anonFlags | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            m->base = base;
+            m->length = rounded;
+            m->hugePages = true;
+        }
+    }
+#endif
+    if (!m->base) {
+        void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, anonFlags, -1, 0);
+        if (base == MAP_FAILED) throw std::runtime_error(systemError("cannot allocate", "<anonymous>"));
+        m->base = base;
+        m->length = size;
+#if defined(MADV_HUGEPAGE)
+        if (hugePages) m->hugePages = ::madvise(base, size, MADV_HUGEPAGE) == 0;
+#endif
+    }
+    const char* data = static_cast<const char*>(m->base);
+    return MappedFile(std::move(m), data, size);
+}
+
+void MappedFile::advise(MapAdvice advice) const
+{
+    if (size_ == 0) return;
+    // madvise 要求起始地址页对齐；本视图不会越出映射，向下取整后仍在映射内
+    const std::size_t page = pageSize();
+    const auto begin = reinterpret_cast<std::uintptr_t>(data_) / page * page;
+    const std::size_t length = reinterpret_cast<std::uintptr_t>(data_) + size_ - begin;
+    int native = MADV_NORMAL;
+    switch (advice) {
+    case MapAdvice::Normal: native = MADV_NORMAL; break;
+    case MapAdvice::Sequential: native = MADV_SEQUENTIAL; break;
+    case MapAdvice::Random: native = MADV_RANDOM; break;
+    case MapAdvice::WillNeed: native = MADV_WILLNEED; break;
+    case MapAdvice::DontNeed:
+        // 私有可写映射上 MADV_DONTNEED 会丢掉修改，只对不会丢数据的映射下发
+        if (mapping_->access == MapAccess::CopyOnWrite || mapping_->anonymous) return;
+        native = MADV_DONTNEED;
+        break;
+    }
+    ::madvise(reinterpret_cast<void*>(begin), length, native);
+}
+
+void MappedFile::flush(bool async) const
+{
+    if (size_ == 0 || !mapping_ || mapping_->access != MapAccess::ReadWrite || mapping_->anonymous) return;
+    const std::size_t page = pageSize();
+    const auto begin = reinterpret_cast<std::uintptr_t>(data_) / page * page;
+    const std::size_t length = reinterpret_cast<std::uintptr_t>(data_) + size_ - begin;
+    if (::msync(reinterpret_cast<void*>(begin), length, async ? MS_ASYNC : MS_SYNC) != 0) {
+        throw std::runtime_error(systemError("cannot flush", mapping_->path));
+    }
+}
+
+#endif
+
+char* MappedFile::writableData() const
+{
+    if (mapping_ && mapping_->access == MapAccess::ReadOnly) {
+        throw std::logic_error("MappedFile: " + mapping_->path + " is mapped read-only");
+    }
+    return const_cast<char*>(data_);
+}
+
+MapAccess MappedFile::access() const
+{
+    return mapping_ ? mapping_->access : MapAccess::ReadOnly;
+}
+
+const std::string& MappedFile::path() const
+{
+    static const std::string empty;
+    return mapping_ ? mapping_->path : empty;
+}
+
+bool MappedFile::hugePagesApplied() const
+{
+    return mapping_ && mapping_->hugePages;
+}
+
+MappedFile MappedFile::slice(std::size_t offset, std::size_t length) const
+{
+    offset = std::min(offset, size_);
+    length = std::min(length, size_ - offset);
+    return MappedFile(mapping_, data_ ? data_ + offset : nullptr, length);
+}
+
+} // namespace fs
+} // namespace foundation
@@ -0,0 +1,128 @@
+#include "foundation/Utils/CacheUtils.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace foundation {
+namespace utils {
+
+std::string CacheStats::toString() const
+{
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "hits=%llu misses=%llu hit_rate=%.4f insertions=%llu evictions=%llu expirations=%llu "
+                  "rejections=%llu entries=%zu bytes=%zu",
+                  static_cast<unsigned long long>(hits), static_cast<unsigned long long>(misses), hitRate(),
+                  static_cast<unsigned long long>(insertions), static_cast<unsigned long long>(evictions),
+                  static_cast<unsigned long long>(expirations), static_cast<unsigned long long>(rejections),
+                  entries, bytes);
+    return buf;
+}
+
+std::vector<metrics::CallbackHandle> bindCacheMetrics(const std::string& name, std::function<CacheStats()> stats)
+{
+    auto& registry = metrics::MetricsRegistry::instance();
+    const metrics::Labels labels{{"cache", name}};
+    std::vector<metrics::CallbackHandle> handles;
+    auto addCounter = [&](const char* metric, double (*pick)(const CacheStats&)) {
+        handles.push_back(registry.counterCallback(metric, labels, [stats, pick] { return pick(stats()); }));
+    };
+    auto addGauge = [&](const char* metric, double (*pick)(const CacheStats&)) {
+        handles.push_back(registry.gaugeCallback(metric, labels, [stats, pick] { return pick(stats()); }));
+    };
+    addCounter("cache_hits_total", [](const CacheStats& s) { return static_cast<double>(s.hits); });
+    addCounter("cache_misses_total", [](const CacheStats& s) { return static_cast<double>(s.misses); });
+    addCounter("cache_evictions_total", [](const CacheStats& s) { return static_cast<double>(s.evictions); });
+    addCounter("cache_expirations_total", [](const CacheStats& s) { return static_cast<double>(s.expirations); });
+    addCounter("cache_rejections_total", [](const CacheStats& s) { return static_cast<double>(s.rejections); });
+    addGauge("cache_entries", [](const CacheStats& s) { return static_cast<double>(s.entries); });
+    addGauge("cache_bytes", [](const CacheStats& s) { return static_cast<double>(s.bytes); });
+    addGauge("cache_hit_rate", [](const CacheStats& s) { return s.hitRate(); });
+    return handles;
+}
+
+// ==================== FrequencySketch ====================
+
+namespace {
+
+constexpr std::uint64_t kSeeds[4] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+};
+
+constexpr std::uint64_t kResetMask = 0x7777777777777777ULL;   // 每个 4 位计数右移一位后清掉借位
+
+// 调用方按 hash 的低位选分片，同一分片里的 key 低位全部相同；
+// 先乘黄金比例常数把高位扩散开，字下标与字内计数都从重新混合后的值取
+inline std::uint64_t spread(std::uint64_t hash)
+{
+    const std::uint64_t h = hash * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+}
+
+// 字内 16 个计数选哪一个：取乘积的高位，每行 4 位
+inline int counterShift(std::uint64_t spreadHash, int row)
+{
+    return static_cast<int>(((spreadHash >> (60 - row * 4)) & 0xF) << 2);
+}
+
+} // namespace
+
+FrequencySketch::FrequencySketch(std::size_t expectedEntries)
+{
+    std::size_t words = 1;
+    while (words < std::max<std::size_t>(expectedEntries / 4, 16)) words <<= 1;
+    table_.assign(words, 0);
+    mask_ = words - 1;
+    sampleSize_ = std::max<std::size_t>(expectedEntries * 10, 160);
+}
+
+std::size_t FrequencySketch::indexOf(std::uint64_t hash, int row) const
+{
+    std::uint64_t h = (hash + kSeeds[row]) * kSeeds[row];
+    h += h >> 32;
+    return static_cast<std::size_t>(h) & mask_;
+}
+
+void FrequencySketch::increment(std::uint64_t hash)
+{
+    // 每行取一个字，字内按混合后 hash 的不同 4 位选一个计数
+    const std::uint64_t h = spread(hash);
+    bool added = false;
+    for (int row = 0; row < 4; ++row) {
+        const std::size_t word = indexOf(h, row);
+        const int shift = counterShift(h, row);
+        const std::uint64_t mask = 0xFULL << shift;
+        if ((table_[word] & mask) != mask) {
+            table_[word] += 1ULL << shift;
+            added = true;
+        }
+    }
+    if (added && ++additions_ >= sampleSize_) halve();
+}
+
+std::uint32_t FrequencySketch::estimate(std::uint64_t hash) const
+{
+    const std::uint64_t h = spread(hash);
+    std::uint32_t freq = 15;
+    for (int row = 0; row < 4; ++row) {
+        const std::size_t word = indexOf(h, row);
+        const int shift = counterShift(h, row);
+        freq = std::min(freq, static_cast<std::uint32_t>((table_[word] >> shift) & 0xF));
+    }
+    return freq;
+}
+
+void FrequencySketch::halve()
+{
+    for (auto& w : table_) w = (w >> 1) & kResetMask;
+    additions_ /= 2;
+}
+
+void FrequencySketch::clear()
+{
+    std::fill(table_.begin(), table_.end(), 0);
+    additions_ = 0;
+}
+
+} // namespace utils
+} // namespace foundation
@@ -0,0 +1,80 @@
+#include "foundation/Utils/LatencyHistogram.h"
+
+#include <cstdio>
+
+namespace foundation {
+namespace utils {
+
+std::uint64_t LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < kSubBuckets) return static_cast<std::uint64_t>(bucket);
+    const int shift = bucket / kSubBuckets - 1;
+    const std::uint64_t sub = static_cast<std::uint64_t>(bucket % kSubBuckets);
+    const std::uint64_t lower = (static_cast<std::uint64_t>(kSubBuckets) + sub) << shift;
+    return lower + (std::uint64_t{1} << shift) - 1;
+}
+
+std::uint64_t LatencyHistogram::count() const
+{
+    std::uint64_t n = 0;
+    for (const auto& b : buckets_) n += b.load(std::memory_order_relaxed);
+    return n;
+}
+
+double LatencyHistogram::mean() const
+{
+    const std::uint64_t n = count();
+    return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+}
+
+std::uint64_t LatencyHistogram::percentile(double p) const
+{
+    const std::uint64_t n = count();
+    if (n == 0) return 0;
+    if (p >= 100.0) return max();
+    auto target = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(n));
+    if (target >= n) target = n - 1;
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen > target) {
+            // 桶上界不超过实际最大值
+            const std::uint64_t upper = bucketUpperBound(i);
+            const std::uint64_t m = max();
+            return upper < m ? upper : m;
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < kBucketCount; ++i) {
+        const std::uint64_t v = other.buckets_[i].load(std::memory_order_relaxed);
+        if (v) buckets_[i].fetch_add(v, std::memory_order_relaxed);
+    }
+    sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    const std::uint64_t m = other.max();
+    std::uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (m > prev && !max_.compare_exchange_weak(prev, m, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+std::string LatencyHistogram::summary() const
+{
+    char buf[200];
+    std::snprintf(buf, sizeof(buf), "count=%llu mean=%.2fus p50=%.2fus p90=%.2fus p99=%.2fus p999=%.2fus max=%.2fus",
+                  static_cast<unsigned long long>(count()), mean() / 1e3, percentile(50) / 1e3,
+                  percentile(90) / 1e3, percentile(99) / 1e3, percentile(99.9) / 1e3, max() / 1e3);
+    return buf;
+}
+
+} // namespace utils
+} // namespace foundation
@@ -0,0 +1,309 @@
+#include "foundation/Utils/time_format.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace foundation {
+namespace utils {
+namespace timefmt {
+
+namespace {
+
+constexpr int kTableFirstYear = 1970;
+constexpr int kTableLastYear = 2099;
+constexpr std::int64_t kMillisPerDay = 86400000LL;
+
+// 格式化只能输出 4 位年份：YYYYMMDD 与毫秒时间戳都先钳到 0000-01-01 .. 9999-12-31 范围内，
+// 保证 write2/write4 的参数落在 [0, 99] / [0, 9999]
+constexpr std::int32_t kMinFormattableDate = 101;        // 0000-01-01
+constexpr std::int32_t kMaxFormattableDate = 99991231;
+constexpr std::int64_t kMinFormattableMillis = -62167219200000LL;   // 0000-01-01 00:00:00.000
+constexpr std::int64_t kMaxFormattableMillis = 253402300799999LL;   // 9999-12-31 23:59:59.999
+
+inline std::int32_t clampDate(std::int32_t yyyymmdd)
+{
+    return yyyymmdd < kMinFormattableDate ? kMinFormattableDate
+                                          : (yyyymmdd > kMaxFormattableDate ? kMaxFormattableDate : yyyymmdd);
+}
+
+// Howard Hinnant days_from_civil，表外年份使用
+int daysFromCivilSlow(int y, int m, int d)
+{
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * static_cast<unsigned>(m + (m > 2 ? -3 : 9)) + 2) / 5 + static_cast<unsigned>(d) - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+// 每个月 1 日对应的天数
+using MonthTable = std::array<std::int32_t, (kTableLastYear - kTableFirstYear + 1) * 12>;
+
+const MonthTable& monthTable()
+{
+    static const MonthTable table = [] {
+        MonthTable t{};
+        for (int y = kTableFirstYear; y <= kTableLastYear; ++y) {
+            for (int m = 1; m <= 12; ++m) {
+                t[(y - kTableFirstYear) * 12 + (m - 1)] = daysFromCivilSlow(y, m, 1);
+            }
+        }
+        return t;
+    }();
+    return table;
+}
+
+// "00".."99" 两位数字表，格式化时一次拷两个字符
+constexpr char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+inline void write2(char* out, int v)
+{
+    std::memcpy(out, kDigitPairs + v * 2, 2);
+}
+
+inline void write4(char* out, int v)
+{
+    write2(out, v / 100);
+    write2(out + 2, v % 100);
+}
+
+inline bool isDigit(char c)
+{
+    return static_cast<unsigned>(c - '0') < 10u;
+}
+
+// 读取 n 位数字；遇到非数字返回 false
+inline bool readDigits(const char* p, int n, int& value)
+{
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!isDigit(p[i])) return false;
+        v = v * 10 + (p[i] - '0');
+    }
+    value = v;
+    return true;
+}
+
+inline bool isLeap(int y)
+{
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+inline bool validDate(int y, int m, int d)
+{
+    static constexpr int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m < 1 || m > 12 || d < 1) return false;
+    const int maxDay = (m == 2 && isLeap(y)) ? 29 : kDays[m - 1];
+    return d <= maxDay;
+}
+
+// 解析日期部分，返回消耗的字符数；失败返回 0
+std::size_t parseDatePart(std::string_view s, int& y, int& m, int& d)
+{
+    const char* p = s.data();
+    if (s.size() >= 10 && p[4] == '-' && p[7] == '-') {
+        if (readDigits(p, 4, y) && readDigits(p + 5, 2, m) && readDigits(p + 8, 2, d) && validDate(y, m, d)) {
+            return 10;
+        }
+        return 0;
+    }
+    if (s.size() >= 8) {
+        if (readDigits(p, 4, y) && readDigits(p + 4, 2, m) && readDigits(p + 6, 2, d) && validDate(y, m, d)) {
+            return 8;
+        }
+    }
+    return 0;
+}
+
+// 每个线程缓存最近一次格式化的日期，日志这类连续同一天的场景可以跳过日期换算
+struct DayCache {
+    int days = INT32_MIN;
+    char text[kDateLength];
+};
+
+thread_local DayCache t_dayCache;
+
+} // namespace
+
+int daysFromCivil(int year, int month, int day)
+{
+    if (year >= kTableFirstYear && year <= kTableLastYear && month >= 1 && month <= 12) {
+        return monthTable()[(year - kTableFirstYear) * 12 + (month - 1)] + day - 1;
+    }
+    return daysFromCivilSlow(year, month, day);
+}
+
+void civilFromDays(int days, int& year, int& month, int& day)
+{
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe) + era * 400 + (month <= 2);
+}
+
+bool parseDate(std::string_view s, std::int32_t& yyyymmdd)
+{
+    int y = 0, m = 0, d = 0;
+    const std::size_t used = parseDatePart(s, y, m, d);
+    if (used == 0 || used != s.size()) return false;
+    yyyymmdd = y * 10000 + m * 100 + d;
+    return true;
+}
+
+bool parseDateTime(std::string_view s, std::int64_t& epochMillis)
+{
+    int y = 0, mo = 0, d = 0;
+    const std::size_t used = parseDatePart(s, y, mo, d);
+    if (used == 0) return false;
+
+    std::int64_t millis = static_cast<std::int64_t>(daysFromCivil(y, mo, d)) * kMillisPerDay;
+    if (used == s.size()) {
+        epochMillis = millis;
+        return true;
+    }
+
+    // 时间部分：[ T]HH:MM:SS[.fff]
+    const std::string_view t = s.substr(used);
+    if (t.size() < 9 || (t[0] != ' ' && t[0] != 'T') || t[3] != ':' || t[6] != ':') return false;
+    int hh = 0, mi = 0, ss = 0;
+    if (!readDigits(t.data() + 1, 2, hh) || !readDigits(t.data() + 4, 2, mi) || !readDigits(t.data() + 7, 2, ss)) {
+        return false;
+    }
+    if (hh > 23 || mi > 59 || ss > 60) return false;
+    millis += (hh * 3600LL + mi * 60LL + ss) * 1000LL;
+
+    if (t.size() > 9) {
+        // 小数秒：1~3 位有效，超出部分只校验不计入
+        if (t[9] != '.' || t.size() == 10) return false;
+        int ms = 0;
+        int digits = 0;
+        for (std::size_t i = 10; i < t.size(); ++i) {
+            if (!isDigit(t[i])) return false;
+            if (digits < 3) {
+                ms = ms * 10 + (t[i] - '0');
+                ++digits;
+            }
+        }
+        while (digits < 3) {
+            ms *= 10;
+            ++digits;
+        }
+        millis += ms;
+    }
+
+    epochMillis = millis;
+    return true;
+}
+
+std::size_t formatDate(std::int32_t yyyymmdd, char* out)
+{
+    yyyymmdd = clampDate(yyyymmdd);
+    write4(out, yyyymmdd / 10000);
+    out[4] = '-';
+    write2(out + 5, yyyymmdd / 100 % 100);
+    out[7] = '-';
+    write2(out + 8, yyyymmdd % 100);
+    out[kDateLength] = '\0';
+    return kDateLength;
+}
+
+std::size_t formatCompactDate(std::int32_t yyyymmdd, char* out)
+{
+    yyyymmdd = clampDate(yyyymmdd);
+    write4(out, yyyymmdd / 10000);
+    write2(out + 4, yyyymmdd / 100 % 100);
+    write2(out + 6, yyyymmdd % 100);
+    out[kCompactDateLength] = '\0';
+    return kCompactDateLength;
+}
+
+std::size_t formatDateTime(std::int64_t epochMillis, char* out, bool withMillis)
+{
+    if (epochMillis < kMinFormattableMillis) epochMillis = kMinFormattableMillis;
+    if (epochMillis > kMaxFormattableMillis) epochMillis = kMaxFormattableMillis;
+    std::int64_t days = epochMillis / kMillisPerDay;
+    std::int64_t rem = epochMillis % kMillisPerDay;
+    if (rem < 0) {
+        rem += kMillisPerDay;
+        --days;
+    }
+
+    DayCache& cache = t_dayCache;
+    if (cache.days != days) {
+        // 毫秒已钳到可格式化范围，年份一定是 4 位，直接写入缓存
+        int y = 0, m = 0, d = 0;
+        civilFromDays(static_cast<int>(days), y, m, d);
+        write4(cache.text, y);
+        cache.text[4] = '-';
+        write2(cache.text + 5, m);
+        cache.text[7] = '-';
+        write2(cache.text + 8, d);
+        cache.days = static_cast<int>(days);
+    }
+    std::memcpy(out, cache.text, kDateLength);
+
+    const int ms = static_cast<int>(rem % 1000);
+    const int secs = static_cast<int>(rem / 1000);
+    out[10] = ' ';
+    write2(out + 11, secs / 3600);
+    out[13] = ':';
+    write2(out + 14, secs / 60 % 60);
+    out[16] = ':';
+    write2(out + 17, secs % 60);
+    if (!withMillis) {
+        out[kDateTimeLength] = '\0';
+        return kDateTimeLength;
+    }
+    out[19] = '.';
+    out[20] = static_cast<char>('0' + ms / 100);
+    write2(out + 21, ms % 100);
+    out[kDateTimeMillisLength] = '\0';
+    return kDateTimeMillisLength;
+}
+
+std::string formatDate(std::int32_t yyyymmdd)
+{
+    char buf[kDateLength + 1];
+    return std::string(buf, formatDate(yyyymmdd, buf));
+}
+
+std::string formatDateTime(std::int64_t epochMillis, bool withMillis)
+{
+    char buf[kDateTimeMillisLength + 1];
+    return std::string(buf, formatDateTime(epochMillis, buf, withMillis));
+}
+
+std::int64_t dateToMillis(std::int32_t yyyymmdd)
+{
+    return static_cast<std::int64_t>(daysFromCivil(yyyymmdd / 10000, yyyymmdd / 100 % 100, yyyymmdd % 100)) *
+           kMillisPerDay;
+}
+
+std::int32_t millisToDate(std::int64_t epochMillis)
+{
+    std::int64_t days = epochMillis / kMillisPerDay;
+    if (epochMillis % kMillisPerDay < 0) --days;
+    int y = 0, m = 0, d = 0;
+    civilFromDays(static_cast<int>(days), y, m, d);
+    return y * 10000 + m * 100 + d;
+}
+
+} // namespace timefmt
+} // namespace utils
+} // namespace foundation
@@ -0,0 +1,171 @@
+#include "foundation/config/ConfigReloader.hpp"
+
+#include <filesystem>
+#include <system_error>
+
+namespace foundation {
+namespace config {
+
+namespace stdfs = std::filesystem;
+
+ConfigReloader::ConfigReloader(ConfigStore& store, ConfigReloadOptions options)
+    : store_(store), options_(std::move(options))
+{
+    // 与 loadLayeredConfig 的合并顺序一致
+    sources_.push_back(options_.configDir + "/foundation/foundation.json");
+    if (!options_.profile.empty()) sources_.push_back(options_.configDir + "/profiles/" + options_.profile + ".json");
+    sources_.push_back(options_.configDir + "/system/override.json");
+}
+
+ConfigReloader::~ConfigReloader()
+{
+    stop();
+}
+
+void ConfigReloader::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    eventDriven_ = false;
+    if (options_.useFileWatcher) {
+        // 来源所在目录不存在（比如没有 profiles/）时那一层只能靠轮询
+        watcher_ = std::make_unique<foundation::fs::FileWatcher>();
+        bool allWatched = true;
+        for (const auto& source : sources_) {
+            try {
+                watcher_->watchFile(source, [this](const std::vector<foundation::fs::FileChange>&) { notifyChanged(); });
+            } catch (const std::runtime_error&) {
+                allWatched = false;
+            }
+        }
+        watcher_->start();
+        eventDriven_ = allWatched && watcher_->backend() == foundation::fs::FileWatcherBackend::Native;
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+void ConfigReloader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    watcher_.reset();
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void ConfigReloader::notifyChanged()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notified_ = true;
+    }
+    cv_.notify_all();
+}
+
+ConfigReloader::Status ConfigReloader::status() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return status_;
+}
+
+std::vector<ConfigReloader::Fingerprint> ConfigReloader::fingerprints() const
+{
+    std::vector<Fingerprint> out(sources_.size());
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        std::error_code ec;
+        const auto size = stdfs::file_size(sources_[i], ec);
+        if (ec) continue;
+        const auto mtime = stdfs::last_write_time(sources_[i], ec);
+        if (ec) continue;
+        out[i].exists = true;
+        out[i].size = size;
+        out[i].mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+    }
+    return out;
+}
+
+bool ConfigReloader::reloadNow()
+{
+    std::lock_guard<std::mutex> reloadLock(reloadMutex_);
+    std::shared_ptr<ConfigSnapshot> next;
+    std::string error;
+    try {
+        next = loadLayeredConfig(options_.configDir, options_.profile);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    bool published = false;
+    std::string listenerError;
+    if (next && !next->sameAs(*store_.snapshot())) {
+        const std::uint64_t before = store_.version();
+        try {
+            store_.publish(std::move(next));
+        } catch (const std::exception& e) {
+            // 抛出时快照通常已经换上，只是监听者出了错；异常不能逃出热加载线程
+            listenerError = std::string("config listener: ") + e.what();
+        } catch (...) {
+            listenerError = "config listener: unknown exception";
+        }
+        published = store_.version() != before;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++status_.checks;
+    if (!error.empty()) {
+        ++status_.failures;
+        status_.lastError = std::move(error);
+    } else if (published) {
+        ++status_.reloads;
+    } else if (listenerError.empty()) {
+        ++status_.unchanged;
+    }
+    if (!listenerError.empty()) {
+        ++status_.listenerFailures;
+        status_.lastError = std::move(listenerError);
+    }
+    return published;
+}
+
+void ConfigReloader::run()
+{
+    using Clock = std::chrono::steady_clock;
+    auto seen = fingerprints();
+    // 启动后先对一次账：store 里的快照加载之后、线程起来之前文件可能已经变了
+    bool pending = true;                    // 有未处理的变化
+    Clock::time_point deadline = Clock::now();   // 计划加载的时刻
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        // 事件驱动时也不无限期等待：事件可能丢失，按 backstopInterval 对一次账
+        const Clock::duration idle = eventDriven_ ? Clock::duration(options_.backstopInterval)
+                                                  : Clock::duration(options_.pollInterval);
+        const auto wait = pending ? std::min<Clock::duration>(options_.pollInterval, deadline - Clock::now()) : idle;
+        const auto wakeUp = [this] { return !running_ || notified_; };
+        cv_.wait_for(lock, std::max<Clock::duration>(wait, Clock::duration::zero()), wakeUp);
+        if (!running_) break;
+        const bool notified = notified_;
+        notified_ = false;
+        lock.unlock();
+
+        // 每次看到新变化都把加载时刻往后推，直到文件安静 debounce 时间
+        auto now = fingerprints();
+        if (notified || now != seen) {
+            seen = std::move(now);
+            pending = true;
+            deadline = Clock::now() + options_.debounce;
+        }
+        if (pending && Clock::now() >= deadline) {
+            pending = false;
+            reloadNow();
+        }
+        lock.lock();
+    }
+}
+
+} // namespace config
+} // namespace foundation
@@ -0,0 +1,516 @@
+#include "foundation/config/ConfigSnapshot.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+#include "foundation/json/json_sax.h"
+
+namespace foundation {
+namespace config {
+
+std::uint64_t hashConfigPath(std::string_view path)
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : path) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// ==================== ConfigValue ====================
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        char x = a[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (x != b[i]) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool parseWhole(std::string_view s, T& out)
+{
+    if (s.empty()) return false;
+    const char* first = s.data();
+    if (*first == '+') ++first;
+    const auto r = std::from_chars(first, s.data() + s.size(), out);
+    return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+std::string formatDouble(double v)
+{
+    char buf[32];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+    return std::string(buf, r.ptr);
+}
+
+} // namespace
+
+ConfigValue ConfigValue::null()
+{
+    return ConfigValue();
+}
+
+ConfigValue ConfigValue::fromBool(bool v)
+{
+    ConfigValue c;
+    c.type = Type::Bool;
+    c.hasBool = c.hasInt = c.hasDouble = true;
+    c.boolValue = v;
+    c.intValue = v ? 1 : 0;
+    c.doubleValue = v ? 1.0 : 0.0;
+    c.text = v ? "true" : "false";
+    return c;
+}
+
+ConfigValue ConfigValue::fromInt(std::int64_t v)
+{
+    ConfigValue c;
+    c.type = Type::Int;
+    c.hasInt = c.hasDouble = true;
+    c.intValue = v;
+    c.doubleValue = static_cast<double>(v);
+    c.hasBool = v == 0 || v == 1;
+    c.boolValue = v == 1;
+    c.text = std::to_string(v);
+    return c;
+}
+
+ConfigValue ConfigValue::fromDouble(double v)
+{
+    ConfigValue c;
+    c.type = Type::Double;
+    c.hasDouble = true;
+    c.doubleValue = v;
+    // 整数值的浮点数（如 3.0）也可以按整数读。先判断范围再转换：
+    // 超出 int64 的值（1e300、20 位整数）和 NaN/Inf 转换是未定义行为。2^63 本身已越界
+    constexpr double kInt64Bound = 9223372036854775808.0;   // 2^63
+    if (std::isfinite(v) && v >= -kInt64Bound && v < kInt64Bound && v == std::trunc(v)) {
+        c.hasInt = true;
+        c.intValue = static_cast<std::int64_t>(v);
+    }
+    c.text = formatDouble(v);
+    return c;
+}
+
+ConfigValue ConfigValue::fromString(std::string v)
+{
+    ConfigValue c;
+    c.type = Type::String;
+    if (equalsIgnoreCase(v, "true") || equalsIgnoreCase(v, "yes") || equalsIgnoreCase(v, "on") || v == "1") {
+        c.hasBool = true;
+        c.boolValue = true;
+    } else if (equalsIgnoreCase(v, "false") || equalsIgnoreCase(v, "no") || equalsIgnoreCase(v, "off") || v == "0") {
+        c.hasBool = true;
+        c.boolValue = false;
+    }
+    c.hasInt = parseWhole(v, c.intValue);
+    c.hasDouble = parseWhole(v, c.doubleValue);
+    if (!c.hasInt) c.intValue = 0;
+    if (!c.hasDouble) c.doubleValue = 0.0;
+    c.text = std::move(v);
+    return c;
+}
+
+// ==================== JSON 展开 ====================
+
+namespace {
+
+// 一次合并操作：value 为空表示删除 path 及其所有子路径（数组整体替换、空对象清空时使用）
+using MergeOp = std::pair<std::string, std::optional<ConfigValue>>;
+
+// 把 JSON 展开成 "a.b.0.c" 路径上的合并操作；解析交给 json_sax，这里只维护当前路径
+class FlattenHandler : public json::JsonSaxHandler {
+public:
+    std::vector<MergeOp> ops;
+    std::string error;   // 非空表示语义错误（解析被回调中止）
+
+    bool onNull() override { return scalar(ConfigValue::null()); }
+    bool onBool(bool v) override { return scalar(ConfigValue::fromBool(v)); }
+    bool onInt(std::int64_t v) override { return scalar(ConfigValue::fromInt(v)); }
+    bool onDouble(double v) override { return scalar(ConfigValue::fromDouble(v)); }
+    bool onString(std::string_view v) override { return scalar(ConfigValue::fromString(std::string(v))); }
+
+    bool onKey(std::string_view key) override {
+        if (key.empty()) return reject("empty key");
+        ++frames_.back().index;
+        path_.resize(frames_.back().pathLen);
+        if (!path_.empty()) path_ += '.';
+        path_.append(key.data(), key.size());
+        return true;
+    }
+
+    bool onStartObject() override {
+        if (frames_.empty() && rootSeen_) return reject("top-level value must be an object");
+        rootSeen_ = true;
+        nextElement();
+        frames_.push_back({false, 0, path_.size()});
+        return true;
+    }
+
+    bool onStartArray() override {
+        if (frames_.empty()) return reject("top-level value must be an object");
+        nextElement();
+        ops.emplace_back(path_, std::nullopt);
+        frames_.push_back({true, 0, path_.size()});
+        return true;
+    }
+
+    bool onEndObject() override {
+        // 空对象覆盖之前的同名标量或子树；顶层的 {} 什么也不改
+        const Frame f = frames_.back();
+        frames_.pop_back();
+        if (f.index == 0 && f.pathLen > 0) ops.emplace_back(path_.substr(0, f.pathLen), std::nullopt);
+        return true;
+    }
+
+    bool onEndArray() override {
+        frames_.pop_back();
+        return true;
+    }
+
+private:
+    struct Frame {
+        bool array;
+        std::size_t index;     // 数组的下一个下标；对象为已出现的成员数
+        std::size_t pathLen;   // 容器自身的路径长度
+    };
+
+    bool reject(const char* what) {
+        error = what;
+        return false;
+    }
+
+    // 数组元素的路径是 "容器路径.下标"；对象成员的路径已由 onKey 设好
+    void nextElement() {
+        if (frames_.empty() || !frames_.back().array) return;
+        Frame& f = frames_.back();
+        path_.resize(f.pathLen);
+        if (!path_.empty()) path_ += '.';
+        path_ += std::to_string(f.index++);
+    }
+
+    bool scalar(ConfigValue value) {
+        if (frames_.empty()) return reject("top-level value must be an object");
+        nextElement();
+        ops.emplace_back(path_, std::move(value));
+        return true;
+    }
+
+    std::vector<Frame> frames_;
+    std::string path_;
+    bool rootSeen_ = false;
+};
+
+std::vector<MergeOp> flattenJson(std::string_view text, const std::string& source)
+{
+    json::JsonSaxOptions options;
+    options.maxDepth = 64;
+    options.allowComments = true;
+    FlattenHandler handler;
+    const auto result = json::parseJsonSax(text, handler, options);
+    if (result.ok && !result.stopped) return std::move(handler.ops);
+    const std::size_t end = std::min(result.offset, text.size());
+    const std::size_t line = 1 + static_cast<std::size_t>(std::count(text.begin(), text.begin() + end, '\n'));
+    const std::string& what = result.stopped ? handler.error : result.error;
+    throw std::runtime_error("config: " + source + ":" + std::to_string(line) + ": " + what);
+}
+
+bool hasPrefix(std::string_view s, std::string_view prefix)
+{
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+void eraseSubtree(std::map<std::string, ConfigValue, std::less<>>& values, const std::string& path)
+{
+    values.erase(path);
+    const std::string prefix = path + ".";
+    auto it = values.lower_bound(prefix);
+    while (it != values.end() && hasPrefix(it->first, prefix)) it = values.erase(it);
+}
+
+} // namespace
+
+// ==================== Builder ====================
+
+ConfigSnapshot::Builder& ConfigSnapshot::Builder::set(const std::string& path, ConfigValue value)
+{
+    if (path.empty()) throw std::invalid_argument("config: empty key");
+    clear(path);
+    values_[path] = std::move(value);
+    return *this;
+}
+
+void ConfigSnapshot::Builder::clear(const std::string& path)
+{
+    // 标量覆盖对象：删掉旧的子路径；对象覆盖标量：删掉路径上作为叶子的祖先
+    eraseSubtree(values_, path);
+    for (std::size_t dot = path.find('.'); dot != std::string::npos; dot = path.find('.', dot + 1)) {
+        auto it = values_.find(std::string_view(path.data(), dot));
+        if (it != values_.end()) values_.erase(it);
+    }
+}
+
+ConfigSnapshot::Builder& ConfigSnapshot::Builder::mergeJson(std::string_view text, const std::string& sourceName)
+{
+    // 先完整解析，语法错误时不留下半层
+    auto ops = flattenJson(text, sourceName);
+    for (auto& [path, value] : ops) {
+        if (value) {
+            set(path, std::move(*value));
+        } else {
+            clear(path);
+        }
+    }
+    sources_.push_back(sourceName);
+    return *this;
+}
+
+ConfigSnapshot::Builder& ConfigSnapshot::Builder::mergeFile(const std::string& path, bool required)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        if (required) throw std::runtime_error("config: cannot open " + path);
+        return *this;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    std::string text = ss.str();
+    // 跳过 UTF-8 BOM
+    if (text.size() >= 3 && text.compare(0, 3, "\xEF\xBB\xBF") == 0) text.erase(0, 3);
+    return mergeJson(text, path);
+}
+
+ConfigSnapshot::Builder& ConfigSnapshot::Builder::merge(const ConfigSnapshot& other)
+{
+    for (const auto& e : other.entries_) set(e.path, e.value);
+    sources_.insert(sources_.end(), other.sources_.begin(), other.sources_.end());
+    return *this;
+}
+
+std::shared_ptr<ConfigSnapshot> ConfigSnapshot::Builder::build() const
+{
+    std::shared_ptr<ConfigSnapshot> snap(new ConfigSnapshot());
+    snap->sources_ = sources_;
+    snap->entries_.reserve(values_.size());
+    for (const auto& [path, value] : values_) {
+        snap->entries_.push_back(Entry{path, hashConfigPath(path), value});
+    }
+    // 装载因子不超过 1/2
+    std::size_t slots = 16;
+    while (slots < snap->entries_.size() * 2) slots <<= 1;
+    snap->index_.assign(slots, 0);
+    snap->mask_ = slots - 1;
+    for (std::size_t i = 0; i < snap->entries_.size(); ++i) {
+        std::uint64_t s = snap->entries_[i].hash & snap->mask_;
+        while (snap->index_[s] != 0) s = (s + 1) & snap->mask_;
+        snap->index_[s] = static_cast<std::uint32_t>(i + 1);
+    }
+    return snap;
+}
+
+std::shared_ptr<ConfigSnapshot> loadLayeredConfig(const std::string& configDir, const std::string& profile)
+{
+    ConfigSnapshot::Builder builder;
+    builder.mergeFile(configDir + "/foundation/foundation.json", true);
+    if (!profile.empty()) builder.mergeFile(configDir + "/profiles/" + profile + ".json", false);
+    builder.mergeFile(configDir + "/system/override.json", false);
+    return builder.build();
+}
+
+// ==================== ConfigSnapshot ====================
+
+const ConfigValue* ConfigSnapshot::find(std::string_view path, std::uint64_t hash) const
+{
+    for (std::uint64_t s = hash & mask_;; s = (s + 1) & mask_) {
+        const std::uint32_t slot = index_[s];
+        if (slot == 0) return nullptr;
+        const Entry& e = entries_[slot - 1];
+        if (e.hash == hash && e.path == path) return &e.value;
+    }
+}
+
+std::vector<std::string> ConfigSnapshot::keys(std::string_view prefix) const
+{
+    std::vector<std::string> out;
+    if (prefix.empty()) {
+        for (const auto& e : entries_) out.push_back(e.path);
+        return out;
+    }
+    const std::string dotted = std::string(prefix) + ".";
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), prefix,
+                               [](const Entry& e, std::string_view p) { return e.path < p; });
+    for (; it != entries_.end(); ++it) {
+        if (it->path == prefix) {
+            out.push_back(it->path);
+        } else if (hasPrefix(it->path, dotted)) {
+            out.push_back(it->path);
+        } else if (!hasPrefix(it->path, prefix)) {
+            break;
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> ConfigSnapshot::children(std::string_view prefix) const
+{
+    std::vector<std::string> out;
+    const std::string dotted = prefix.empty() ? std::string() : std::string(prefix) + ".";
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), std::string_view(dotted),
+                               [](const Entry& e, std::string_view p) { return e.path < p; });
+    for (; it != entries_.end() && hasPrefix(it->path, dotted); ++it) {
+        const std::string_view rest = std::string_view(it->path).substr(dotted.size());
+        const std::string name(rest.substr(0, rest.find('.')));
+        if (out.empty() || out.back() != name) out.push_back(name);
+    }
+    return out;
+}
+
+bool ConfigSnapshot::sameAs(const ConfigSnapshot& other, std::string_view prefix) const
+{
+    // 有序表上 prefix 子树是连续的一段，其中可能夹着 "log_x" 这类只共享前缀的兄弟节点，逐项过滤
+    const std::string dotted = std::string(prefix) + ".";
+    const auto inTree = [&](const Entry& e) { return prefix.empty() || e.path == prefix || hasPrefix(e.path, dotted); };
+    const auto range = [prefix](const std::vector<Entry>& entries) {
+        auto first = std::lower_bound(entries.begin(), entries.end(), prefix,
+                                      [](const Entry& e, std::string_view p) { return e.path < p; });
+        auto last = first;
+        while (last != entries.end() && hasPrefix(last->path, prefix)) ++last;
+        return std::make_pair(first, last);
+    };
+    auto [a, aEnd] = range(entries_);
+    auto [b, bEnd] = range(other.entries_);
+    for (;;) {
+        while (a != aEnd && !inTree(*a)) ++a;
+        while (b != bEnd && !inTree(*b)) ++b;
+        if (a == aEnd || b == bEnd) return a == aEnd && b == bEnd;
+        if (a->path != b->path || a->value.type != b->value.type || a->value.text != b->value.text) return false;
+        ++a;
+        ++b;
+    }
+}
+
+// ==================== ConfigStore ====================
+
+ConfigStore::ConfigStore(std::shared_ptr<ConfigSnapshot> initial)
+{
+    if (!initial) throw std::invalid_argument("config: null snapshot");
+    if (initial->version_ != 0) throw std::invalid_argument("config: snapshot already published");
+    initial->version_ = nextVersion_++;
+    current_.store(std::move(initial));
+}
+
+void ConfigStore::refresh(detail::StringCell& cell, const ConfigSnapshot& snap)
+{
+    cell.value.store(std::make_shared<const std::string>(snap.getString(cell.path, cell.def)));
+}
+
+namespace {
+
+template <typename Cell, typename F>
+void refreshAll(std::vector<std::weak_ptr<Cell>>& list, F&& refresh)
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < list.size(); ++i) {
+        if (auto cell = list[i].lock()) {
+            refresh(*cell);
+            if (kept != i) list[kept] = std::move(list[i]);
+            ++kept;
+        }
+    }
+    list.resize(kept);
+}
+
+} // namespace
+
+void ConfigStore::publish(std::shared_ptr<ConfigSnapshot> next)
+{
+    if (!next) throw std::invalid_argument("config: null snapshot");
+    std::lock_guard<std::mutex> publishLock(publishMutex_);
+
+    std::shared_ptr<const ConfigSnapshot> previous;
+    std::vector<Listener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (next->version_ != 0) throw std::invalid_argument("config: snapshot already published");
+        next->version_ = nextVersion_++;
+        const ConfigSnapshot& snap = *next;
+        previous = current_.exchange(std::move(next));
+
+        const auto scalar = [&snap](auto& cell) { refresh(cell, snap); };
+        refreshAll(boolCells_, scalar);
+        refreshAll(intCells_, scalar);
+        refreshAll(int64Cells_, scalar);
+        refreshAll(doubleCells_, scalar);
+        refreshAll(stringCells_, [&snap](detail::StringCell& cell) { refresh(cell, snap); });
+
+        listeners.reserve(listeners_.size());
+        for (const auto& [id, l] : listeners_) listeners.push_back(l);
+    }
+    // 监听者在锁外调用，可以在回调里创建句柄或读取 snapshot()
+    // 一个监听者抛异常不能让后面的监听者错过这次变化：全部通知完再重新抛出第一个异常
+    const auto current = snapshot();
+    std::exception_ptr firstError;
+    for (const auto& l : listeners) {
+        try {
+            l(*previous, *current);
+        } catch (...) {
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+    if (firstError) std::rethrow_exception(firstError);
+}
+
+ConfigStringHandle ConfigStore::stringHandle(const std::string& path, const std::string& def)
+{
+    auto cell = std::make_shared<detail::StringCell>();
+    cell->path = path;
+    cell->def = def;
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh(*cell, *current_.load());
+    stringCells_.erase(std::remove_if(stringCells_.begin(), stringCells_.end(),
+                                      [](const auto& w) { return w.expired(); }),
+                       stringCells_.end());
+    stringCells_.push_back(cell);
+    return ConfigStringHandle(std::move(cell));
+}
+
+std::size_t ConfigStore::addListener(Listener listener)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::size_t id = nextListenerId_++;
+    listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+std::size_t ConfigStore::subscribe(const std::string& prefix, std::function<void(const ConfigSnapshot&)> fn)
+{
+    if (!fn) throw std::invalid_argument("config: empty subscriber for " + prefix);
+    return addListener([prefix, fn = std::move(fn)](const ConfigSnapshot& oldSnap, const ConfigSnapshot& newSnap) {
+        if (!newSnap.sameAs(oldSnap, prefix)) fn(newSnap);
+    });
+}
+
+void ConfigStore::removeListener(std::size_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                    [id](const auto& p) { return p.first == id; }),
+                     listeners_.end());
+}
+
+} // namespace config
+} // namespace foundation
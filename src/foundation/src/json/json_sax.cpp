@@ -0,0 +1,447 @@
+#include "foundation/json/json_sax.h"
+
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FOUNDATION_JSON_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace foundation {
+namespace json {
+
+namespace {
+
+#if FOUNDATION_JSON_SSE2
+inline int lowestBit(unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// 字符串内第一个需要特殊处理的字符：引号、反斜杠或控制字符
+const char* findStringSpecial(const char* p, const char* end)
+{
+#if FOUNDATION_JSON_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+        // 无符号 v <= 0x1F
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask != 0) return p + lowestBit(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) ++p;
+    return p;
+}
+
+const char* skipSpaces(const char* p, const char* end)
+{
+    // 紧凑 JSON 里空白很少，先逐字节看两个；格式化过的大文件才走 SIMD
+    for (int i = 0; i < 2; ++i) {
+        if (p == end || !isSpace(*p)) return p;
+        ++p;
+    }
+#if FOUNDATION_JSON_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, nl)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, tab)));
+        const unsigned notWs = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+        if (notWs != 0) return p + lowestBit(notWs);
+        p += 16;
+    }
+#endif
+    while (p < end && isSpace(*p)) ++p;
+    return p;
+}
+
+void appendUtf8(std::string& out, std::uint32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+class SaxParser {
+public:
+    SaxParser(std::string_view text, JsonSaxHandler& handler, const JsonSaxOptions& options)
+        : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()), handler_(handler), options_(options) {}
+
+    JsonSaxResult run() {
+        JsonSaxResult result;
+        if (!parse()) {
+            result.offset = static_cast<std::size_t>(p_ - begin_);
+            if (stopped_) {
+                result.ok = true;
+                result.stopped = true;
+            } else {
+                result.error = error_;
+            }
+            return result;
+        }
+        result.ok = true;
+        result.offset = static_cast<std::size_t>(p_ - begin_);
+        return result;
+    }
+
+private:
+    bool fail(const char* what) {
+        if (error_.empty()) error_ = what;
+        return false;
+    }
+
+    // 回调返回 false
+    bool stop() {
+        stopped_ = true;
+        return false;
+    }
+
+    bool skip() {
+        for (;;) {
+            p_ = skipSpaces(p_, end_);
+            if (!options_.allowComments || p_ + 1 >= end_ || *p_ != '/') return true;
+            if (p_[1] == '/') {
+                while (p_ < end_ && *p_ != '\n') ++p_;
+            } else if (p_[1] == '*') {
+                const char* close = nullptr;
+                for (const char* q = p_ + 2; q + 1 < end_; ++q) {
+                    if (q[0] == '*' && q[1] == '/') {
+                        close = q;
+                        break;
+                    }
+                }
+                if (!close) return fail("unterminated comment");
+                p_ = close + 2;
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool parse() {
+        if (!skip()) return false;
+        bool needValue = true;   // false 表示刚结束一个值，等待 , ] } 或输入结束
+        for (;;) {
+            if (needValue) {
+                if (p_ == end_) return fail("unexpected end of input");
+                const char c = *p_;
+                if (c == '{') {
+                    if (!push('{')) return false;
+                    ++p_;
+                    if (!handler_.onStartObject()) return stop();
+                    if (!skip()) return false;
+                    if (p_ < end_ && *p_ == '}') {
+                        ++p_;
+                        stack_.pop_back();
+                        if (!handler_.onEndObject()) return stop();
+                        needValue = false;
+                    } else if (!parseKey()) {
+                        return false;
+                    }
+                } else if (c == '[') {
+                    if (!push('[')) return false;
+                    ++p_;
+                    if (!handler_.onStartArray()) return stop();
+                    if (!skip()) return false;
+                    if (p_ < end_ && *p_ == ']') {
+                        ++p_;
+                        stack_.pop_back();
+                        if (!handler_.onEndArray()) return stop();
+                        needValue = false;
+                    }
+                } else {
+                    if (!parseScalar()) return false;
+                    needValue = false;
+                }
+                continue;
+            }
+
+            if (!skip()) return false;
+            if (stack_.empty()) {
+                if (p_ != end_) return fail("trailing characters");
+                return true;
+            }
+            if (p_ == end_) return fail("unexpected end of input");
+            const char c = *p_++;
+            const char top = stack_.back();
+            if (c == ',') {
+                if (!skip()) return false;
+                if (top == '{' && !parseKey()) return false;
+                needValue = true;
+            } else if (c == '}' && top == '{') {
+                stack_.pop_back();
+                if (!handler_.onEndObject()) return stop();
+            } else if (c == ']' && top == '[') {
+                stack_.pop_back();
+                if (!handler_.onEndArray()) return stop();
+            } else {
+                --p_;
+                return fail("expected ',' or closing bracket");
+            }
+        }
+    }
+
+    bool push(char c) {
+        if (stack_.size() >= options_.maxDepth) return fail("nesting too deep");
+        stack_.push_back(c);
+        return true;
+    }
+
+    // 读 "key" : ，之后等待值
+    bool parseKey() {
+        if (p_ == end_ || *p_ != '"') return fail("expected object key");
+        std::string_view key;
+        if (!parseString(key)) return false;
+        if (!handler_.onKey(key)) return stop();
+        if (!skip()) return false;
+        if (p_ == end_ || *p_ != ':') return fail("expected ':'");
+        ++p_;
+        return skip();
+    }
+
+    bool parseScalar() {
+        const char c = *p_;
+        if (c == '"') {
+            std::string_view s;
+            if (!parseString(s)) return false;
+            return handler_.onString(s) || stop();
+        }
+        if (c == 't') {
+            if (!literal("true", 4)) return false;
+            return handler_.onBool(true) || stop();
+        }
+        if (c == 'f') {
+            if (!literal("false", 5)) return false;
+            return handler_.onBool(false) || stop();
+        }
+        if (c == 'n') {
+            if (!literal("null", 4)) return false;
+            return handler_.onNull() || stop();
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) return parseNumber();
+        return fail("unexpected character");
+    }
+
+    bool literal(const char* word, std::size_t n) {
+        if (static_cast<std::size_t>(end_ - p_) < n || std::memcmp(p_, word, n) != 0) return fail("invalid literal");
+        p_ += n;
+        return true;
+    }
+
+    bool parseNumber() {
+        const char* start = p_;
+        bool negative = false;
+        if (*p_ == '-') {
+            negative = true;
+            ++p_;
+        }
+        // 先按 JSON 语法校验：不允许前导零、"1."、".5"、"1e"
+        if (p_ == end_ || !isDigit(*p_)) return failAt(start, "invalid number");
+        std::uint64_t value = 0;
+        const char* digits = p_;
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            while (p_ < end_ && isDigit(*p_)) {
+                value = value * 10 + static_cast<std::uint64_t>(*p_ - '0');
+                ++p_;
+            }
+        }
+        const std::size_t digitCount = static_cast<std::size_t>(p_ - digits);
+        bool fractional = false;
+        if (p_ < end_ && *p_ == '.') {
+            fractional = true;
+            ++p_;
+            if (p_ == end_ || !isDigit(*p_)) return failAt(start, "invalid number");
+            while (p_ < end_ && isDigit(*p_)) ++p_;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            fractional = true;
+            ++p_;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+            if (p_ == end_ || !isDigit(*p_)) return failAt(start, "invalid number");
+            while (p_ < end_ && isDigit(*p_)) ++p_;
+        }
+        if (p_ < end_ && isDigit(*p_)) return failAt(start, "invalid number");   // 0 后面跟数字
+
+        // 整数快速路径：18 位以内不会溢出
+        if (!fractional && digitCount <= 18) {
+            // -0 没有对应的整数，按 double 报告以保留符号
+            if (negative && value == 0) return handler_.onDouble(-0.0) || stop();
+            const auto v = negative ? -static_cast<std::int64_t>(value) : static_cast<std::int64_t>(value);
+            return handler_.onInt(v) || stop();
+        }
+        // 小数、指数或很长的整数交给 from_chars（精确舍入，不依赖 locale）
+        if (!fractional) {
+            std::int64_t i = 0;
+            const auto r = std::from_chars(start, p_, i);
+            if (r.ec == std::errc() && r.ptr == p_) return handler_.onInt(i) || stop();
+        }
+        double d = 0.0;
+        const auto r = std::from_chars(start, p_, d);
+        if (r.ec != std::errc() || r.ptr != p_) return failAt(start, "number out of range");
+        return handler_.onDouble(d) || stop();
+    }
+
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    bool failAt(const char* at, const char* what) {
+        p_ = at;
+        return fail(what);
+    }
+
+    bool parseHex4(std::uint32_t& out) {
+        if (end_ - p_ < 4) return fail("truncated \\u escape");
+        out = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = *p_++;
+            out <<= 4;
+            if (c >= '0' && c <= '9') {
+                out |= static_cast<std::uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                out |= static_cast<std::uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                out |= static_cast<std::uint32_t>(c - 'A' + 10);
+            } else {
+                return fail("invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    // p_ 指向开头的引号；结束时指向结尾引号之后
+    bool parseString(std::string_view& out) {
+        const char* start = ++p_;
+        const char* q = findStringSpecial(p_, end_);
+        if (q < end_ && *q == '"') {
+            out = std::string_view(start, static_cast<std::size_t>(q - start));
+            p_ = q + 1;
+            return true;
+        }
+        // 有转义：解码到 scratch_
+        scratch_.assign(start, q);
+        p_ = q;
+        for (;;) {
+            if (p_ == end_) return fail("unterminated string");
+            const char c = *p_;
+            if (c == '"') {
+                ++p_;
+                out = scratch_;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) return fail("control character in string");
+            if (c != '\\') {
+                q = findStringSpecial(p_, end_);
+                scratch_.append(p_, q);
+                p_ = q;
+                continue;
+            }
+            if (++p_ == end_) return fail("unterminated string");
+            const char e = *p_++;
+            switch (e) {
+            case '"': scratch_ += '"'; break;
+            case '\\': scratch_ += '\\'; break;
+            case '/': scratch_ += '/'; break;
+            case 'b': scratch_ += '\b'; break;
+            case 'f': scratch_ += '\f'; break;
+            case 'n': scratch_ += '\n'; break;
+            case 'r': scratch_ += '\r'; break;
+            case 't': scratch_ += '\t'; break;
+            case 'u': {
+                std::uint32_t cp = 0;
+                if (!parseHex4(cp)) return false;
+                if (cp >= 0xD800 && cp < 0xDC00) {
+                    if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') return fail("unpaired surrogate");
+                    p_ += 2;
+                    std::uint32_t lo = 0;
+                    if (!parseHex4(lo)) return false;
+                    if (lo < 0xDC00 || lo >= 0xE000) return fail("unpaired surrogate");
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                } else if (cp >= 0xDC00 && cp < 0xE000) {
+                    return fail("unpaired surrogate");   // 没有高代理在前的低代理
+                }
+                appendUtf8(scratch_, cp);
+                break;
+            }
+            default: return fail("invalid escape");
+            }
+        }
+    }
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    JsonSaxHandler& handler_;
+    const JsonSaxOptions& options_;
+    std::vector<char> stack_;
+    std::string scratch_;
+    std::string error_;
+    bool stopped_ = false;
+};
+
+} // namespace
+
+JsonSaxResult parseJsonSax(std::string_view text, JsonSaxHandler& handler, const JsonSaxOptions& options)
+{
+    return SaxParser(text, handler, options).run();
+}
+
+bool parseJsonNumber(std::string_view s, double& out)
+{
+    if (s.empty()) return false;
+    const char* first = s.data();
+    if (*first == '+') ++first;
+    const auto r = std::from_chars(first, s.data() + s.size(), out);
+    return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+bool parseJsonNumber(std::string_view s, std::int64_t& out)
+{
+    if (s.empty()) return false;
+    const char* first = s.data();
+    if (*first == '+') ++first;
+    const auto r = std::from_chars(first, s.data() + s.size(), out);
+    return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+} // namespace json
+} // namespace foundation
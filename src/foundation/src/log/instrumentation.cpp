@@ -0,0 +1,225 @@
+#include "foundation/log/instrumentation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using foundation::utils::LatencyHistogram;
+
+namespace foundation {
+namespace metrics {
+
+namespace {
+
+constexpr std::size_t kStageCount = static_cast<std::size_t>(Stage::Count);
+
+struct ThreadStats {
+    std::array<LatencyHistogram, kStageCount> stages;
+};
+
+// 线程注册表：只在线程第一次打点和线程退出时加锁。
+// 线程退出时把自己的数据并入 retired 并注销，线程池反复起停线程时注册表不会无限增长
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadStats>> threads;   // 存活线程
+    ThreadStats retired;                                 // 已退出线程的合并数据
+};
+
+Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+// 每线程一份，析构（线程退出）时归档。直方图放在堆上，不占每个线程的 TLS 空间
+struct LocalStats {
+    std::shared_ptr<ThreadStats> stats = std::make_shared<ThreadStats>();
+
+    LocalStats()
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(stats);
+    }
+    ~LocalStats()
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (std::size_t i = 0; i < kStageCount; ++i) r.retired.stages[i].merge(stats->stages[i]);
+        r.threads.erase(std::find(r.threads.begin(), r.threads.end(), stats));
+    }
+};
+
+ThreadStats& localStats()
+{
+    thread_local LocalStats local;
+    return *local.stats;
+}
+
+} // namespace
+
+std::atomic<bool> Instrumentation::enabled_{true};
+std::atomic<double> Instrumentation::nanosPerTick_{0.0};
+
+const char* stageName(Stage stage)
+{
+    switch (stage) {
+    case Stage::DataDecode: return "data_decode";
+    case Stage::Dispatch: return "dispatch";
+    case Stage::IndicatorUpdate: return "indicator_update";
+    case Stage::SignalEval: return "signal_eval";
+    case Stage::StrategyStep: return "strategy_step";
+    case Stage::OrderSimulation: return "order_simulation";
+    case Stage::Count: break;
+    }
+    return "unknown";
+}
+
+double Instrumentation::calibrate(std::chrono::nanoseconds window)
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::uint64_t c0 = now();
+    // 短窗口忙等，sleep 的精度不够
+    if (window < std::chrono::milliseconds(1)) {
+        while (std::chrono::steady_clock::now() - t0 < window) {
+        }
+    } else {
+        std::this_thread::sleep_for(window);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const std::uint64_t c1 = now();
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    const double ticksPerNano = ns > 0.0 && c1 > c0 ? static_cast<double>(c1 - c0) / ns : 1.0;
+#else
+    (void)window;
+    const double ticksPerNano = 1.0;
+#endif
+    nanosPerTick_.store(1.0 / ticksPerNano, std::memory_order_relaxed);
+    return ticksPerNano;
+}
+
+void Instrumentation::resetCalibration()
+{
+    nanosPerTick_.store(0.0, std::memory_order_relaxed);
+}
+
+std::uint64_t Instrumentation::toNanos(std::uint64_t ticks)
+{
+    double k = nanosPerTick_.load(std::memory_order_relaxed);
+    if (k == 0.0) {
+        // 没有在启动时校准：粗校准一次，不让第一个探针等 20ms
+        calibrate(std::chrono::microseconds(100));
+        k = nanosPerTick_.load(std::memory_order_relaxed);
+    }
+    return static_cast<std::uint64_t>(static_cast<double>(ticks) * k);
+}
+
+void Instrumentation::record(Stage stage, std::uint64_t nanos)
+{
+    localStats().stages[static_cast<std::size_t>(stage)].recordSingleWriter(nanos);
+}
+
+Instrumentation::StageSummary Instrumentation::summary(Stage stage)
+{
+    const std::size_t i = static_cast<std::size_t>(stage);
+    // 归档数据与存活线程列表在同一把锁下取，线程恰好在两者之间退出也不会重复或漏计
+    LatencyHistogram merged;
+    std::vector<std::shared_ptr<ThreadStats>> threads;
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        merged.merge(r.retired.stages[i]);
+        threads = r.threads;
+    }
+    for (const auto& t : threads) merged.merge(t->stages[i]);
+
+    StageSummary s;
+    s.stage = stage;
+    s.count = merged.count();
+    s.meanMicros = merged.mean() / 1e3;
+    s.totalMillis = s.meanMicros * static_cast<double>(s.count) / 1e3;
+    s.p50Micros = static_cast<double>(merged.percentile(50)) / 1e3;
+    s.p99Micros = static_cast<double>(merged.percentile(99)) / 1e3;
+    s.maxMicros = static_cast<double>(merged.max()) / 1e3;
+    return s;
+}
+
+std::array<Instrumentation::StageSummary, kStageCount> Instrumentation::snapshot()
+{
+    std::array<StageSummary, kStageCount> result{};
+    for (std::size_t i = 0; i < kStageCount; ++i) result[i] = summary(static_cast<Stage>(i));
+    return result;
+}
+
+std::string Instrumentation::report()
+{
+    const auto stages = snapshot();
+    double total = 0.0;
+    for (const auto& s : stages) total += s.totalMillis;
+
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-18s %12s %12s %7s %10s %10s %10s %10s\n", "stage", "count", "total_ms",
+                  "share", "mean_us", "p50_us", "p99_us", "max_us");
+    out += line;
+    for (const auto& s : stages) {
+        std::snprintf(line, sizeof(line), "%-18s %12llu %12.3f %6.1f%% %10.3f %10.3f %10.3f %10.3f\n",
+                      stageName(s.stage), static_cast<unsigned long long>(s.count), s.totalMillis,
+                      total > 0.0 ? s.totalMillis * 100.0 / total : 0.0, s.meanMicros, s.p50Micros, s.p99Micros,
+                      s.maxMicros);
+        out += line;
+    }
+    return out;
+}
+
+void Instrumentation::reset()
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto& h : r.retired.stages) h.reset();
+    for (auto& t : r.threads) {
+        for (auto& h : t->stages) h.reset();
+    }
+}
+
+std::vector<CallbackHandle> Instrumentation::bindMetrics(const std::string& name)
+{
+    auto& registry = foundation::metrics::MetricsRegistry::instance();
+    std::vector<CallbackHandle> handles;
+    for (std::size_t i = 0; i < kStageCount; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const Labels labels{{"engine", name}, {"stage", stageName(stage)}};
+        handles.push_back(registry.counterCallback("engine_stage_samples_total", labels, [stage] {
+            return static_cast<double>(summary(stage).count);
+        }));
+        handles.push_back(registry.counterCallback("engine_stage_seconds_total", labels, [stage] {
+            return summary(stage).totalMillis / 1e3;
+        }));
+        const std::pair<const char*, double StageSummary::*> quantiles[] = {
+            {"0.5", &StageSummary::p50Micros}, {"0.99", &StageSummary::p99Micros}, {"1", &StageSummary::maxMicros}};
+        for (const auto& [q, field] : quantiles) {
+            auto l = labels;
+            l["quantile"] = q;
+            handles.push_back(registry.gaugeCallback("engine_stage_latency_us", l, [stage, field = field] {
+                return summary(stage).*field;
+            }));
+        }
+    }
+    return handles;
+}
+
+std::size_t Instrumentation::threadCount()
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.threads.size();
+}
+
+} // namespace metrics
+} // namespace foundation
@@ -0,0 +1,434 @@
+#include "foundation/log/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace foundation {
+namespace metrics {
+
+using foundation::utils::LatencyHistogram;
+
+std::size_t threadShard()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+// ==================== Counter / Gauge / Histogram ====================
+
+std::uint64_t Counter::value() const
+{
+    std::uint64_t sum = 0;
+    for (const auto& c : cells_) sum += c.value.load(std::memory_order_relaxed);
+    return sum;
+}
+
+void Counter::reset()
+{
+    for (auto& c : cells_) c.value.store(0, std::memory_order_relaxed);
+}
+
+void Gauge::add(double d)
+{
+    double cur = value_.load(std::memory_order_relaxed);
+    while (!value_.compare_exchange_weak(cur, cur + d, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::snapshot(LatencyHistogram& out) const
+{
+    out.reset();
+    for (const auto& s : shards_) out.merge(s);
+}
+
+void Histogram::reset()
+{
+    for (auto& s : shards_) s.reset();
+}
+
+// ==================== MetricsRegistry ====================
+
+namespace {
+
+void validateName(const std::string& name)
+{
+    if (name.empty()) throw std::invalid_argument("metrics: empty name");
+    for (char c : name) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                        c == ':';
+        if (!ok) throw std::invalid_argument("metrics: invalid name " + name);
+    }
+}
+
+std::string escape(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '"': out += "\\\""; break;
+        case '\n': out += "\\n"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out;
+}
+
+std::string labelText(const Labels& labels, const std::string& extraKey = std::string(),
+                      const std::string& extraValue = std::string())
+{
+    if (labels.empty() && extraKey.empty()) return std::string();
+    std::string out = "{";
+    bool first = true;
+    for (const auto& [k, v] : labels) {
+        if (!first) out += ',';
+        out += k + "=\"" + escape(v) + "\"";
+        first = false;
+    }
+    if (!extraKey.empty()) {
+        if (!first) out += ',';
+        out += extraKey + "=\"" + extraValue + "\"";
+    }
+    out += '}';
+    return out;
+}
+
+std::string formatNumber(double v)
+{
+    if (std::isnan(v)) return "NaN";
+    if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+// JSON 不支持 NaN/Inf，输出为 null
+std::string jsonNumber(double v)
+{
+    return std::isfinite(v) ? formatNumber(v) : "null";
+}
+
+const char* typeName(MetricSample::Type t)
+{
+    switch (t) {
+    case MetricSample::Type::Counter: return "counter";
+    case MetricSample::Type::Gauge: return "gauge";
+    case MetricSample::Type::Histogram: return "summary";
+    }
+    return "untyped";
+}
+
+} // namespace
+
+struct MetricsRegistry::Impl {
+    struct Entry {
+        std::string name;
+        Labels labels;
+        MetricSample::Type type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    // 回调本体单独加锁：导出时在注册表锁外调用，注销时拿这把锁等正在进行的调用结束
+    struct CallbackSlot {
+        std::mutex mutex;
+        bool alive = true;
+        std::function<double()> fn;
+    };
+
+    struct Callback {
+        std::string name;
+        Labels labels;
+        MetricSample::Type type;
+        std::string key;
+        std::shared_ptr<CallbackSlot> slot;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;                 // key = name + 标签文本，有序便于稳定输出
+    std::unordered_map<std::string, MetricSample::Type> types;
+    std::map<std::uint64_t, Callback> callbacks;
+    std::unordered_set<std::string> callbackKeys;        // 回调占用的 name + 标签文本
+    std::uint64_t nextCallbackId = 1;
+
+    // 同一个名字（不论是对象还是回调）只能有一种类型，否则导出的 # TYPE 会自相矛盾
+    void claimType(const std::string& name, MetricSample::Type type) {
+        validateName(name);
+        auto t = types.find(name);
+        if (t != types.end() && t->second != type) {
+            throw std::invalid_argument("metrics: " + name + " already registered with another type");
+        }
+        types[name] = type;
+    }
+
+    Entry& find(const std::string& name, const Labels& labels, MetricSample::Type type) {
+        claimType(name, type);
+        const std::string key = name + labelText(labels);
+        auto it = entries.find(key);
+        if (it != entries.end()) return it->second;
+        if (callbackKeys.count(key)) {
+            throw std::invalid_argument("metrics: " + key + " already registered as a callback");
+        }
+        Entry e;
+        e.name = name;
+        e.labels = labels;
+        e.type = type;
+        return entries.emplace(key, std::move(e)).first->second;
+    }
+};
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::MetricsRegistry() : impl_(std::make_unique<Impl>()) {}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+Counter& MetricsRegistry::counter(const std::string& name, const Labels& labels)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& e = impl_->find(name, labels, MetricSample::Type::Counter);
+    if (!e.counter) e.counter = std::make_unique<Counter>();
+    return *e.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const Labels& labels)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& e = impl_->find(name, labels, MetricSample::Type::Gauge);
+    if (!e.gauge) e.gauge = std::make_unique<Gauge>();
+    return *e.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const Labels& labels)
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& e = impl_->find(name, labels, MetricSample::Type::Histogram);
+    if (!e.histogram) e.histogram = std::make_unique<Histogram>();
+    return *e.histogram;
+}
+
+CallbackHandle MetricsRegistry::gaugeCallback(const std::string& name, const Labels& labels,
+                                              std::function<double()> fn)
+{
+    return addCallback(name, labels, MetricSample::Type::Gauge, std::move(fn));
+}
+
+CallbackHandle MetricsRegistry::counterCallback(const std::string& name, const Labels& labels,
+                                                std::function<double()> fn)
+{
+    return addCallback(name, labels, MetricSample::Type::Counter, std::move(fn));
+}
+
+CallbackHandle MetricsRegistry::addCallback(const std::string& name, const Labels& labels, MetricSample::Type type,
+                                            std::function<double()> fn)
+{
+    if (!fn) throw std::invalid_argument("metrics: empty callback for " + name);
+    auto slot = std::make_shared<Impl::CallbackSlot>();
+    slot->fn = std::move(fn);
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->claimType(name, type);
+    // 同名同标签只能有一个序列，否则导出重复的样本
+    std::string key = name + labelText(labels);
+    if (impl_->entries.count(key) || impl_->callbackKeys.count(key)) {
+        throw std::invalid_argument("metrics: " + key + " already registered");
+    }
+    const std::uint64_t id = impl_->nextCallbackId++;
+    impl_->callbackKeys.insert(key);
+    impl_->callbacks.emplace(id, Impl::Callback{name, labels, type, std::move(key), std::move(slot)});
+    return CallbackHandle(this, id);
+}
+
+void MetricsRegistry::unregister(std::uint64_t id)
+{
+    std::shared_ptr<Impl::CallbackSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        auto it = impl_->callbacks.find(id);
+        if (it == impl_->callbacks.end()) return;
+        impl_->callbackKeys.erase(it->second.key);
+        slot = std::move(it->second.slot);
+        impl_->callbacks.erase(it);
+    }
+    // 等正在导出的调用结束；返回后回调不会再被调用
+    std::function<double()> fn;
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->alive = false;
+        fn.swap(slot->fn);
+    }
+}
+
+std::vector<MetricSample> MetricsRegistry::snapshot() const
+{
+    std::vector<MetricSample> out;
+    std::vector<Impl::Callback> callbacks;
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    out.reserve(impl_->entries.size() + impl_->callbacks.size());
+    callbacks.reserve(impl_->callbacks.size());
+    for (const auto& [id, cb] : impl_->callbacks) callbacks.push_back(cb);
+    LatencyHistogram merged;
+    for (const auto& [key, e] : impl_->entries) {
+        MetricSample s;
+        s.name = e.name;
+        s.labels = e.labels;
+        s.type = e.type;
+        switch (e.type) {
+        case MetricSample::Type::Counter:
+            s.value = static_cast<double>(e.counter->value());
+            break;
+        case MetricSample::Type::Gauge:
+            s.value = e.gauge->value();
+            break;
+        case MetricSample::Type::Histogram:
+            e.histogram->snapshot(merged);
+            s.count = merged.count();
+            s.sum = merged.mean() * static_cast<double>(s.count);
+            s.p50 = merged.percentile(50);
+            s.p90 = merged.percentile(90);
+            s.p99 = merged.percentile(99);
+            s.max = merged.max();
+            break;
+        }
+        out.push_back(std::move(s));
+    }
+    lock.unlock();
+
+    // 回调在注册表锁外执行，回调里可以读写其它指标；已注销的跳过
+    for (auto& cb : callbacks) {
+        std::lock_guard<std::mutex> slotLock(cb.slot->mutex);
+        if (!cb.slot->alive) continue;
+        MetricSample s;
+        s.name = std::move(cb.name);
+        s.labels = std::move(cb.labels);
+        s.type = cb.type;
+        s.value = cb.slot->fn();
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+std::string MetricsRegistry::exportText() const
+{
+    auto samples = snapshot();
+    // 同名的样本要连续输出，# TYPE 只写一次
+    std::stable_sort(samples.begin(), samples.end(),
+                     [](const MetricSample& a, const MetricSample& b) { return a.name < b.name; });
+    std::ostringstream os;
+    std::string lastTyped;
+    for (const auto& s : samples) {
+        if (s.name != lastTyped) {
+            os << "# TYPE " << s.name << ' ' << typeName(s.type) << '\n';
+            lastTyped = s.name;
+        }
+        if (s.type != MetricSample::Type::Histogram) {
+            os << s.name << labelText(s.labels) << ' ' << formatNumber(s.value) << '\n';
+            continue;
+        }
+        os << s.name << labelText(s.labels, "quantile", "0.5") << ' ' << s.p50 << '\n'
+           << s.name << labelText(s.labels, "quantile", "0.9") << ' ' << s.p90 << '\n'
+           << s.name << labelText(s.labels, "quantile", "0.99") << ' ' << s.p99 << '\n'
+           << s.name << labelText(s.labels, "quantile", "1") << ' ' << s.max << '\n'
+           << s.name << "_sum" << labelText(s.labels) << ' ' << formatNumber(s.sum) << '\n'
+           << s.name << "_count" << labelText(s.labels) << ' ' << s.count << '\n';
+    }
+    return os.str();
+}
+
+std::string MetricsRegistry::exportJson() const
+{
+    const auto samples = snapshot();
+    std::ostringstream os;
+    os << "{\"metrics\":[";
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        const auto& s = samples[i];
+        if (i) os << ',';
+        os << "{\"name\":\"" << s.name << "\",\"type\":\"" << typeName(s.type) << "\",\"labels\":{";
+        bool first = true;
+        for (const auto& [k, v] : s.labels) {
+            if (!first) os << ',';
+            os << '"' << escape(k) << "\":\"" << escape(v) << '"';
+            first = false;
+        }
+        os << '}';
+        if (s.type == MetricSample::Type::Histogram) {
+            os << ",\"count\":" << s.count << ",\"sum\":" << jsonNumber(s.sum) << ",\"p50\":" << s.p50
+               << ",\"p90\":" << s.p90 << ",\"p99\":" << s.p99 << ",\"max\":" << s.max;
+        } else {
+            os << ",\"value\":" << jsonNumber(s.value);
+        }
+        os << '}';
+    }
+    os << "]}";
+    return os.str();
+}
+
+void MetricsRegistry::writeJsonFile(const std::string& path) const
+{
+    const std::string json = exportJson();
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("metrics: cannot write " + tmp);
+        out << json << '\n';
+        if (!out) throw std::runtime_error("metrics: write failed " + tmp);
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        // Windows 上目标已存在时 rename 失败，先删再改名
+        std::remove(path.c_str());
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) throw std::runtime_error("metrics: cannot rename " + tmp);
+    }
+}
+
+void MetricsRegistry::resetAll()
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (auto& [key, e] : impl_->entries) {
+        if (e.counter) e.counter->reset();
+        if (e.gauge) e.gauge->set(0.0);
+        if (e.histogram) e.histogram->reset();
+    }
+}
+
+// ==================== CallbackHandle ====================
+
+CallbackHandle& CallbackHandle::operator=(CallbackHandle&& o) noexcept
+{
+    if (this != &o) {
+        release();
+        registry_ = o.registry_;
+        id_ = o.id_;
+        o.id_ = 0;
+    }
+    return *this;
+}
+
+void CallbackHandle::release()
+{
+    if (id_ != 0) {
+        registry_->unregister(id_);
+        id_ = 0;
+    }
+}
+
+} // namespace metrics
+} // namespace foundation
@@ -0,0 +1,173 @@
+#include "foundation/memory/Arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace foundation {
+namespace memory {
+
+namespace {
+
+constexpr std::size_t kChunkAlignment = alignof(std::max_align_t);
+
+inline char* alignUp(char* p, std::size_t alignment)
+{
+    const auto v = reinterpret_cast<std::uintptr_t>(p);
+    return reinterpret_cast<char*>((v + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+}
+
+} // namespace
+
+// ==================== CountingResource ====================
+
+void CountingResource::resetCounters()
+{
+    allocations_.store(0, std::memory_order_relaxed);
+    deallocations_.store(0, std::memory_order_relaxed);
+    bytes_.store(0, std::memory_order_relaxed);
+}
+
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* p = upstream_->allocate(bytes, alignment);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    live_.fetch_add(bytes, std::memory_order_relaxed);
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    upstream_->deallocate(p, bytes, alignment);
+    deallocations_.fetch_add(1, std::memory_order_relaxed);
+    live_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+// ==================== MonotonicArena ====================
+
+MonotonicArena::MonotonicArena(std::size_t initialChunk, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), nextChunk_(std::max<std::size_t>(initialChunk, 64))
+{
+}
+
+MonotonicArena::MonotonicArena(void* buffer, std::size_t size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), nextChunk_(std::max<std::size_t>(size, 64) * 2)
+{
+    if (buffer && size > 0) {
+        chunks_.push_back({static_cast<char*>(buffer), size, false});
+        capacity_ = size;
+        cursor_ = static_cast<char*>(buffer);
+        end_ = cursor_ + size;
+    }
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    freeOwnedChunks();
+}
+
+void* MonotonicArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (cursor_) {
+        char* p = alignUp(cursor_, alignment);
+        if (p <= end_ && static_cast<std::size_t>(end_ - p) >= bytes) {
+            used_ += static_cast<std::size_t>(p + bytes - cursor_);
+            cursor_ = p + bytes;
+            peak_ = std::max(peak_, used_);
+            return p;
+        }
+    }
+    return allocateSlow(bytes, alignment);
+}
+
+void* MonotonicArena::allocateSlow(std::size_t bytes, std::size_t alignment)
+{
+    // 先看 reset 之后留下的、排在后面的块放不放得下
+    for (std::size_t i = cursor_ ? current_ + 1 : 0; i < chunks_.size(); ++i) {
+        char* p = alignUp(chunks_[i].data, alignment);
+        const char* end = chunks_[i].data + chunks_[i].size;
+        if (p <= end && static_cast<std::size_t>(end - p) >= bytes) {
+            current_ = i;
+            end_ = chunks_[i].data + chunks_[i].size;
+            used_ += static_cast<std::size_t>(p + bytes - chunks_[i].data);
+            cursor_ = p + bytes;
+            peak_ = std::max(peak_, used_);
+            return p;
+        }
+    }
+
+    const std::size_t need = bytes + (alignment > kChunkAlignment ? alignment : 0);
+    const std::size_t size = std::max(nextChunk_, need);
+    char* data = static_cast<char*>(upstream_->allocate(size, kChunkAlignment));
+    ++upstreamAllocations_;
+    nextChunk_ = size * 2;
+    chunks_.push_back({data, size, true});
+    capacity_ += size;
+
+    current_ = chunks_.size() - 1;
+    char* p = alignUp(data, alignment);
+    end_ = data + size;
+    used_ += static_cast<std::size_t>(p + bytes - data);
+    cursor_ = p + bytes;
+    peak_ = std::max(peak_, used_);
+    return p;
+}
+
+void MonotonicArena::reset()
+{
+    std::size_t owned = 0;
+    std::size_t ownedBytes = 0;
+    for (const auto& c : chunks_) {
+        if (c.owned) {
+            ++owned;
+            ownedBytes += c.size;
+        }
+    }
+    // 多个块合并成一个，下一轮只在一块连续内存里分配
+    if (owned > 1) {
+        freeOwnedChunks();
+        char* data = static_cast<char*>(upstream_->allocate(ownedBytes, kChunkAlignment));
+        ++upstreamAllocations_;
+        chunks_.push_back({data, ownedBytes, true});
+        capacity_ += ownedBytes;
+    }
+    current_ = 0;
+    used_ = 0;
+    if (chunks_.empty()) {
+        cursor_ = end_ = nullptr;
+    } else {
+        cursor_ = chunks_[0].data;
+        end_ = cursor_ + chunks_[0].size;
+    }
+}
+
+void MonotonicArena::release()
+{
+    freeOwnedChunks();
+    reset();
+}
+
+void MonotonicArena::freeOwnedChunks()
+{
+    std::vector<Chunk> kept;
+    for (const auto& c : chunks_) {
+        if (c.owned) {
+            upstream_->deallocate(c.data, c.size, kChunkAlignment);
+            capacity_ -= c.size;
+        } else {
+            kept.push_back(c);
+        }
+    }
+    chunks_ = std::move(kept);
+}
+
+// ==================== threadLocalPool ====================
+
+std::pmr::memory_resource* threadLocalPool()
+{
+    thread_local std::pmr::unsynchronized_pool_resource pool(std::pmr::new_delete_resource());
+    return &pool;
+}
+
+} // namespace memory
+} // namespace foundation
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "foundation/Utils/CacheUtils.h"
+
+using namespace foundation::utils;
+
+namespace {
+
+// 近似 Zipf 分布的 key 序列，模拟少数热门标的/接口被反复访问
+std::vector<int> zipfKeys(std::size_t count, int universe, unsigned seed)
+{
+    std::vector<double> cdf(universe);
+    double sum = 0.0;
+    for (int i = 0; i < universe; ++i) {
+        sum += 1.0 / (i + 1);
+        cdf[i] = sum;
+    }
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, sum);
+    std::vector<int> keys(count);
+    for (auto& k : keys) k = static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+    return keys;
+}
+
+double hitRate(const CacheOptions& options, const std::vector<int>& keys)
+{
+    ConcurrentCache<int, std::string> cache(options);
+    for (int k : keys) {
+        if (!cache.get(k)) cache.put(k, std::string(200, 'x'));
+    }
+    return cache.stats().hitRate();
+}
+
+} // namespace
+
+// Zipf 访问下的命中率：分片不影响命中率，TinyLFU 不比 LRU 差。
+// 单线程跑，结果确定；多线程吞吐见 src/foundation/bench/CacheBench.cpp
+TEST(CachePerformanceTest, ZipfHitRates)
+{
+    const std::vector<int> keys = zipfKeys(200000, 100000, 42);
+
+    CacheOptions base;
+    base.capacityBytes = 5000 * (sizeof(std::string) + 200 + base.entryOverhead);
+
+    CacheOptions single = base;
+    single.shards = 1;
+    CacheOptions sharded = base;
+    sharded.shards = 64;
+    CacheOptions tinyLfu = sharded;
+    tinyLfu.policy = EvictionPolicy::TinyLfu;
+
+    const double lru = hitRate(single, keys);
+    const double shardedLru = hitRate(sharded, keys);
+    const double lfu = hitRate(tinyLfu, keys);
+
+    EXPECT_GT(lru, 0.3);
+    EXPECT_NEAR(shardedLru, lru, 0.05);
+    EXPECT_GE(lfu, shardedLru);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "foundation/memory/Arena.hpp"
+
+using namespace foundation::memory;
+
+namespace {
+
+bool aligned(const void* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(MonotonicArenaTest, AllocatesAlignedAndGrows)
+{
+    CountingResource upstream;
+    MonotonicArena arena(256, &upstream);
+
+    std::vector<void*> ptrs;
+    for (std::size_t align : {1u, 2u, 8u, 16u, 64u, 4096u}) {
+        void* p = arena.allocate(24, align);
+        EXPECT_TRUE(aligned(p, align)) << align;
+        ptrs.push_back(p);
+    }
+    void* big = arena.allocate(10000, 8);
+    EXPECT_NE(big, nullptr);
+    EXPECT_GE(arena.chunkCount(), 2u);
+    EXPECT_EQ(upstream.allocations(), arena.upstreamAllocations());
+    EXPECT_GE(arena.capacity(), arena.used());
+    // 各次分配互不重叠
+    for (std::size_t i = 0; i + 1 < ptrs.size(); ++i) EXPECT_NE(ptrs[i], ptrs[i + 1]);
+}
+
+TEST(MonotonicArenaTest, ResetReusesChunksWithoutUpstreamCalls)
+{
+    CountingResource upstream;
+    MonotonicArena arena(128, &upstream);
+
+    auto round = [&] {
+        std::pmr::vector<int> v(&arena);
+        for (int i = 0; i < 1000; ++i) v.push_back(i);
+        std::pmr::string s("a string long enough to skip the small buffer optimisation", &arena);
+        EXPECT_EQ(v[999], 999);
+    };
+
+    round();
+    arena.reset();
+    EXPECT_EQ(arena.chunkCount(), 1u);   // 多个块在 reset 时合并
+    EXPECT_EQ(arena.used(), 0u);
+    const auto afterFirst = upstream.allocations();
+
+    for (int i = 0; i < 100; ++i) {
+        round();
+        arena.reset();
+    }
+    EXPECT_EQ(upstream.allocations(), afterFirst);
+    EXPECT_GT(arena.peak(), 4000u);
+
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_EQ(upstream.liveBytes(), 0u);
+}
+
+TEST(MonotonicArenaTest, UsesCallerBufferFirst)
+{
+    alignas(std::max_align_t) char buffer[1024];
+    CountingResource upstream;
+    MonotonicArena arena(buffer, sizeof(buffer), &upstream);
+
+    void* p = arena.allocate(100, 8);
+    EXPECT_GE(static_cast<char*>(p), buffer);
+    EXPECT_LT(static_cast<char*>(p), buffer + sizeof(buffer));
+    EXPECT_EQ(upstream.allocations(), 0u);
+
+    EXPECT_NE(arena.allocate(2000, 8), nullptr);
+    EXPECT_EQ(upstream.allocations(), 1u);
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(100, 8), buffer);
+    arena.release();
+    EXPECT_EQ(arena.capacity(), sizeof(buffer));
+    EXPECT_EQ(upstream.liveBytes(), 0u);
+}
+
+TEST(MonotonicArenaTest, ResetGuardAndPmrContainers)
+{
+    MonotonicArena arena(1024);
+    {
+        ArenaResetGuard guard(arena);
+        std::pmr::map<int, std::pmr::string> m(&arena);
+        for (int i = 0; i < 100; ++i) m.emplace(i, std::pmr::string(50, static_cast<char>('a' + i % 26)));
+        EXPECT_EQ(std::string_view(m.at(27)), std::string(50, 'b'));
+        m.clear();   // 容器先于 guard 析构
+    }
+    EXPECT_EQ(arena.used(), 0u);
+}
+
+TEST(CountingResourceTest, CountsAllocationsAndBytes)
+{
+    CountingResource counter;
+    {
+        std::pmr::vector<std::uint64_t> v(&counter);
+        v.reserve(100);
+        EXPECT_EQ(counter.allocations(), 1u);
+        EXPECT_EQ(counter.bytesAllocated(), 800u);
+        EXPECT_EQ(counter.liveBytes(), 800u);
+    }
+    EXPECT_EQ(counter.deallocations(), 1u);
+    EXPECT_EQ(counter.liveBytes(), 0u);
+    counter.resetCounters();
+    EXPECT_EQ(counter.allocations(), 0u);
+}
+
+TEST(ThreadLocalPoolTest, EachThreadHasItsOwnPool)
+{
+    std::pmr::memory_resource* main = threadLocalPool();
+    EXPECT_EQ(main, threadLocalPool());
+
+    std::pmr::memory_resource* other = nullptr;
+    std::thread t([&] {
+        other = threadLocalPool();
+        std::pmr::vector<std::pmr::string> v(other);
+        for (int i = 0; i < 1000; ++i) v.emplace_back(40, 'x');
+        EXPECT_EQ(v.back().size(), 40u);
+    });
+    t.join();
+    EXPECT_NE(main, other);
+
+    std::pmr::vector<int> v(main);
+    v.assign(100, 7);
+    EXPECT_EQ(v[50], 7);
+}
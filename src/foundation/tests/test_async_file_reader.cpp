@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "foundation/Fs/AsyncFileReader.h"
+#include "foundation/testing/TempDir.h"
+
+using namespace foundation::fs;
+namespace stdfs = std::filesystem;
+
+namespace {
+
+// io_uring 在当前环境不可用时自动跳过该参数
+class AsyncFileReaderTest : public ::testing::TestWithParam<AsyncReaderBackend> {
+protected:
+    void SetUp() override {
+        dir_ = foundation::testutil::freshTempDir("async_reader_test");
+    }
+    void TearDown() override { stdfs::remove_all(dir_); }
+
+    AsyncReaderOptions options() const {
+        AsyncReaderOptions opts;
+        opts.backend = GetParam();
+        opts.queueDepth = 8;
+        opts.ioThreads = 3;
+        return opts;
+    }
+
+    std::unique_ptr<AsyncFileReader> makeReader(AsyncReaderOptions opts) {
+        try {
+            return std::make_unique<AsyncFileReader>(std::move(opts));
+        } catch (const std::runtime_error&) {
+            return nullptr;
+        }
+    }
+
+    std::string write(const std::string& name, const std::string& content) {
+        const auto p = (dir_ / name).string();
+        std::ofstream(p, std::ios::binary) << content;
+        return p;
+    }
+
+    stdfs::path dir_;
+};
+
+std::string contentFor(std::size_t i)
+{
+    // 大小从 0 到几百 KB 不等，覆盖空文件和需要多次读的文件
+    std::string s((i * 7919) % 300000, '\0');
+    for (std::size_t k = 0; k < s.size(); ++k) s[k] = static_cast<char>('A' + (k + i) % 23);
+    return s;
+}
+
+} // namespace
+
+TEST_P(AsyncFileReaderTest, ReadsManyFilesConcurrently)
+{
+    auto reader = makeReader(options());
+    if (!reader) GTEST_SKIP() << "io_uring unavailable";
+    EXPECT_EQ(reader->backend(), GetParam());
+
+    const std::size_t n = 200;
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < n; ++i) paths.push_back(write("f" + std::to_string(i), contentFor(i)));
+
+    std::mutex mutex;
+    std::vector<int> seen(n, 0);
+    std::atomic<int> mismatches{0};
+    for (std::size_t i = 0; i < n; ++i) {
+        reader->read(paths[i],
+                     [&](AsyncReadResult&& r) {
+                         if (!r.ok() || r.data != contentFor(r.tag) || r.path != paths[r.tag]) ++mismatches;
+                         std::lock_guard<std::mutex> lock(mutex);
+                         ++seen[r.tag];
+                     },
+                     i);
+    }
+    reader->wait();
+    EXPECT_EQ(reader->pending(), 0u);
+    EXPECT_EQ(mismatches.load(), 0);
+    for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(seen[i], 1) << i;
+}
+
+TEST_P(AsyncFileReaderTest, ReportsErrorsThroughCallback)
+{
+    auto reader = makeReader(options());
+    if (!reader) GTEST_SKIP() << "io_uring unavailable";
+
+    std::vector<AsyncReadResult> results(3);
+    reader->read((dir_ / "missing").string(), [&](AsyncReadResult&& r) { results[0] = std::move(r); }, 0);
+    reader->read(dir_.string(), [&](AsyncReadResult&& r) { results[1] = std::move(r); }, 1);
+    reader->read(write("ok", "fine"), [&](AsyncReadResult&& r) { results[2] = std::move(r); }, 2);
+    reader->wait();
+
+    EXPECT_FALSE(results[0].ok());
+    EXPECT_NE(results[0].message.find("missing"), std::string::npos);
+    EXPECT_FALSE(results[1].ok());
+    EXPECT_TRUE(results[2].ok());
+    EXPECT_EQ(results[2].data, "fine");
+}
+
+TEST_P(AsyncFileReaderTest, ReadsPseudoFilesWithZeroSize)
+{
+    if (!stdfs::exists("/proc/self/status")) GTEST_SKIP() << "no procfs";
+    auto reader = makeReader(options());
+    if (!reader) GTEST_SKIP() << "io_uring unavailable";
+
+    // st_size 为 0，但内容不为空；/proc/self/maps 通常超过一个 4KB 的读块
+    std::vector<AsyncReadResult> results(3);
+    reader->read("/proc/self/status", [&](AsyncReadResult&& r) { results[0] = std::move(r); }, 0);
+    reader->read("/proc/self/maps", [&](AsyncReadResult&& r) { results[1] = std::move(r); }, 1);
+    reader->read(write("empty", ""), [&](AsyncReadResult&& r) { results[2] = std::move(r); }, 2);
+    reader->wait();
+
+    ASSERT_TRUE(results[0].ok()) << results[0].message;
+    EXPECT_NE(results[0].data.find("Name:"), std::string::npos);
+    ASSERT_TRUE(results[1].ok()) << results[1].message;
+    EXPECT_FALSE(results[1].data.empty());
+    EXPECT_EQ(results[1].data.back(), '\n');
+    ASSERT_TRUE(results[2].ok());
+    EXPECT_TRUE(results[2].data.empty());
+}
+
+TEST_P(AsyncFileReaderTest, DispatchesToExecutorAndSurvivesThrowingCallbacks)
+{
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    auto opts = options();
+    opts.dispatch = [&](std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        workers.emplace_back(std::move(task));
+    };
+    auto reader = makeReader(opts);
+    if (!reader) GTEST_SKIP() << "io_uring unavailable";
+
+    std::atomic<int> done{0};
+    for (int i = 0; i < 20; ++i) {
+        reader->read(write("d" + std::to_string(i), contentFor(i)), [&](AsyncReadResult&& r) {
+            if (r.data == contentFor(r.tag)) ++done;
+        }, static_cast<std::uint64_t>(i));
+    }
+    reader->wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& t : workers) t.join();
+    }
+    EXPECT_EQ(done.load(), 20);
+
+    // 不派发时回调抛异常不影响后续读取
+    auto inlineReader = makeReader(options());
+    std::atomic<int> calls{0};
+    for (int i = 0; i < 5; ++i) {
+        inlineReader->read(write("t" + std::to_string(i), "x"), [&](AsyncReadResult&&) {
+            ++calls;
+            throw std::runtime_error("boom");
+        });
+    }
+    inlineReader->wait();
+    EXPECT_EQ(calls.load(), 5);
+}
+
+TEST_P(AsyncFileReaderTest, DestructorDrainsQueue)
+{
+    std::atomic<int> calls{0};
+    {
+        auto reader = makeReader(options());
+        if (!reader) GTEST_SKIP() << "io_uring unavailable";
+        for (int i = 0; i < 50; ++i) {
+            reader->read(write("q" + std::to_string(i), contentFor(i)), [&](AsyncReadResult&& r) {
+                if (r.ok()) ++calls;
+            });
+        }
+    }
+    EXPECT_EQ(calls.load(), 50);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncFileReaderTest,
+                         ::testing::Values(AsyncReaderBackend::IoUring, AsyncReaderBackend::ThreadPool),
+                         [](const ::testing::TestParamInfo<AsyncReaderBackend>& info) {
+                             return info.param == AsyncReaderBackend::IoUring ? "IoUring" : "ThreadPool";
+                         });
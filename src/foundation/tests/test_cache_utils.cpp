@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "foundation/Utils/CacheUtils.h"
+
+using namespace foundation::utils;
+
+namespace {
+
+// 测试里每个值按固定 100 字节计，容量好算
+struct FixedSizer {
+    std::size_t operator()(const std::string&) const { return 100; }
+};
+
+using TestCache = ConcurrentCache<int, std::string, std::hash<int>, FixedSizer>;
+
+CacheOptions smallOptions(std::size_t entries, EvictionPolicy policy = EvictionPolicy::Lru)
+{
+    CacheOptions o;
+    o.shards = 1;
+    o.entryOverhead = 0;
+    o.capacityBytes = entries * 100;
+    o.policy = policy;
+    return o;
+}
+
+} // namespace
+
+TEST(CacheUtilsTest, PutGetAndStats)
+{
+    TestCache cache(smallOptions(10));
+    EXPECT_TRUE(cache.put(1, "one"));
+    ASSERT_TRUE(cache.get(1));
+    EXPECT_EQ(*cache.get(1), "one");
+    EXPECT_FALSE(cache.get(2));
+
+    const auto st = cache.stats();
+    EXPECT_EQ(st.hits, 2u);
+    EXPECT_EQ(st.misses, 1u);
+    EXPECT_EQ(st.entries, 1u);
+    EXPECT_EQ(st.bytes, 100u);
+}
+
+TEST(CacheUtilsTest, LruEvictsLeastRecentlyUsed)
+{
+    TestCache cache(smallOptions(3));
+    cache.put(1, "a");
+    cache.put(2, "b");
+    cache.put(3, "c");
+    cache.get(1);          // 1 变为最近使用
+    cache.put(4, "d");     // 淘汰 2
+
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(cache.stats().bytes, 300u);
+}
+
+TEST(CacheUtilsTest, ReplaceKeepsByteAccounting)
+{
+    ConcurrentCache<int, std::string> cache(CacheOptions(1 << 20));
+    cache.put(1, std::string(1000, 'x'));
+    const auto before = cache.stats().bytes;
+    cache.put(1, std::string(10, 'y'));
+    EXPECT_LT(cache.stats().bytes, before);
+    EXPECT_EQ(cache.size(), 1u);
+    cache.erase(1);
+    EXPECT_EQ(cache.stats().bytes, 0u);
+}
+
+TEST(CacheUtilsTest, OversizedValueRejected)
+{
+    TestCache cache(smallOptions(0));
+    EXPECT_FALSE(cache.put(1, "x"));
+    EXPECT_EQ(cache.stats().rejections, 1u);
+}
+
+TEST(CacheUtilsTest, TtlExpires)
+{
+    TestCache cache(smallOptions(10));
+    cache.put(1, "short", std::chrono::milliseconds(20));
+    cache.put(2, "forever");
+    EXPECT_TRUE(cache.get(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_TRUE(cache.get(2));
+    EXPECT_EQ(cache.stats().expirations, 1u);
+}
+
+TEST(CacheUtilsTest, TinyLfuProtectsHotKeysFromScan)
+{
+    TestCache lru(smallOptions(10));
+    TestCache lfu(smallOptions(10, EvictionPolicy::TinyLfu));
+    for (auto* cache : {&lru, &lfu}) {
+        for (int round = 0; round < 20; ++round) {
+            for (int k = 0; k < 5; ++k) {
+                if (!cache->get(k)) cache->put(k, "hot");
+            }
+        }
+        // 一次性扫描大量冷数据
+        for (int k = 1000; k < 1100; ++k) {
+            if (!cache->get(k)) cache->put(k, "cold");
+        }
+    }
+    int lruHot = 0;
+    int lfuHot = 0;
+    for (int k = 0; k < 5; ++k) {
+        lruHot += lru.contains(k);
+        lfuHot += lfu.contains(k);
+    }
+    EXPECT_EQ(lruHot, 0);
+    EXPECT_EQ(lfuHot, 5);
+    EXPECT_GT(lfu.stats().rejections, 0u);
+}
+
+TEST(CacheUtilsTest, GetOrLoadCallsLoaderOnce)
+{
+    TestCache cache(smallOptions(10));
+    int calls = 0;
+    auto loader = [&] { ++calls; return std::string("loaded"); };
+    EXPECT_EQ(*cache.getOrLoad(7, loader), "loaded");
+    EXPECT_EQ(*cache.getOrLoad(7, loader), "loaded");
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(CacheUtilsTest, ConcurrentAccessKeepsInvariants)
+{
+    CacheOptions o;
+    o.capacityBytes = 200 * 100;
+    o.entryOverhead = 0;
+    TestCache cache(o);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 20000; ++i) {
+                const int key = (i * 7 + t) % 500;
+                if (!cache.get(key)) cache.put(key, "v");
+                if (i % 97 == 0) cache.erase(key);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    const auto st = cache.stats();
+    EXPECT_LE(st.bytes, o.capacityBytes);
+    EXPECT_EQ(st.bytes, st.entries * 100);
+    EXPECT_EQ(st.hits + st.misses, 8u * 20000u);
+}
+
+TEST(CacheUtilsTest, SketchSeparatesKeysThatShareLowBits)
+{
+    // 同一分片里的 key 低位相同；只在高位不同的 hash 也要落到不同的计数上
+    FrequencySketch sketch(1024);
+    for (std::uint64_t k = 0; k < 500; ++k) sketch.increment((k << 40) | 0xABCDULL);
+
+    std::uint32_t total = 0;
+    for (std::uint64_t k = 1000; k < 2000; ++k) total += sketch.estimate((k << 40) | 0xABCDULL);
+    EXPECT_LT(total, 200u);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include "foundation/config/ConfigReloader.hpp"
+#include "foundation/testing/TempDir.h"
+
+using namespace foundation::config;
+namespace fs = std::filesystem;
+
+namespace {
+
+class ConfigReloaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = foundation::testutil::freshTempDir("config_reloader");
+        fs::create_directories(dir_ / "foundation");
+        fs::create_directories(dir_ / "system");
+        write("foundation/foundation.json",
+              R"({"runtime": {"executor": {"workers": 8}}, "log": {"level": "info"}, "risk": {"max_position": 1000}})");
+    }
+
+    void TearDown() override { fs::remove_all(dir_); }
+
+    void write(const std::string& rel, const std::string& text) {
+        std::ofstream out(dir_ / rel, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+
+    template <typename Pred>
+    static bool waitFor(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(3000)) {
+        const auto end = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < end) {
+            if (pred()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return pred();
+    }
+
+    ConfigReloadOptions options() const {
+        ConfigReloadOptions o;
+        o.configDir = dir_.string();
+        o.pollInterval = std::chrono::milliseconds(10);
+        o.debounce = std::chrono::milliseconds(30);
+        return o;
+    }
+
+    fs::path dir_;
+};
+
+} // namespace
+
+TEST_F(ConfigReloaderTest, PicksUpOverrideAndNotifiesSubscribers)
+{
+    ConfigStore store(loadLayeredConfig(dir_.string(), ""));
+    auto workers = store.handle<int>("runtime.executor.workers", 0);
+    std::atomic<int> logNotifications{0};
+    std::atomic<int> riskNotifications{0};
+    store.subscribe("log", [&](const ConfigSnapshot&) { logNotifications.fetch_add(1); });
+    store.subscribe("risk", [&](const ConfigSnapshot&) { riskNotifications.fetch_add(1); });
+
+    ConfigReloader reloader(store, options());
+    reloader.start();
+    write("system/override.json", R"({"runtime": {"executor": {"workers": 2}}, "log": {"level": "debug"}})");
+
+    ASSERT_TRUE(waitFor([&] { return workers.get() == 2; }));
+    EXPECT_EQ(store.snapshot()->getString("log.level"), "debug");
+    EXPECT_EQ(logNotifications.load(), 1);
+    EXPECT_EQ(riskNotifications.load(), 0);
+    reloader.stop();
+    EXPECT_EQ(reloader.status().reloads, 1u);
+}
+
+TEST_F(ConfigReloaderTest, KeepsOldSnapshotOnSyntaxError)
+{
+    ConfigStore store(loadLayeredConfig(dir_.string(), ""));
+    ConfigReloader reloader(store, options());
+    const auto version = store.version();
+
+    write("system/override.json", R"({"log": {"level": )");
+    EXPECT_FALSE(reloader.reloadNow());
+    EXPECT_EQ(store.version(), version);
+    EXPECT_EQ(reloader.status().failures, 1u);
+    EXPECT_NE(reloader.status().lastError.find("override.json"), std::string::npos);
+
+    write("system/override.json", R"({"log": {"level": "warn"}})");
+    EXPECT_TRUE(reloader.reloadNow());
+    EXPECT_EQ(store.snapshot()->getString("log.level"), "warn");
+
+    // 内容不变不发布
+    EXPECT_FALSE(reloader.reloadNow());
+    EXPECT_EQ(reloader.status().unchanged, 1u);
+}
+
+TEST_F(ConfigReloaderTest, ThrowingListenerDoesNotStopReloading)
+{
+    ConfigStore store(loadLayeredConfig(dir_.string(), ""));
+    auto workers = store.handle<int>("runtime.executor.workers", 0);
+    std::atomic<int> calls{0};
+    store.addListener([&](const ConfigSnapshot&, const ConfigSnapshot&) {
+        calls.fetch_add(1);
+        throw std::runtime_error("listener boom");
+    });
+    // 排在抛异常的监听者后面的订阅者照样收到每一次变化
+    std::atomic<int> laterWorkers{0};
+    store.subscribe("runtime", [&](const ConfigSnapshot& snap) {
+        laterWorkers.store(snap.get<int>("runtime.executor.workers", 0));
+    });
+
+    ConfigReloader reloader(store, options());
+    reloader.start();
+    write("system/override.json", R"({"runtime": {"executor": {"workers": 2}}})");
+    ASSERT_TRUE(waitFor([&] { return workers.get() == 2; }));
+    ASSERT_TRUE(waitFor([&] { return reloader.status().listenerFailures == 1; }));
+    EXPECT_EQ(laterWorkers.load(), 2);
+
+    // 线程还活着，下一次变化照常加载
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write("system/override.json", R"({"runtime": {"executor": {"workers": 3}}})");
+    ASSERT_TRUE(waitFor([&] { return workers.get() == 3; }));
+    ASSERT_TRUE(waitFor([&] { return reloader.status().listenerFailures == 2; }));
+    EXPECT_EQ(laterWorkers.load(), 3);
+    reloader.stop();
+
+    const auto st = reloader.status();
+    EXPECT_EQ(st.reloads, 2u);
+    EXPECT_EQ(st.failures, 0u);
+    EXPECT_NE(st.lastError.find("listener boom"), std::string::npos) << st.lastError;
+    EXPECT_EQ(calls.load(), 2);
+}
+
+TEST_F(ConfigReloaderTest, ExternalNotificationTriggersReload)
+{
+    ConfigStore store(loadLayeredConfig(dir_.string(), ""));
+    auto opts = options();
+    opts.pollInterval = std::chrono::milliseconds(60000);   // 不靠轮询
+    ConfigReloader reloader(store, opts);
+    reloader.start();
+    write("system/override.json", R"({"risk": {"max_position": 500}})");
+    reloader.notifyChanged();
+    EXPECT_TRUE(waitFor([&] { return store.snapshot()->get<int>("risk.max_position", 0) == 500; }));
+}
+
+TEST_F(ConfigReloaderTest, FileEventsReplacePolling)
+{
+    ConfigStore store(loadLayeredConfig(dir_.string(), ""));
+    auto opts = options();
+    opts.pollInterval = std::chrono::milliseconds(60000);
+    ConfigReloader reloader(store, opts);
+    reloader.start();
+    write("system/override.json", R"({"log": {"level": "error"}})");
+#if defined(__linux__)
+    EXPECT_TRUE(waitFor([&] { return store.snapshot()->getString("log.level") == "error"; }));
+#endif
+}
+
+TEST_F(ConfigReloaderTest, BackstopPollCatchesLostEvents)
+{
+    ConfigStore store(loadLayeredConfig(dir_.string(), ""));
+    auto opts = options();
+    opts.pollInterval = std::chrono::milliseconds(60000);
+    opts.backstopInterval = std::chrono::milliseconds(50);
+    ConfigReloader reloader(store, opts);
+    reloader.start();
+    // 删除并重建目录：原来的目录监视随之失效，之后的写入可能没有任何文件事件
+    fs::remove_all(dir_ / "system");
+    fs::create_directories(dir_ / "system");
+    write("system/override.json", R"({"risk": {"max_position": 7}})");
+    EXPECT_TRUE(waitFor([&] { return store.snapshot()->get<int>("risk.max_position", 0) == 7; }));
+}
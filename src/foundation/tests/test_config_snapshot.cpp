@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "foundation/config/ConfigSnapshot.hpp"
+
+using namespace foundation::config;
+
+namespace {
+
+const char* kBase = R"({
+  "runtime": { "executor": { "workers": 8, "queue_capacity": 1024 } },
+  "log": { "level": "info", "async": true },
+  "network": { "default_timeout": 30, "proxy": { "enabled": false } },
+  "symbols": ["600000.SH", "000001.SZ", "600519.SH"],
+  "ratio": 0.25
+})";
+
+const char* kProfile = R"({
+  // 开发环境
+  "runtime": { "executor": { "workers": 4 } },
+  "log": { "level": "debug" },   /* 块注释 */
+  "network": { "proxy": "off" },
+  "symbols": ["300750.SZ"]
+})";
+
+} // namespace
+
+TEST(ConfigSnapshotTest, FlattensAndMergesLayers)
+{
+    auto snap = ConfigSnapshot::Builder().mergeJson(kBase, "base").mergeJson(kProfile, "dev").build();
+
+    EXPECT_EQ(snap->get<std::int64_t>("runtime.executor.workers", 0), 4);
+    EXPECT_EQ(snap->get<int>("runtime.executor.queue_capacity", 0), 1024);
+    EXPECT_EQ(snap->getString("log.level"), "debug");
+    EXPECT_TRUE(snap->get<bool>("log.async", false));
+    EXPECT_DOUBLE_EQ(snap->get<double>("ratio", 0.0), 0.25);
+
+    // 标量覆盖对象，数组整体替换
+    EXPECT_FALSE(snap->contains("network.proxy.enabled"));
+    EXPECT_FALSE(snap->get<bool>("network.proxy", true));
+    EXPECT_EQ(snap->getString("symbols.0"), "300750.SZ");
+    EXPECT_FALSE(snap->contains("symbols.1"));
+
+    EXPECT_EQ(snap->sources(), (std::vector<std::string>{"base", "dev"}));
+    EXPECT_EQ(snap->children("runtime.executor"), (std::vector<std::string>{"queue_capacity", "workers"}));
+    EXPECT_EQ(snap->keys("log"), (std::vector<std::string>{"log.async", "log.level"}));
+}
+
+TEST(ConfigSnapshotTest, EmptyObjectClearsEarlierValue)
+{
+    auto snap = ConfigSnapshot::Builder()
+                    .mergeJson(kBase, "base")
+                    .mergeJson(R"({"log": {}, "ratio": {}, "runtime": {"executor": {"workers": 2}}})", "override")
+                    .build();
+    // 空对象清掉之前的子树和标量
+    EXPECT_FALSE(snap->contains("log.level"));
+    EXPECT_FALSE(snap->contains("log.async"));
+    EXPECT_FALSE(snap->contains("ratio"));
+    EXPECT_DOUBLE_EQ(snap->get<double>("ratio", -1.0), -1.0);
+    // 非空对象仍按路径合并
+    EXPECT_EQ(snap->get<int>("runtime.executor.workers", 0), 2);
+    EXPECT_EQ(snap->get<int>("runtime.executor.queue_capacity", 0), 1024);
+
+    // 嵌在下层的空对象同样删掉路径上作为叶子的祖先
+    snap = ConfigSnapshot::Builder().mergeJson(R"({"a": 1, "b": {"c": 2}})").mergeJson(R"({"a": {"x": {}}})").build();
+    EXPECT_FALSE(snap->contains("a"));
+    EXPECT_EQ(snap->get<int>("b.c", 0), 2);
+    // 顶层的 {} 不改变任何东西
+    snap = ConfigSnapshot::Builder().mergeJson(kBase).mergeJson("{}").build();
+    EXPECT_EQ(snap->getString("log.level"), "info");
+}
+
+TEST(ConfigSnapshotTest, TypedConversionsAndDefaults)
+{
+    auto snap = ConfigSnapshot::Builder()
+                    .set("server.port", ConfigValue::fromString("8080"))
+                    .set("server.host", ConfigValue::fromString("localhost"))
+                    .set("feature.on", ConfigValue::fromString("yes"))
+                    .set("big", ConfigValue::fromInt(1ll << 40))
+                    .build();
+
+    EXPECT_EQ(snap->get<int>("server.port", 0), 8080);
+    EXPECT_EQ(snap->get<int>("server.host", -1), -1);
+    EXPECT_TRUE(snap->get<bool>("feature.on", false));
+    EXPECT_EQ(snap->get<int>("big", 7), 7);   // 超出 int 范围
+    EXPECT_EQ(snap->get<std::int64_t>("big", 0), 1ll << 40);
+    EXPECT_EQ(snap->get<int>("missing", 42), 42);
+    EXPECT_THROW(snap->require<int>("missing"), std::runtime_error);
+    EXPECT_THROW(snap->require<int>("server.host"), std::runtime_error);
+
+    const ConfigKey key("server.port");
+    ASSERT_NE(snap->find(key), nullptr);
+    EXPECT_EQ(snap->find(key)->intValue, 8080);
+}
+
+TEST(ConfigSnapshotTest, OutOfRangeDoublesAreNotIntegers)
+{
+    auto snap = ConfigSnapshot::Builder()
+                    .mergeJson(R"({"huge": 1e300, "digits20": 12345678901234567890, "neg": -9223372036854775808,
+                                   "whole": 3.0, "frac": 2.5})")
+                    .set("nan", ConfigValue::fromDouble(std::nan("")))
+                    .set("inf", ConfigValue::fromDouble(HUGE_VAL))
+                    .set("edge", ConfigValue::fromDouble(9223372036854775808.0))   // 2^63
+                    .build();
+
+    for (const char* path : {"huge", "digits20", "nan", "inf", "edge"}) {
+        SCOPED_TRACE(path);
+        const ConfigValue* v = snap->find(ConfigKey(path));
+        ASSERT_NE(v, nullptr);
+        EXPECT_FALSE(v->hasInt);
+        EXPECT_EQ(snap->get<std::int64_t>(path, -1), -1);
+        EXPECT_TRUE(v->hasDouble);
+    }
+    EXPECT_DOUBLE_EQ(snap->get<double>("huge", 0.0), 1e300);
+    EXPECT_DOUBLE_EQ(snap->get<double>("digits20", 0.0), 12345678901234567890.0);
+    EXPECT_EQ(snap->get<std::int64_t>("neg", 0), std::numeric_limits<std::int64_t>::min());
+    EXPECT_EQ(snap->get<int>("whole", 0), 3);
+    EXPECT_EQ(snap->get<int>("frac", 0), 0);
+}
+
+TEST(ConfigSnapshotTest, SyntaxErrorReportsLineAndKeepsBuilder)
+{
+    ConfigSnapshot::Builder b;
+    b.mergeJson(R"({"a": 1})", "ok");
+    try {
+        b.mergeJson("{\n\"a\": 2,\n\"b\": }", "bad.json");
+        FAIL() << "expected parse error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("bad.json:3"), std::string::npos);
+    }
+    EXPECT_EQ(b.build()->get<int>("a", 0), 1);
+}
+
+TEST(ConfigSnapshotTest, RejectsNonObjectRootEmptyKeysAndDeepNesting)
+{
+    const auto error = [](const std::string& text) {
+        try {
+            ConfigSnapshot::Builder().mergeJson(text, "x.json");
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    EXPECT_NE(error("[1, 2]").find("x.json:1: top-level value must be an object"), std::string::npos);
+    EXPECT_NE(error("\"text\"").find("top-level value must be an object"), std::string::npos);
+    EXPECT_NE(error("{\n\"a\": {\"\": 1}}").find("x.json:2: empty key"), std::string::npos);
+    EXPECT_NE(error("{\"a\": 1} {}").find("trailing characters"), std::string::npos);
+    EXPECT_NE(error("{\"a\": 1 /* open").find("unterminated comment"), std::string::npos);
+    EXPECT_NE(error(std::string(100, '[')).find("top-level value must be an object"), std::string::npos);
+    std::string deep = "{";
+    for (int i = 0; i < 100; ++i) deep += "\"k\": {";
+    EXPECT_NE(error(deep).find("nesting too deep"), std::string::npos);
+
+    // 数组里的对象和嵌套数组按下标展开
+    auto snap = ConfigSnapshot::Builder().mergeJson(R"({"a": [{"b": 1}, [true, null], "s"], "e": {}})").build();
+    EXPECT_EQ(snap->get<int>("a.0.b", 0), 1);
+    EXPECT_TRUE(snap->get<bool>("a.1.0", false));
+    EXPECT_EQ(snap->getString("a.2", ""), "s");
+    EXPECT_EQ(snap->size(), 4u);
+}
+
+TEST(ConfigSnapshotTest, LoadsRepositoryLayers)
+{
+    ConfigSnapshot::Builder b;
+    EXPECT_THROW(b.mergeFile("no_such_dir/foundation.json"), std::runtime_error);
+    b.mergeFile("no_such_dir/override.json", false);
+    EXPECT_EQ(b.build()->size(), 0u);
+}
+
+TEST(ConfigStoreTest, HandlesFollowPublish)
+{
+    ConfigStore store(ConfigSnapshot::Builder().mergeJson(kBase).build());
+    auto workers = store.handle<std::int64_t>("runtime.executor.workers", 1);
+    auto proxy = store.handle<bool>("network.proxy.enabled", true);
+    auto level = store.stringHandle("log.level");
+    EXPECT_EQ(workers.get(), 8);
+    EXPECT_FALSE(proxy.get());
+    EXPECT_EQ(*level.get(), "info");
+    const auto v1 = store.version();
+
+    std::uint64_t seenOld = 0;
+    std::uint64_t seenNew = 0;
+    store.addListener([&](const ConfigSnapshot& o, const ConfigSnapshot& n) {
+        seenOld = o.version();
+        seenNew = n.version();
+    });
+
+    auto oldSnap = store.snapshot();
+    store.publish(ConfigSnapshot::Builder().mergeJson(kBase).mergeJson(kProfile).build());
+    EXPECT_EQ(workers.get(), 4);
+    EXPECT_TRUE(proxy.get());   // 路径不存在，回到默认值
+    EXPECT_EQ(*level.get(), "debug");
+    EXPECT_EQ(seenOld, v1);
+    EXPECT_EQ(seenNew, store.version());
+    EXPECT_GT(store.version(), v1);
+    // 旧快照仍被持有者保活
+    EXPECT_EQ(oldSnap->get<int>("runtime.executor.workers", 0), 8);
+
+    auto snap = ConfigSnapshot::Builder().build();
+    store.publish(snap);
+    EXPECT_THROW(store.publish(snap), std::invalid_argument);
+}
+
+TEST(ConfigStoreTest, ThrowingListenerDoesNotStarveLaterSubscribers)
+{
+    ConfigStore store(ConfigSnapshot::Builder().mergeJson(kBase).build());
+    int first = 0;
+    int second = 0;
+    store.subscribe("runtime", [&](const ConfigSnapshot&) {
+        ++first;
+        throw std::runtime_error("first subscriber failed");
+    });
+    store.subscribe("runtime", [&](const ConfigSnapshot& snap) {
+        second = snap.get<int>("runtime.executor.workers", 0);
+    });
+
+    try {
+        store.publish(ConfigSnapshot::Builder().mergeJson(kBase).mergeJson(kProfile).build());
+        FAIL() << "listener error should be rethrown";
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ(e.what(), "first subscriber failed");
+    }
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 4);
+    EXPECT_EQ(store.snapshot()->get<int>("runtime.executor.workers", 0), 4);
+}
+
+TEST(ConfigStoreTest, ConcurrentReadersDuringPublish)
+{
+    auto make = [](int n) {
+        return ConfigSnapshot::Builder()
+            .set("a", ConfigValue::fromInt(n))
+            .set("b", ConfigValue::fromInt(n))
+            .build();
+    };
+    ConfigStore store(make(0));
+    auto a = store.handle<int>("a", -1);
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!stop.load()) {
+                auto s = store.snapshot();
+                if (s->get<int>("a", -1) != s->get<int>("b", -2)) torn.fetch_add(1);
+                const int v = a.get();
+                if (v < last) torn.fetch_add(1);   // 句柄的值单调前进
+                last = v;
+            }
+        });
+    }
+    for (int i = 1; i <= 500; ++i) store.publish(make(i));
+    stop.store(true);
+    for (auto& t : readers) t.join();
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(a.get(), 500);
+}
+
+TEST(ConfigStoreTest, CachedReadsFollowPublishAcrossStoresAndThreads)
+{
+    // 多于每线程缓存槽位数的字符串句柄和多个 store，槽位会互相覆盖
+    ConfigStore a(ConfigSnapshot::Builder().set("k", ConfigValue::fromString("a0")).build());
+    ConfigStore b(ConfigSnapshot::Builder().set("k", ConfigValue::fromString("b0")).build());
+    std::vector<ConfigStringHandle> handles;
+    for (int i = 0; i < 40; ++i) handles.push_back((i % 2 ? b : a).stringHandle("k"));
+    for (int i = 0; i < 40; ++i) EXPECT_EQ(*handles[i].get(), i % 2 ? "b0" : "a0");
+    EXPECT_EQ(a.snapshot()->getString("k"), "a0");
+
+    a.publish(ConfigSnapshot::Builder().set("k", ConfigValue::fromString("a1")).build());
+    EXPECT_EQ(a.snapshot()->getString("k"), "a1");
+    EXPECT_EQ(b.snapshot()->getString("k"), "b0");
+    for (int i = 0; i < 40; ++i) EXPECT_EQ(*handles[i].get(), i % 2 ? "b0" : "a1");
+
+    // 另一个线程先读到旧版本并缓存，publish 之后必须读到新版本
+    std::atomic<int> phase{0};
+    std::string before;
+    std::string after;
+    std::thread reader([&] {
+        before = b.snapshot()->getString("k");
+        phase.store(1);
+        while (phase.load() != 2) std::this_thread::yield();
+        after = b.snapshot()->getString("k");
+    });
+    while (phase.load() != 1) std::this_thread::yield();
+    b.publish(ConfigSnapshot::Builder().set("k", ConfigValue::fromString("b1")).build());
+    phase.store(2);
+    reader.join();
+    EXPECT_EQ(before, "b0");
+    EXPECT_EQ(after, "b1");
+}
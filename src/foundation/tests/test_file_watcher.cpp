@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "foundation/Fs/FileWatcher.h"
+#include "foundation/testing/TempDir.h"
+
+using namespace foundation::fs;
+namespace stdfs = std::filesystem;
+
+namespace {
+
+class FileWatcherTest : public ::testing::TestWithParam<FileWatcherBackend> {
+protected:
+    void SetUp() override {
+#if !defined(__linux__)
+        if (GetParam() == FileWatcherBackend::Native) GTEST_SKIP() << "no native backend";
+#endif
+        dir_ = foundation::testutil::freshTempDir("file_watcher");
+        options_.backend = GetParam();
+        options_.coalesce = std::chrono::milliseconds(30);
+        options_.pollInterval = std::chrono::milliseconds(20);
+    }
+
+    void TearDown() override { stdfs::remove_all(dir_); }
+
+    void write(const stdfs::path& p, const std::string& text) {
+        std::ofstream out(p, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+
+    template <typename Pred>
+    static bool waitFor(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(3000)) {
+        const auto end = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < end) {
+            if (pred()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return pred();
+    }
+
+    stdfs::path dir_;
+    FileWatcherOptions options_;
+};
+
+struct Recorder {
+    std::mutex mutex;
+    std::vector<std::vector<FileChange>> batches;
+
+    FileChangeCallback callback() {
+        return [this](const std::vector<FileChange>& changes) {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(changes);
+        };
+    }
+    std::size_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches.size();
+    }
+    std::vector<FileChange> first() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches.empty() ? std::vector<FileChange>() : batches.front();
+    }
+    std::set<std::string> paths() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::set<std::string> out;
+        for (const auto& b : batches) {
+            for (const auto& c : b) out.insert(stdfs::path(c.path).filename().string());
+        }
+        return out;
+    }
+};
+
+} // namespace
+
+TEST_P(FileWatcherTest, ReportsFileCreationAndModification)
+{
+    FileWatcher watcher(options_);
+    EXPECT_EQ(watcher.backend(), GetParam());
+    Recorder rec;
+    watcher.watchFile((dir_ / "config.json").string(), rec.callback());
+    watcher.start();
+
+    write(dir_ / "config.json", "{}");
+    ASSERT_TRUE(waitFor([&] { return rec.count() >= 1; }));
+    EXPECT_EQ(rec.first()[0].event, FileEvent::Created);
+
+    write(dir_ / "other.json", "{}");   // 同目录的其它文件不触发
+    write(dir_ / "config.json", "{\"a\": 1}");
+    ASSERT_TRUE(waitFor([&] { return rec.count() >= 2; }));
+    EXPECT_EQ(rec.paths(), std::set<std::string>{"config.json"});
+}
+
+TEST_P(FileWatcherTest, CoalescesBurstWrites)
+{
+    write(dir_ / "burst.log", "");
+    FileWatcher watcher(options_);
+    Recorder rec;
+    watcher.watchFile((dir_ / "burst.log").string(), rec.callback());
+    watcher.start();
+
+    {
+        std::ofstream out(dir_ / "burst.log", std::ios::binary | std::ios::app);
+        for (int i = 0; i < 200; ++i) {
+            out << "line " << i << '\n';
+            out.flush();
+        }
+    }
+    ASSERT_TRUE(waitFor([&] { return rec.count() >= 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_LE(rec.count(), 2u);
+    ASSERT_EQ(rec.first().size(), 1u);
+    EXPECT_EQ(rec.first()[0].event, FileEvent::Modified);
+}
+
+TEST_P(FileWatcherTest, WatchesDirectoryAndRenameSaves)
+{
+    write(dir_ / "target.csv", "old");
+    FileWatcher watcher(options_);
+    Recorder rec;
+    watcher.watchDirectory(dir_.string(), rec.callback());
+    watcher.start();
+
+    write(dir_ / "a.csv", "1");
+    write(dir_ / "b.csv", "2");
+    // 编辑器式保存：写临时文件后改名覆盖
+    write(dir_ / "target.csv.tmp", "new content");
+    stdfs::rename(dir_ / "target.csv.tmp", dir_ / "target.csv");
+
+    ASSERT_TRUE(waitFor([&] {
+        const auto p = rec.paths();
+        return p.count("a.csv") && p.count("b.csv") && p.count("target.csv");
+    }));
+}
+
+TEST_P(FileWatcherTest, UnwatchStopsCallbacks)
+{
+    FileWatcher watcher(options_);
+    Recorder keep;
+    Recorder drop;
+    watcher.watchFile((dir_ / "keep.txt").string(), keep.callback());
+    const auto id = watcher.watchFile((dir_ / "drop.txt").string(), drop.callback());
+    watcher.start();
+    watcher.unwatch(id);
+    EXPECT_EQ(watcher.watchCount(), 1u);
+
+    write(dir_ / "drop.txt", "x");
+    write(dir_ / "keep.txt", "x");
+    ASSERT_TRUE(waitFor([&] { return keep.count() >= 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(drop.count(), 0u);
+}
+
+TEST_P(FileWatcherTest, ManyWatchedFilesShareDirectory)
+{
+    FileWatcher watcher(options_);
+    std::atomic<int> hits{0};
+    std::atomic<int> wrong{0};
+    constexpr int kFiles = 2000;
+    for (int i = 0; i < kFiles; ++i) {
+        watcher.watchFile((dir_ / ("f" + std::to_string(i))).string(), [&, i](const std::vector<FileChange>&) {
+            (i == 1234 ? hits : wrong).fetch_add(1);
+        });
+    }
+    EXPECT_EQ(watcher.watchCount(), static_cast<std::size_t>(kFiles));
+    watcher.start();
+    write(dir_ / "f1234", "x");
+    ASSERT_TRUE(waitFor([&] { return hits.load() >= 1; }));
+    EXPECT_EQ(wrong.load(), 0);
+}
+
+TEST_P(FileWatcherTest, SurvivesDirectoryRemovalAndRecreation)
+{
+    const stdfs::path sub = dir_ / "sub";
+    stdfs::create_directories(sub);
+    write(sub / "a.txt", "1");
+    FileWatcher watcher(options_);
+    Recorder rec;
+    watcher.watchFile((sub / "a.txt").string(), rec.callback());
+    watcher.start();
+
+    stdfs::remove_all(sub);
+    ASSERT_TRUE(waitFor([&] { return rec.count() >= 1; }));
+    EXPECT_EQ(rec.first()[0].event, FileEvent::Removed);
+
+    // 目录重建后 watch 应重新生效
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const std::size_t before = rec.count();
+    stdfs::create_directories(sub);
+    write(sub / "a.txt", "2");
+    ASSERT_TRUE(waitFor([&] { return rec.count() > before; }));
+    const std::size_t settled = rec.count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    write(sub / "a.txt", "3");
+    ASSERT_TRUE(waitFor([&] { return rec.count() > settled; }));
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, FileWatcherTest,
+                         ::testing::Values(FileWatcherBackend::Native, FileWatcherBackend::Polling),
+                         [](const ::testing::TestParamInfo<FileWatcherBackend>& info) {
+                             return info.param == FileWatcherBackend::Native ? "Native" : "Polling";
+                         });
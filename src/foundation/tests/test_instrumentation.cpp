@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "foundation/log/instrumentation.hpp"
+
+using namespace foundation::metrics;
+
+TEST(InstrumentationTest, UncalibratedFirstConversionIsCheap)
+{
+    // 启动时没有 calibrate() 也不能让第一个探针等上 20ms；先清掉其它用例留下的校准
+    Instrumentation::resetCalibration();
+    ASSERT_FALSE(Instrumentation::calibrated());
+    const auto t0 = std::chrono::steady_clock::now();
+    Instrumentation::toNanos(1000);
+    const auto elapsed = std::chrono::steady_clock::now() - t0;
+    EXPECT_TRUE(Instrumentation::calibrated());
+    EXPECT_LT(elapsed, std::chrono::milliseconds(5));
+}
+
+TEST(InstrumentationTest, CalibratedConversionTracksSteadyClock)
+{
+    EXPECT_GT(Instrumentation::calibrate(), 0.0);
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::uint64_t c0 = Instrumentation::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    const std::uint64_t c1 = Instrumentation::now();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    const double measured = static_cast<double>(Instrumentation::toNanos(c1 - c0));
+    EXPECT_NEAR(measured / static_cast<double>(ns), 1.0, 0.1);
+}
+
+TEST(InstrumentationTest, ProbesAggregateAcrossThreads)
+{
+    Instrumentation::calibrate(std::chrono::milliseconds(1));
+    Instrumentation::reset();
+    auto work = [] {
+        for (int i = 0; i < 100; ++i) {
+            ENGINE_PROBE(Stage::StrategyStep);
+        }
+        { ENGINE_PROBE(Stage::OrderSimulation); }
+    };
+    std::thread t(work);
+    work();
+    t.join();
+    const auto stages = Instrumentation::snapshot();
+    EXPECT_EQ(stages[static_cast<std::size_t>(Stage::StrategyStep)].count, 200u);
+    EXPECT_EQ(stages[static_cast<std::size_t>(Stage::OrderSimulation)].count, 2u);
+    EXPECT_EQ(stages[static_cast<std::size_t>(Stage::Dispatch)].count, 0u);
+    EXPECT_GE(Instrumentation::threadCount(), 1u);   // t 已退出，数据在归档里
+    EXPECT_NE(Instrumentation::report().find("strategy_step"), std::string::npos);
+
+    Instrumentation::setEnabled(false);
+    work();
+    Instrumentation::setEnabled(true);
+    EXPECT_EQ(Instrumentation::snapshot()[static_cast<std::size_t>(Stage::StrategyStep)].count, 200u);
+}
+
+TEST(InstrumentationTest, ExitedThreadsAreRetiredNotLeaked)
+{
+    Instrumentation::calibrate(std::chrono::milliseconds(1));
+    Instrumentation::reset();
+    { ENGINE_PROBE(Stage::Dispatch); }   // 本线程先登记
+    const std::size_t before = Instrumentation::threadCount();
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::thread> pool;
+        for (int i = 0; i < 4; ++i) {
+            pool.emplace_back([] {
+                for (int k = 0; k < 10; ++k) {
+                    ENGINE_PROBE(Stage::SignalEval);
+                }
+            });
+        }
+        for (auto& t : pool) t.join();
+    }
+    // 80 个线程都已退出：注册表没有变大，它们的样本一个不少
+    EXPECT_EQ(Instrumentation::threadCount(), before);
+    EXPECT_EQ(Instrumentation::snapshot()[static_cast<std::size_t>(Stage::SignalEval)].count, 800u);
+    Instrumentation::reset();
+    EXPECT_EQ(Instrumentation::snapshot()[static_cast<std::size_t>(Stage::SignalEval)].count, 0u);
+}
+
+TEST(InstrumentationTest, StagesExportToMetricsRegistry)
+{
+    Instrumentation::calibrate(std::chrono::milliseconds(1));
+    Instrumentation::reset();
+    for (int i = 0; i < 5; ++i) {
+        ENGINE_PROBE(Stage::IndicatorUpdate);
+    }
+    {
+        const auto handles = Instrumentation::bindMetrics("instrumentation_test");
+        const std::string text = foundation::metrics::MetricsRegistry::instance().exportText();
+        EXPECT_NE(text.find("# TYPE engine_stage_samples_total counter"), std::string::npos);
+        EXPECT_NE(text.find("engine_stage_samples_total{engine=\"instrumentation_test\",stage=\"indicator_update\"} 5"),
+                  std::string::npos);
+        EXPECT_NE(text.find("# TYPE engine_stage_latency_us gauge"), std::string::npos);
+        EXPECT_NE(text.find("quantile=\"0.99\",stage=\"indicator_update\""), std::string::npos);
+    }
+    // 句柄析构后注销
+    const std::string after = foundation::metrics::MetricsRegistry::instance().exportText();
+    EXPECT_EQ(after.find("engine=\"instrumentation_test\""), std::string::npos);
+}
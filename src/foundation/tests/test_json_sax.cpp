@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "foundation/json/json_sax.h"
+
+using namespace foundation::json;
+
+namespace {
+
+// 把事件序列化成紧凑文本，便于断言
+class Recorder : public JsonSaxHandler {
+public:
+    std::string out;
+    int stopAfter = -1;   // 第 N 个事件后返回 false
+    int events = 0;
+
+    bool onNull() override { return add("null"); }
+    bool onBool(bool b) override { return add(b ? "true" : "false"); }
+    bool onInt(std::int64_t v) override { return add("i" + std::to_string(v)); }
+    bool onDouble(double v) override { return add("d" + std::to_string(v)); }
+    bool onString(std::string_view s) override { return add("s:" + std::string(s)); }
+    bool onKey(std::string_view s) override { return add("k:" + std::string(s)); }
+    bool onStartObject() override { return add("{"); }
+    bool onEndObject() override { return add("}"); }
+    bool onStartArray() override { return add("["); }
+    bool onEndArray() override { return add("]"); }
+
+private:
+    bool add(const std::string& e) {
+        if (!out.empty()) out += ' ';
+        out += e;
+        return ++events != stopAfter;
+    }
+};
+
+std::string events(std::string_view text, const JsonSaxOptions& options = JsonSaxOptions())
+{
+    Recorder r;
+    const auto res = parseJsonSax(text, r, options);
+    EXPECT_TRUE(res.ok) << res.error << " at " << res.offset;
+    return r.out;
+}
+
+JsonSaxResult fail(std::string_view text, const JsonSaxOptions& options = JsonSaxOptions())
+{
+    Recorder r;
+    return parseJsonSax(text, r, options);
+}
+
+} // namespace
+
+TEST(JsonSaxTest, EmitsEventsInDocumentOrder)
+{
+    EXPECT_EQ(events(R"( {"a": [1, -2, 3.5, true, false, null], "b": {"c": "x"}} )"),
+              "{ k:a [ i1 i-2 d3.500000 true false null ] k:b { k:c s:x } }");
+    EXPECT_EQ(events("[]"), "[ ]");
+    EXPECT_EQ(events("{}"), "{ }");
+    EXPECT_EQ(events("42"), "i42");
+    EXPECT_EQ(events(R"("top")"), "s:top");
+}
+
+TEST(JsonSaxTest, NumbersSplitIntoIntAndDouble)
+{
+    EXPECT_EQ(events("[0, -0, 1e2, 1.0, 9223372036854775807, 9223372036854775808, -9223372036854775808]"),
+              "[ i0 d-0.000000 d100.000000 d1.000000 i9223372036854775807 d9223372036854775808.000000 "
+              "i-9223372036854775808 ]");
+    EXPECT_FALSE(fail("[01]").ok);
+    EXPECT_FALSE(fail("[1.]").ok);
+    EXPECT_FALSE(fail("[.5]").ok);
+    EXPECT_FALSE(fail("[1e]").ok);
+    EXPECT_FALSE(fail("[-]").ok);
+    EXPECT_FALSE(fail("[+1]").ok);
+}
+
+TEST(JsonSaxTest, DecodesEscapesAndUnicode)
+{
+    EXPECT_EQ(events(R"(["a\"b\\c\/d\n\t", "\u4e2d\u6587", "\ud83d\ude00", "平安银行"])"),
+              "[ s:a\"b\\c/d\n\t s:中文 s:\xF0\x9F\x98\x80 s:平安银行 ]");
+    EXPECT_FALSE(fail(R"(["\x"])").ok);
+    EXPECT_FALSE(fail(R"(["\u12"])").ok);
+    EXPECT_FALSE(fail(R"(["\ud83d"])").ok);      // 孤立的高代理
+    EXPECT_FALSE(fail(R"(["\udc00"])").ok);      // 孤立的低代理
+    EXPECT_FALSE(fail(R"(["\ude00\ud83d"])").ok);  // 顺序颠倒的代理对
+    EXPECT_FALSE(fail("[\"a\nb\"]").ok);          // 未转义的控制字符
+}
+
+TEST(JsonSaxTest, UnescapedStringsPointIntoInput)
+{
+    struct Capture : JsonSaxHandler {
+        std::string_view last;
+        bool onString(std::string_view s) override {
+            last = s;
+            return true;
+        }
+    } cap;
+    const std::string text = R"(["600000.SH"])";
+    ASSERT_TRUE(parseJsonSax(text, cap).ok);
+    EXPECT_EQ(cap.last, "600000.SH");
+    EXPECT_EQ(cap.last.data(), text.data() + 2);
+}
+
+TEST(JsonSaxTest, LongStringsAcrossVectorBlocks)
+{
+    // 引号/反斜杠分别落在 16 字节块的不同位置
+    for (std::size_t len = 0; len < 70; ++len) {
+        const std::string body(len, 'x');
+        EXPECT_EQ(events("[\"" + body + "\"]"), "[ s:" + body + " ]") << len;
+        EXPECT_EQ(events("[\"" + body + "\\n" + body + "\"]"), "[ s:" + body + "\n" + body + " ]") << len;
+        EXPECT_EQ(events(std::string(len, ' ') + "[" + std::string(len, '\n') + "1]"), "[ i1 ]") << len;
+    }
+}
+
+TEST(JsonSaxTest, ReportsErrorOffsets)
+{
+    auto r = fail(R"({"a": 1,})");
+    EXPECT_FALSE(r.ok);
+    EXPECT_EQ(r.offset, 8u);
+    EXPECT_FALSE(r.error.empty());
+
+    r = fail(R"({"a" 1})");
+    EXPECT_FALSE(r.ok);
+    EXPECT_EQ(r.offset, 5u);
+
+    EXPECT_FALSE(fail("[1, 2").ok);
+    EXPECT_FALSE(fail(R"(["abc)").ok);
+    EXPECT_FALSE(fail("[1] 2").ok);
+    EXPECT_FALSE(fail("[1]]").ok);
+    EXPECT_FALSE(fail("").ok);
+    EXPECT_FALSE(fail("tru").ok);
+    EXPECT_FALSE(fail("{1: 2}").ok);
+}
+
+TEST(JsonSaxTest, HandlerCanStopEarly)
+{
+    Recorder r;
+    r.stopAfter = 3;
+    const auto res = parseJsonSax(R"([1, 2, 3, 4] trailing garbage)", r);
+    EXPECT_TRUE(res.ok);
+    EXPECT_TRUE(res.stopped);
+    EXPECT_EQ(r.out, "[ i1 i2");
+}
+
+TEST(JsonSaxTest, CommentsOnlyWhenAllowed)
+{
+    const char* text = "// 头部\n{\"a\": /* 值 */ 1, // 行尾\n \"b\": 2}";
+    EXPECT_FALSE(fail(text).ok);
+    JsonSaxOptions opts;
+    opts.allowComments = true;
+    EXPECT_EQ(events(text, opts), "{ k:a i1 k:b i2 }");
+    EXPECT_FALSE(fail("[1 /* 未结束", opts).ok);
+}
+
+TEST(JsonSaxTest, DeepNestingIsBoundedNotRecursive)
+{
+    const std::size_t depth = 100000;
+    const std::string deep = std::string(depth, '[') + std::string(depth, ']');
+
+    JsonSaxOptions opts;
+    opts.maxDepth = depth;
+    Recorder r;
+    EXPECT_TRUE(parseJsonSax(deep, r, opts).ok);
+
+    opts.maxDepth = 64;
+    const auto res = fail(deep, opts);
+    EXPECT_FALSE(res.ok);
+    EXPECT_EQ(res.offset, 64u);
+}
+
+TEST(JsonSaxTest, ParsesNumbersInStrings)
+{
+    double d = 0;
+    EXPECT_TRUE(parseJsonNumber("7.10", d));
+    EXPECT_DOUBLE_EQ(d, 7.10);
+    EXPECT_TRUE(parseJsonNumber("-1.5e3", d));
+    EXPECT_DOUBLE_EQ(d, -1500.0);
+    EXPECT_FALSE(parseJsonNumber("", d));
+    EXPECT_FALSE(parseJsonNumber("7.1x", d));
+
+    std::int64_t i = 0;
+    EXPECT_TRUE(parseJsonNumber("123456789012", i));
+    EXPECT_EQ(i, 123456789012);
+    EXPECT_FALSE(parseJsonNumber("1.5", i));
+    EXPECT_FALSE(parseJsonNumber("99999999999999999999", i));
+}
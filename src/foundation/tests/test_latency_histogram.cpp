@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "foundation/Utils/LatencyHistogram.h"
+
+using namespace foundation::utils;
+
+TEST(LatencyHistogramTest, BucketBoundsContainValue)
+{
+    for (std::uint64_t v : {0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, 1ull << 40}) {
+        const int b = LatencyHistogram::bucketOf(v);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(b), v);
+        if (b > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(b - 1), v);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(~0ull), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError)
+{
+    LatencyHistogram h;
+    for (std::uint64_t v = 1; v <= 100000; ++v) h.record(v);
+    EXPECT_EQ(h.count(), 100000u);
+    EXPECT_EQ(h.max(), 100000u);
+    EXPECT_NEAR(h.mean(), 50000.5, 0.01);
+    EXPECT_NEAR(static_cast<double>(h.percentile(50)), 50000.0, 50000.0 * 0.07);
+    EXPECT_NEAR(static_cast<double>(h.percentile(99)), 99000.0, 99000.0 * 0.07);
+    EXPECT_EQ(h.percentile(100), 100000u);
+}
+
+TEST(LatencyHistogramTest, MergeAndConcurrentRecord)
+{
+    LatencyHistogram total;
+    std::vector<std::thread> threads;
+    LatencyHistogram perThread[4];
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {
+                perThread[t].record(100 + t);
+                total.record(100 + t);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    LatencyHistogram merged;
+    for (auto& h : perThread) merged.merge(h);
+    EXPECT_EQ(merged.count(), 40000u);
+    EXPECT_EQ(total.count(), 40000u);
+    EXPECT_EQ(merged.max(), 103u);
+    merged.reset();
+    EXPECT_EQ(merged.count(), 0u);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "foundation/Fs/MappedFile.h"
+#include "foundation/testing/TempDir.h"
+
+using namespace foundation::fs;
+namespace stdfs = std::filesystem;
+
+namespace {
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = foundation::testutil::freshTempDir("mapped_file_test");
+    }
+    void TearDown() override { stdfs::remove_all(dir_); }
+
+    std::string write(const std::string& name, const std::string& content) {
+        const auto p = (dir_ / name).string();
+        std::ofstream(p, std::ios::binary) << content;
+        return p;
+    }
+
+    static std::string read(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    stdfs::path dir_;
+};
+
+std::string pattern(std::size_t n)
+{
+    std::string s(n, '\0');
+    for (std::size_t i = 0; i < n; ++i) s[i] = static_cast<char>('a' + i % 26);
+    return s;
+}
+
+} // namespace
+
+TEST_F(MappedFileTest, MapsWholeFileReadOnly)
+{
+    const std::string content = pattern(3 * MappedFile::pageSize() + 17);
+    const auto path = write("a.bin", content);
+
+    const auto file = MappedFile::open(path);
+    EXPECT_EQ(file.size(), content.size());
+    EXPECT_EQ(file.view(), content);
+    EXPECT_EQ(file.path(), path);
+    EXPECT_EQ(file.access(), MapAccess::ReadOnly);
+    EXPECT_THROW(file.writableData(), std::logic_error);
+}
+
+TEST_F(MappedFileTest, UnalignedOffsetAndLength)
+{
+    const std::string content = pattern(5 * MappedFile::pageSize());
+    const auto path = write("a.bin", content);
+
+    MapOptions opts;
+    opts.offset = MappedFile::pageSize() + 123;
+    opts.length = 2 * MappedFile::pageSize() + 7;
+    const auto file = MappedFile::open(path, opts);
+    EXPECT_EQ(file.view(), content.substr(opts.offset, opts.length));
+
+    opts.length = 0;
+    EXPECT_EQ(MappedFile::open(path, opts).view(), content.substr(opts.offset));
+
+    opts.length = content.size();
+    EXPECT_THROW(MappedFile::open(path, opts), std::runtime_error);
+    opts.offset = content.size() + 1;
+    opts.length = 0;
+    EXPECT_THROW(MappedFile::open(path, opts), std::runtime_error);
+}
+
+TEST_F(MappedFileTest, EmptyFileAndMissingFile)
+{
+    const auto empty = MappedFile::open(write("empty.bin", ""));
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.view(), "");
+    empty.advise(MapAdvice::Sequential);
+
+    EXPECT_THROW(MappedFile::open((dir_ / "missing.bin").string()), std::runtime_error);
+}
+
+TEST_F(MappedFileTest, ReadWriteCreatesAndWritesBack)
+{
+    const auto path = (dir_ / "rw.bin").string();
+    MapOptions opts;
+    opts.access = MapAccess::ReadWrite;
+    opts.createSize = 10000;
+    {
+        auto file = MappedFile::open(path, opts);
+        ASSERT_EQ(file.size(), 10000u);
+        EXPECT_EQ(file.view(), std::string(10000, '\0'));
+        std::memcpy(file.writableData() + 4096, "hello", 5);
+        file.flush();
+    }
+    const std::string disk = read(path);
+    ASSERT_EQ(disk.size(), 10000u);
+    EXPECT_EQ(disk.substr(4096, 5), "hello");
+
+    // 已有文件比 createSize 大时不截断
+    opts.createSize = 100;
+    EXPECT_EQ(MappedFile::open(path, opts).size(), 10000u);
+}
+
+TEST_F(MappedFileTest, CopyOnWriteDoesNotTouchFile)
+{
+    const auto path = write("cow.bin", "original");
+    MapOptions opts;
+    opts.access = MapAccess::CopyOnWrite;
+    auto file = MappedFile::open(path, opts);
+    std::memcpy(file.writableData(), "modified", 8);
+    EXPECT_EQ(file.view(), "modified");
+    file.flush();
+    EXPECT_EQ(read(path), "original");
+    EXPECT_EQ(MappedFile::open(path).view(), "original");
+}
+
+TEST_F(MappedFileTest, SliceKeepsMappingAlive)
+{
+    const std::string content = pattern(2 * MappedFile::pageSize());
+    MappedFile tail;
+    {
+        const auto file = MappedFile::open(write("a.bin", content));
+        tail = file.slice(MappedFile::pageSize() + 1, 10);
+        EXPECT_EQ(file.slice(content.size() - 3).view(), content.substr(content.size() - 3));
+        EXPECT_TRUE(file.slice(content.size() + 100).empty());
+    }
+    EXPECT_EQ(tail.view(), content.substr(MappedFile::pageSize() + 1, 10));
+    tail.advise(MapAdvice::DontNeed);
+    EXPECT_EQ(tail.view(), content.substr(MappedFile::pageSize() + 1, 10));
+}
+
+TEST_F(MappedFileTest, AdviceAndPopulateKeepContent)
+{
+    const std::string content = pattern(8 * MappedFile::pageSize() + 5);
+    const auto path = write("a.bin", content);
+    for (auto advice : {MapAdvice::Normal, MapAdvice::Sequential, MapAdvice::Random, MapAdvice::WillNeed,
+                        MapAdvice::DontNeed}) {
+        MapOptions opts;
+        opts.advice = advice;
+        opts.populate = true;
+        opts.hugePages = true;   // 不支持时静默退回普通页
+        const auto file = MappedFile::open(path, opts);
+        file.slice(3, 5000).advise(advice);
+        EXPECT_EQ(file.view(), content);
+    }
+}
+
+TEST_F(MappedFileTest, AnonymousMappingIsZeroedAndWritable)
+{
+    for (bool huge : {false, true}) {
+        auto mem = MappedFile::anonymous(3 << 20, huge);
+        ASSERT_EQ(mem.size(), std::size_t(3) << 20);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mem.data()) % MappedFile::pageSize(), 0u);
+        EXPECT_EQ(mem.data()[12345], 0);
+        mem.writableData()[mem.size() - 1] = 'x';
+        EXPECT_EQ(mem.data()[mem.size() - 1], 'x');
+    }
+    EXPECT_TRUE(MappedFile::anonymous(0).empty());
+}
+
+TEST_F(MappedFileTest, SharedAcrossThreads)
+{
+    const std::string content = pattern(64 * 1024);
+    const std::uint64_t expected = std::accumulate(content.begin(), content.end(), std::uint64_t(0));
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    {
+        const auto file = MappedFile::open(write("a.bin", content));
+        for (int t = 0; t < 4; ++t) {
+            // 每个线程持有自己的句柄拷贝，原句柄先析构
+            threads.emplace_back([view = file.slice(0), expected, &ok] {
+                std::uint64_t sum = 0;
+                for (char c : view.view()) sum += static_cast<unsigned char>(c);
+                if (sum == expected) ++ok;
+            });
+        }
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(ok.load(), 4);
+}
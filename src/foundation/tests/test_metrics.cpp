@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "foundation/Utils/CacheUtils.h"
+#include "foundation/log/metrics.hpp"
+
+using namespace foundation::metrics;
+
+TEST(MetricsTest, CounterSumsAcrossThreads)
+{
+    MetricsRegistry registry;
+    auto& c = registry.counter("test_events_total", {{"kind", "a"}});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&c] {
+            for (int i = 0; i < 10000; ++i) c.inc();
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(c.value(), 80000u);
+    EXPECT_EQ(&c, &registry.counter("test_events_total", {{"kind", "a"}}));
+    EXPECT_NE(&c, &registry.counter("test_events_total", {{"kind", "b"}}));
+}
+
+TEST(MetricsTest, GaugeSetAndAdd)
+{
+    MetricsRegistry registry;
+    auto& g = registry.gauge("test_queue_depth");
+    g.set(10);
+    g.add(2.5);
+    g.add(-0.5);
+    EXPECT_DOUBLE_EQ(g.value(), 12.0);
+}
+
+TEST(MetricsTest, HistogramMergesShards)
+{
+    MetricsRegistry registry;
+    auto& h = registry.histogram("test_latency_ns");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h] {
+            for (std::uint64_t v = 1; v <= 1000; ++v) h.record(v);
+        });
+    }
+    for (auto& t : threads) t.join();
+    foundation::utils::LatencyHistogram merged;
+    h.snapshot(merged);
+    EXPECT_EQ(merged.count(), 4000u);
+    EXPECT_EQ(merged.max(), 1000u);
+}
+
+TEST(MetricsTest, RejectsInvalidNameAndTypeConflict)
+{
+    MetricsRegistry registry;
+    EXPECT_THROW(registry.counter("bad name"), std::invalid_argument);
+    EXPECT_THROW(registry.counter(""), std::invalid_argument);
+    registry.counter("test_conflict");
+    EXPECT_THROW(registry.gauge("test_conflict"), std::invalid_argument);
+}
+
+TEST(MetricsTest, CallbackUnregistersWithHandle)
+{
+    MetricsRegistry registry;
+    double depth = 3;
+    {
+        auto handle = registry.gaugeCallback("test_pull_depth", {}, [&depth] { return depth; });
+        const auto samples = registry.snapshot();
+        ASSERT_EQ(samples.size(), 1u);
+        EXPECT_DOUBLE_EQ(samples[0].value, 3.0);
+    }
+    EXPECT_TRUE(registry.snapshot().empty());
+}
+
+TEST(MetricsTest, ExportTextAndJson)
+{
+    MetricsRegistry registry;
+    registry.counter("test_requests_total", {{"host", "sina"}}).inc(5);
+    registry.histogram("test_request_ns").record(100);
+
+    const std::string text = registry.exportText();
+    EXPECT_NE(text.find("# TYPE test_requests_total counter"), std::string::npos);
+    EXPECT_NE(text.find("test_requests_total{host=\"sina\"} 5"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_request_ns summary"), std::string::npos);
+    EXPECT_NE(text.find("test_request_ns_count 1"), std::string::npos);
+
+    const std::string json = registry.exportJson();
+    EXPECT_NE(json.find("\"name\":\"test_requests_total\""), std::string::npos);
+    EXPECT_NE(json.find("\"host\":\"sina\""), std::string::npos);
+
+    const std::string path = "test_metrics_snapshot.json";
+    registry.writeJsonFile(path);
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    EXPECT_EQ(ss.str(), json + "\n");
+    in.close();
+    std::remove(path.c_str());
+}
+
+TEST(MetricsTest, CacheBindsToGlobalRegistry)
+{
+    foundation::utils::ConcurrentCache<int, int> cache(foundation::utils::CacheOptions(1u << 20));
+    cache.bindMetrics("metrics_test");
+    cache.put(1, 1);
+    cache.get(1);
+    cache.get(2);
+
+    const std::string text = MetricsRegistry::instance().exportText();
+    EXPECT_NE(text.find("cache_hits_total{cache=\"metrics_test\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("cache_misses_total{cache=\"metrics_test\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE cache_hits_total counter"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE cache_hit_rate gauge"), std::string::npos);
+}
+
+TEST(MetricsTest, CallbacksCarryTypeAndConflictWithOtherTypes)
+{
+    MetricsRegistry registry;
+    double hits = 7;
+    auto counter = registry.counterCallback("test_pulled_total", {}, [&hits] { return hits; });
+    auto gauge = registry.gaugeCallback("test_pulled_ratio", {}, [] { return 0.5; });
+    const std::string text = registry.exportText();
+    EXPECT_NE(text.find("# TYPE test_pulled_total counter"), std::string::npos);
+    EXPECT_NE(text.find("test_pulled_total 7"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_pulled_ratio gauge"), std::string::npos);
+
+    // 回调与对象共用同一套类型检查
+    EXPECT_THROW(registry.gaugeCallback("test_pulled_total", {}, [] { return 0.0; }), std::invalid_argument);
+    EXPECT_THROW(registry.gauge("test_pulled_total"), std::invalid_argument);
+    registry.gauge("test_depth");
+    EXPECT_THROW(registry.counterCallback("test_depth", {}, [] { return 0.0; }), std::invalid_argument);
+    EXPECT_THROW(registry.counterCallback("bad name", {}, [] { return 0.0; }), std::invalid_argument);
+    EXPECT_NO_THROW(registry.counterCallback("test_pulled_total", {{"k", "v"}}, [] { return 1.0; }));
+}
+
+TEST(MetricsTest, DuplicateCallbackSeriesRejected)
+{
+    MetricsRegistry registry;
+    auto first = registry.gaugeCallback("test_queue_depth", {{"queue", "a"}}, [] { return 1.0; });
+    EXPECT_THROW(registry.gaugeCallback("test_queue_depth", {{"queue", "a"}}, [] { return 2.0; }),
+                 std::invalid_argument);
+    EXPECT_THROW(registry.gauge("test_queue_depth", {{"queue", "a"}}), std::invalid_argument);
+    auto other = registry.gaugeCallback("test_queue_depth", {{"queue", "b"}}, [] { return 3.0; });
+
+    registry.gauge("test_open_files");
+    EXPECT_THROW(registry.gaugeCallback("test_open_files", {}, [] { return 0.0; }), std::invalid_argument);
+
+    // 注销后同一序列可以重新注册
+    first.release();
+    EXPECT_NO_THROW(registry.gaugeCallback("test_queue_depth", {{"queue", "a"}}, [] { return 4.0; }));
+}
+
+TEST(MetricsTest, CallbacksRunOutsideTheRegistryLock)
+{
+    MetricsRegistry registry;
+    // 回调里访问注册表本身：在锁内调用会自锁
+    auto handle = registry.gaugeCallback("test_reentrant", {}, [&registry] {
+        registry.counter("test_reentrant_reads_total").inc();
+        return 1.0;
+    });
+    registry.exportText();
+    const std::string text = registry.exportText();
+    EXPECT_NE(text.find("test_reentrant_reads_total 1"), std::string::npos);
+    EXPECT_NE(text.find("test_reentrant 1"), std::string::npos);
+}
+
+TEST(MetricsTest, ReleaseWaitsForRunningCallback)
+{
+    MetricsRegistry registry;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    auto handle = registry.gaugeCallback("test_slow", {}, [&] {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+        return 1.0;
+    });
+    std::thread exporter([&] { registry.snapshot(); });
+    while (!entered) std::this_thread::yield();
+    handle.release();
+    // release 返回时回调已经结束，之后不会再被调用
+    EXPECT_TRUE(finished);
+    exporter.join();
+    EXPECT_TRUE(registry.snapshot().empty());
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "foundation/memory/Arena.hpp"
+#include "foundation/memory/ObjectPool.hpp"
+
+using namespace foundation::memory;
+
+namespace {
+
+struct Tracked {
+    static int live;
+    explicit Tracked(int v) : value(v) { ++live; }
+    ~Tracked() { --live; }
+    int value;
+};
+int Tracked::live = 0;
+
+struct alignas(128) Wide {
+    double v[4];
+};
+
+} // namespace
+
+TEST(ObjectPoolTest, CreateGetDestroy)
+{
+    ObjectPool<std::string> pool;
+    auto a = pool.create("alpha");
+    auto b = pool.create(3, 'x');
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(*pool.get(a), "alpha");
+    EXPECT_EQ(pool[b], "xxx");
+
+    EXPECT_TRUE(pool.destroy(a));
+    EXPECT_EQ(pool.get(a), nullptr);
+    EXPECT_FALSE(pool.contains(a));
+    EXPECT_FALSE(pool.destroy(a));   // 重复释放被拒绝
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool[b], "xxx");
+}
+
+TEST(ObjectPoolTest, ReusedSlotInvalidatesOldHandle)
+{
+    ObjectPool<int> pool;
+    auto old = pool.create(1);
+    pool.destroy(old);
+    auto reused = pool.create(2);
+    EXPECT_EQ(reused.index(), old.index());        // 槽位复用
+    EXPECT_NE(reused.generation(), old.generation());
+    EXPECT_EQ(pool.get(old), nullptr);              // 旧句柄看不到新对象
+    EXPECT_EQ(*pool.get(reused), 2);
+
+    EXPECT_EQ(pool.get(PoolHandle<int>()), nullptr);
+    EXPECT_FALSE(PoolHandle<int>().valid());
+}
+
+TEST(ObjectPoolTest, SlotsAreCacheLineAlignedAndStable)
+{
+    ObjectPool<double> pool;
+    std::vector<PoolHandle<double>> handles;
+    std::vector<const double*> addresses;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(pool.create(i * 0.5));
+        addresses.push_back(pool.get(handles.back()));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(addresses.back()) % kCacheLineSize, 0u);
+    }
+    // 池子增长时已有对象不搬移
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(pool.get(handles[i]), addresses[i]);
+        EXPECT_EQ(*addresses[i], i * 0.5);
+    }
+
+    ObjectPool<Wide> wide;
+    auto h = wide.create();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(wide.get(h)) % 128, 0u);
+}
+
+TEST(ObjectPoolTest, SteadyStateDoesNotAllocate)
+{
+    CountingResource upstream;
+    ObjectPool<Tracked> pool(&upstream);
+    pool.reserve(300);
+    const auto reserved = upstream.allocations();
+    EXPECT_EQ(reserved, 2u);
+    EXPECT_GE(pool.capacity(), 300u);
+
+    std::vector<PoolHandle<Tracked>> live;
+    live.reserve(300);
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 300; ++i) live.push_back(pool.create(i));
+        for (auto h : live) pool.destroy(h);
+        live.clear();
+    }
+    EXPECT_EQ(upstream.allocations(), reserved);
+    EXPECT_EQ(pool.chunkAllocations(), 2u);
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(ObjectPoolTest, ClearAndDestructorRunDestructors)
+{
+    CountingResource upstream;
+    {
+        ObjectPool<Tracked> pool(&upstream);
+        std::vector<PoolHandle<Tracked>> handles;
+        for (int i = 0; i < 10; ++i) handles.push_back(pool.create(i));
+
+        int sum = 0;
+        pool.forEach([&](PoolHandle<Tracked> h, Tracked& t) {
+            EXPECT_TRUE(pool.contains(h));
+            sum += t.value;
+        });
+        EXPECT_EQ(sum, 45);
+
+        pool.clear();
+        EXPECT_EQ(Tracked::live, 0);
+        EXPECT_TRUE(pool.empty());
+        for (auto h : handles) EXPECT_EQ(pool.get(h), nullptr);
+
+        pool.create(7);
+        pool.create(8);
+        EXPECT_EQ(Tracked::live, 2);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+    EXPECT_EQ(upstream.liveBytes(), 0u);
+}
+
+#ifndef NDEBUG
+TEST(ObjectPoolDeathTest, StaleHandleAssertsInDebug)
+{
+    ObjectPool<int> pool;
+    auto h = pool.create(1);
+    pool.destroy(h);
+    EXPECT_DEATH(pool[h] = 2, "stale or invalid handle");
+}
+#endif
+
+TEST(ObjectPoolTest, ThreadLocalPoolsAreIndependent)
+{
+    auto& mine = threadLocalObjectPool<int>();
+    auto h = mine.create(42);
+
+    std::size_t otherSize = 0;
+    bool sawMine = true;
+    std::thread t([&] {
+        auto& other = threadLocalObjectPool<int>();
+        sawMine = other.contains(h);
+        for (int i = 0; i < 100; ++i) other.create(i);
+        otherSize = other.size();
+    });
+    t.join();
+
+    EXPECT_FALSE(sawMine);
+    EXPECT_EQ(otherSize, 100u);
+    EXPECT_EQ(mine.size(), 1u);
+    mine.destroy(h);
+}
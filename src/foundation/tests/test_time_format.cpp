@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "foundation/Utils/time_format.hpp"
+
+using namespace foundation::utils::timefmt;
+
+TEST(TimeFormatTest, DaysFromCivilRoundTrip)
+{
+    EXPECT_EQ(daysFromCivil(1970, 1, 1), 0);
+    EXPECT_EQ(daysFromCivil(2000, 3, 1), 11017);
+    EXPECT_EQ(daysFromCivil(1969, 12, 31), -1);
+
+    for (int days = -50000; days < 60000; days += 13) {
+        int y = 0, m = 0, d = 0;
+        civilFromDays(days, y, m, d);
+        ASSERT_EQ(daysFromCivil(y, m, d), days);
+    }
+}
+
+TEST(TimeFormatTest, ParseDate)
+{
+    std::int32_t date = 0;
+    EXPECT_TRUE(parseDate("2023-06-30", date));
+    EXPECT_EQ(date, 20230630);
+    EXPECT_TRUE(parseDate("20240229", date));
+    EXPECT_EQ(date, 20240229);
+
+    EXPECT_FALSE(parseDate("2023-02-29", date));
+    EXPECT_FALSE(parseDate("2023-13-01", date));
+    EXPECT_FALSE(parseDate("2023/06/30", date));
+    EXPECT_FALSE(parseDate("2023-06-30 ", date));
+    EXPECT_FALSE(parseDate("", date));
+}
+
+TEST(TimeFormatTest, ParseDateTime)
+{
+    std::int64_t ms = 0;
+    EXPECT_TRUE(parseDateTime("1970-01-02", ms));
+    EXPECT_EQ(ms, 86400000);
+
+    EXPECT_TRUE(parseDateTime("2023-06-30 09:30:00", ms));
+    EXPECT_EQ(ms, 1688117400000LL);
+
+    EXPECT_TRUE(parseDateTime("2023-06-30T09:30:00.5", ms));
+    EXPECT_EQ(ms % 1000, 500);
+    EXPECT_TRUE(parseDateTime("2023-06-30 09:30:00.123456", ms));
+    EXPECT_EQ(ms % 1000, 123);
+
+    EXPECT_FALSE(parseDateTime("2023-06-30 24:00:00", ms));
+    EXPECT_FALSE(parseDateTime("2023-06-30 09:30", ms));
+    EXPECT_FALSE(parseDateTime("2023-06-30 09:30:00.", ms));
+}
+
+TEST(TimeFormatTest, FormatRoundTrip)
+{
+    EXPECT_EQ(formatDate(20230105), "2023-01-05");
+
+    char buf[kDateTimeMillisLength + 1];
+    EXPECT_EQ(formatCompactDate(20230105, buf), kCompactDateLength);
+    EXPECT_STREQ(buf, "20230105");
+
+    std::int64_t ms = 0;
+    ASSERT_TRUE(parseDateTime("2023-06-30 14:59:58.007", ms));
+    EXPECT_EQ(formatDateTime(ms, true), "2023-06-30 14:59:58.007");
+    EXPECT_EQ(formatDateTime(ms), "2023-06-30 14:59:58");
+
+    // 跨天时线程缓存必须刷新
+    EXPECT_EQ(formatDateTime(ms + 86400000), "2023-07-01 14:59:58");
+    EXPECT_EQ(formatDateTime(-1000), "1969-12-31 23:59:59");
+
+    EXPECT_EQ(millisToDate(dateToMillis(20240229)), 20240229);
+}
+
+TEST(TimeFormatTest, FormatClampsUnrepresentableYears)
+{
+    // 年份超出 0000-9999 时钳到可表示范围，不越界读两位数字表
+    // 下界与 formatDateTime 一致，钳到 0000-01-01 而不是不存在的 0000-00-00
+    EXPECT_EQ(formatDate(-20230105), "0000-01-01");
+    EXPECT_EQ(formatDate(0), "0000-01-01");
+    EXPECT_EQ(formatDate(123456789), "9999-12-31");
+    EXPECT_EQ(formatDate(99991231), "9999-12-31");
+    EXPECT_EQ(formatDate(101), "0000-01-01");
+
+    char buf[kDateTimeMillisLength + 1];
+    EXPECT_EQ(formatCompactDate(2147483647, buf), kCompactDateLength);
+    EXPECT_STREQ(buf, "99991231");
+    EXPECT_EQ(formatCompactDate(-1, buf), kCompactDateLength);
+    EXPECT_STREQ(buf, "00000101");
+
+    EXPECT_EQ(formatDateTime(INT64_MIN, true), "0000-01-01 00:00:00.000");
+    EXPECT_EQ(formatDateTime(INT64_MAX, true), "9999-12-31 23:59:59.999");
+    EXPECT_EQ(formatDateTime(-62200000000000LL), "0000-01-01 00:00:00");
+}
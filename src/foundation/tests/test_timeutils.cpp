@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "foundation/Utils/time_format.hpp"
+
+using namespace foundation::utils::timefmt;
+
+namespace {
+
+// 对照：std::get_time 解析（按 UTC 解释）
+std::int64_t parseWithGetTime(const std::string& s)
+{
+    std::tm tm{};
+    std::istringstream in(s);
+    in >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    const std::int64_t days = daysFromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    return (days * 86400 + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec) * 1000;
+}
+
+// 对照：strftime 格式化
+std::size_t formatWithStrftime(std::int64_t millis, char* out)
+{
+    const std::time_t secs = static_cast<std::time_t>(millis / 1000);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &secs);
+#else
+    gmtime_r(&secs, &tm);
+#endif
+    return std::strftime(out, 32, "%Y-%m-%d %H:%M:%S", &tm);
+}
+
+} // namespace
+
+// 与 std::get_time / strftime 逐条对照；速度对比见 src/foundation/bench/TimeFormatBench.cpp
+TEST(TimeUtilsTest, ParseMatchesGetTime)
+{
+    for (int i = 0; i < 1000; ++i) {
+        const std::string row = formatDateTime(dateToMillis(20100101) + static_cast<std::int64_t>(i) * 3600000 * 7);
+        std::int64_t v = 0;
+        ASSERT_TRUE(parseDateTime(row, v)) << row;
+        EXPECT_EQ(v, parseWithGetTime(row)) << row;
+    }
+}
+
+TEST(TimeUtilsTest, FormatMatchesStrftime)
+{
+    char fast[64];
+    char slow[64];
+    // 跨天打散（日期缓存基本不命中）与日志式连续时间戳（大多落在同一天）两种序列
+    const std::int64_t logBase = dateToMillis(20240102) + 9 * 3600000LL;
+    for (std::int64_t i = 0; i < 2000; ++i) {
+        for (const std::int64_t millis : {i * 25200000, logBase + i * 137}) {
+            const std::size_t n = formatDateTime(millis, fast);
+            const std::size_t m = formatWithStrftime(millis, slow);
+            ASSERT_EQ(n, m) << millis;
+            EXPECT_EQ(std::string(fast, n), std::string(slow, m)) << millis;
+        }
+    }
+}